@@ -1,8 +1,14 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <random>
+#include <string_view>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fault_model.h"
+#include "random_stream.h"
 
 namespace evtol
 {
@@ -14,6 +20,9 @@ namespace evtol
         DELTA,
         ECHO
     };
+
+    inline constexpr size_t NUM_AIRCRAFT_TYPES = 5;
+
     struct FlightStats
     {
         double total_flight_time_hours = 0.0;
@@ -127,6 +136,28 @@ namespace evtol
             charge_count++;
         }
 
+        /**
+         * Add another accumulator's totals (e.g. a per-thread shard) into this one
+         */
+        void merge(const FlightStats &other)
+        {
+            total_flight_time_hours += other.total_flight_time_hours;
+            total_distance_miles += other.total_distance_miles;
+            total_charging_time_hours += other.total_charging_time_hours;
+            total_waiting_time_hours += other.total_waiting_time_hours;
+            total_faults += other.total_faults;
+            total_passenger_miles += other.total_passenger_miles;
+            flight_count += other.flight_count;
+            charge_count += other.charge_count;
+
+            partial_flight_time_hours += other.partial_flight_time_hours;
+            partial_distance_miles += other.partial_distance_miles;
+            partial_charging_time_hours += other.partial_charging_time_hours;
+            partial_passenger_miles += other.partial_passenger_miles;
+            partial_flight_count += other.partial_flight_count;
+            partial_charge_count += other.partial_charge_count;
+        }
+
         double avg_flight_time() const
         {
             return flight_count > 0 ? total_flight_time_hours / flight_count : 0.0;
@@ -160,7 +191,7 @@ namespace evtol
 
     struct AircraftSpec
     {
-        const std::string manufacturer;
+        const std::string_view manufacturer; // names are string literals, so specs can be constexpr
         const double cruise_speed_mph;
         const double battery_capacity_kwh;
         const double time_to_charge_hours;
@@ -168,11 +199,31 @@ namespace evtol
         const double fault_probability_per_hour;
         // out of scope for this project, but leaving energy usage in class to be dynamic (in theory)
 
-        constexpr AircraftSpec(const std::string &mfg, double speed, double battery,
+        constexpr AircraftSpec(std::string_view mfg, double speed, double battery,
                                double charge_time, int passengers, double fault_prob)
             : manufacturer(mfg), cruise_speed_mph(speed), battery_capacity_kwh(battery),
               time_to_charge_hours(charge_time), passenger_count(passengers),
               fault_probability_per_hour(fault_prob) {}
+
+        /**
+         * Hours of cruise on a battery at battery_level
+         */
+        constexpr double flight_time_hours(double battery_level, double energy_consumption_per_mile) const
+        {
+            return battery_level * battery_capacity_kwh / (cruise_speed_mph * energy_consumption_per_mile);
+        }
+    };
+
+    /**
+     * Everything about an aircraft that changes during a run, as saved in checkpoints
+     */
+    struct AircraftSnapshot
+    {
+        double battery_level = 1.0;
+        bool faulty = false;
+        std::uint64_t rng_seed = 0;
+        std::uint64_t rng_stream_id = 0;
+        std::uint64_t rng_draw_index = 0;
     };
 
     class AircraftBase
@@ -193,15 +244,55 @@ namespace evtol
         virtual double get_charge_time_hours() const = 0;
         virtual bool is_faulty() const = 0;
         virtual void set_faulty(bool faulty) = 0;
+
+        /**
+         * Key this aircraft's fault sampling to a reproducible stream
+         * Aircraft without stochastic behavior can ignore it
+         */
+        virtual void seed_random_stream(std::uint64_t /*seed*/, std::uint64_t /*stream_id*/) {}
+
+        /**
+         * The stream check_fault_during_flight draws from, for batched block generation
+         * Aircraft without one return nullptr
+         */
+        virtual RandomStream *random_stream() { return nullptr; }
+
+        /**
+         * Select how check_fault_during_flight draws faults (see fault_model.h)
+         * Aircraft with their own fault behavior can ignore it
+         */
+        virtual void set_fault_model(FaultModel /*model*/) {}
+
+        /**
+         * State for checkpoints; the defaults cover aircraft with no random stream
+         * Batteries are only ever full or empty, so restoring one is a charge or a discharge.
+         */
+        virtual AircraftSnapshot save_state() const
+        {
+            AircraftSnapshot state;
+            state.battery_level = get_battery_level();
+            state.faulty = is_faulty();
+            return state;
+        }
+
+        virtual void restore_state(const AircraftSnapshot &state)
+        {
+            if (state.battery_level > 0.0)
+                charge_battery();
+            else
+                discharge_battery();
+            set_faulty(state.faulty);
+        }
     };
 
+    /**
+     * The default fleet container: polymorphic aircraft owned through heap pointers
+     */
+    using AircraftFleet = std::vector<std::unique_ptr<AircraftBase>>;
+
     template <typename Derived>
     class Aircraft : public AircraftBase
     {
-    private:
-        static inline std::mt19937 rng{std::random_device{}()};
-        static inline std::uniform_real_distribution<double> fault_dist{0.0, 1.0};
-
     public:
         Aircraft(int id) : aircraft_id_(id), battery_level_(1.0), is_faulty_(false) {}
 
@@ -212,32 +303,44 @@ namespace evtol
             return static_cast<const Derived *>(this)->get_aircraft_spec();
         }
 
+        /**
+         * Flight time and distance on a full battery, folded at compile time from the class's spec
+         */
+        static constexpr double full_charge_flight_time_hours()
+        {
+            return Derived::get_aircraft_spec().flight_time_hours(1.0, Derived::get_energy_consumption_per_mile());
+        }
+
+        static constexpr double full_charge_flight_distance_miles()
+        {
+            return full_charge_flight_time_hours() * Derived::get_aircraft_spec().cruise_speed_mph;
+        }
+
+        // Batteries are only ever full or empty, so flights normally take the per-type constants;
+        // other levels (a future partial-charge model) fall back to the general expression
         double get_flight_time_hours() const override
         {
-            return battery_level_ * get_spec().battery_capacity_kwh /
-                   (get_spec().cruise_speed_mph * energy_consumption_per_mile());
+            constexpr double full_charge = full_charge_flight_time_hours();
+            if (battery_level_ == 1.0)
+            {
+                return full_charge;
+            }
+            return get_spec().flight_time_hours(battery_level_, energy_consumption_per_mile());
         }
 
         double get_flight_distance_miles() const override
         {
+            constexpr double full_charge = full_charge_flight_distance_miles();
+            if (battery_level_ == 1.0)
+            {
+                return full_charge;
+            }
             return get_flight_time_hours() * get_spec().cruise_speed_mph;
         }
 
         double check_fault_during_flight(double flight_time_hours) override
         {
-            double fault_rate = get_spec().fault_probability_per_hour;
-            if (fault_rate <= 0.0)
-                return -1.0; // never faults
-
-            // Simple probability check for fault during this flight
-            double flight_fault_probability = fault_rate * flight_time_hours;
-            if (fault_dist(rng) < flight_fault_probability)
-            {
-                // Fault occurs - randomly pick a time during the flight
-                // this could be more sophisticated, but should work for our purposes
-                return fault_dist(rng) * flight_time_hours;
-            }
-            return -1.0;
+            return sample_flight_fault(rng_, fault_model_, get_spec().fault_probability_per_hour, flight_time_hours);
         }
 
         void discharge_battery() override
@@ -267,7 +370,7 @@ namespace evtol
 
         std::string get_manufacturer() const override
         {
-            return get_spec().manufacturer;
+            return std::string(get_spec().manufacturer);
         }
 
         int get_passenger_count() const override
@@ -290,6 +393,39 @@ namespace evtol
             is_faulty_ = faulty;
         }
 
+        void seed_random_stream(std::uint64_t seed, std::uint64_t stream_id) override
+        {
+            rng_.reseed(seed, stream_id);
+        }
+
+        void set_fault_model(FaultModel model) override
+        {
+            fault_model_ = model;
+        }
+
+        RandomStream *random_stream() override
+        {
+            return &rng_;
+        }
+
+        const RandomStream &get_random_stream() const
+        {
+            return rng_;
+        }
+
+        AircraftSnapshot save_state() const override
+        {
+            return {battery_level_, is_faulty_, rng_.get_seed(), rng_.get_stream_id(), rng_.get_draw_index()};
+        }
+
+        void restore_state(const AircraftSnapshot &state) override
+        {
+            battery_level_ = state.battery_level;
+            is_faulty_ = state.faulty;
+            rng_.reseed(state.rng_seed, state.rng_stream_id);
+            rng_.set_draw_index(state.rng_draw_index);
+        }
+
     protected:
         virtual double energy_consumption_per_mile() const = 0;
 
@@ -297,5 +433,7 @@ namespace evtol
         int aircraft_id_;
         double battery_level_;
         bool is_faulty_;
+        RandomStream rng_;
+        FaultModel fault_model_ = FaultModel::LINEAR;
     };
 }
\ No newline at end of file
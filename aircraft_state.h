@@ -63,6 +63,21 @@ namespace evtol
         void reset_for_activity(AircraftState new_state, double duration);
     };
 
+    /**
+     * Event-driven engine's record of what an aircraft is doing, kept densely by fleet position
+     * Holds everything the engine needs between an aircraft's events and at the end of the run.
+     */
+    struct AircraftTimeline
+    {
+        AircraftState state{AircraftState::IDLE};
+        double start_time_hours{0.0};      // start of the flight, wait or charge under way
+        double end_time_hours{0.0};        // scheduled end of the flight or charge
+        double activity_hours{0.0};        // planned length of the flight or charge
+        double flight_distance_miles{0.0}; // planned distance of the flight
+        double waiting_time_hours{0.0};    // wait that preceded the charge
+        double fault_time_hours{-1.0};     // time of the fault pending in this flight, -1 if none
+    };
+
     /**
      * State machine for aircraft state transitions
      */
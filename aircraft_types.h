@@ -1,4 +1,9 @@
 #pragma once
+#include <array>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include "aircraft.h"
 
 namespace evtol
@@ -9,10 +14,11 @@ namespace evtol
     public:
         AlphaAircraft(int id) : Aircraft<AlphaAircraft>(id) {}
 
-        static const AircraftSpec &get_aircraft_spec()
+        static constexpr AircraftSpec SPEC{"Alpha", 120.0, 320.0, 0.6, 4, 0.25};
+
+        static constexpr const AircraftSpec &get_aircraft_spec()
         {
-            static const AircraftSpec spec("Alpha", 120.0, 320.0, 0.6, 4, 0.25);
-            return spec;
+            return SPEC;
         }
 
         static constexpr AircraftType get_aircraft_type()
@@ -20,10 +26,15 @@ namespace evtol
             return AircraftType::ALPHA;
         }
 
+        static constexpr double get_energy_consumption_per_mile()
+        {
+            return 1.6;
+        }
+
     protected:
         double energy_consumption_per_mile() const override
         {
-            return 1.6;
+            return get_energy_consumption_per_mile();
         }
     };
 
@@ -32,10 +43,11 @@ namespace evtol
     public:
         BetaAircraft(int id) : Aircraft<BetaAircraft>(id) {}
 
-        static const AircraftSpec &get_aircraft_spec()
+        static constexpr AircraftSpec SPEC{"Beta", 100.0, 100.0, 0.2, 5, 0.10};
+
+        static constexpr const AircraftSpec &get_aircraft_spec()
         {
-            static const AircraftSpec spec("Beta", 100.0, 100.0, 0.2, 5, 0.10);
-            return spec;
+            return SPEC;
         }
 
         static constexpr AircraftType get_aircraft_type()
@@ -43,10 +55,15 @@ namespace evtol
             return AircraftType::BETA;
         }
 
+        static constexpr double get_energy_consumption_per_mile()
+        {
+            return 1.5;
+        }
+
     protected:
         double energy_consumption_per_mile() const override
         {
-            return 1.5;
+            return get_energy_consumption_per_mile();
         }
     };
 
@@ -55,10 +72,11 @@ namespace evtol
     public:
         CharlieAircraft(int id) : Aircraft<CharlieAircraft>(id) {}
 
-        static const AircraftSpec &get_aircraft_spec()
+        static constexpr AircraftSpec SPEC{"Charlie", 160.0, 220.0, 0.8, 3, 0.05};
+
+        static constexpr const AircraftSpec &get_aircraft_spec()
         {
-            static const AircraftSpec spec("Charlie", 160.0, 220.0, 0.8, 3, 0.05);
-            return spec;
+            return SPEC;
         }
 
         static constexpr AircraftType get_aircraft_type()
@@ -66,10 +84,15 @@ namespace evtol
             return AircraftType::CHARLIE;
         }
 
+        static constexpr double get_energy_consumption_per_mile()
+        {
+            return 2.2;
+        }
+
     protected:
         double energy_consumption_per_mile() const override
         {
-            return 2.2;
+            return get_energy_consumption_per_mile();
         }
     };
 
@@ -78,10 +101,11 @@ namespace evtol
     public:
         DeltaAircraft(int id) : Aircraft<DeltaAircraft>(id) {}
 
-        static const AircraftSpec &get_aircraft_spec()
+        static constexpr AircraftSpec SPEC{"Delta", 90.0, 120.0, 0.62, 2, 0.22};
+
+        static constexpr const AircraftSpec &get_aircraft_spec()
         {
-            static const AircraftSpec spec("Delta", 90.0, 120.0, 0.62, 2, 0.22);
-            return spec;
+            return SPEC;
         }
 
         static constexpr AircraftType get_aircraft_type()
@@ -89,10 +113,15 @@ namespace evtol
             return AircraftType::DELTA;
         }
 
+        static constexpr double get_energy_consumption_per_mile()
+        {
+            return 0.8;
+        }
+
     protected:
         double energy_consumption_per_mile() const override
         {
-            return 0.8;
+            return get_energy_consumption_per_mile();
         }
     };
 
@@ -101,10 +130,11 @@ namespace evtol
     public:
         EchoAircraft(int id) : Aircraft<EchoAircraft>(id) {}
 
-        static const AircraftSpec &get_aircraft_spec()
+        static constexpr AircraftSpec SPEC{"Echo", 30.0, 150.0, 0.3, 2, 0.61};
+
+        static constexpr const AircraftSpec &get_aircraft_spec()
         {
-            static const AircraftSpec spec("Echo", 30.0, 150.0, 0.3, 2, 0.61);
-            return spec;
+            return SPEC;
         }
 
         static constexpr AircraftType get_aircraft_type()
@@ -112,27 +142,157 @@ namespace evtol
             return AircraftType::ECHO;
         }
 
+        static constexpr double get_energy_consumption_per_mile()
+        {
+            return 5.8;
+        }
+
     protected:
         double energy_consumption_per_mile() const override
         {
-            return 5.8;
+            return get_energy_consumption_per_mile();
         }
     };
 
+    /**
+     * Compile-time list of the concrete aircraft classes
+     */
+    template <typename... Types>
+    struct AircraftTypeList
+    {
+    };
+
+    using AllAircraftTypes = AircraftTypeList<AlphaAircraft, BetaAircraft, CharlieAircraft, DeltaAircraft, EchoAircraft>;
+
+    /**
+     * Per-type parameters resolved without virtual dispatch
+     */
+    struct AircraftTypeParameters
+    {
+        const AircraftSpec *spec = nullptr;
+        double energy_consumption_per_mile = 0.0;
+        double full_charge_flight_time_hours = 0.0;     // flight on a full battery, the only level flights start at
+        double full_charge_flight_distance_miles = 0.0;
+    };
+
+    using AircraftTypeTable = std::array<AircraftTypeParameters, NUM_AIRCRAFT_TYPES>;
+
+    /**
+     * Table indexed by AircraftType, generated at compile time from the CRTP classes in AllAircraftTypes
+     */
+    inline constexpr AircraftTypeTable AIRCRAFT_TYPE_TABLE = []<typename... Types>(AircraftTypeList<Types...>)
+    {
+        AircraftTypeTable result{};
+        ((result[static_cast<size_t>(Types::get_aircraft_type())] =
+              AircraftTypeParameters{&Types::get_aircraft_spec(), Types::get_energy_consumption_per_mile(),
+                                     Types::full_charge_flight_time_hours(), Types::full_charge_flight_distance_miles()}),
+         ...);
+        return result;
+    }(AllAircraftTypes{});
+
+    inline const AircraftTypeTable &aircraft_type_table()
+    {
+        return AIRCRAFT_TYPE_TABLE;
+    }
+
+    /**
+     * Invoke func(std::type_identity<T>{}) for every concrete aircraft class
+     */
+    template <typename Func>
+    void for_each_aircraft_class(Func &&func)
+    {
+        [&]<typename... Types>(AircraftTypeList<Types...>)
+        {
+            (func(std::type_identity<Types>{}), ...);
+        }(AllAircraftTypes{});
+    }
+
+    /**
+     * Relative share of each aircraft type in a fleet
+     * Types are dealt out in repeating blocks of sum(weights) ids, each type taking weight
+     * consecutive ids in type order; the default equal weights give the round-robin id % 5.
+     */
+    struct FleetMix
+    {
+        static constexpr const char *type_names[] = {
+            "alpha", "beta", "charlie", "delta", "echo"};
+
+        std::array<int, NUM_AIRCRAFT_TYPES> weights{1, 1, 1, 1, 1};
+
+        int period() const { return std::accumulate(weights.begin(), weights.end(), 0); }
+
+        /**
+         * Type of the aircraft with the given id
+         * @pre period() > 0
+         */
+        AircraftType type_of(int aircraft_id) const
+        {
+            int position = aircraft_id % period();
+            size_t t = 0;
+            while (position >= weights[t])
+            {
+                position -= weights[t];
+                ++t;
+            }
+            return static_cast<AircraftType>(t);
+        }
+
+        /**
+         * Weights divided by their common divisor; mixes with equal normal forms build equal fleets
+         */
+        FleetMix normalized() const
+        {
+            int divisor = 0;
+            for (int weight : weights)
+            {
+                divisor = std::gcd(divisor, weight);
+            }
+
+            FleetMix result = *this;
+            if (divisor > 1)
+            {
+                for (int &weight : result.weights)
+                {
+                    weight /= divisor;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * "alpha:2,beta:1,..." listing the types with a non-zero weight
+         */
+        std::string to_string() const
+        {
+            std::string text;
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                if (weights[t] > 0)
+                {
+                    text += (text.empty() ? "" : ",") + std::string(type_names[t]) + ":" + std::to_string(weights[t]);
+                }
+            }
+            return text;
+        }
+
+        bool operator==(const FleetMix &) const = default;
+    };
+
     template <typename... AircraftTypes>
     class AircraftFactory
     {
     public:
-        static std::vector<std::unique_ptr<AircraftBase>> create_fleet(int size)
+        /**
+         * @param mix Type shares; the default is the round-robin id % 5
+         */
+        static std::vector<std::unique_ptr<AircraftBase>> create_fleet(int size, const FleetMix &mix = {})
         {
             std::vector<std::unique_ptr<AircraftBase>> fleet;
             fleet.reserve(static_cast<size_t>(size));
 
             for (int i = 0; i < size; ++i)
             {
-                int aircraft_type = i % 5; // Round-robin distribution
-                
-                switch (aircraft_type)
+                switch (static_cast<int>(mix.type_of(i)))
                 {
                 case 0:
                     fleet.emplace_back(std::make_unique<AlphaAircraft>(i));
@@ -0,0 +1,154 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include "aircraft.h"
+#include "aircraft_types.h"
+
+namespace evtol
+{
+    /**
+     * Fleet of CRTP aircraft objects placed in one contiguous arena
+     * The objects are laid out grouped by type (all Alphas, then all Betas, ...) in a single block
+     * handed out by a std::pmr::monotonic_buffer_resource, while positions stay in id order like
+     * AircraftFactory::create_fleet, so runs match the pointer fleet exactly. reset() destroys and
+     * rebuilds every aircraft in the same block, so repeated runs allocate nothing.
+     */
+    class ArenaFleet
+    {
+    private:
+        int size_ = 0;
+        FleetMix mix_;
+        std::vector<std::byte> storage_;
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+        std::vector<AircraftBase *> aircraft_; // by fleet position (= id)
+
+        void destroy()
+        {
+            for (AircraftBase *aircraft : aircraft_)
+            {
+                aircraft->~AircraftBase();
+            }
+            aircraft_.clear();
+            if (arena_)
+            {
+                arena_->release();
+            }
+        }
+
+        void build()
+        {
+            std::array<size_t, NUM_AIRCRAFT_TYPES> counts{};
+            for (int id = 0; id < size_; ++id)
+            {
+                counts[static_cast<size_t>(mix_.type_of(id))]++;
+            }
+
+            size_t bytes = 0;
+            for_each_aircraft_class([&](auto type_tag)
+                                    {
+                using T = typename decltype(type_tag)::type;
+                bytes += counts[static_cast<size_t>(T::get_aircraft_type())] * sizeof(T) + alignof(T); });
+
+            // A block that fits is kept; only a larger fleet replaces it
+            if (!arena_ || bytes > storage_.size())
+            {
+                storage_.assign(bytes, std::byte{0});
+                arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>(storage_.data(), storage_.size());
+            }
+
+            aircraft_.assign(static_cast<size_t>(size_), nullptr);
+            for_each_aircraft_class([&](auto type_tag)
+                                    {
+                using T = typename decltype(type_tag)::type;
+                if (counts[static_cast<size_t>(T::get_aircraft_type())] == 0)
+                {
+                    return;
+                }
+                for (int id = 0; id < size_; ++id)
+                {
+                    if (mix_.type_of(id) == T::get_aircraft_type())
+                    {
+                        aircraft_[static_cast<size_t>(id)] = new (arena_->allocate(sizeof(T), alignof(T))) T(id);
+                    }
+                } });
+        }
+
+    public:
+        using iterator = std::vector<AircraftBase *>::iterator;
+        using const_iterator = std::vector<AircraftBase *>::const_iterator;
+
+        ArenaFleet() = default;
+
+        /**
+         * Build size aircraft typed by mix, the same fleet as AircraftFactory<>::create_fleet(size, mix)
+         */
+        explicit ArenaFleet(int size, const FleetMix &mix = {}) : size_(size), mix_(mix)
+        {
+            build();
+        }
+
+        ~ArenaFleet() { destroy(); }
+
+        ArenaFleet(const ArenaFleet &) = delete;
+        ArenaFleet &operator=(const ArenaFleet &) = delete;
+
+        // The arena and the block live on the heap, so moving keeps every aircraft in place
+        ArenaFleet(ArenaFleet &&) noexcept = default;
+
+        ArenaFleet &operator=(ArenaFleet &&other) noexcept
+        {
+            if (this != &other)
+            {
+                destroy();
+                size_ = other.size_;
+                mix_ = other.mix_;
+                storage_ = std::move(other.storage_);
+                arena_ = std::move(other.arena_);
+                aircraft_ = std::move(other.aircraft_);
+                other.aircraft_.clear();
+            }
+            return *this;
+        }
+
+        /**
+         * Rebuild every aircraft as freshly created, reusing the arena
+         */
+        void reset()
+        {
+            destroy();
+            build();
+        }
+
+        /**
+         * Rebuild as a fleet of size aircraft typed by mix; the arena is only reallocated to grow
+         */
+        void reset(int size, const FleetMix &mix)
+        {
+            destroy();
+            size_ = size;
+            mix_ = mix;
+            build();
+        }
+
+        size_t size() const { return aircraft_.size(); }
+        bool empty() const { return aircraft_.empty(); }
+        const FleetMix &get_mix() const { return mix_; }
+
+        /**
+         * Bytes of the arena block the aircraft objects live in
+         */
+        size_t arena_bytes() const { return storage_.size(); }
+
+        AircraftBase *operator[](size_t index) const { return aircraft_[index]; }
+
+        iterator begin() { return aircraft_.begin(); }
+        iterator end() { return aircraft_.end(); }
+        const_iterator begin() const { return aircraft_.begin(); }
+        const_iterator end() const { return aircraft_.end(); }
+    };
+}
@@ -0,0 +1,577 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "aircraft.h"
+#include "snapshot.h"
+#include "statistics_engine.h"
+
+namespace evtol
+{
+    /**
+     * Streaming mean/variance accumulator (Welford), mergeable across workers
+     */
+    class RunningStat
+    {
+    private:
+        size_t count_ = 0;
+        double mean_ = 0.0;
+        double m2_ = 0.0;
+
+    public:
+        void add(double value)
+        {
+            ++count_;
+            double delta = value - mean_;
+            mean_ += delta / static_cast<double>(count_);
+            m2_ += delta * (value - mean_);
+        }
+
+        void merge(const RunningStat &other)
+        {
+            if (other.count_ == 0)
+            {
+                return;
+            }
+            if (count_ == 0)
+            {
+                *this = other;
+                return;
+            }
+
+            double total = static_cast<double>(count_ + other.count_);
+            double delta = other.mean_ - mean_;
+            mean_ += delta * static_cast<double>(other.count_) / total;
+            m2_ += other.m2_ + delta * delta * static_cast<double>(count_) * static_cast<double>(other.count_) / total;
+            count_ += other.count_;
+        }
+
+        size_t count() const { return count_; }
+        double mean() const { return mean_; }
+
+        void save_state(SnapshotWriter &out) const
+        {
+            out.write(static_cast<std::uint64_t>(count_));
+            out.write(mean_);
+            out.write(m2_);
+        }
+
+        void restore_state(SnapshotReader &in)
+        {
+            count_ = static_cast<size_t>(in.read<std::uint64_t>());
+            mean_ = in.read<double>();
+            m2_ = in.read<double>();
+        }
+
+        double variance() const
+        {
+            return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0;
+        }
+
+        double stddev() const { return std::sqrt(variance()); }
+
+        /**
+         * Half-width of the two-sided 95% confidence interval for the mean
+         */
+        double ci95_half_width() const
+        {
+            if (count_ < 2)
+            {
+                return 0.0;
+            }
+            return t_critical_95(count_ - 1) * stddev() / std::sqrt(static_cast<double>(count_));
+        }
+
+        /**
+         * Two-sided 95% Student t critical value for the given degrees of freedom
+         */
+        static double t_critical_95(size_t degrees_of_freedom)
+        {
+            static constexpr double table[] = {
+                12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+            if (degrees_of_freedom == 0)
+            {
+                return 0.0;
+            }
+            if (degrees_of_freedom <= 30)
+            {
+                return table[degrees_of_freedom - 1];
+            }
+            if (degrees_of_freedom <= 40)
+                return 2.021;
+            if (degrees_of_freedom <= 60)
+                return 2.000;
+            if (degrees_of_freedom <= 120)
+                return 1.980;
+            return 1.960;
+        }
+    };
+
+    /**
+     * A named scalar extracted from FlightStats for cross-replication statistics
+     */
+    struct FlightStatsMetric
+    {
+        const char *name;
+        double (*extract)(const FlightStats &);
+    };
+
+    inline constexpr std::array<FlightStatsMetric, 18> FLIGHT_STATS_METRICS = {{
+        {"total_flight_time_hours", [](const FlightStats &s) { return s.total_flight_time_hours; }},
+        {"total_distance_miles", [](const FlightStats &s) { return s.total_distance_miles; }},
+        {"total_charging_time_hours", [](const FlightStats &s) { return s.total_charging_time_hours; }},
+        {"total_waiting_time_hours", [](const FlightStats &s) { return s.total_waiting_time_hours; }},
+        {"total_faults", [](const FlightStats &s) { return static_cast<double>(s.total_faults); }},
+        {"total_passenger_miles", [](const FlightStats &s) { return s.total_passenger_miles; }},
+        {"flight_count", [](const FlightStats &s) { return static_cast<double>(s.flight_count); }},
+        {"charge_count", [](const FlightStats &s) { return static_cast<double>(s.charge_count); }},
+        {"partial_flight_time_hours", [](const FlightStats &s) { return s.partial_flight_time_hours; }},
+        {"partial_distance_miles", [](const FlightStats &s) { return s.partial_distance_miles; }},
+        {"partial_charging_time_hours", [](const FlightStats &s) { return s.partial_charging_time_hours; }},
+        {"partial_passenger_miles", [](const FlightStats &s) { return s.partial_passenger_miles; }},
+        {"partial_flight_count", [](const FlightStats &s) { return static_cast<double>(s.partial_flight_count); }},
+        {"partial_charge_count", [](const FlightStats &s) { return static_cast<double>(s.partial_charge_count); }},
+        {"avg_flight_time", [](const FlightStats &s) { return s.avg_flight_time(); }},
+        {"avg_distance", [](const FlightStats &s) { return s.avg_distance(); }},
+        {"avg_charging_time", [](const FlightStats &s) { return s.avg_charging_time(); }},
+        {"avg_waiting_time", [](const FlightStats &s) { return s.avg_waiting_time(); }},
+    }};
+
+    /**
+     * Per-replication result: the final FlightStats of every aircraft type
+     */
+    using ReplicationResult = std::array<FlightStats, NUM_AIRCRAFT_TYPES>;
+
+    /**
+     * Cross-replication statistics for every FlightStats metric, per aircraft type and fleet-wide
+     */
+    class BatchStatistics
+    {
+    private:
+        using MetricStats = std::array<RunningStat, FLIGHT_STATS_METRICS.size()>;
+
+        std::array<MetricStats, NUM_AIRCRAFT_TYPES> per_type_{};
+        MetricStats fleet_{};
+        size_t replications_ = 0;
+        std::vector<TypeDistributions> distributions_; // pooled over replications; empty unless added
+
+        static void add_metrics(MetricStats &target, const FlightStats &stats)
+        {
+            for (size_t m = 0; m < FLIGHT_STATS_METRICS.size(); ++m)
+            {
+                target[m].add(FLIGHT_STATS_METRICS[m].extract(stats));
+            }
+        }
+
+        static void write_metrics(std::ostringstream &oss, const MetricStats &metrics)
+        {
+            for (size_t m = 0; m < FLIGHT_STATS_METRICS.size(); ++m)
+            {
+                const RunningStat &stat = metrics[m];
+                double half_width = stat.ci95_half_width();
+                oss << "  " << std::left << std::setw(30) << FLIGHT_STATS_METRICS[m].name << std::right
+                    << " mean " << std::setw(10) << stat.mean()
+                    << "  sd " << std::setw(9) << stat.stddev()
+                    << "  95% CI [" << stat.mean() - half_width << ", " << stat.mean() + half_width << "]\n";
+            }
+        }
+
+        static void write_percentiles(std::ostringstream &oss, const TypeDistributions &distributions)
+        {
+            auto write_line = [&](const char *name, const StreamingHistogram &histogram)
+            {
+                oss << "  " << std::left << std::setw(30) << name << std::right
+                    << " p50 " << std::setw(10) << histogram.value_at_percentile(50.0)
+                    << "  p95 " << std::setw(9) << histogram.value_at_percentile(95.0)
+                    << "  p99 " << histogram.value_at_percentile(99.0) << "\n";
+            };
+
+            write_line("flight_time_hours", distributions.flight_time_hours);
+            write_line("charge_wait_hours", distributions.charge_wait_hours);
+            write_line("queue_length_on_arrival", distributions.queue_length);
+        }
+
+    public:
+        static constexpr const char *aircraft_type_names[] = {
+            "Alpha", "Beta", "Charlie", "Delta", "Echo"};
+
+        /**
+         * Combine the per-type stats of one replication into fleet-wide totals
+         */
+        static FlightStats fleet_totals(const ReplicationResult &result)
+        {
+            FlightStats total;
+            for (const auto &stats : result)
+            {
+                total.total_flight_time_hours += stats.total_flight_time_hours;
+                total.total_distance_miles += stats.total_distance_miles;
+                total.total_charging_time_hours += stats.total_charging_time_hours;
+                total.total_waiting_time_hours += stats.total_waiting_time_hours;
+                total.total_faults += stats.total_faults;
+                total.total_passenger_miles += stats.total_passenger_miles;
+                total.flight_count += stats.flight_count;
+                total.charge_count += stats.charge_count;
+                total.partial_flight_time_hours += stats.partial_flight_time_hours;
+                total.partial_distance_miles += stats.partial_distance_miles;
+                total.partial_charging_time_hours += stats.partial_charging_time_hours;
+                total.partial_passenger_miles += stats.partial_passenger_miles;
+                total.partial_flight_count += stats.partial_flight_count;
+                total.partial_charge_count += stats.partial_charge_count;
+            }
+            return total;
+        }
+
+        /**
+         * Snapshot the final per-type stats of a finished replication
+         */
+        static ReplicationResult capture(const StatisticsCollector &stats)
+        {
+            ReplicationResult result;
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                result[t] = stats.get_stats(static_cast<AircraftType>(t));
+            }
+            return result;
+        }
+
+        void add_replication(const ReplicationResult &result)
+        {
+            for (size_t t = 0; t < per_type_.size(); ++t)
+            {
+                add_metrics(per_type_[t], result[t]);
+            }
+            add_metrics(fleet_, fleet_totals(result));
+            ++replications_;
+        }
+
+        void add_replication(const StatisticsCollector &stats)
+        {
+            add_replication(capture(stats));
+        }
+
+        /**
+         * Pool the percentile histograms of one or more replications; a shard without them is ignored
+         */
+        void add_distributions(const StatsShard &shard)
+        {
+            if (!shard.has_distributions())
+            {
+                return;
+            }
+
+            distributions_.resize(NUM_AIRCRAFT_TYPES);
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                distributions_[t].merge(shard.distributions(static_cast<AircraftType>(t)));
+            }
+        }
+
+        bool has_distributions() const { return !distributions_.empty(); }
+
+        /**
+         * @pre has_distributions()
+         */
+        const TypeDistributions &get_distributions(AircraftType type) const
+        {
+            return distributions_[static_cast<size_t>(type)];
+        }
+
+        void merge(const BatchStatistics &other)
+        {
+            for (size_t t = 0; t < per_type_.size(); ++t)
+            {
+                for (size_t m = 0; m < FLIGHT_STATS_METRICS.size(); ++m)
+                {
+                    per_type_[t][m].merge(other.per_type_[t][m]);
+                }
+            }
+            for (size_t m = 0; m < FLIGHT_STATS_METRICS.size(); ++m)
+            {
+                fleet_[m].merge(other.fleet_[m]);
+            }
+            replications_ += other.replications_;
+
+            if (other.has_distributions())
+            {
+                distributions_.resize(NUM_AIRCRAFT_TYPES);
+                for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+                {
+                    distributions_[t].merge(other.distributions_[t]);
+                }
+            }
+        }
+
+        size_t get_replication_count() const { return replications_; }
+
+        /**
+         * Accumulators and pooled histograms, e.g. to send a partial batch to another process
+         */
+        void save_state(SnapshotWriter &out) const
+        {
+            out.begin_section(snapshot_tag("BTCH"));
+            out.write(static_cast<std::uint64_t>(replications_));
+            for (const MetricStats &metrics : per_type_)
+            {
+                for (const RunningStat &stat : metrics)
+                {
+                    stat.save_state(out);
+                }
+            }
+            for (const RunningStat &stat : fleet_)
+            {
+                stat.save_state(out);
+            }
+            out.write(static_cast<std::uint8_t>(has_distributions()));
+            for (const auto &distributions : distributions_)
+            {
+                distributions.save_state(out);
+            }
+        }
+
+        /**
+         * @throws std::runtime_error for a corrupt section
+         */
+        void restore_state(SnapshotReader &in)
+        {
+            in.expect_section(snapshot_tag("BTCH"));
+            replications_ = static_cast<size_t>(in.read<std::uint64_t>());
+            for (MetricStats &metrics : per_type_)
+            {
+                for (RunningStat &stat : metrics)
+                {
+                    stat.restore_state(in);
+                }
+            }
+            for (RunningStat &stat : fleet_)
+            {
+                stat.restore_state(in);
+            }
+            distributions_.clear();
+            if (in.read<std::uint8_t>() != 0)
+            {
+                distributions_.resize(NUM_AIRCRAFT_TYPES);
+                for (auto &distributions : distributions_)
+                {
+                    distributions.restore_state(in);
+                }
+            }
+        }
+
+        const RunningStat &get_metric(AircraftType type, size_t metric_index) const
+        {
+            return per_type_[static_cast<size_t>(type)].at(metric_index);
+        }
+
+        const RunningStat &get_fleet_metric(size_t metric_index) const
+        {
+            return fleet_.at(metric_index);
+        }
+
+        /**
+         * Look up a metric index by name
+         * @return Index into FLIGHT_STATS_METRICS, or -1 if unknown
+         */
+        static int find_metric(const std::string &name)
+        {
+            for (size_t m = 0; m < FLIGHT_STATS_METRICS.size(); ++m)
+            {
+                if (name == FLIGHT_STATS_METRICS[m].name)
+                {
+                    return static_cast<int>(m);
+                }
+            }
+            return -1;
+        }
+
+        std::string generate_report() const
+        {
+            std::ostringstream oss;
+
+            oss << std::fixed << std::setprecision(3);
+            oss << "\n========== eVTOL Batch Results (" << replications_ << " replications) ==========\n\n";
+
+            for (size_t t = 0; t < per_type_.size(); ++t)
+            {
+                oss << aircraft_type_names[t] << " Aircraft:\n";
+                write_metrics(oss, per_type_[t]);
+                if (has_distributions())
+                {
+                    write_percentiles(oss, distributions_[t]);
+                }
+                oss << "\n";
+            }
+
+            oss << "========== Fleet Totals ==========\n";
+            write_metrics(oss, fleet_);
+            if (has_distributions())
+            {
+                TypeDistributions fleet;
+                for (const auto &distributions : distributions_)
+                {
+                    fleet.merge(distributions);
+                }
+                write_percentiles(oss, fleet);
+            }
+            oss << "\n";
+
+            return oss.str();
+        }
+    };
+
+    /**
+     * A metric a stopping rule watches: the fleet totals' or one aircraft type's
+     */
+    struct WatchedMetric
+    {
+        size_t metric_index = 0;          // into FLIGHT_STATS_METRICS
+        std::optional<AircraftType> type; // fleet totals when unset
+
+        const RunningStat &in(const BatchStatistics &batch) const
+        {
+            return type ? batch.get_metric(*type, metric_index) : batch.get_fleet_metric(metric_index);
+        }
+
+        std::string to_string() const
+        {
+            std::string name = FLIGHT_STATS_METRICS[metric_index].name;
+            return type ? std::string(BatchStatistics::aircraft_type_names[static_cast<size_t>(*type)]) + ":" + name : name;
+        }
+
+        /**
+         * Parse "metric" (fleet totals) or "type:metric", e.g. "echo:total_faults"
+         * @throws std::invalid_argument for an unknown type or metric
+         */
+        static WatchedMetric parse(const std::string &text)
+        {
+            WatchedMetric watched;
+            std::string metric = text;
+            size_t colon = text.find(':');
+            if (colon != std::string::npos)
+            {
+                std::string type_name = text.substr(0, colon);
+                metric = text.substr(colon + 1);
+                for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+                {
+                    std::string candidate = BatchStatistics::aircraft_type_names[t];
+                    if (candidate.size() == type_name.size() &&
+                        std::equal(candidate.begin(), candidate.end(), type_name.begin(), [](char a, char b)
+                                   { return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b)); }))
+                    {
+                        watched.type = static_cast<AircraftType>(t);
+                    }
+                }
+                if (!watched.type)
+                {
+                    throw std::invalid_argument("Unknown aircraft type: " + type_name);
+                }
+            }
+
+            int index = BatchStatistics::find_metric(metric);
+            if (index < 0)
+            {
+                throw std::invalid_argument("Unknown metric: " + metric);
+            }
+            watched.metric_index = static_cast<size_t>(index);
+            return watched;
+        }
+    };
+
+    /**
+     * Sequential stopping for a batch: replications continue until the 95% confidence interval of
+     * every watched metric is within relative_half_width of its mean (e.g. 0.02 for mean +/- 2%),
+     * but no fewer than min_replications and no more than max_replications.
+     * The rule is checked between rounds whose sizes depend only on the replications done so far
+     * (see next_round), never on thread counts or timing, so a seeded batch stops at the same count
+     * with the same statistics wherever it runs.
+     */
+    struct ConfidenceStoppingRule
+    {
+        static constexpr size_t DEFAULT_MIN_REPLICATIONS = 10;
+
+        double relative_half_width = 0.0; // 0 = off: run max_replications
+        size_t min_replications = DEFAULT_MIN_REPLICATIONS;
+        size_t max_replications = 1;
+        std::vector<WatchedMetric> metrics;
+
+        bool enabled() const { return relative_half_width > 0.0 && !metrics.empty(); }
+
+        /**
+         * Confidence interval half-width over |mean|; 0 for a metric that is always 0, infinite
+         * before two replications or for any other spread around a zero mean
+         */
+        static double relative_width(const RunningStat &stat)
+        {
+            if (stat.count() < 2)
+            {
+                return std::numeric_limits<double>::infinity();
+            }
+            double half_width = stat.ci95_half_width();
+            if (stat.mean() == 0.0)
+            {
+                return half_width == 0.0 ? 0.0 : std::numeric_limits<double>::infinity();
+            }
+            return half_width / std::abs(stat.mean());
+        }
+
+        /**
+         * Widest relative half-width among the watched metrics, and which metric it is
+         */
+        std::pair<double, const WatchedMetric *> widest(const BatchStatistics &batch) const
+        {
+            std::pair<double, const WatchedMetric *> result{0.0, nullptr};
+            for (const WatchedMetric &metric : metrics)
+            {
+                double width = relative_width(metric.in(batch));
+                if (!result.second || width > result.first)
+                {
+                    result = {width, &metric};
+                }
+            }
+            return result;
+        }
+
+        bool is_met(const BatchStatistics &batch) const
+        {
+            return batch.get_replication_count() >= min_replications && widest(batch).first <= relative_half_width;
+        }
+
+        /**
+         * Replications to run before checking again, with done already run: min_replications at
+         * first, then a quarter of those done (at least min_replications), capped at the maximum
+         */
+        size_t next_round(size_t done) const
+        {
+            if (done >= max_replications)
+            {
+                return 0;
+            }
+            size_t round = std::max<size_t>(1, done == 0 ? min_replications : std::max(min_replications, done / 4));
+            return std::min(round, max_replications - done);
+        }
+    };
+
+    /**
+     * A batch run under a ConfidenceStoppingRule
+     */
+    struct SequentialBatchResult
+    {
+        BatchStatistics batch;
+        bool converged = false; // stopped by the rule rather than at max_replications
+        size_t rounds = 0;
+    };
+}
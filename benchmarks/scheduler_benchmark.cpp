@@ -0,0 +1,111 @@
+// Event scheduler benchmark: classic hold model plus full event-driven runs
+// Build and run with `make benchmark`
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "aircraft_types.h"
+#include "event_driven_simulation.h"
+#include "simulation_runner.h"
+
+using namespace evtol;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_ms(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    /**
+     * Hold model: keep `queue_size` events pending, then repeatedly pop the earliest and
+     * push a replacement a random increment later
+     * @return Nanoseconds per pop+push pair
+     */
+    template <typename Scheduler>
+    double hold_benchmark(size_t queue_size, size_t operations)
+    {
+        std::mt19937_64 gen(1);
+        std::exponential_distribution<double> increment(1.0);
+        Scheduler scheduler;
+
+        for (size_t i = 0; i < queue_size; ++i)
+        {
+            scheduler.push(EventType::FLIGHT_COMPLETE, increment(gen),
+                           FlightCompleteData{static_cast<int>(i), i, 1.0, 100.0, false});
+        }
+
+        double checksum = 0.0;
+        auto start = Clock::now();
+        for (size_t i = 0; i < operations; ++i)
+        {
+            auto event = scheduler.pop();
+            checksum += event.time_hours;
+            scheduler.push(event.type, event.time_hours + increment(gen), std::move(event.data));
+        }
+        double ms = elapsed_ms(start);
+
+        if (checksum < 0.0)
+        {
+            std::cout << checksum; // keep the loop observable
+        }
+        return ms * 1.0e6 / static_cast<double>(operations);
+    }
+
+    double simulation_benchmark(EventSchedulerType scheduler, int fleet_size, double duration_hours)
+    {
+        SimulationConfig config;
+        config.simulation_duration_hours = duration_hours;
+        config.random_seed = 7;
+        config.scheduler = scheduler;
+
+        StatisticsCollector stats;
+        ChargerManager chargers;
+        auto fleet = AircraftFactory<>::create_fleet(fleet_size);
+
+        auto start = Clock::now();
+        SimulationRunner(stats, config).run_simulation(chargers, fleet);
+        return elapsed_ms(start);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    size_t operations = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 2000000;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "========== Hold model (" << operations << " pop+push pairs, ns per pair) ==========\n";
+    std::cout << std::setw(12) << "pending" << std::setw(14) << "binary heap" << std::setw(14) << "4-ary heap"
+              << std::setw(14) << "calendar" << "\n";
+
+    for (size_t queue_size : {1000u, 100000u, 1000000u})
+    {
+        std::cout << std::setw(12) << queue_size
+                  << std::setw(14) << hold_benchmark<BinaryHeapScheduler<EventData>>(queue_size, operations)
+                  << std::setw(14) << hold_benchmark<QuaternaryHeapScheduler<EventData>>(queue_size, operations)
+                  << std::setw(14) << hold_benchmark<CalendarQueueScheduler<EventData>>(queue_size, operations) << "\n";
+    }
+
+    std::cout << "\n========== Event-driven simulation (3 chargers, 24h, ms) ==========\n";
+    std::cout << std::setw(12) << "fleet" << std::setw(14) << "binary heap" << std::setw(14) << "4-ary heap"
+              << std::setw(14) << "calendar" << "\n";
+
+    for (int fleet_size : {1000, 100000})
+    {
+        std::cout << std::setw(12) << fleet_size;
+        for (auto scheduler : {EventSchedulerType::BINARY_HEAP, EventSchedulerType::QUATERNARY_HEAP,
+                               EventSchedulerType::CALENDAR_QUEUE})
+        {
+            std::cout << std::setw(14) << simulation_benchmark(scheduler, fleet_size, 24.0);
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+}
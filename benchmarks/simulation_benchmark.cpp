@@ -0,0 +1,302 @@
+// Google Benchmark suite: whole simulations plus charger, statistics and event queue microbenchmarks
+// Build and run with `make bench`; results are also written as JSON (see BENCH_JSON in the Makefile)
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "arena_fleet.h"
+#include "charger_manager.h"
+#include "event_driven_simulation.h"
+#include "simulation_runner.h"
+#include "statistics_engine.h"
+
+using namespace evtol;
+
+namespace
+{
+    // ---- Whole simulations ----
+
+    /**
+     * One complete run per iteration, fleet rebuilt in place as in the app
+     * Args: mode (0 = event-driven, 1 = frame-based), fleet size, chargers, duration (h), frame time (s)
+     */
+    void BM_Simulation(benchmark::State &state)
+    {
+        SimulationConfig config;
+        config.mode = state.range(0) == 0 ? SimulationMode::EVENT_DRIVEN : SimulationMode::FRAME_BASED;
+        config.fleet_size = static_cast<int>(state.range(1));
+        config.num_chargers = static_cast<int>(state.range(2));
+        config.simulation_duration_hours = static_cast<double>(state.range(3));
+        config.frame_time_seconds = static_cast<double>(state.range(4));
+        config.num_threads = 1;
+        config.random_seed = 7;
+
+        ArenaFleet fleet(config.fleet_size, config.fleet_mix);
+        std::int64_t flights = 0;
+        for (auto _ : state)
+        {
+            fleet.reset();
+            StatisticsCollector stats;
+            ChargerManager chargers(config.get_charger_pools());
+            SimulationRunner(stats, config).run_simulation(chargers, fleet);
+            flights += BatchStatistics::fleet_totals(BatchStatistics::capture(stats)).flight_count;
+        }
+        state.SetItemsProcessed(flights);
+        state.counters["aircraft"] = static_cast<double>(config.fleet_size);
+    }
+
+    void simulation_arguments(benchmark::internal::Benchmark *benchmark)
+    {
+        benchmark->ArgNames({"frame", "fleet", "chargers", "hours", "frame_s"});
+        for (std::int64_t fleet_size : {20, 200, 2000})
+        {
+            for (std::int64_t chargers : {3, 30})
+            {
+                for (std::int64_t hours : {3, 24})
+                {
+                    benchmark->Args({0, fleet_size, chargers, hours, 60});
+                }
+            }
+        }
+        for (std::int64_t fleet_size : {20, 200})
+        {
+            for (std::int64_t frame_seconds : {1, 60})
+            {
+                benchmark->Args({1, fleet_size, 3, 3, frame_seconds});
+            }
+        }
+    }
+
+    BENCHMARK(BM_Simulation)->Apply(simulation_arguments)->Unit(benchmark::kMicrosecond);
+
+    // ---- ChargerManager ----
+
+    /**
+     * Take every charger, then release them all; Arg: chargers
+     */
+    void BM_ChargerRequestRelease(benchmark::State &state)
+    {
+        int charger_count = static_cast<int>(state.range(0));
+        ChargerManager chargers(charger_count);
+        chargers.reserve_aircraft(charger_count);
+        for (auto _ : state)
+        {
+            for (int id = 0; id < charger_count; ++id)
+            {
+                benchmark::DoNotOptimize(chargers.request_charger(id));
+            }
+            for (int id = 0; id < charger_count; ++id)
+            {
+                chargers.release_charger(id);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * charger_count);
+    }
+
+    BENCHMARK(BM_ChargerRequestRelease)->Arg(3)->Arg(64)->Arg(4096);
+
+    /**
+     * Queue aircraft at a full pool and hand them chargers in FIFO order; Arg: aircraft waiting
+     */
+    void BM_ChargerQueueHandoff(benchmark::State &state)
+    {
+        int waiting = static_cast<int>(state.range(0));
+        ChargerManager chargers(0);
+        chargers.reserve_aircraft(waiting);
+        for (auto _ : state)
+        {
+            for (int id = 0; id < waiting; ++id)
+            {
+                chargers.add_to_queue(id);
+            }
+            for (int id = 0; id < waiting; ++id)
+            {
+                benchmark::DoNotOptimize(chargers.get_next_from_queue(0));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * waiting);
+    }
+
+    BENCHMARK(BM_ChargerQueueHandoff)->Arg(16)->Arg(4096);
+
+    // ---- StatisticsCollector ----
+
+    /**
+     * record_flight/record_charge_session/record_queue_length through the collector's virtual interface
+     * Arg: percentile histograms enabled (0/1)
+     */
+    void BM_StatisticsRecord(benchmark::State &state)
+    {
+        StatisticsCollector stats;
+        if (state.range(0) != 0)
+        {
+            stats.enable_distributions();
+        }
+
+        std::uint64_t i = 0;
+        for (auto _ : state)
+        {
+            auto type = static_cast<AircraftType>(i % NUM_AIRCRAFT_TYPES);
+            double hours = 0.5 + static_cast<double>(i & 63) * 0.01;
+            stats.record_flight(type, hours, hours * 100.0, 4);
+            stats.record_charge_session(type, 0.6, hours * 0.1);
+            stats.record_queue_length(type, static_cast<int>(i & 7));
+            ++i;
+        }
+        benchmark::DoNotOptimize(stats.shard());
+        state.SetItemsProcessed(state.iterations() * 3);
+    }
+
+    BENCHMARK(BM_StatisticsRecord)->ArgName("percentiles")->Arg(0)->Arg(1);
+
+    /**
+     * The engines' path: StatsRecorder straight into the collector's shard; Arg as BM_StatisticsRecord
+     */
+    void BM_StatsRecorderRecord(benchmark::State &state)
+    {
+        StatisticsCollector stats;
+        if (state.range(0) != 0)
+        {
+            stats.enable_distributions();
+        }
+        StatsRecorder recorder(stats);
+
+        std::uint64_t i = 0;
+        for (auto _ : state)
+        {
+            auto type = static_cast<AircraftType>(i % NUM_AIRCRAFT_TYPES);
+            double hours = 0.5 + static_cast<double>(i & 63) * 0.01;
+            recorder.record_flight(type, hours, hours * 100.0, 4);
+            recorder.record_charge_session(type, 0.6, hours * 0.1);
+            recorder.record_queue_length(type, static_cast<int>(i & 7));
+            ++i;
+        }
+        benchmark::DoNotOptimize(stats.shard());
+        state.SetItemsProcessed(state.iterations() * 3);
+    }
+
+    BENCHMARK(BM_StatsRecorderRecord)->ArgName("percentiles")->Arg(0)->Arg(1);
+
+    // ---- Random streams ----
+
+    /**
+     * One draw at a time, as fault sampling takes them
+     */
+    void BM_RandomStreamNext(benchmark::State &state)
+    {
+        RandomStream stream(1, 2);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(stream.next_uniform());
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    BENCHMARK(BM_RandomStreamNext);
+
+    /**
+     * Arg(0) draws per call through the lane-batched fill_uniforms
+     */
+    void BM_RandomStreamFill(benchmark::State &state)
+    {
+        RandomStream stream(1, 2);
+        std::vector<double> draws(static_cast<size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            stream.fill_uniforms(draws);
+            benchmark::DoNotOptimize(draws.data());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    BENCHMARK(BM_RandomStreamFill)->Arg(16)->Arg(1024);
+
+    /**
+     * One flight's fault draw per iteration; Arg: fault model (0 = linear, 1 = exponential)
+     */
+    void BM_FlightFaultSample(benchmark::State &state)
+    {
+        EchoAircraft aircraft(0);
+        aircraft.seed_random_stream(3, 0);
+        aircraft.set_fault_model(state.range(0) == 0 ? FaultModel::LINEAR : FaultModel::EXPONENTIAL);
+        double flight_time = aircraft.get_flight_time_hours();
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(aircraft.check_fault_during_flight(flight_time));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    BENCHMARK(BM_FlightFaultSample)->ArgName("exponential")->Arg(0)->Arg(1);
+
+    // ---- Event queues ----
+
+    /**
+     * Hold model: keep Arg(0) events pending, pop the earliest and push a replacement a random increment later
+     */
+    template <typename Scheduler>
+    void BM_SchedulerHold(benchmark::State &state)
+    {
+        size_t queue_size = static_cast<size_t>(state.range(0));
+        std::mt19937_64 gen(1);
+        std::exponential_distribution<double> increment(1.0);
+        Scheduler scheduler;
+        for (size_t i = 0; i < queue_size; ++i)
+        {
+            scheduler.push(EventType::FLIGHT_COMPLETE, increment(gen),
+                           FlightCompleteData{static_cast<int>(i), i, 1.0, 100.0, false});
+        }
+
+        for (auto _ : state)
+        {
+            auto event = scheduler.pop();
+            benchmark::DoNotOptimize(event.time_hours);
+            scheduler.push(event.type, event.time_hours + increment(gen), std::move(event.data));
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    BENCHMARK_TEMPLATE(BM_SchedulerHold, BinaryHeapScheduler<EventData>)->Range(1 << 10, 1 << 20);
+    BENCHMARK_TEMPLATE(BM_SchedulerHold, QuaternaryHeapScheduler<EventData>)->Range(1 << 10, 1 << 20);
+    BENCHMARK_TEMPLATE(BM_SchedulerHold, CalendarQueueScheduler<EventData>)->Range(1 << 10, 1 << 20);
+
+    /**
+     * Fill a queue with Arg(0) events and drain it, as a run's start and finalization do
+     */
+    template <typename Scheduler>
+    void BM_SchedulerFillDrain(benchmark::State &state)
+    {
+        size_t event_count = static_cast<size_t>(state.range(0));
+        std::mt19937_64 gen(2);
+        std::uniform_real_distribution<double> time(0.0, 24.0);
+        std::vector<double> times(event_count);
+        for (double &t : times)
+        {
+            t = time(gen);
+        }
+
+        for (auto _ : state)
+        {
+            Scheduler scheduler;
+            for (size_t i = 0; i < event_count; ++i)
+            {
+                scheduler.push(EventType::CHARGING_COMPLETE, times[i],
+                               ChargingCompleteData{static_cast<int>(i), i, 0.6, 0.0});
+            }
+            while (!scheduler.empty())
+            {
+                benchmark::DoNotOptimize(scheduler.pop());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(event_count));
+    }
+
+    BENCHMARK_TEMPLATE(BM_SchedulerFillDrain, BinaryHeapScheduler<EventData>)->Arg(1 << 12)->Arg(1 << 16);
+    BENCHMARK_TEMPLATE(BM_SchedulerFillDrain, QuaternaryHeapScheduler<EventData>)->Arg(1 << 12)->Arg(1 << 16);
+    BENCHMARK_TEMPLATE(BM_SchedulerFillDrain, CalendarQueueScheduler<EventData>)->Arg(1 << 12)->Arg(1 << 16);
+}
+
+BENCHMARK_MAIN();
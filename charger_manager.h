@@ -1,70 +1,454 @@
 #pragma once
-#include <queue>
-#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
-#include <memory>
-#include <array>
+#include <utility>
 #include <vector>
 
+#include "dispatch_policy.h"
+#include "snapshot.h"
+
 namespace evtol
 {
+    /**
+     * One group of chargers, e.g. the pads of a single vertiport
+     */
+    struct ChargerPoolSpec
+    {
+        std::string name;
+        int charger_count = 0;
+    };
+
+    /**
+     * Charger allocation across one or more named pools
+     * Chargers are numbered 0..N-1 across all pools in declaration order. Each pool keeps its free
+     * chargers on a stack and its own waiting queue, served in the order of the dispatch policy
+     * (first come, first served by default); aircraft and charger lookups are dense vectors
+     * indexed by id. An aircraft uses its home pool, which defaults to aircraft_id % pool count.
+     * The single-pool API below (request_charger, get_next_from_queue, ...) is what the engines use.
+     */
     class ChargerManager
     {
+    public:
+        static constexpr int DEFAULT_NUM_CHARGERS = 3;
+        static constexpr size_t npos = SIZE_MAX;
+
+        using WaitingQueue = DispatchQueue;
+
     private:
-        std::queue<int> waiting_queue_;
-        std::unordered_set<int> available_chargers_;
-        std::unordered_map<int, int> aircraft_to_charger_map_;
+        // Aircraft ids at or above this (or negative) are tracked in a hash map instead of the dense table
+        static constexpr int MAX_DENSE_AIRCRAFT_ID = 1 << 24;
+
+        struct Pool
+        {
+            std::string name;
+            int first_charger = 0;
+            int charger_count = 0;
+            std::vector<int> free_chargers; // stack; back() is handed out next
+            WaitingQueue waiting_queue;
+        };
+
+        struct AircraftSlot
+        {
+            int charger_id = -1;
+            int home_pool = -1; // -1: aircraft_id % pool count
+        };
+
+        struct SparseSlot // checkpoint record of sparse_aircraft_slots_
+        {
+            int aircraft_id;
+            AircraftSlot slot;
+        };
+
+        std::vector<Pool> pools_;
+        std::vector<int> charger_to_aircraft_; // -1 when the charger is free
+        std::vector<int> charger_pool_;
+        std::vector<AircraftSlot> aircraft_slots_;
+        std::unordered_map<int, AircraftSlot> sparse_aircraft_slots_;
+
+        DispatchPolicy dispatch_policy_ = DispatchPolicy::FIFO;
         int active_chargers_ = 0;
+        int queued_aircraft_ = 0;
+        size_t last_released_pool_ = 0;
+
+        static bool is_dense_id(int aircraft_id)
+        {
+            return aircraft_id >= 0 && aircraft_id < MAX_DENSE_AIRCRAFT_ID;
+        }
+
+        AircraftSlot &slot(int aircraft_id)
+        {
+            if (!is_dense_id(aircraft_id))
+            {
+                return sparse_aircraft_slots_[aircraft_id];
+            }
+
+            size_t index = static_cast<size_t>(aircraft_id);
+            if (index >= aircraft_slots_.size())
+            {
+                aircraft_slots_.resize(std::max(index + 1, 2 * aircraft_slots_.size()));
+            }
+            return aircraft_slots_[index];
+        }
+
+        const AircraftSlot *find_slot(int aircraft_id) const
+        {
+            if (!is_dense_id(aircraft_id))
+            {
+                auto it = sparse_aircraft_slots_.find(aircraft_id);
+                return it != sparse_aircraft_slots_.end() ? &it->second : nullptr;
+            }
+
+            size_t index = static_cast<size_t>(aircraft_id);
+            return index < aircraft_slots_.size() ? &aircraft_slots_[index] : nullptr;
+        }
+
+        const Pool &pool_at(size_t pool) const
+        {
+            if (pool >= pools_.size())
+            {
+                throw std::out_of_range("Unknown charger pool index: " + std::to_string(pool));
+            }
+            return pools_[pool];
+        }
+
+        Pool &pool_at(size_t pool)
+        {
+            return const_cast<Pool &>(static_cast<const ChargerManager &>(*this).pool_at(pool));
+        }
+
+        // Restored aircraft slots only name existing chargers and pools, and hold what they point at
+        void check_restored_slots() const
+        {
+            auto check = [&](int aircraft_id, const AircraftSlot &entry)
+            {
+                bool valid_pool = entry.home_pool >= -1 && entry.home_pool < static_cast<int>(pools_.size());
+                bool valid_charger = entry.charger_id == -1 ||
+                                     (get_charger_pool(entry.charger_id) != npos &&
+                                      charger_to_aircraft_[static_cast<size_t>(entry.charger_id)] == aircraft_id);
+                if (!valid_pool || !valid_charger)
+                {
+                    throw std::runtime_error("Checkpoint aircraft slots are damaged");
+                }
+            };
+            for (size_t id = 0; id < aircraft_slots_.size(); ++id)
+            {
+                check(static_cast<int>(id), aircraft_slots_[id]);
+            }
+            for (const auto &[aircraft_id, entry] : sparse_aircraft_slots_)
+            {
+                check(aircraft_id, entry);
+            }
+        }
+
+        // Every charger is either on its own pool's free list, once, or held; the counters agree
+        void check_restored_counts() const
+        {
+            std::vector<bool> listed_free(charger_to_aircraft_.size(), false);
+            size_t queued = 0;
+            for (size_t p = 0; p < pools_.size(); ++p)
+            {
+                for (int charger_id : pools_[p].free_chargers)
+                {
+                    if (get_charger_pool(charger_id) != p || listed_free[static_cast<size_t>(charger_id)] ||
+                        charger_to_aircraft_[static_cast<size_t>(charger_id)] != -1)
+                    {
+                        throw std::runtime_error("Checkpoint free charger lists are damaged");
+                    }
+                    listed_free[static_cast<size_t>(charger_id)] = true;
+                }
+                queued += pools_[p].waiting_queue.size();
+            }
+
+            int held = 0;
+            for (size_t charger = 0; charger < charger_to_aircraft_.size(); ++charger)
+            {
+                if (charger_to_aircraft_[charger] != -1)
+                {
+                    ++held;
+                }
+                else if (!listed_free[charger])
+                {
+                    throw std::runtime_error("Checkpoint free charger lists are damaged");
+                }
+            }
 
-        const int NUM_CHARGERS = 3;
+            if (active_chargers_ != held || queued_aircraft_ < 0 || static_cast<size_t>(queued_aircraft_) != queued ||
+                last_released_pool_ >= pools_.size())
+            {
+                throw std::runtime_error("Checkpoint charger counts are damaged");
+            }
+        }
 
     public:
-        ChargerManager()
+        ChargerManager() : ChargerManager(DEFAULT_NUM_CHARGERS) {}
+
+        explicit ChargerManager(int num_chargers, DispatchPolicy policy = DispatchPolicy::FIFO)
+            : ChargerManager(std::vector<ChargerPoolSpec>{{"default", num_chargers}}, policy) {}
+
+        /**
+         * @throws std::invalid_argument for an empty pool list or a negative charger count
+         */
+        explicit ChargerManager(const std::vector<ChargerPoolSpec> &pools, DispatchPolicy policy = DispatchPolicy::FIFO)
+            : dispatch_policy_(policy)
+        {
+            if (pools.empty())
+            {
+                throw std::invalid_argument("ChargerManager needs at least one charger pool");
+            }
+
+            for (const auto &spec : pools)
+            {
+                if (spec.charger_count < 0)
+                {
+                    throw std::invalid_argument("Charger pool '" + spec.name + "' has a negative charger count");
+                }
+
+                Pool pool;
+                pool.name = spec.name;
+                pool.waiting_queue = WaitingQueue(policy);
+                pool.first_charger = static_cast<int>(charger_to_aircraft_.size());
+                pool.charger_count = spec.charger_count;
+                pool.free_chargers.reserve(static_cast<size_t>(spec.charger_count));
+                for (int i = spec.charger_count - 1; i >= 0; --i)
+                {
+                    pool.free_chargers.push_back(pool.first_charger + i);
+                }
+
+                charger_to_aircraft_.insert(charger_to_aircraft_.end(), static_cast<size_t>(spec.charger_count), -1);
+                charger_pool_.insert(charger_pool_.end(), static_cast<size_t>(spec.charger_count),
+                                     static_cast<int>(pools_.size()));
+                pools_.push_back(std::move(pool));
+            }
+        }
+
+        /**
+         * Pre-size the dense aircraft table for ids 0..max_aircraft_id
+         */
+        void reserve_aircraft(int max_aircraft_id)
+        {
+            if (is_dense_id(max_aircraft_id) && static_cast<size_t>(max_aircraft_id) >= aircraft_slots_.size())
+            {
+                aircraft_slots_.resize(static_cast<size_t>(max_aircraft_id) + 1);
+            }
+        }
+
+        // ---- Pools ----
+
+        size_t get_pool_count() const { return pools_.size(); }
+
+        const std::string &get_pool_name(size_t pool) const { return pool_at(pool).name; }
+
+        /**
+         * @return Index of the pool with this name
+         * @throws std::invalid_argument if there is none
+         */
+        size_t find_pool(const std::string &name) const
+        {
+            for (size_t pool = 0; pool < pools_.size(); ++pool)
+            {
+                if (pools_[pool].name == name)
+                {
+                    return pool;
+                }
+            }
+            throw std::invalid_argument("Unknown charger pool: " + name);
+        }
+
+        int get_pool_charger_count(size_t pool) const { return pool_at(pool).charger_count; }
+
+        int get_available_chargers(size_t pool) const
+        {
+            return static_cast<int>(pool_at(pool).free_chargers.size());
+        }
+
+        int get_queue_size(size_t pool) const
+        {
+            return static_cast<int>(pool_at(pool).waiting_queue.size());
+        }
+
+        /**
+         * Queue of a pool, for size, membership, priority and front lookups without copying it
+         */
+        const WaitingQueue &waiting_queue(size_t pool = 0) const { return pool_at(pool).waiting_queue; }
+
+        /**
+         * Copy of the aircraft waiting at a pool, in the order they will be served
+         * Under priority policies this sorts a copy of the heap; prefer waiting_queue(pool) for lookups.
+         */
+        std::vector<int> waiting_order(size_t pool = 0) const
+        {
+            std::vector<int> ids;
+            for (const auto &entry : pool_at(pool).waiting_queue.entries_in_order())
+            {
+                ids.push_back(entry.id);
+            }
+            return ids;
+        }
+
+        // ---- Dispatch ----
+
+        DispatchPolicy get_dispatch_policy() const { return dispatch_policy_; }
+
+        /**
+         * Priority queue_for_charger gives an aircraft under this manager's policy
+         */
+        template <typename AircraftRef>
+        double dispatch_priority_of(const AircraftRef &aircraft) const
+        {
+            return dispatch_priority(dispatch_policy_, aircraft);
+        }
+
+        /**
+         * Queue an aircraft (pointer or SoA handle) at its home pool with its policy priority
+         */
+        template <typename AircraftRef>
+        void queue_for_charger(const AircraftRef &aircraft)
+        {
+            add_to_queue(aircraft->get_id(), dispatch_priority_of(aircraft));
+        }
+
+        /**
+         * Change the priority of an aircraft waiting at its home pool; it keeps its arrival order
+         * among equal priorities, and under FIFO its place
+         * @return False if it is not waiting there
+         */
+        bool reprioritize(int aircraft_id, double priority)
+        {
+            return pools_[get_home_pool(aircraft_id)].waiting_queue.update(aircraft_id, priority);
+        }
+
+        /**
+         * Take an aircraft out of its home pool's queue, e.g. when it leaves for another pool
+         * @return False if it was not waiting there
+         */
+        bool remove_from_queue(int aircraft_id)
+        {
+            if (!pools_[get_home_pool(aircraft_id)].waiting_queue.erase(aircraft_id))
+            {
+                return false;
+            }
+            queued_aircraft_--;
+            return true;
+        }
+
+        bool is_queued(int aircraft_id) const
+        {
+            return pools_[get_home_pool(aircraft_id)].waiting_queue.contains(aircraft_id);
+        }
+
+        void set_home_pool(int aircraft_id, size_t pool)
+        {
+            pool_at(pool);
+            slot(aircraft_id).home_pool = static_cast<int>(pool);
+        }
+
+        size_t get_home_pool(int aircraft_id) const
         {
-            for (int i = 0; i < NUM_CHARGERS; ++i)
+            const AircraftSlot *entry = find_slot(aircraft_id);
+            if (entry && entry->home_pool >= 0)
             {
-                available_chargers_.insert(i);
+                return static_cast<size_t>(entry->home_pool);
             }
+
+            int pool_count = static_cast<int>(pools_.size());
+            return static_cast<size_t>(((aircraft_id % pool_count) + pool_count) % pool_count);
+        }
+
+        /**
+         * @return Pool owning the charger, or npos for an invalid id
+         */
+        size_t get_charger_pool(int charger_id) const
+        {
+            if (charger_id < 0 || charger_id >= get_total_chargers())
+            {
+                return npos;
+            }
+            return static_cast<size_t>(charger_pool_[static_cast<size_t>(charger_id)]);
+        }
+
+        /**
+         * Pop the next aircraft waiting at a pool
+         * @return Aircraft id, or -1 if the queue is empty
+         */
+        int get_next_from_queue(size_t pool)
+        {
+            WaitingQueue &queue = pool_at(pool).waiting_queue;
+            if (queue.empty())
+            {
+                return -1;
+            }
+
+            int aircraft_id = queue.pop();
+            queued_aircraft_--;
+            return aircraft_id;
         }
 
+        // ---- Single-pool compatible API ----
+
+        /**
+         * Take a free charger from the aircraft's home pool
+         * As with the original map-based manager, a second request by the same aircraft takes another
+         * charger and only the latest one is released later (the event-driven engine relies on this).
+         * @return True if a charger was assigned
+         */
         bool request_charger(int aircraft_id)
         {
-            if (!available_chargers_.empty())
+            AircraftSlot &entry = slot(aircraft_id);
+            Pool &pool = pools_[get_home_pool(aircraft_id)];
+            if (pool.free_chargers.empty())
             {
-                int charger_id = *available_chargers_.begin();
-                available_chargers_.erase(charger_id);
-                aircraft_to_charger_map_[aircraft_id] = charger_id;
-                active_chargers_++;
-                return true;
+                return false;
             }
-            return false;
+
+            int charger_id = pool.free_chargers.back();
+            pool.free_chargers.pop_back();
+            entry.charger_id = charger_id;
+            charger_to_aircraft_[static_cast<size_t>(charger_id)] = aircraft_id;
+            active_chargers_++;
+            return true;
         }
 
         void release_charger(int aircraft_id)
         {
-            auto it = aircraft_to_charger_map_.find(aircraft_id);
-            if (it != aircraft_to_charger_map_.end())
+            const AircraftSlot *existing = find_slot(aircraft_id);
+            if (!existing || existing->charger_id == -1)
             {
-                available_chargers_.insert(it->second);
-                aircraft_to_charger_map_.erase(it);
-                active_chargers_--;
+                return;
             }
+
+            AircraftSlot &entry = slot(aircraft_id);
+            size_t pool = get_charger_pool(entry.charger_id);
+            pools_[pool].free_chargers.push_back(entry.charger_id);
+            charger_to_aircraft_[static_cast<size_t>(entry.charger_id)] = -1;
+            entry.charger_id = -1;
+            active_chargers_--;
+            last_released_pool_ = pool;
         }
 
-        void add_to_queue(int aircraft_id)
+        /**
+         * Queue the aircraft at its home pool
+         * @param priority Lower is served first, equal priorities in arrival order (see queue_for_charger);
+         *        ignored under FIFO
+         * @throws std::logic_error if it is already waiting there
+         */
+        void add_to_queue(int aircraft_id, double priority = 0.0)
         {
-            waiting_queue_.push(aircraft_id);
+            pools_[get_home_pool(aircraft_id)].waiting_queue.push(aircraft_id, priority);
+            queued_aircraft_++;
         }
 
+        /**
+         * Pop the next aircraft waiting at the pool that most recently freed a charger
+         * (pool 0 before any release), which is the pool the caller's release just served
+         */
         int get_next_from_queue()
         {
-            if (!waiting_queue_.empty())
-            {
-                int aircraft_id = waiting_queue_.front();
-                waiting_queue_.pop();
-                return aircraft_id;
-            }
-            return -1;
+            return get_next_from_queue(last_released_pool_);
         }
 
         bool assign_charger(int aircraft_id)
@@ -74,7 +458,7 @@ namespace evtol
 
         int get_queue_size() const
         {
-            return static_cast<int>(waiting_queue_.size());
+            return queued_aircraft_;
         }
 
         int get_active_chargers() const
@@ -84,54 +468,182 @@ namespace evtol
 
         int get_available_chargers() const
         {
-            return static_cast<int>(available_chargers_.size());
+            return get_total_chargers() - active_chargers_;
         }
 
-        constexpr int get_total_chargers() const
+        int get_total_chargers() const
         {
-            return NUM_CHARGERS;
+            return static_cast<int>(charger_to_aircraft_.size());
         }
 
         // Additional methods for frame-based simulation
         int get_num_chargers() const
         {
-            return NUM_CHARGERS;
+            return get_total_chargers();
         }
 
         bool is_charger_occupied(int charger_id) const
         {
-            return available_chargers_.find(charger_id) == available_chargers_.end();
+            return get_charger_pool(charger_id) != npos &&
+                   charger_to_aircraft_[static_cast<size_t>(charger_id)] != -1;
         }
 
         int get_aircraft_at_charger(int charger_id) const
         {
-            for (const auto& pair : aircraft_to_charger_map_)
+            if (get_charger_pool(charger_id) == npos)
+            {
+                return -1; // No such charger
+            }
+            return charger_to_aircraft_[static_cast<size_t>(charger_id)];
+        }
+
+        int get_charger_id(int aircraft_id) const
+        {
+            const AircraftSlot *entry = find_slot(aircraft_id);
+            return entry ? entry->charger_id : -1;
+        }
+
+        /**
+         * Charger assignments, free lists and queues, for checkpoints
+         */
+        void save_state(SnapshotWriter &out) const
+        {
+            out.begin_section(snapshot_tag("CHRG"));
+            out.write(dispatch_policy_);
+            out.write(static_cast<std::uint64_t>(pools_.size()));
+            for (const auto &pool : pools_)
             {
-                if (pair.second == charger_id)
+                out.write_string(pool.name);
+                out.write(pool.charger_count);
+                out.write_vector(pool.free_chargers);
+
+                // In serving order, so re-queueing them on restore keeps ties in arrival order
+                std::vector<int> waiting;
+                std::vector<double> priorities;
+                for (const auto &entry : pool.waiting_queue.entries_in_order())
                 {
-                    return pair.first;
+                    waiting.push_back(entry.id);
+                    priorities.push_back(entry.priority);
                 }
+                out.write_vector(waiting);
+                out.write_vector(priorities);
+            }
+
+            out.write_vector(charger_to_aircraft_);
+            out.write_vector(aircraft_slots_);
+
+            std::vector<SparseSlot> sparse;
+            sparse.reserve(sparse_aircraft_slots_.size());
+            for (const auto &[aircraft_id, entry] : sparse_aircraft_slots_)
+            {
+                sparse.push_back({aircraft_id, entry});
             }
-            return -1;  // No aircraft at this charger
+            std::sort(sparse.begin(), sparse.end(), [](const SparseSlot &a, const SparseSlot &b)
+                      { return a.aircraft_id < b.aircraft_id; });
+            out.write_vector(sparse);
+
+            out.write(active_chargers_);
+            out.write(queued_aircraft_);
+            out.write(static_cast<std::uint64_t>(last_released_pool_));
         }
 
-        int get_charger_id(int aircraft_id) const
+        /**
+         * Replace the state with one saved by save_state
+         * Every restored id and count is checked against the configured pools before anything is
+         * replaced, so a damaged checkpoint leaves the manager as it was.
+         * @throws std::runtime_error if the saved pools or dispatch policy differ from this manager's,
+         *         or the saved state is inconsistent with them
+         */
+        void restore_state(SnapshotReader &in)
         {
-            auto it = aircraft_to_charger_map_.find(aircraft_id);
-            return (it != aircraft_to_charger_map_.end()) ? it->second : -1;
+            in.expect_section(snapshot_tag("CHRG"));
+            if (in.read<DispatchPolicy>() != dispatch_policy_)
+            {
+                throw std::runtime_error("Checkpoint dispatch policy does not match the configured policy");
+            }
+            if (in.read<std::uint64_t>() != pools_.size())
+            {
+                throw std::runtime_error("Checkpoint charger pools do not match the configured pools");
+            }
+
+            ChargerManager restored(*this);
+            std::vector<std::vector<int>> waiting(pools_.size());
+            std::vector<std::vector<double>> priorities(pools_.size());
+            for (size_t p = 0; p < pools_.size(); ++p)
+            {
+                Pool &pool = restored.pools_[p];
+                std::string name = in.read_string();
+                int charger_count = in.read<int>();
+                if (name != pool.name || charger_count != pool.charger_count)
+                {
+                    throw std::runtime_error("Checkpoint charger pools do not match the configured pools");
+                }
+
+                pool.free_chargers = in.read_vector<int>();
+                waiting[p] = in.read_vector<int>();
+                priorities[p] = in.read_vector<double>();
+                if (priorities[p].size() != waiting[p].size())
+                {
+                    throw std::runtime_error("Checkpoint waiting queue is damaged");
+                }
+            }
+
+            restored.charger_to_aircraft_ = in.read_vector<int>();
+            if (restored.charger_to_aircraft_.size() != charger_to_aircraft_.size())
+            {
+                throw std::runtime_error("Checkpoint charger pools do not match the configured pools");
+            }
+            restored.aircraft_slots_ = in.read_vector<AircraftSlot>();
+
+            restored.sparse_aircraft_slots_.clear();
+            for (const SparseSlot &sparse : in.read_vector<SparseSlot>())
+            {
+                if (is_dense_id(sparse.aircraft_id) || !restored.sparse_aircraft_slots_.emplace(sparse.aircraft_id, sparse.slot).second)
+                {
+                    throw std::runtime_error("Checkpoint aircraft slots are damaged");
+                }
+            }
+
+            restored.active_chargers_ = in.read<int>();
+            restored.queued_aircraft_ = in.read<int>();
+            restored.last_released_pool_ = static_cast<size_t>(in.read<std::uint64_t>());
+            restored.check_restored_slots();
+
+            // Queues go last: an aircraft waits at its home pool, which the restored slots decide
+            for (size_t p = 0; p < pools_.size(); ++p)
+            {
+                Pool &pool = restored.pools_[p];
+                pool.waiting_queue.clear();
+                for (size_t i = 0; i < waiting[p].size(); ++i)
+                {
+                    int aircraft_id = waiting[p][i];
+                    if (restored.get_home_pool(aircraft_id) != p || pool.waiting_queue.contains(aircraft_id) ||
+                        !std::isfinite(priorities[p][i]))
+                    {
+                        throw std::runtime_error("Checkpoint waiting queue is damaged");
+                    }
+                    pool.waiting_queue.push(aircraft_id, priorities[p][i]);
+                }
+            }
+            restored.check_restored_counts();
+
+            *this = std::move(restored);
         }
 
+        /**
+         * Every waiting aircraft, pool by pool, each pool in the order it will be served
+         */
         std::vector<int> get_waiting_queue() const
         {
             std::vector<int> queue_copy;
-            std::queue<int> temp_queue = waiting_queue_;  // Copy the queue
-            while (!temp_queue.empty())
+            queue_copy.reserve(static_cast<size_t>(queued_aircraft_));
+            for (size_t pool = 0; pool < pools_.size(); ++pool)
             {
-                queue_copy.push_back(temp_queue.front());
-                temp_queue.pop();
+                std::vector<int> waiting = waiting_order(pool);
+                queue_copy.insert(queue_copy.end(), waiting.begin(), waiting.end());
             }
             return queue_copy;
         }
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,195 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "snapshot.h"
+#include "charger_manager.h"
+#include "statistics_engine.h"
+#include "simulation_interface.h"
+
+namespace evtol
+{
+    /**
+     * What a checkpoint was taken from; checked before anything is restored
+     */
+    struct CheckpointHeader
+    {
+        SimulationMode mode;
+        double time_hours;         // simulated time the checkpoint holds
+        double frame_time_seconds; // frame-based engine only, else 0
+        std::uint64_t fleet_size;
+    };
+
+    /**
+     * File name of the checkpoint taken at time_hours: <prefix>_<hours>h.ckpt
+     */
+    inline std::string checkpoint_file_name(const std::string &prefix, double time_hours)
+    {
+        std::ostringstream name;
+        name << prefix << "_" << time_hours << "h.ckpt";
+        return name.str();
+    }
+
+    /**
+     * Checkpoint times at whole multiples of an interval
+     */
+    class CheckpointSchedule
+    {
+    private:
+        double every_hours_ = 0.0;
+        std::uint64_t next_index_ = 0;
+
+    public:
+        /**
+         * @param every_hours Interval between checkpoints; 0 disables them
+         * @param from_hours The first checkpoint is the first multiple after this
+         */
+        void start(double every_hours, double from_hours = 0.0)
+        {
+            every_hours_ = every_hours;
+            next_index_ = 0;
+            if (every_hours_ > 0.0)
+            {
+                next_index_ = static_cast<std::uint64_t>(std::floor(from_hours / every_hours_));
+                while (next_time() <= from_hours)
+                {
+                    ++next_index_;
+                }
+            }
+        }
+
+        double next_time() const
+        {
+            return every_hours_ > 0.0 ? static_cast<double>(next_index_) * every_hours_
+                                      : std::numeric_limits<double>::infinity();
+        }
+
+        /**
+         * A checkpoint falls at or before time_hours and before the end of the run
+         */
+        bool due(double time_hours, double duration_hours) const
+        {
+            double next = next_time();
+            return next <= time_hours && next < duration_hours;
+        }
+
+        /**
+         * @return The due checkpoint's time; moves on to the next one
+         */
+        double take()
+        {
+            double time_hours = next_time();
+            ++next_index_;
+            return time_hours;
+        }
+    };
+
+    /**
+     * Ids, types and per-aircraft state (battery, fault, random stream position) of a fleet
+     */
+    template <typename Fleet>
+    void save_fleet_state(SnapshotWriter &out, const Fleet &fleet)
+    {
+        out.begin_section(snapshot_tag("FLET"));
+        out.write(static_cast<std::uint64_t>(fleet.size()));
+        for (const auto &aircraft : fleet)
+        {
+            out.write(aircraft->get_id());
+            out.write(aircraft->get_type());
+            out.write(aircraft->save_state());
+        }
+    }
+
+    /**
+     * @throws std::runtime_error unless the fleet has the saved aircraft and types in the saved order
+     */
+    template <typename Fleet>
+    void restore_fleet_state(SnapshotReader &in, Fleet &fleet)
+    {
+        in.expect_section(snapshot_tag("FLET"));
+        if (in.read<std::uint64_t>() != fleet.size())
+        {
+            throw std::runtime_error("Checkpoint fleet size does not match the fleet");
+        }
+
+        for (size_t i = 0; i < fleet.size(); ++i)
+        {
+            if (in.read<int>() != fleet[i]->get_id())
+            {
+                throw std::runtime_error("Checkpoint aircraft ids do not match the fleet");
+            }
+            if (in.read<AircraftType>() != fleet[i]->get_type())
+            {
+                throw std::runtime_error("Checkpoint aircraft types do not match the fleet mix");
+            }
+            fleet[i]->restore_state(in.read<AircraftSnapshot>());
+        }
+    }
+
+    /**
+     * Write a complete checkpoint: header, the engine's own section, chargers, fleet and statistics
+     * @param save_engine Callable invoked as save_engine(SnapshotWriter &)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    template <typename Fleet, typename SaveEngine>
+    void write_checkpoint(const std::string &path, const CheckpointHeader &header, SaveEngine &&save_engine,
+                          const ChargerManager &charger_mgr, const Fleet &fleet, const StatisticsCollector &stats)
+    {
+        SnapshotWriter out;
+        out.begin_section(snapshot_tag("HEAD"));
+        out.write(header);
+        save_engine(out);
+        charger_mgr.save_state(out);
+        save_fleet_state(out, fleet);
+        stats.save_state(out);
+        out.save(path);
+    }
+
+    /**
+     * Load a checkpoint written by write_checkpoint into the engine, chargers, fleet and statistics
+     * The header must match expected (mode, fleet size, frame time) and lie within duration_hours.
+     * @param restore_engine Callable invoked as restore_engine(SnapshotReader &)
+     * @return The saved header
+     * @throws std::runtime_error if the file is unreadable or was taken from a different set-up
+     */
+    template <typename Fleet, typename RestoreEngine>
+    CheckpointHeader read_checkpoint(const std::string &path, const CheckpointHeader &expected, double duration_hours,
+                                     RestoreEngine &&restore_engine, ChargerManager &charger_mgr, Fleet &fleet,
+                                     StatisticsCollector &stats)
+    {
+        SnapshotReader in(path);
+        in.expect_section(snapshot_tag("HEAD"));
+        auto header = in.read<CheckpointHeader>();
+
+        if (header.mode != expected.mode)
+        {
+            throw std::runtime_error("Checkpoint " + path + " was written by the other simulation mode");
+        }
+        if (header.fleet_size != expected.fleet_size)
+        {
+            throw std::runtime_error("Checkpoint " + path + " is for a fleet of " + std::to_string(header.fleet_size) + " aircraft");
+        }
+        if (header.frame_time_seconds != expected.frame_time_seconds)
+        {
+            throw std::runtime_error("Checkpoint " + path + " was taken with a different frame time");
+        }
+        if (header.time_hours > duration_hours)
+        {
+            throw std::runtime_error("Checkpoint " + path + " is past the end of the simulation");
+        }
+
+        restore_engine(in);
+        charger_mgr.restore_state(in);
+        restore_fleet_state(in, fleet);
+        stats.restore_state(in);
+        if (!in.at_end())
+        {
+            throw std::runtime_error("Checkpoint " + path + " has trailing data");
+        }
+        return header;
+    }
+}
@@ -0,0 +1,511 @@
+#pragma once
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "aircraft_state.h"
+#include "charger_manager.h"
+#include "event_scheduler.h"
+#include "fleet_index.h"
+#include "random_stream.h"
+#include "simulation_config.h"
+#include "simulation_interface.h"
+
+namespace evtol
+{
+    /**
+     * A point in simulated time a coroutine waits for, with its place among events at the same time
+     * The sequence number is taken when the wake-up is planned, as the event engine numbers an
+     * event when it is scheduled, so simultaneous events resolve the same way in both engines.
+     */
+    struct Wakeup
+    {
+        double time_hours;
+        std::uint64_t sequence;
+        EventType type; // what the waiting aircraft does then, for the profile
+    };
+
+    /**
+     * Min-heap of suspended coroutines by (time, sequence)
+     * Entries are 32 bytes with no payload: what happens next is in the waiting coroutine's frame.
+     */
+    class ResumeQueue
+    {
+    private:
+        struct Entry
+        {
+            Wakeup wakeup;
+            std::coroutine_handle<> handle;
+
+            bool operator<(const Entry &other) const
+            {
+                if (wakeup.time_hours != other.wakeup.time_hours)
+                {
+                    return wakeup.time_hours > other.wakeup.time_hours;
+                }
+                return wakeup.sequence > other.wakeup.sequence;
+            }
+        };
+
+        std::vector<Entry> heap_;
+        std::uint64_t next_sequence_ = 0;
+
+    public:
+        Wakeup plan(double time_hours, EventType type) { return {time_hours, next_sequence_++, type}; }
+
+        void push(const Wakeup &wakeup, std::coroutine_handle<> handle)
+        {
+            heap_.push_back({wakeup, handle});
+            std::push_heap(heap_.begin(), heap_.end());
+        }
+
+        /**
+         * @pre !empty()
+         */
+        const Wakeup &top() const { return heap_.front().wakeup; }
+
+        /**
+         * @pre !empty()
+         */
+        std::pair<Wakeup, std::coroutine_handle<>> pop()
+        {
+            std::pop_heap(heap_.begin(), heap_.end());
+            Entry entry = heap_.back();
+            heap_.pop_back();
+            return {entry.wakeup, entry.handle};
+        }
+
+        bool empty() const { return heap_.empty(); }
+        size_t size() const { return heap_.size(); }
+
+        void clear()
+        {
+            heap_.clear();
+            next_sequence_ = 0;
+        }
+
+        void reserve(size_t capacity) { heap_.reserve(capacity); }
+    };
+
+    /**
+     * Event-driven simulation with every aircraft as a C++20 coroutine
+     *
+     * Each aircraft's lifecycle is one loop, fly -> land -> co_await a charger -> charge -> repeat,
+     * and everything the event engine keeps in timelines and event payloads (start times, flight
+     * time and distance, the planned fault, the time it joined the queue) is a local of that loop.
+     * The dispatcher is a heap of (time, sequence, handle) that resumes the earliest coroutine; a
+     * charger handed over by a finishing aircraft resumes the first waiting one directly. Frames
+     * come from a pool owned by the engine and are reused by the following runs.
+     *
+     * Wake-ups are numbered where the event engine schedules its events, chargers are assigned with
+     * the same ChargerManager calls and partial activities are recorded in fleet order at the end,
+     * so a run gives exactly the event engine's statistics and trace. Runs are not checkpointed
+     * (frames cannot be saved), logged or solved analytically.
+     */
+    class CoroutineSimulationEngine : public SimulationEngineBase
+    {
+    private:
+        /**
+         * Owning handle of one aircraft's coroutine
+         */
+        class AircraftProcess
+        {
+        public:
+            struct promise_type
+            {
+                bool scheduled = false; // suspended on a wake-up rather than a charger
+                bool stopping = false;  // the run is over; the pending wake-up will never come
+
+                // Frames are carved from the pool of the engine running on this thread, see run()
+                inline static thread_local std::pmr::memory_resource *frame_pool = nullptr;
+                inline static thread_local size_t frame_size = 0;
+
+                static void *operator new(size_t size)
+                {
+                    frame_size = size;
+                    return frame_pool->allocate(size, alignof(std::max_align_t));
+                }
+
+                static void operator delete(void *frame, size_t size)
+                {
+                    frame_pool->deallocate(frame, size, alignof(std::max_align_t));
+                }
+
+                AircraftProcess get_return_object()
+                {
+                    return AircraftProcess(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                std::suspend_never initial_suspend() noexcept { return {}; } // run to the first wait
+                std::suspend_always final_suspend() noexcept { return {}; }  // destroyed by the handle
+                void return_void() {}
+                void unhandled_exception() { throw; }
+            };
+
+            AircraftProcess() = default;
+            explicit AircraftProcess(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+            AircraftProcess(AircraftProcess &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+            AircraftProcess &operator=(AircraftProcess &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    destroy();
+                    handle_ = std::exchange(other.handle_, {});
+                }
+                return *this;
+            }
+            AircraftProcess(const AircraftProcess &) = delete;
+            AircraftProcess &operator=(const AircraftProcess &) = delete;
+            ~AircraftProcess() { destroy(); }
+
+            void resume() const { handle_.resume(); }
+
+            /**
+             * Let a coroutine waiting on a wake-up record its activity as partial and finish
+             */
+            void stop() const
+            {
+                if (handle_ && !handle_.done() && handle_.promise().scheduled)
+                {
+                    handle_.promise().stopping = true;
+                    handle_.resume();
+                }
+            }
+
+        private:
+            std::coroutine_handle<promise_type> handle_;
+
+            void destroy()
+            {
+                if (handle_)
+                {
+                    handle_.destroy();
+                    handle_ = {};
+                }
+            }
+        };
+
+        /**
+         * co_await until(wakeup): suspend until the dispatcher reaches wakeup
+         * @return False if the run ended first
+         */
+        struct WakeupAwaiter
+        {
+            ResumeQueue &queue;
+            Wakeup wakeup;
+            AircraftProcess::promise_type *promise = nullptr;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<AircraftProcess::promise_type> handle)
+            {
+                promise = &handle.promise();
+                promise->scheduled = true;
+                queue.push(wakeup, handle);
+            }
+
+            bool await_resume() const noexcept
+            {
+                promise->scheduled = false;
+                return !promise->stopping;
+            }
+        };
+
+        /**
+         * co_await ChargerAwaiter{}: suspend until an aircraft that finished charging hands its charger over
+         */
+        struct ChargerAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            void await_resume() const noexcept {}
+        };
+
+        /**
+         * A flight under way, as its coroutine remembers it
+         */
+        struct Flight
+        {
+            double start_time_hours;
+            double flight_time_hours;
+            double distance_miles;
+            double fault_time_hours; // into the flight, if it faults
+            std::optional<Wakeup> fault;
+            Wakeup landing;
+        };
+
+        SimulationConfig config_;
+        std::pmr::unsynchronized_pool_resource frame_pool_;
+        size_t frame_size_ = 0;
+        ResumeQueue queue_;
+        FleetIndex fleet_index_;
+        std::vector<AircraftProcess> processes_; // by fleet position
+
+        /**
+         * Points frame allocation at this engine's pool for one run and frees every frame before
+         * the pool is handed back, also when the run throws
+         */
+        class FramePoolScope
+        {
+        private:
+            CoroutineSimulationEngine &engine_;
+            std::pmr::memory_resource *previous_;
+
+        public:
+            explicit FramePoolScope(CoroutineSimulationEngine &engine)
+                : engine_(engine), previous_(AircraftProcess::promise_type::frame_pool)
+            {
+                AircraftProcess::promise_type::frame_pool = &engine.frame_pool_;
+            }
+
+            ~FramePoolScope()
+            {
+                engine_.processes_.clear();
+                AircraftProcess::promise_type::frame_pool = previous_;
+            }
+
+            FramePoolScope(const FramePoolScope &) = delete;
+            FramePoolScope &operator=(const FramePoolScope &) = delete;
+        };
+
+        WakeupAwaiter until(const Wakeup &wakeup) { return {queue_, wakeup}; }
+
+        bool counts_at_end(double end_time_hours) const
+        {
+            return end_time_hours <= simulation_duration_hours_ || config_.enable_partial_flights;
+        }
+
+        template <typename Aircraft>
+        Flight take_off(Aircraft &aircraft)
+        {
+            Flight flight{current_time_hours_, aircraft->get_flight_time_hours(), aircraft->get_flight_distance_miles(), -1.0, std::nullopt, {}};
+            trace(aircraft->get_id(), TraceEventType::FLIGHT_START, aircraft->get_type(), flight.flight_time_hours, flight.distance_miles);
+
+            flight.fault_time_hours = aircraft->check_fault_during_flight(flight.flight_time_hours);
+            if (flight.fault_time_hours >= 0.0)
+            {
+                flight.fault = queue_.plan(current_time_hours_ + flight.fault_time_hours, EventType::FAULT_OCCURRED);
+            }
+            flight.landing = queue_.plan(current_time_hours_ + flight.flight_time_hours, EventType::FLIGHT_COMPLETE);
+            return flight;
+        }
+
+        template <typename Aircraft>
+        void record_partial_flight(Aircraft &aircraft, const Flight &flight)
+        {
+            if (!counts_at_end(flight.landing.time_hours))
+            {
+                return;
+            }
+            double partial_flight_time = simulation_duration_hours_ - flight.start_time_hours;
+            double partial_distance = (partial_flight_time / flight.flight_time_hours) * flight.distance_miles;
+            stats_recorder_.record_partial_flight(aircraft->get_type(), partial_flight_time, partial_distance, aircraft->get_passenger_count());
+            trace(aircraft->get_id(), TraceEventType::PARTIAL_FLIGHT, aircraft->get_type(), partial_flight_time, partial_distance);
+        }
+
+        /**
+         * Give the charger the finishing aircraft held to the first aircraft waiting at its pool
+         * The waiting coroutine runs until it plans the end of its charge, before the caller continues.
+         */
+        void hand_over_charger(ChargerManager &charger_mgr, int aircraft_id)
+        {
+            int next_aircraft_id = charger_mgr.get_next_from_queue(charger_mgr.get_home_pool(aircraft_id));
+            if (next_aircraft_id == -1)
+            {
+                return;
+            }
+            size_t next_index = fleet_index_.index_of(next_aircraft_id);
+            if (next_index != FleetIndex::npos)
+            {
+                charger_mgr.assign_charger(next_aircraft_id);
+                processes_[next_index].resume();
+            }
+        }
+
+        template <typename Fleet>
+        AircraftProcess fly_aircraft(Fleet &fleet, ChargerManager &charger_mgr, size_t fleet_index)
+        {
+            auto &&aircraft = fleet[fleet_index];
+            const int id = aircraft->get_id();
+            const AircraftType type = aircraft->get_type();
+
+            Flight flight = take_off(aircraft);
+            while (true)
+            {
+                if (flight.fault)
+                {
+                    if (!co_await until(*flight.fault))
+                    {
+                        record_partial_flight(aircraft, flight);
+                        co_return;
+                    }
+                    aircraft->set_faulty(true);
+                    stats_recorder_.record_fault(type);
+                    trace(id, TraceEventType::FAULT, type, flight.fault_time_hours);
+                }
+                if (!co_await until(flight.landing))
+                {
+                    record_partial_flight(aircraft, flight);
+                    co_return;
+                }
+
+                aircraft->discharge_battery();
+                stats_recorder_.record_flight(type, flight.flight_time_hours, flight.distance_miles, aircraft->get_passenger_count());
+                trace(id, TraceEventType::FLIGHT_COMPLETE, type, flight.flight_time_hours, flight.distance_miles);
+                if (aircraft->is_faulty())
+                {
+                    co_return; // grounded
+                }
+
+                double waiting_time = 0.0;
+                if (charger_mgr.request_charger(id))
+                {
+                    stats_recorder_.record_queue_length(type, 0);
+                }
+                else
+                {
+                    int queue_length = charger_mgr.get_queue_size(charger_mgr.get_home_pool(id));
+                    stats_recorder_.record_queue_length(type, queue_length);
+                    trace(id, TraceEventType::CHARGER_QUEUED, type, queue_length);
+                    charger_mgr.queue_for_charger(aircraft);
+
+                    double queued_at = current_time_hours_;
+                    co_await ChargerAwaiter{};
+                    waiting_time = current_time_hours_ - queued_at;
+                }
+
+                double charge_start = current_time_hours_;
+                double charge_time = aircraft->get_charge_time_hours();
+                trace(id, TraceEventType::CHARGE_START, type, charge_time, waiting_time);
+                Wakeup charged = queue_.plan(charge_start + charge_time, EventType::CHARGING_COMPLETE);
+                if (!co_await until(charged))
+                {
+                    if (counts_at_end(charged.time_hours))
+                    {
+                        double partial_charge_time = simulation_duration_hours_ - charge_start;
+                        stats_recorder_.record_partial_charge(type, partial_charge_time);
+                        trace(id, TraceEventType::PARTIAL_CHARGE, type, partial_charge_time);
+                    }
+                    co_return;
+                }
+
+                aircraft->charge_battery();
+                stats_recorder_.record_charge_session(type, charge_time, waiting_time);
+                trace(id, TraceEventType::CHARGE_COMPLETE, type, charge_time, waiting_time);
+
+                // The next flight is planned before the charger changes hands, as in the event engine
+                bool flies_again = current_time_hours_ < simulation_duration_hours_ && !aircraft->is_faulty();
+                if (flies_again)
+                {
+                    flight = take_off(aircraft);
+                }
+                hand_over_charger(charger_mgr, id);
+                if (!flies_again)
+                {
+                    co_return;
+                }
+            }
+        }
+
+    public:
+        CoroutineSimulationEngine(StatisticsCollector &stats, const SimulationConfig &config)
+            : SimulationEngineBase(stats, config.simulation_duration_hours), config_(config)
+        {
+        }
+
+        // Frames of a run live in frame_pool_
+        CoroutineSimulationEngine(const CoroutineSimulationEngine &) = delete;
+        CoroutineSimulationEngine &operator=(const CoroutineSimulationEngine &) = delete;
+
+        /**
+         * Run on any fleet container; the fleet's calls are resolved statically inside the coroutines
+         */
+        template <SimulationFleet Fleet>
+        void run(ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            is_running_ = true;
+            current_time_hours_ = 0.0;
+            if (simulation_duration_hours_ <= 0.0)
+            {
+                is_running_ = false;
+                return;
+            }
+
+            ProfileCounters *profile = active_profile();
+            ScopedPhaseTimer phase_timer(profile, ProfilePhase::INIT);
+            if (config_.random_seed)
+            {
+                seed_fleet_streams(fleet, *config_.random_seed);
+            }
+            apply_fault_model(fleet, config_.fault_model);
+
+            // Every aircraft takes off at time zero, in fleet order
+            fleet_index_.build(fleet);
+            queue_.clear();
+            queue_.reserve(fleet.size() * 2);
+            FramePoolScope frame_scope(*this);
+            processes_.reserve(fleet.size());
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                processes_.push_back(fly_aircraft(fleet, charger_mgr, i));
+            }
+            frame_size_ = AircraftProcess::promise_type::frame_size;
+
+            if (profile)
+            {
+                profile->begin_run(0.0);
+                profile->sample_charger_queue(0.0, charger_mgr.get_queue_size());
+            }
+            phase_timer.next(ProfilePhase::MAIN_LOOP);
+
+            // Wake-ups at or past the limit stay pending; their coroutines finish as partial activities
+            while (!queue_.empty() && queue_.top().time_hours < simulation_duration_hours_)
+            {
+                auto [wakeup, handle] = queue_.pop();
+                current_time_hours_ = wakeup.time_hours;
+                if (profile)
+                {
+                    profile->record_event(wakeup.type, queue_.size() + 1);
+                }
+
+                handle.resume();
+                if (profile)
+                {
+                    profile->sample_charger_queue(current_time_hours_, charger_mgr.get_queue_size());
+                }
+                publish_progress(charger_mgr);
+            }
+
+            phase_timer.next(ProfilePhase::FINALIZE);
+            current_time_hours_ = simulation_duration_hours_;
+            for (const AircraftProcess &process : processes_)
+            {
+                process.stop();
+            }
+            processes_.clear();
+            queue_.clear();
+            if (profile)
+            {
+                profile->end_run(simulation_duration_hours_);
+            }
+            publish_progress(charger_mgr, true);
+            is_running_ = false;
+        }
+
+        /**
+         * Bytes of one aircraft's coroutine frame in the last run (all aircraft share a frame type)
+         */
+        size_t get_frame_size() const { return frame_size_; }
+
+    protected:
+        void run_simulation_impl(ChargerManager &charger_mgr, AircraftFleet &fleet) override
+        {
+            run(charger_mgr, fleet);
+        }
+    };
+}
@@ -0,0 +1,568 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace evtol
+{
+    /**
+     * Order in which aircraft waiting at a charger pool get the next free charger
+     */
+    enum class DispatchPolicy : std::uint8_t
+    {
+        FIFO,                  // first come, first served
+        SHORTEST_CHARGE_FIRST, // shortest full charge first, e.g. Beta (0.2 h) before Charlie (0.8 h)
+        MOST_PASSENGERS_FIRST  // highest passenger count first
+    };
+
+    inline const char *dispatch_policy_to_string(DispatchPolicy policy)
+    {
+        switch (policy)
+        {
+        case DispatchPolicy::FIFO:
+            return "fifo";
+        case DispatchPolicy::SHORTEST_CHARGE_FIRST:
+            return "shortest-charge";
+        case DispatchPolicy::MOST_PASSENGERS_FIRST:
+            return "most-passengers";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Parse a dispatch policy name as accepted by --dispatch
+     * @throws std::invalid_argument for unknown names
+     */
+    inline DispatchPolicy parse_dispatch_policy(const std::string &name)
+    {
+        if (name == "fifo")
+            return DispatchPolicy::FIFO;
+        if (name == "shortest-charge" || name == "scf")
+            return DispatchPolicy::SHORTEST_CHARGE_FIRST;
+        if (name == "most-passengers")
+            return DispatchPolicy::MOST_PASSENGERS_FIRST;
+        throw std::invalid_argument("Unknown dispatch policy: " + name);
+    }
+
+    /**
+     * Queue priority of an aircraft (pointer or SoA handle) under a policy; lower is served first,
+     * equal priorities in arrival order, so FIFO is every aircraft at 0
+     */
+    template <typename AircraftRef>
+    double dispatch_priority(DispatchPolicy policy, const AircraftRef &aircraft)
+    {
+        switch (policy)
+        {
+        case DispatchPolicy::FIFO:
+            break;
+        case DispatchPolicy::SHORTEST_CHARGE_FIRST:
+            return aircraft->get_charge_time_hours();
+        case DispatchPolicy::MOST_PASSENGERS_FIRST:
+            return -static_cast<double>(aircraft->get_passenger_count());
+        }
+        return 0.0;
+    }
+
+    /**
+     * A waiting aircraft: served by priority, then by arrival sequence
+     */
+    struct QueueEntry
+    {
+        int id;
+        double priority;
+        std::uint64_t sequence;
+    };
+
+    /**
+     * One value per aircraft id, with a default for ids never set
+     * Ids below MAX_DENSE_ID index a vector; others go to a hash map.
+     */
+    template <typename T>
+    class IdTable
+    {
+    private:
+        static constexpr int MAX_DENSE_ID = 1 << 24;
+
+        T absent_;
+        std::vector<T> dense_;
+        std::unordered_map<int, T> sparse_;
+
+        static bool is_dense_id(int id) { return id >= 0 && id < MAX_DENSE_ID; }
+
+    public:
+        explicit IdTable(T absent) : absent_(absent) {}
+
+        T get(int id) const
+        {
+            if (!is_dense_id(id))
+            {
+                auto it = sparse_.find(id);
+                return it != sparse_.end() ? it->second : absent_;
+            }
+            size_t index = static_cast<size_t>(id);
+            return index < dense_.size() ? dense_[index] : absent_;
+        }
+
+        /**
+         * Setting the default value forgets the id
+         */
+        void set(int id, T value)
+        {
+            if (!is_dense_id(id))
+            {
+                if (value == absent_)
+                {
+                    sparse_.erase(id);
+                }
+                else
+                {
+                    sparse_[id] = value;
+                }
+                return;
+            }
+
+            size_t index = static_cast<size_t>(id);
+            if (index >= dense_.size())
+            {
+                if (value == absent_)
+                {
+                    return;
+                }
+                dense_.resize(std::max(index + 1, 2 * dense_.size()), absent_);
+            }
+            dense_[index] = value;
+        }
+    };
+
+    /**
+     * Min-heap of ids with ARITY children per node and a position index
+     * Entries are ordered by (priority, arrival sequence). The index maps each id to its heap slot,
+     * so besides push and pop an entry can be reprioritized or removed by id in O(log N) rather
+     * than by a scan. update() keeps the entry's arrival sequence, so among equal priorities it
+     * stays where it arrived.
+     */
+    template <size_t ARITY = 4>
+    class IndexedDaryHeap
+    {
+        static_assert(ARITY >= 2, "a heap node needs at least two children");
+
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        using Entry = QueueEntry;
+
+    private:
+        std::vector<Entry> heap_;
+        IdTable<size_t> positions_{npos}; // heap slot by id
+        std::uint64_t next_sequence_ = 0;
+
+        static bool before(const Entry &a, const Entry &b)
+        {
+            return a.priority < b.priority || (a.priority == b.priority && a.sequence < b.sequence);
+        }
+
+        size_t position_of(int id) const { return positions_.get(id); }
+
+        void set_position(int id, size_t position) { positions_.set(id, position); }
+
+        void place(size_t position, const Entry &entry)
+        {
+            heap_[position] = entry;
+            set_position(entry.id, position);
+        }
+
+        void sift_up(size_t position)
+        {
+            Entry entry = heap_[position];
+            while (position > 0)
+            {
+                size_t parent = (position - 1) / ARITY;
+                if (!before(entry, heap_[parent]))
+                {
+                    break;
+                }
+                place(position, heap_[parent]);
+                position = parent;
+            }
+            place(position, entry);
+        }
+
+        void sift_down(size_t position)
+        {
+            Entry entry = heap_[position];
+            while (true)
+            {
+                size_t first_child = position * ARITY + 1;
+                if (first_child >= heap_.size())
+                {
+                    break;
+                }
+                size_t last_child = std::min(first_child + ARITY, heap_.size());
+                size_t best = first_child;
+                for (size_t child = first_child + 1; child < last_child; ++child)
+                {
+                    if (before(heap_[child], heap_[best]))
+                    {
+                        best = child;
+                    }
+                }
+                if (!before(heap_[best], entry))
+                {
+                    break;
+                }
+                place(position, heap_[best]);
+                position = best;
+            }
+            place(position, entry);
+        }
+
+        void remove_at(size_t position)
+        {
+            set_position(heap_[position].id, npos);
+            Entry last = heap_.back();
+            heap_.pop_back();
+            if (position < heap_.size())
+            {
+                place(position, last);
+                sift_down(position);
+                sift_up(position);
+            }
+        }
+
+    public:
+        bool empty() const { return heap_.empty(); }
+        size_t size() const { return heap_.size(); }
+        bool contains(int id) const { return position_of(id) != npos; }
+
+        /**
+         * Entry served next; the heap must not be empty
+         */
+        const Entry &top() const { return heap_.front(); }
+
+        /**
+         * @throws std::logic_error if the id is already queued
+         */
+        void push(int id, double priority)
+        {
+            if (contains(id))
+            {
+                throw std::logic_error("Aircraft " + std::to_string(id) + " is already queued");
+            }
+            heap_.push_back({id, priority, next_sequence_++});
+            sift_up(heap_.size() - 1);
+        }
+
+        /**
+         * Remove the entry served next
+         * @return Its id; the heap must not be empty
+         */
+        int pop()
+        {
+            int id = heap_.front().id;
+            remove_at(0);
+            return id;
+        }
+
+        /**
+         * @return False if the id is not queued
+         */
+        bool erase(int id)
+        {
+            size_t position = position_of(id);
+            if (position == npos)
+            {
+                return false;
+            }
+            remove_at(position);
+            return true;
+        }
+
+        /**
+         * Change a queued entry's priority
+         * @return False if the id is not queued
+         */
+        bool update(int id, double priority)
+        {
+            size_t position = position_of(id);
+            if (position == npos)
+            {
+                return false;
+            }
+            double previous = heap_[position].priority;
+            heap_[position].priority = priority;
+            if (priority < previous)
+            {
+                sift_up(position);
+            }
+            else
+            {
+                sift_down(position);
+            }
+            return true;
+        }
+
+        /**
+         * @throws std::out_of_range if the id is not queued
+         */
+        double priority_of(int id) const
+        {
+            size_t position = position_of(id);
+            if (position == npos)
+            {
+                throw std::out_of_range("Aircraft " + std::to_string(id) + " is not queued");
+            }
+            return heap_[position].priority;
+        }
+
+        /**
+         * Copy of the queued entries in the order they would be served
+         */
+        std::vector<Entry> entries_in_order() const
+        {
+            std::vector<Entry> entries = heap_;
+            std::sort(entries.begin(), entries.end(), before);
+            return entries;
+        }
+
+        void clear()
+        {
+            for (const Entry &entry : heap_)
+            {
+                set_position(entry.id, npos);
+            }
+            heap_.clear();
+        }
+    };
+
+    /**
+     * First-come, first-served queue of ids with a membership index
+     * Each id's live arrival sequence is indexed by id, so contains() and erase() are O(1); an erased
+     * entry stays in the deque as a stale record until it reaches the front, where pops and erases
+     * drop it. Every id queues at most once, as in IndexedDaryHeap.
+     */
+    class ArrivalQueue
+    {
+    public:
+        using Entry = QueueEntry;
+
+    private:
+        static constexpr std::uint64_t NOT_QUEUED = UINT64_MAX;
+        static constexpr size_t MIN_COMPACT_SIZE = 64;
+
+        std::deque<Entry> arrivals_; // arrival order, including stale records
+        IdTable<std::uint64_t> live_sequences_{NOT_QUEUED};
+        std::uint64_t next_sequence_ = 0;
+        size_t size_ = 0;
+
+        bool is_live(const Entry &entry) const { return live_sequences_.get(entry.id) == entry.sequence; }
+
+        // Keeps the front live, so front() and pop() never scan
+        void drop_stale_records()
+        {
+            while (!arrivals_.empty() && !is_live(arrivals_.front()))
+            {
+                arrivals_.pop_front();
+            }
+            if (arrivals_.size() >= MIN_COMPACT_SIZE && arrivals_.size() > 2 * size_)
+            {
+                arrivals_.erase(std::remove_if(arrivals_.begin(), arrivals_.end(), [this](const Entry &entry)
+                                               { return !is_live(entry); }),
+                                arrivals_.end());
+            }
+        }
+
+    public:
+        bool empty() const { return size_ == 0; }
+        size_t size() const { return size_; }
+        bool contains(int id) const { return live_sequences_.get(id) != NOT_QUEUED; }
+
+        /**
+         * Id served next; the queue must not be empty
+         */
+        int front() const { return arrivals_.front().id; }
+
+        /**
+         * @throws std::logic_error if the id is already queued
+         */
+        void push(int id)
+        {
+            if (contains(id))
+            {
+                throw std::logic_error("Aircraft " + std::to_string(id) + " is already queued");
+            }
+            arrivals_.push_back({id, 0.0, next_sequence_});
+            live_sequences_.set(id, next_sequence_++);
+            ++size_;
+        }
+
+        /**
+         * Remove the id served next
+         * @return Its id; the queue must not be empty
+         */
+        int pop()
+        {
+            int id = arrivals_.front().id;
+            live_sequences_.set(id, NOT_QUEUED);
+            arrivals_.pop_front();
+            --size_;
+            drop_stale_records();
+            return id;
+        }
+
+        /**
+         * @return False if the id is not queued
+         */
+        bool erase(int id)
+        {
+            if (!contains(id))
+            {
+                return false;
+            }
+            live_sequences_.set(id, NOT_QUEUED);
+            --size_;
+            drop_stale_records();
+            return true;
+        }
+
+        /**
+         * Copy of the queued entries in arrival order
+         */
+        std::vector<Entry> entries_in_order() const
+        {
+            std::vector<Entry> entries;
+            entries.reserve(size_);
+            for (const Entry &entry : arrivals_)
+            {
+                if (is_live(entry))
+                {
+                    entries.push_back(entry);
+                }
+            }
+            return entries;
+        }
+
+        void clear()
+        {
+            for (const Entry &entry : arrivals_)
+            {
+                live_sequences_.set(entry.id, NOT_QUEUED);
+            }
+            arrivals_.clear();
+            size_ = 0;
+        }
+    };
+
+    /**
+     * Waiting queue of one charger pool under a dispatch policy
+     * FIFO keeps an ArrivalQueue, so the default policy costs about what the plain deque did before
+     * policies existed and ignores priorities; every other policy keeps an IndexedDaryHeap. Under
+     * both, lookups and removals by id are indexed and an id already waiting cannot be queued again.
+     */
+    class DispatchQueue
+    {
+    public:
+        using Entry = QueueEntry;
+
+    private:
+        bool fifo_;
+        ArrivalQueue arrivals_;
+        IndexedDaryHeap<4> heap_;
+
+    public:
+        explicit DispatchQueue(DispatchPolicy policy = DispatchPolicy::FIFO) : fifo_(policy == DispatchPolicy::FIFO) {}
+
+        bool empty() const { return fifo_ ? arrivals_.empty() : heap_.empty(); }
+        size_t size() const { return fifo_ ? arrivals_.size() : heap_.size(); }
+        bool contains(int id) const { return fifo_ ? arrivals_.contains(id) : heap_.contains(id); }
+
+        /**
+         * @return Id served next, or -1 if the queue is empty
+         */
+        int front() const
+        {
+            if (empty())
+            {
+                return -1;
+            }
+            return fifo_ ? arrivals_.front() : heap_.top().id;
+        }
+
+        /**
+         * Priority the id waits with (0 under FIFO)
+         * @throws std::out_of_range if the id is not queued
+         */
+        double priority_of(int id) const
+        {
+            if (!fifo_)
+            {
+                return heap_.priority_of(id);
+            }
+            if (!arrivals_.contains(id))
+            {
+                throw std::out_of_range("Aircraft " + std::to_string(id) + " is not queued");
+            }
+            return 0.0;
+        }
+
+        /**
+         * @throws std::logic_error if the id is already queued
+         */
+        void push(int id, double priority)
+        {
+            if (fifo_)
+            {
+                arrivals_.push(id);
+            }
+            else
+            {
+                heap_.push(id, priority);
+            }
+        }
+
+        /**
+         * @return Id served next, or -1 if the queue is empty
+         */
+        int pop()
+        {
+            if (empty())
+            {
+                return -1;
+            }
+            return fifo_ ? arrivals_.pop() : heap_.pop();
+        }
+
+        bool erase(int id)
+        {
+            return fifo_ ? arrivals_.erase(id) : heap_.erase(id);
+        }
+
+        /**
+         * @return False if the id is not queued; under FIFO the order never changes
+         */
+        bool update(int id, double priority)
+        {
+            return fifo_ ? arrivals_.contains(id) : heap_.update(id, priority);
+        }
+
+        /**
+         * Copy of the queued entries in serving order (FIFO priorities are 0); sorts a copy of the
+         * heap under priority policies
+         */
+        std::vector<Entry> entries_in_order() const
+        {
+            return fifo_ ? arrivals_.entries_in_order() : heap_.entries_in_order();
+        }
+
+        void clear()
+        {
+            arrivals_.clear();
+            heap_.clear();
+        }
+    };
+}
@@ -0,0 +1,680 @@
+#include "distributed_batch.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "arena_fleet.h"
+#include "simulation_runner.h"
+
+namespace evtol
+{
+    namespace
+    {
+        // Message sections, in the order a connection sees them:
+        //   worker HELO (threads, host), coordinator JOB_ (task kind, options), then TASK (task,
+        //   first, count) / RSLT (task, results) or FAIL (task, error) pairs until DONE
+        constexpr std::uint32_t HELLO = snapshot_tag("HELO");
+        constexpr std::uint32_t JOB = snapshot_tag("JOB_");
+        constexpr std::uint32_t TASK = snapshot_tag("TASK");
+        constexpr std::uint32_t RESULT = snapshot_tag("RSLT");
+        constexpr std::uint32_t FAILED = snapshot_tag("FAIL");
+        constexpr std::uint32_t DONE = snapshot_tag("DONE");
+
+        // A worker that stops half way through a message is given up on after this long
+        constexpr int RECEIVE_TIMEOUT_SECONDS = 30;
+        constexpr int POLL_PERIOD_MS = 100;
+
+        std::runtime_error socket_error(const std::string &what)
+        {
+            return std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        void set_option(int fd, int level, int name, int value)
+        {
+            ::setsockopt(fd, level, name, &value, sizeof(value));
+        }
+
+        std::string host_name()
+        {
+            char name[256] = {};
+            if (::gethostname(name, sizeof(name) - 1) != 0)
+            {
+                return "unknown";
+            }
+            return name;
+        }
+
+        SnapshotWriter section(std::uint32_t tag)
+        {
+            SnapshotWriter message;
+            message.begin_section(tag);
+            return message;
+        }
+
+        /**
+         * Which section a message holds, for messages that may be one of several
+         */
+        std::uint32_t read_tag(SnapshotReader &message)
+        {
+            return message.read<std::uint32_t>();
+        }
+    }
+
+    MessageSocket::MessageSocket(MessageSocket &&other) noexcept : fd_(std::exchange(other.fd_, -1))
+    {
+    }
+
+    MessageSocket &MessageSocket::operator=(MessageSocket &&other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    void MessageSocket::close()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    MessageSocket MessageSocket::connect(const std::string &address)
+    {
+        size_t colon = address.rfind(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == address.size())
+        {
+            throw std::runtime_error("Worker address must be host:port, got '" + address + "'");
+        }
+        std::string host = address.substr(0, colon);
+        std::string port = address.substr(colon + 1);
+
+        addrinfo hints{};
+        hints.ai_family = AF_INET; // the coordinator listens on IPv4
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *found = nullptr;
+        if (int error = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &found); error != 0)
+        {
+            throw std::runtime_error("Cannot resolve " + address + ": " + ::gai_strerror(error));
+        }
+
+        int fd = -1;
+        for (addrinfo *candidate = found; candidate && fd < 0; candidate = candidate->ai_next)
+        {
+            fd = ::socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+            if (fd >= 0 && ::connect(fd, candidate->ai_addr, candidate->ai_addrlen) != 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        ::freeaddrinfo(found);
+        if (fd < 0)
+        {
+            throw socket_error("Cannot connect to " + address);
+        }
+
+        set_option(fd, IPPROTO_TCP, TCP_NODELAY, 1);
+        set_option(fd, SOL_SOCKET, SO_KEEPALIVE, 1);
+        return MessageSocket(fd);
+    }
+
+    void MessageSocket::send(const SnapshotWriter &message)
+    {
+        if (fd_ < 0)
+        {
+            throw std::runtime_error("Sending on a closed connection");
+        }
+
+        std::uint64_t size = message.data().size();
+        auto write_all = [this](const void *data, size_t length)
+        {
+            const auto *bytes = static_cast<const char *>(data);
+            while (length > 0)
+            {
+                ssize_t written = ::send(fd_, bytes, length, MSG_NOSIGNAL);
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (written <= 0)
+                {
+                    throw socket_error("Connection lost while sending");
+                }
+                bytes += written;
+                length -= static_cast<size_t>(written);
+            }
+        };
+        write_all(&size, sizeof(size));
+        write_all(message.data().data(), message.data().size());
+    }
+
+    SnapshotReader MessageSocket::receive()
+    {
+        if (fd_ < 0)
+        {
+            throw std::runtime_error("Receiving on a closed connection");
+        }
+
+        auto read_all = [this](void *data, size_t length)
+        {
+            auto *bytes = static_cast<char *>(data);
+            while (length > 0)
+            {
+                ssize_t received = ::recv(fd_, bytes, length, 0);
+                if (received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (received == 0)
+                {
+                    throw std::runtime_error("Connection closed by peer");
+                }
+                if (received < 0)
+                {
+                    throw socket_error("Connection lost while receiving");
+                }
+                bytes += received;
+                length -= static_cast<size_t>(received);
+            }
+        };
+
+        std::uint64_t size = 0;
+        read_all(&size, sizeof(size));
+        if (size < sizeof(SnapshotFileHeader) || size > MAX_MESSAGE_SIZE)
+        {
+            throw std::runtime_error("Received a malformed message");
+        }
+        std::vector<std::byte> data(static_cast<size_t>(size));
+        read_all(data.data(), data.size());
+        return SnapshotReader(std::move(data));
+    }
+
+    BatchCoordinator::BatchCoordinator(const SimulationConfig &config, const DistributedBatchOptions &options)
+        : config_(config), options_(options)
+    {
+        if (!config_.random_seed)
+        {
+            config_.random_seed = RandomStream::entropy_seed();
+        }
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0)
+        {
+            throw socket_error("Cannot create the coordinator socket");
+        }
+        set_option(listen_fd_, SOL_SOCKET, SO_REUSEADDR, 1);
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(static_cast<std::uint16_t>(options_.port));
+        socklen_t length = sizeof(address);
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), length) != 0 || ::listen(listen_fd_, 64) != 0 ||
+            ::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&address), &length) != 0)
+        {
+            std::runtime_error error = socket_error("Cannot listen on port " + std::to_string(options_.port));
+            ::close(listen_fd_);
+            throw error;
+        }
+        port_ = ntohs(address.sin_port);
+    }
+
+    BatchCoordinator::~BatchCoordinator()
+    {
+        if (listen_fd_ >= 0)
+        {
+            ::close(listen_fd_);
+        }
+    }
+
+    size_t BatchCoordinator::chunk_for(size_t total_items) const
+    {
+        if (options_.chunk > 0)
+        {
+            return options_.chunk;
+        }
+        return std::max<size_t>(1, (total_items + DistributedBatchOptions::AUTO_TASK_COUNT - 1) /
+                                       DistributedBatchOptions::AUTO_TASK_COUNT);
+    }
+
+    template <typename OnResult>
+    DistributedRunReport BatchCoordinator::serve(DistributedTaskKind kind, size_t total_items, OnResult &&on_result)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker
+        {
+            MessageSocket socket;
+            std::string name = "unidentified worker";
+            bool joined = false;            // sent HELO and got the job
+            std::optional<size_t> task;     // task being run
+        };
+
+        size_t chunk = chunk_for(total_items);
+        size_t task_count = (total_items + chunk - 1) / chunk;
+
+        DistributedRunReport report;
+        report.tasks_total = task_count;
+
+        std::deque<size_t> queue;
+        for (size_t task = 0; task < task_count; ++task)
+        {
+            queue.push_back(task);
+        }
+        std::vector<bool> finished(task_count, false);
+
+        SnapshotWriter job = section(JOB);
+        job.write(kind);
+        std::vector<std::string> args = config_.to_args();
+        job.write(static_cast<std::uint64_t>(args.size()));
+        for (const std::string &arg : args)
+        {
+            job.write_string(arg);
+        }
+
+        auto log = [&](const std::string &line)
+        {
+            if (options_.log)
+            {
+                *options_.log << "[coordinator] " << line << std::endl;
+            }
+        };
+
+        std::vector<Worker> workers;
+        std::string failure; // a task that failed would fail on every worker, so it ends the run
+        Clock::time_point last_seen = Clock::now();
+
+        auto lose = [&](Worker &worker, const std::string &reason)
+        {
+            if (worker.task)
+            {
+                queue.push_front(*worker.task);
+                log("lost " + worker.name + " (" + reason + "); task " + std::to_string(*worker.task) + " re-queued");
+            }
+            else
+            {
+                log("lost " + worker.name + " (" + reason + ")");
+            }
+            ++report.workers_lost;
+            worker.socket.close();
+        };
+
+        auto assign = [&](Worker &worker)
+        {
+            if (queue.empty())
+            {
+                return;
+            }
+            size_t task = queue.front();
+            queue.pop_front();
+            worker.task = task;
+
+            SnapshotWriter message = section(TASK);
+            message.write(static_cast<std::uint64_t>(task));
+            message.write(static_cast<std::uint64_t>(task * chunk));
+            message.write(static_cast<std::uint64_t>(std::min(chunk, total_items - task * chunk)));
+            worker.socket.send(message);
+        };
+
+        auto handle = [&](Worker &worker)
+        {
+            SnapshotReader message = worker.socket.receive();
+            std::uint32_t tag = read_tag(message);
+            if (tag == HELLO && !worker.joined)
+            {
+                auto threads = message.read<std::uint32_t>();
+                worker.name = message.read_string() + " (" + std::to_string(threads) + " threads)";
+                worker.joined = true;
+                ++report.workers_seen;
+                log(worker.name + " joined");
+                worker.socket.send(job);
+            }
+            else if (tag == RESULT && worker.task)
+            {
+                auto task = static_cast<size_t>(message.read<std::uint64_t>());
+                if (task != *worker.task)
+                {
+                    throw std::runtime_error("result for a task it was not given");
+                }
+                worker.task.reset();
+                if (!finished[task])
+                {
+                    report.converged = on_result(task, message);
+                    finished[task] = true;
+                    ++report.tasks_done;
+                }
+            }
+            else if (tag == FAILED && worker.task)
+            {
+                message.read<std::uint64_t>();
+                failure = worker.name + " failed task " + std::to_string(*worker.task) + ": " + message.read_string();
+            }
+            else
+            {
+                throw std::runtime_error("unexpected message");
+            }
+        };
+
+        while (report.tasks_done < task_count && failure.empty() && !report.converged)
+        {
+            for (Worker &worker : workers)
+            {
+                if (worker.joined && !worker.task)
+                {
+                    try
+                    {
+                        assign(worker);
+                    }
+                    catch (const std::runtime_error &e)
+                    {
+                        lose(worker, e.what());
+                    }
+                }
+            }
+            std::erase_if(workers, [](const Worker &worker)
+                          { return !worker.socket.is_open(); });
+
+            if (!workers.empty())
+            {
+                last_seen = Clock::now();
+            }
+            else if (std::chrono::duration<double>(Clock::now() - last_seen).count() > options_.worker_wait_seconds)
+            {
+                log("no workers for " + std::to_string(options_.worker_wait_seconds) + " s; stopping after " +
+                    std::to_string(report.tasks_done) + " of " + std::to_string(task_count) + " tasks");
+                break;
+            }
+
+            std::vector<pollfd> polled;
+            polled.push_back({listen_fd_, POLLIN, 0});
+            for (const Worker &worker : workers)
+            {
+                polled.push_back({worker.socket.fd(), POLLIN, 0});
+            }
+            if (::poll(polled.data(), polled.size(), POLL_PERIOD_MS) < 0 && errno != EINTR)
+            {
+                throw socket_error("Waiting for workers failed");
+            }
+
+            for (size_t i = 0; i < workers.size(); ++i)
+            {
+                if (polled[i + 1].revents == 0)
+                {
+                    continue;
+                }
+                try
+                {
+                    handle(workers[i]);
+                }
+                catch (const std::runtime_error &e)
+                {
+                    lose(workers[i], e.what());
+                }
+            }
+
+            if ((polled[0].revents & POLLIN) != 0)
+            {
+                int fd = ::accept(listen_fd_, nullptr, nullptr);
+                if (fd >= 0)
+                {
+                    set_option(fd, IPPROTO_TCP, TCP_NODELAY, 1);
+                    set_option(fd, SOL_SOCKET, SO_KEEPALIVE, 1);
+                    timeval timeout{RECEIVE_TIMEOUT_SECONDS, 0};
+                    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                    Worker &worker = workers.emplace_back();
+                    worker.socket = MessageSocket(fd);
+                }
+            }
+        }
+
+        // Workers still connected are released; a dead one no longer matters
+        for (Worker &worker : workers)
+        {
+            try
+            {
+                worker.socket.send(section(DONE));
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+        }
+
+        if (!failure.empty())
+        {
+            throw std::runtime_error(failure);
+        }
+        return report;
+    }
+
+    DistributedBatchResult BatchCoordinator::run_replications()
+    {
+        DistributedBatchResult result;
+
+        // Task results wait here until every earlier task has been merged
+        std::vector<std::optional<BatchStatistics>> pending;
+        size_t next_merge = 0;
+
+        // The stopping rule sees the batch only as tasks merge in order, so where it stops depends on
+        // the chunk size but not on which worker finished first
+        ConfidenceStoppingRule rule = config_.stopping_rule();
+        bool converged = false;
+
+        size_t total = static_cast<size_t>(config_.replications);
+        result.report = serve(DistributedTaskKind::REPLICATIONS, total, [&](size_t task, SnapshotReader &message)
+                              {
+            if (pending.size() <= task)
+            {
+                pending.resize(task + 1);
+            }
+            pending[task].emplace().restore_state(message);
+            while (!converged && next_merge < pending.size() && pending[next_merge])
+            {
+                result.batch.merge(*pending[next_merge]);
+                pending[next_merge].reset();
+                ++next_merge;
+                converged = rule.enabled() && rule.is_met(result.batch);
+            }
+            return converged; });
+
+        // Partial results: merge what finished after the gap left by lost tasks
+        for (auto &task : pending)
+        {
+            if (task && !converged)
+            {
+                result.batch.merge(*task);
+            }
+        }
+        return result;
+    }
+
+    DistributedSweepResult BatchCoordinator::run_sweep(std::ostream &csv)
+    {
+        SweepRunner sweep(config_);
+        const std::vector<SweepPoint> &points = sweep.get_points();
+        std::vector<std::optional<SweepResult>> results(points.size());
+
+        csv << SweepRunner::csv_header() << std::flush;
+        DistributedSweepResult result;
+        result.report = serve(DistributedTaskKind::SWEEP_POINTS, points.size(), [&](size_t, SnapshotReader &message)
+                              {
+            auto count = message.read<std::uint64_t>();
+            for (std::uint64_t i = 0; i < count; ++i)
+            {
+                auto index = static_cast<size_t>(message.read<std::uint64_t>());
+                if (index >= points.size())
+                {
+                    throw std::runtime_error("result for an unknown sweep point");
+                }
+                StatsShard shard;
+                shard.restore_state(message);
+
+                SweepResult &point_result = results[index].emplace();
+                point_result.point = points[index];
+                for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+                {
+                    point_result.stats[t] = shard.get(static_cast<AircraftType>(t));
+                }
+                csv << SweepRunner::format_row(point_result) << std::flush;
+            }
+            return false; });
+
+        for (auto &point_result : results)
+        {
+            if (point_result)
+            {
+                result.results.push_back(std::move(*point_result));
+            }
+        }
+        return result;
+    }
+
+    size_t BatchWorker::run(const std::string &address)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        MessageSocket coordinator;
+        Clock::time_point start = Clock::now();
+        while (!coordinator.is_open())
+        {
+            try
+            {
+                coordinator = MessageSocket::connect(address);
+            }
+            catch (const std::runtime_error &)
+            {
+                if (std::chrono::duration<double>(Clock::now() - start).count() > CONNECT_RETRY_SECONDS)
+                {
+                    throw;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+        }
+
+        SnapshotWriter hello = section(HELLO);
+        hello.write(static_cast<std::uint32_t>(ThreadPool::resolve_thread_count(num_threads_)));
+        hello.write_string(host_name());
+
+        // A coordinator that finished before this worker got to it closes the connection unanswered
+        std::optional<SnapshotReader> received;
+        try
+        {
+            coordinator.send(hello);
+            received.emplace(coordinator.receive());
+        }
+        catch (const std::runtime_error &)
+        {
+            return 0;
+        }
+
+        SnapshotReader &job = *received;
+        if (read_tag(job) != JOB)
+        {
+            throw std::runtime_error("Coordinator did not send a job");
+        }
+        auto kind = job.read<DistributedTaskKind>();
+        std::vector<std::string> args(1, "evtolsim");
+        for (auto count = job.read<std::uint64_t>(); count > 0; --count)
+        {
+            args.push_back(job.read_string());
+        }
+        std::vector<char *> argv;
+        for (std::string &arg : args)
+        {
+            argv.push_back(arg.data());
+        }
+
+        SimulationConfig config;
+        config.parse_args(static_cast<int>(argv.size()), argv.data());
+        config.num_threads = num_threads_;
+        if (kind == DistributedTaskKind::SWEEP_POINTS)
+        {
+            config.sweep_csv_path = "(coordinator)"; // rows go to the coordinator's CSV
+        }
+        if (!config.validate())
+        {
+            throw std::runtime_error("Coordinator sent an invalid configuration");
+        }
+
+        StatisticsCollector unused_stats;
+        SimulationRunner runner(unused_stats, config);
+        std::optional<SweepRunner> sweep;
+        if (kind == DistributedTaskKind::SWEEP_POINTS)
+        {
+            sweep.emplace(config);
+        }
+
+        size_t tasks_done = 0;
+        while (true)
+        {
+            SnapshotReader message = coordinator.receive();
+            std::uint32_t tag = read_tag(message);
+            if (tag == DONE)
+            {
+                return tasks_done;
+            }
+            if (tag != TASK)
+            {
+                throw std::runtime_error("Coordinator sent an unexpected message");
+            }
+            auto task = message.read<std::uint64_t>();
+            auto first = static_cast<size_t>(message.read<std::uint64_t>());
+            auto count = static_cast<size_t>(message.read<std::uint64_t>());
+
+            SnapshotWriter reply = section(RESULT);
+            try
+            {
+                reply.write(task);
+                if (sweep)
+                {
+                    std::vector<SweepResult> results = sweep->run_points(first, count);
+                    reply.write(static_cast<std::uint64_t>(results.size()));
+                    for (const SweepResult &result : results)
+                    {
+                        StatsShard shard;
+                        for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+                        {
+                            shard.get(static_cast<AircraftType>(t)) = result.stats[t];
+                        }
+                        reply.write(static_cast<std::uint64_t>(result.point.index));
+                        shard.save_state(reply);
+                    }
+                }
+                else
+                {
+                    runner.run_replications([&config]
+                                            { return ArenaFleet(config.fleet_size, config.fleet_mix); },
+                                            first, count)
+                        .save_state(reply);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                reply = section(FAILED);
+                reply.write(task);
+                reply.write_string(e.what());
+            }
+            coordinator.send(reply);
+            ++tasks_done;
+        }
+    }
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "batch_statistics.h"
+#include "simulation_config.h"
+#include "snapshot.h"
+#include "sweep_runner.h"
+
+namespace evtol
+{
+    /**
+     * TCP connection carrying whole messages
+     * A message is a SnapshotWriter buffer (header and tagged sections) preceded by its length as a
+     * u64, so a received message is read with the same bounds checks as a checkpoint file. Sends
+     * never raise SIGPIPE; a closed or broken connection throws instead.
+     */
+    class MessageSocket
+    {
+    private:
+        int fd_ = -1;
+
+    public:
+        static constexpr std::uint64_t MAX_MESSAGE_SIZE = std::uint64_t{1} << 30;
+
+        MessageSocket() = default;
+        explicit MessageSocket(int fd) : fd_(fd) {}
+        ~MessageSocket() { close(); }
+
+        MessageSocket(MessageSocket &&other) noexcept;
+        MessageSocket &operator=(MessageSocket &&other) noexcept;
+        MessageSocket(const MessageSocket &) = delete;
+        MessageSocket &operator=(const MessageSocket &) = delete;
+
+        /**
+         * @param address host:port
+         * @throws std::runtime_error if the address is malformed or nothing accepts the connection
+         */
+        static MessageSocket connect(const std::string &address);
+
+        bool is_open() const { return fd_ >= 0; }
+        int fd() const { return fd_; }
+
+        /**
+         * @throws std::runtime_error if the connection is closed or broken
+         */
+        void send(const SnapshotWriter &message);
+
+        /**
+         * Block until the next whole message has arrived
+         * @throws std::runtime_error if the peer closed the connection, it broke or timed out, or the
+         *         message is not a snapshot of this version
+         */
+        SnapshotReader receive();
+
+        void close();
+    };
+
+    /**
+     * What a distributed run hands out: ranges of replications or of sweep points
+     */
+    enum class DistributedTaskKind : std::uint8_t
+    {
+        REPLICATIONS,
+        SWEEP_POINTS
+    };
+
+    struct DistributedBatchOptions
+    {
+        static constexpr size_t AUTO_TASK_COUNT = 32; // tasks a batch is cut into when chunk is 0
+
+        int port = 0;                      // 0 = any free port, see BatchCoordinator::port()
+        size_t chunk = 0;                  // replications or sweep points per task; 0 = automatic
+        double worker_wait_seconds = 60.0; // stop with partial results after this long without a worker
+        std::ostream *log = nullptr;       // one line per worker joining, leaving or being lost
+
+        static DistributedBatchOptions from_config(const SimulationConfig &config, std::ostream *log)
+        {
+            DistributedBatchOptions options;
+            options.port = config.coordinator_port;
+            options.chunk = static_cast<size_t>(config.distributed_chunk);
+            options.worker_wait_seconds = config.worker_wait_seconds;
+            options.log = log;
+            return options;
+        }
+    };
+
+    /**
+     * How a distributed run went; results cover tasks_done of tasks_total tasks
+     */
+    struct DistributedRunReport
+    {
+        size_t tasks_total = 0;
+        size_t tasks_done = 0;
+        size_t workers_seen = 0;
+        size_t workers_lost = 0; // connections that dropped before the run was over
+        bool converged = false;  // the batch met its CI target before every task ran
+
+        bool complete() const { return converged || tasks_done == tasks_total; }
+    };
+
+    struct DistributedBatchResult
+    {
+        BatchStatistics batch; // replications of the finished tasks only, see get_replication_count()
+        DistributedRunReport report;
+    };
+
+    struct DistributedSweepResult
+    {
+        std::vector<SweepResult> results; // finished points, in point order
+        DistributedRunReport report;
+    };
+
+    /**
+     * Serves a batch or sweep to BatchWorker processes over TCP
+     * The replications (or sweep points) are cut into fixed ranges by index; a worker takes one range
+     * at a time, runs it across its own thread pool and sends back the merged BatchStatistics of
+     * the range (or the per-point results), so statistics are reduced per thread, then per node,
+     * then here. Replication seeds depend only on the batch seed and the replication index, so the
+     * batch is the same however the ranges were spread. Task results are merged in task order as
+     * they become contiguous, so the merged batch does not depend on which worker finished first.
+     *
+     * A worker whose connection drops (crash, kill, network) loses its current task, which goes back
+     * to the front of the queue for the others; everything it finished before stays merged. If no
+     * worker has been connected for worker_wait_seconds the run stops and returns the finished tasks
+     * only, with report.complete() false. A worker that reports a failed task ends the run with an
+     * exception, since another worker would fail the same way.
+     */
+    class BatchCoordinator
+    {
+    private:
+        SimulationConfig config_;
+        DistributedBatchOptions options_;
+        int listen_fd_ = -1;
+        int port_ = 0;
+
+        size_t chunk_for(size_t total_items) const;
+
+        /**
+         * Hand out ceil(total_items / chunk) tasks until all are done, no worker is left or on_result
+         * returns true (the results so far are enough)
+         * @param on_result Called once per finished task with its index and the rest of its RSLT message
+         */
+        template <typename OnResult>
+        DistributedRunReport serve(DistributedTaskKind kind, size_t total_items, OnResult &&on_result);
+
+    public:
+        /**
+         * Listens from construction on, so workers may connect before run_*() is called
+         * A config without a seed gets one here, since every worker must draw the same seeds.
+         * @throws std::runtime_error if the port cannot be bound
+         */
+        BatchCoordinator(const SimulationConfig &config, const DistributedBatchOptions &options);
+        ~BatchCoordinator();
+
+        BatchCoordinator(const BatchCoordinator &) = delete;
+        BatchCoordinator &operator=(const BatchCoordinator &) = delete;
+
+        /**
+         * Port workers connect to (the one picked by the system if options.port was 0)
+         */
+        int port() const { return port_; }
+
+        const SimulationConfig &get_config() const { return config_; }
+
+        /**
+         * Run config.replications replications, as SimulationRunner::run_replications does locally
+         * With config.ci_target set the rule is checked each time the next task in order has been
+         * merged, and the batch stops there (report.converged); tasks past it are discarded.
+         */
+        DistributedBatchResult run_replications();
+
+        /**
+         * Run every point of the config's sweep; rows are written to csv (after its header) as
+         * results arrive, as SweepRunner::run does locally
+         */
+        DistributedSweepResult run_sweep(std::ostream &csv);
+    };
+
+    /**
+     * Runs tasks for a BatchCoordinator until it sends DONE
+     * The coordinator sends the options the simulations depend on (SimulationConfig::to_args); the
+     * worker runs them with its own thread count.
+     */
+    class BatchWorker
+    {
+    private:
+        int num_threads_;
+
+    public:
+        static constexpr double CONNECT_RETRY_SECONDS = 10.0; // workers may start before the coordinator
+
+        explicit BatchWorker(int num_threads = 0) : num_threads_(num_threads) {}
+
+        /**
+         * @param address host:port of the coordinator
+         * @return Tasks this worker finished; 0 if the coordinator was already done when it connected
+         * @throws std::runtime_error if the coordinator cannot be reached or the connection breaks
+         */
+        size_t run(const std::string &address);
+    };
+}
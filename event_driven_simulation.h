@@ -1,43 +1,33 @@
 #pragma once
-#include <queue>
+#include <algorithm>
+#include <string>
 #include <vector>
 #include <memory>
 #include <chrono>
 #include <variant>
 #include <iostream>
-#include <unordered_map>
+#include <optional>
+#include <cstdint>
 
+#include "random_stream.h"
+#include "aircraft_state.h"
+#include "event_scheduler.h"
+#include "fleet_index.h"
 #include "charger_manager.h"
 #include "statistics_engine.h"
 #include "simulation_interface.h"
+#include "simulation_log.h"
+#include "checkpoint.h"
+#include "profiler.h"
+#include "progress_monitor.h"
+#include "uncontended_solver.h"
 
 namespace evtol
 {
-    enum class EventType
-    {
-        FLIGHT_COMPLETE,
-        CHARGING_COMPLETE,
-        FAULT_OCCURRED
-    };
-
-    template <typename T>
-    struct Event
-    {
-        EventType type;
-        double time_hours;
-        T data;
-
-        Event(EventType t, double time, T d) : type(t), time_hours(time), data(std::move(d)) {}
-
-        bool operator<(const Event &other) const
-        {
-            return time_hours > other.time_hours;
-        }
-    };
-
     struct FlightCompleteData
     {
         int aircraft_id;
+        size_t fleet_index;
         double flight_time;
         double distance;
         bool fault_occurred;
@@ -46,6 +36,7 @@ namespace evtol
     struct ChargingCompleteData
     {
         int aircraft_id;
+        size_t fleet_index;
         double charge_time;
         double waiting_time;
     };
@@ -53,46 +44,116 @@ namespace evtol
     struct FaultData
     {
         int aircraft_id;
+        size_t fleet_index;
         double fault_time;
     };
 
     using EventData = std::variant<FlightCompleteData, ChargingCompleteData, FaultData>;
     using SimulationEvent = Event<EventData>;
 
-    class EventDrivenSimulation
+    /**
+     * Event-driven simulation core, parameterized on its event queue
+     * @tparam Scheduler Any EventScheduler over EventData (see event_scheduler.h)
+     */
+    template <EventScheduler Scheduler>
+    class BasicEventDrivenSimulation
     {
+        static_assert(std::is_same_v<typename Scheduler::payload_type, EventData>,
+                      "scheduler must store EventData payloads");
+
     private:
-        std::priority_queue<SimulationEvent> event_queue_;
+        Scheduler event_queue_;
         double current_time_hours_;
         double simulation_duration_hours_;
         StatisticsCollector &stats_collector_;
-        std::unordered_map<int, double> waiting_start_times_;
-        std::unordered_map<int, double> flight_start_times_;
-        std::unordered_map<int, double> charging_start_times_;
+        StatsRecorder stats_recorder_;
+        FleetIndex fleet_index_;
+        std::vector<AircraftTimeline> timelines_; // by fleet position
         bool enable_detailed_logging_;
         bool enable_partial_flights_;
+        std::optional<std::uint64_t> random_seed_;
+        TraceWriter *trace_writer_ = nullptr;
+        CheckpointOptions checkpoint_options_;
+        CheckpointSchedule checkpoints_;
+        bool enable_analytic_solver_ = false;
+        bool solved_analytically_ = false;
+        FaultModel fault_model_ = FaultModel::LINEAR;
+        ProfileCounters *profile_ = nullptr;
+        ProgressChannel *progress_ = nullptr;
+
+        /**
+         * @param message String or callable returning one; only formatted when detailed logging is on
+         */
+        template <typename Message>
+        void log_event(Message &&message) const
+        {
+            if constexpr (DETAILED_LOGGING_COMPILED_IN)
+            {
+                if (enable_detailed_logging_)
+                {
+                    write_log_event(current_time_hours_, std::forward<Message>(message));
+                }
+            }
+        }
 
-        void log_event(const std::string& message) const
+        // Null unless profiling is compiled in and requested, so every hook folds away otherwise
+        ProfileCounters *active_profile() const
         {
-            if (enable_detailed_logging_)
+            if constexpr (PROFILING_COMPILED_IN)
             {
-                std::cout << "[" << current_time_hours_ << "h] " << message << std::endl;
+                return profile_;
+            }
+            return nullptr;
+        }
+
+        // Every state change is traced, so this is also where the profile counts them
+        void trace(int aircraft_id, TraceEventType event_type, AircraftType aircraft_type,
+                   double value_a = 0.0, double value_b = 0.0)
+        {
+            if (ProfileCounters *profile = active_profile())
+            {
+                profile->state_changes++;
+            }
+            if (trace_writer_)
+            {
+                trace_writer_->record(current_time_hours_, aircraft_id, event_type, aircraft_type, value_a, value_b);
+            }
+        }
+
+        // One relaxed load per call unless a reader is waiting or the run is finished
+        void publish_progress(const ChargerManager &charger_mgr, bool finished = false)
+        {
+            if (progress_ && (finished || progress_->requested()))
+            {
+                progress_->publish(ProgressSnapshot::capture(current_time_hours_, simulation_duration_hours_,
+                                                             stats_collector_, charger_mgr, finished));
             }
         }
 
     public:
-        EventDrivenSimulation(StatisticsCollector &stats, double duration_hours = 3.0, bool detailed_logging = false, bool partial_flights = true)
+        BasicEventDrivenSimulation(StatisticsCollector &stats, double duration_hours = 3.0, bool detailed_logging = false, bool partial_flights = true,
+                              std::optional<std::uint64_t> random_seed = std::nullopt)
             : current_time_hours_(0.0), simulation_duration_hours_(duration_hours),
-              stats_collector_(stats), enable_detailed_logging_(detailed_logging), enable_partial_flights_(partial_flights)
+              stats_collector_(stats), stats_recorder_(stats), enable_detailed_logging_(detailed_logging), enable_partial_flights_(partial_flights),
+              random_seed_(random_seed)
         {
         }
 
-        template <typename Fleet>
+        /**
+         * Run from time zero, or from checkpoint_options.restore_path when set
+         */
+        template <SimulationFleet Fleet>
         void run_simulation(ChargerManager &charger_mgr, Fleet &fleet)
         {
+            if (!checkpoint_options_.restore_path.empty())
+            {
+                resume_simulation(charger_mgr, fleet);
+                return;
+            }
+
             log_event("=== Starting event-driven simulation ===");
-            log_event("Fleet size: " + std::to_string(fleet.size()));
-            log_event("Available chargers: " + std::to_string(charger_mgr.get_available_chargers()));
+            log_event([&] { return "Fleet size: " + std::to_string(fleet.size()); });
+            log_event([&] { return "Available chargers: " + std::to_string(charger_mgr.get_available_chargers()); });
             
             // Early termination for zero or negative duration
             if (simulation_duration_hours_ <= 0.0)
@@ -100,30 +161,51 @@ namespace evtol
                 log_event("Simulation duration is zero or negative - terminating early");
                 return;
             }
-            
-            schedule_initial_flights(fleet);
 
-            // process events
-            while (!event_queue_.empty() && current_time_hours_ < simulation_duration_hours_)
+            ScopedPhaseTimer phase_timer(active_profile(), ProfilePhase::INIT);
+            if (random_seed_)
             {
-                auto event = event_queue_.top();
-                event_queue_.pop();
-
-                current_time_hours_ = event.time_hours;
+                seed_fleet_streams(fleet, *random_seed_);
+            }
+            apply_fault_model(fleet, fault_model_);
 
-                if (current_time_hours_ >= simulation_duration_hours_)
-                {
-                    log_event("Simulation time limit reached");
-                    break;
-                }
+            if (try_solve_analytically(charger_mgr, fleet, phase_timer))
+            {
+                return;
+            }
+            
+            schedule_initial_flights(fleet);
+            checkpoints_.start(checkpoint_options_.every_hours);
+            run_events(charger_mgr, fleet, phase_timer);
+        }
 
-                process_event(event, charger_mgr, fleet);
+        /**
+         * Restore everything from checkpoint_options.restore_path and run on to the end
+         * The run may be longer or shorter than the one that wrote the checkpoint, and may use another scheduler.
+         * @throws std::runtime_error if the checkpoint cannot be read or does not fit this set-up
+         */
+        template <SimulationFleet Fleet>
+        void resume_simulation(ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            ScopedPhaseTimer phase_timer(active_profile(), ProfilePhase::INIT);
+            const std::string &path = checkpoint_options_.restore_path;
+            CheckpointHeader expected{SimulationMode::EVENT_DRIVEN, 0.0, 0.0, fleet.size()};
+            CheckpointHeader header = read_checkpoint(
+                path, expected, simulation_duration_hours_, [&](SnapshotReader &in)
+                { restore_state(in, fleet.size()); },
+                charger_mgr, fleet, stats_collector_);
+            fleet_index_.build(fleet);
+
+            log_event([&] { return "=== Resuming event-driven simulation from " + path + " (" +
+                                   std::to_string(header.time_hours) + "h) ==="; });
+            if (checkpoint_options_.branch_seed)
+            {
+                seed_fleet_streams(fleet, *checkpoint_options_.branch_seed);
             }
+            apply_fault_model(fleet, fault_model_);
 
-            // Process any remaining activities at simulation end
-            log_event("=== Finalizing simulation ===");
-            finalize_simulation(fleet);
-            log_event("=== Simulation completed ===");
+            checkpoints_.start(checkpoint_options_.every_hours, header.time_hours);
+            run_events(charger_mgr, fleet, phase_timer);
         }
 
         template <typename Fleet>
@@ -134,269 +216,462 @@ namespace evtol
             using T = std::decay_t<decltype(data)>;
             
             if constexpr (std::is_same_v<T, FlightCompleteData>) {
-                log_event("Processing FLIGHT_COMPLETE event for aircraft " + std::to_string(data.aircraft_id));
+                log_event([&] { return "Processing FLIGHT_COMPLETE event for aircraft " + std::to_string(data.aircraft_id); });
                 handle_flight_complete(data, charger_mgr, fleet);
             } else if constexpr (std::is_same_v<T, ChargingCompleteData>) {
-                log_event("Processing CHARGING_COMPLETE event for aircraft " + std::to_string(data.aircraft_id));
+                log_event([&] { return "Processing CHARGING_COMPLETE event for aircraft " + std::to_string(data.aircraft_id); });
                 handle_charging_complete(data, charger_mgr, fleet);
             } else if constexpr (std::is_same_v<T, FaultData>) {
-                log_event("Processing FAULT_OCCURRED event for aircraft " + std::to_string(data.aircraft_id));
+                log_event([&] { return "Processing FAULT_OCCURRED event for aircraft " + std::to_string(data.aircraft_id); });
                 handle_fault(data, fleet);
             } }, event.data);
         }
 
+        /**
+         * Queue an event at its real time, even past the end of the run
+         * Flights and charges still pending at the end become partial activities (if enabled) in
+         * finalize_simulation; events past the end are otherwise never processed. Keeping their real
+         * time means a run resumed from a checkpoint can be given a longer duration.
+         */
         void schedule_event(EventType type, double time_hours, EventData data)
         {
             double scheduled_time = time_hours;
             bool is_partial_event = false;
             
-            // For flight events that would extend beyond simulation duration,
-            // schedule them at simulation end time as partial events (if enabled)
-            if (time_hours > simulation_duration_hours_ && type == EventType::FLIGHT_COMPLETE && enable_partial_flights_)
+            // Flight and charging events that would extend beyond simulation duration
+            // end at the simulation end time as partial events (if enabled)
+            if (time_hours > simulation_duration_hours_ && type != EventType::FAULT_OCCURRED && enable_partial_flights_)
             {
                 scheduled_time = simulation_duration_hours_;
                 is_partial_event = true;
             }
             
-            // For charging events that would extend beyond simulation duration,
-            // schedule them at simulation end time as partial events (if enabled)
-            if (time_hours > simulation_duration_hours_ && type == EventType::CHARGING_COMPLETE && enable_partial_flights_)
+            // Only log events within simulation duration or partial events
+            if (scheduled_time <= simulation_duration_hours_)
             {
-                scheduled_time = simulation_duration_hours_;
-                is_partial_event = true;
+                log_event([&]
+                          {
+                    const char *event_type_str = "";
+                    switch (type) {
+                        case EventType::FLIGHT_COMPLETE: event_type_str = "FLIGHT_COMPLETE"; break;
+                        case EventType::CHARGING_COMPLETE: event_type_str = "CHARGING_COMPLETE"; break;
+                        case EventType::FAULT_OCCURRED: event_type_str = "FAULT_OCCURRED"; break;
+                    }
+
+                    int aircraft_id = std::visit([](const auto &event_data) -> int
+                                                 { return event_data.aircraft_id; }, data);
+
+                    std::string message = std::string(is_partial_event ? "Scheduled partial " : "Scheduled ") + event_type_str +
+                                          " event for aircraft " + std::to_string(aircraft_id) + " at time " + std::to_string(scheduled_time) + "h";
+                    if (is_partial_event)
+                    {
+                        message += " (originally " + std::to_string(time_hours) + "h)";
+                    }
+                    return message; });
             }
-            
-            // Only schedule if within simulation duration or it's a partial event
-            if (scheduled_time <= simulation_duration_hours_)
+
+            event_queue_.push(type, time_hours, std::move(data));
+        }
+
+        double get_current_time() const { return current_time_hours_; }
+        double get_duration() const { return simulation_duration_hours_; }
+
+        /**
+         * @param writer Trace to append to, owned by the caller; nullptr stops tracing
+         */
+        void set_trace_writer(TraceWriter *writer) { trace_writer_ = writer; }
+
+        /**
+         * Write checkpoints and/or resume from one in the following runs
+         */
+        void set_checkpoint_options(const CheckpointOptions &options) { checkpoint_options_ = options; }
+
+        /**
+         * Solve runs whose chargers never run out without the event queue (see UncontendedSolver)
+         * Only untraced, unlogged runs without checkpoints qualify; any other run uses the event queue.
+         */
+        void set_analytic_solver(bool enabled) { enable_analytic_solver_ = enabled; }
+
+        /**
+         * Whether the last run was solved by UncontendedSolver
+         */
+        bool solved_analytically() const { return solved_analytically_; }
+
+        /**
+         * Fault model the fleet samples flights with in the following runs (see fault_model.h)
+         */
+        void set_fault_model(FaultModel model) { fault_model_ = model; }
+
+        /**
+         * Count the following runs into counters (see profiler.h); nullptr stops profiling
+         * Has no effect unless built with EVTOL_PROFILE=1.
+         */
+        void set_profile(ProfileCounters *counters) { profile_ = counters; }
+
+        /**
+         * Publish progress snapshots of the following runs (see progress_monitor.h); nullptr stops publishing
+         */
+        void set_progress_channel(ProgressChannel *channel) { progress_ = channel; }
+
+        /**
+         * Current time, aircraft timelines and the event queue with its sequence numbers
+         */
+        void save_state(SnapshotWriter &out) const
+        {
+            out.begin_section(snapshot_tag("EVNT"));
+            out.write(current_time_hours_);
+            out.write_vector(timelines_);
+
+            std::vector<SimulationEvent> events = event_queue_.pending_events();
+            out.write(static_cast<std::uint64_t>(events.size()));
+            for (const SimulationEvent &event : events)
+            {
+                out.write(event.type);
+                out.write(event.time_hours);
+                out.write(event.sequence);
+                out.write(static_cast<std::uint8_t>(event.data.index()));
+                std::visit([&](const auto &event_data)
+                           { out.write(event_data); }, event.data);
+            }
+            out.write(event_queue_.get_next_sequence());
+        }
+
+        /**
+         * @param fleet_size Size of the fleet the events refer to
+         * @throws std::runtime_error for a corrupt section
+         */
+        void restore_state(SnapshotReader &in, size_t fleet_size)
+        {
+            in.expect_section(snapshot_tag("EVNT"));
+            current_time_hours_ = in.read<double>();
+            timelines_ = in.read_vector<AircraftTimeline>();
+            if (timelines_.size() != fleet_size)
+            {
+                throw std::runtime_error("Checkpoint aircraft timelines do not match the fleet");
+            }
+
+            auto event_count = in.read<std::uint64_t>();
+            std::vector<SimulationEvent> events;
+            events.reserve(static_cast<size_t>(std::min<std::uint64_t>(event_count, fleet_size * 3 + 1)));
+            for (std::uint64_t i = 0; i < event_count; ++i)
             {
-                std::string event_type_str;
-                switch (type) {
-                    case EventType::FLIGHT_COMPLETE: event_type_str = "FLIGHT_COMPLETE"; break;
-                    case EventType::CHARGING_COMPLETE: event_type_str = "CHARGING_COMPLETE"; break;
-                    case EventType::FAULT_OCCURRED: event_type_str = "FAULT_OCCURRED"; break;
+                auto type = in.read<EventType>();
+                auto time_hours = in.read<double>();
+                auto sequence = in.read<std::uint64_t>();
+                EventData data = read_event_data(in, in.read<std::uint8_t>());
+
+                size_t fleet_index = std::visit([](const auto &event_data)
+                                                { return event_data.fleet_index; }, data);
+                if (fleet_index >= fleet_size)
+                {
+                    throw std::runtime_error("Checkpoint event refers to an aircraft outside the fleet");
                 }
-                
-                int aircraft_id = std::visit([](const auto &data) -> int {
-                    using T = std::decay_t<decltype(data)>;
-                    if constexpr (std::is_same_v<T, FlightCompleteData>) {
-                        return data.aircraft_id;
-                    } else if constexpr (std::is_same_v<T, ChargingCompleteData>) {
-                        return data.aircraft_id;
-                    } else if constexpr (std::is_same_v<T, FaultData>) {
-                        return data.aircraft_id;
+                events.emplace_back(type, time_hours, std::move(data), sequence);
+            }
+            event_queue_.restore(std::move(events), in.read<std::uint64_t>());
+        }
+
+    private:
+        static EventData read_event_data(SnapshotReader &in, std::uint8_t alternative)
+        {
+            switch (alternative)
+            {
+            case 0:
+                return in.read<FlightCompleteData>();
+            case 1:
+                return in.read<ChargingCompleteData>();
+            case 2:
+                return in.read<FaultData>();
+            default:
+                throw std::runtime_error("Checkpoint has an unknown event type");
+            }
+        }
+
+        template <typename Fleet>
+        void write_due_checkpoints(const ChargerManager &charger_mgr, const Fleet &fleet, double time_hours)
+        {
+            while (checkpoints_.due(time_hours, simulation_duration_hours_))
+            {
+                double checkpoint_time = checkpoints_.take();
+                std::string path = checkpoint_file_name(checkpoint_options_.path_prefix, checkpoint_time);
+                write_checkpoint(path, {SimulationMode::EVENT_DRIVEN, checkpoint_time, 0.0, fleet.size()},
+                                 [&](SnapshotWriter &out)
+                                 { save_state(out); },
+                                 charger_mgr, fleet, stats_collector_);
+                log_event([&] { return "Checkpoint written: " + path; });
+            }
+        }
+
+        template <SimulationFleet Fleet>
+        bool try_solve_analytically(ChargerManager &charger_mgr, Fleet &fleet, ScopedPhaseTimer &phase_timer)
+        {
+            solved_analytically_ = false;
+            if (!enable_analytic_solver_ || trace_writer_ || enable_detailed_logging_ ||
+                checkpoint_options_.every_hours > 0.0 || current_time_hours_ != 0.0 || !event_queue_.empty())
+            {
+                return false;
+            }
+
+            UncontendedSolver solver(stats_recorder_, simulation_duration_hours_, enable_partial_flights_);
+            if (!solver.prepare(charger_mgr, fleet))
+            {
+                return false;
+            }
+            phase_timer.next(ProfilePhase::MAIN_LOOP);
+            solver.run(charger_mgr, fleet);
+            current_time_hours_ = simulation_duration_hours_;
+            solved_analytically_ = true;
+            if (ProfileCounters *profile = active_profile())
+            {
+                profile->begin_run(0.0);
+                profile->end_run(simulation_duration_hours_);
+            }
+            publish_progress(charger_mgr, true);
+            return true;
+        }
+
+        template <typename Fleet>
+        void run_events(ChargerManager &charger_mgr, Fleet &fleet, ScopedPhaseTimer &phase_timer)
+        {
+            ProfileCounters *profile = active_profile();
+            if (profile)
+            {
+                profile->begin_run(current_time_hours_);
+                profile->sample_charger_queue(current_time_hours_, charger_mgr.get_queue_size());
+            }
+            phase_timer.next(ProfilePhase::MAIN_LOOP);
+
+            // process events; peek first so events at the time limit stay queued for finalization
+            while (!event_queue_.empty())
+            {
+                double next_time = event_queue_.next_time();
+
+                // A checkpoint at time t holds every event before t
+                write_due_checkpoints(charger_mgr, fleet, next_time);
+
+                if (next_time >= simulation_duration_hours_)
+                {
+                    // Without partial activities, events past the limit are left unprocessed
+                    if (enable_partial_flights_ || next_time == simulation_duration_hours_)
+                    {
+                        log_event("Simulation time limit reached");
                     }
-                    return -1;
-                }, data);
-                
-                if (is_partial_event)
+                    break;
+                }
+
+                auto event = event_queue_.pop();
+                current_time_hours_ = event.time_hours;
+                if (profile)
                 {
-                    log_event("Scheduled partial " + event_type_str + " event for aircraft " + std::to_string(aircraft_id) + 
-                             " at time " + std::to_string(scheduled_time) + "h (originally " + std::to_string(time_hours) + "h)");
+                    profile->record_event(event.type, event_queue_.size() + 1); // depth it was popped at
                 }
-                else
+
+                process_event(event, charger_mgr, fleet);
+                if (profile)
                 {
-                    log_event("Scheduled " + event_type_str + " event for aircraft " + std::to_string(aircraft_id) + " at time " + std::to_string(scheduled_time) + "h");
+                    profile->sample_charger_queue(current_time_hours_, charger_mgr.get_queue_size());
                 }
-                
-                event_queue_.emplace(type, scheduled_time, data);
+                publish_progress(charger_mgr);
             }
-        }
+            write_due_checkpoints(charger_mgr, fleet, simulation_duration_hours_);
 
-        double get_current_time() const { return current_time_hours_; }
-        double get_duration() const { return simulation_duration_hours_; }
+            // Process any remaining activities at simulation end
+            phase_timer.next(ProfilePhase::FINALIZE);
+            log_event("=== Finalizing simulation ===");
+            finalize_simulation(fleet);
+            log_event("=== Simulation completed ===");
+            if (profile)
+            {
+                profile->end_run(simulation_duration_hours_);
+            }
+            publish_progress(charger_mgr, true);
+        }
 
-    private:
         template <typename Fleet>
         void schedule_initial_flights(Fleet &fleet)
         {
-            for (auto &aircraft : fleet)
+            fleet_index_.build(fleet);
+            timelines_.assign(fleet.size(), AircraftTimeline{});
+
+            for (size_t i = 0; i < fleet.size(); ++i)
             {
-                schedule_flight(aircraft.get());
+                schedule_flight(fleet, i);
             }
         }
 
-        template <typename Aircraft>
-        void schedule_flight(Aircraft *aircraft)
+        template <typename Fleet>
+        void schedule_flight(Fleet &fleet, size_t fleet_index)
         {
+            auto &&aircraft = fleet[fleet_index];
             double distance = aircraft->get_flight_distance_miles();
             double flight_time = aircraft->get_flight_time_hours();
 
-            log_event("Starting flight for aircraft " + std::to_string(aircraft->get_id()) + 
-                     " (distance: " + std::to_string(distance) + " miles, flight time: " + 
-                     std::to_string(flight_time) + "h)");
+            log_event([&] { return "Starting flight for aircraft " + std::to_string(aircraft->get_id()) + 
+                                  " (distance: " + std::to_string(distance) + " miles, flight time: " + 
+                                  std::to_string(flight_time) + "h)"; });
 
-            // Record flight start time
-            flight_start_times_[aircraft->get_id()] = current_time_hours_;
+            trace(aircraft->get_id(), TraceEventType::FLIGHT_START, aircraft->get_type(), flight_time, distance);
 
             double fault_time = aircraft->check_fault_during_flight(flight_time);
             bool fault_occurred = (fault_time >= 0.0);
 
+            AircraftTimeline &timeline = timelines_[fleet_index];
+            timeline.state = AircraftState::FLYING;
+            timeline.start_time_hours = current_time_hours_;
+            timeline.end_time_hours = current_time_hours_ + flight_time;
+            timeline.activity_hours = flight_time;
+            timeline.flight_distance_miles = distance;
+            timeline.fault_time_hours = fault_occurred ? current_time_hours_ + fault_time : -1.0;
+
             if (fault_occurred) {
-                log_event("Aircraft " + std::to_string(aircraft->get_id()) + " will experience fault at " + 
-                         std::to_string(fault_time) + "h into flight");
+                log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " will experience fault at " + 
+                                      std::to_string(fault_time) + "h into flight"; });
                 FaultData fault_data{
                     aircraft->get_id(),
+                    fleet_index,
                     fault_time};
                 schedule_event(EventType::FAULT_OCCURRED, current_time_hours_ + fault_time, fault_data);
             }
 
             FlightCompleteData flight_data{
                 aircraft->get_id(),
+                fleet_index,
                 flight_time,
                 distance,
                 fault_occurred};
 
-            schedule_event(EventType::FLIGHT_COMPLETE, current_time_hours_ + flight_time, flight_data);
+            schedule_event(EventType::FLIGHT_COMPLETE, timeline.end_time_hours, flight_data);
         }
 
         template <typename Fleet>
         void handle_flight_complete(const FlightCompleteData &data, ChargerManager &charger_mgr, Fleet &fleet)
         {
-            auto aircraft_it = std::find_if(fleet.begin(), fleet.end(),
-                                            [&](const auto &aircraft)
-                                            { return aircraft->get_id() == data.aircraft_id; });
-
-            if (aircraft_it != fleet.end())
-            {
-                auto &aircraft = *aircraft_it;
+            auto &&aircraft = fleet[data.fleet_index];
 
-                log_event("Aircraft " + std::to_string(data.aircraft_id) + " completed flight (" + 
-                         std::to_string(data.distance) + " miles, " + std::to_string(data.flight_time) + "h)");
+            log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " completed flight (" + 
+                                  std::to_string(data.distance) + " miles, " + std::to_string(data.flight_time) + "h)"; });
 
-                aircraft->discharge_battery();
+            aircraft->discharge_battery();
 
-                stats_collector_.record_flight(aircraft->get_type(), data.flight_time,
-                                               data.distance, aircraft->get_passenger_count());
+            stats_recorder_.record_flight(aircraft->get_type(), data.flight_time,
+                                           data.distance, aircraft->get_passenger_count());
+            trace(data.aircraft_id, TraceEventType::FLIGHT_COMPLETE, aircraft->get_type(), data.flight_time, data.distance);
 
-                // Clean up flight start time tracking
-                flight_start_times_.erase(data.aircraft_id);
-
-                if (!aircraft->is_faulty())
+            AircraftTimeline &timeline = timelines_[data.fleet_index];
+            if (!aircraft->is_faulty())
+            {
+                if (charger_mgr.request_charger(aircraft->get_id()))
                 {
-                    if (charger_mgr.request_charger(aircraft->get_id()))
-                    {
-                        log_event("Aircraft " + std::to_string(data.aircraft_id) + " assigned to charger immediately");
-                        schedule_charging(aircraft.get(), 0.0);
-                    }
-                    else
-                    {
-                        log_event("Aircraft " + std::to_string(data.aircraft_id) + " added to charging queue (no chargers available)");
-                        charger_mgr.add_to_queue(aircraft->get_id());
-                        waiting_start_times_[aircraft->get_id()] = current_time_hours_;
-                    }
+                    log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " assigned to charger immediately"; });
+                    stats_recorder_.record_queue_length(aircraft->get_type(), 0);
+                    schedule_charging(fleet, data.fleet_index, 0.0);
                 }
                 else
                 {
-                    log_event("Aircraft " + std::to_string(data.aircraft_id) + " is faulty - not scheduling charging");
+                    log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " added to charging queue (no chargers available)"; });
+                    int queue_length = charger_mgr.get_queue_size(charger_mgr.get_home_pool(aircraft->get_id()));
+                    stats_recorder_.record_queue_length(aircraft->get_type(), queue_length);
+                    trace(data.aircraft_id, TraceEventType::CHARGER_QUEUED, aircraft->get_type(), queue_length);
+                    charger_mgr.queue_for_charger(aircraft);
+                    timeline.state = AircraftState::WAITING_FOR_CHARGER;
+                    timeline.start_time_hours = current_time_hours_;
                 }
             }
+            else
+            {
+                log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " is faulty - not scheduling charging"; });
+                timeline.state = AircraftState::FAULT;
+            }
         }
 
         template <typename Fleet>
         void handle_charging_complete(const ChargingCompleteData &data, ChargerManager &charger_mgr, Fleet &fleet)
         {
-            auto aircraft_it = std::find_if(fleet.begin(), fleet.end(),
-                                            [&](const auto &aircraft)
-                                            { return aircraft->get_id() == data.aircraft_id; });
-
-            if (aircraft_it != fleet.end())
-            {
-                auto &aircraft = *aircraft_it;
+            auto &&aircraft = fleet[data.fleet_index];
 
-                log_event("Aircraft " + std::to_string(data.aircraft_id) + " completed charging (" + 
-                         std::to_string(data.charge_time) + "h charge, " + std::to_string(data.waiting_time) + "h wait)");
+            log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " completed charging (" + 
+                                  std::to_string(data.charge_time) + "h charge, " + std::to_string(data.waiting_time) + "h wait)"; });
 
-                aircraft->charge_battery();
+            aircraft->charge_battery();
 
-                stats_collector_.record_charge_session(aircraft->get_type(), data.charge_time, data.waiting_time);
+            stats_recorder_.record_charge_session(aircraft->get_type(), data.charge_time, data.waiting_time);
+            trace(data.aircraft_id, TraceEventType::CHARGE_COMPLETE, aircraft->get_type(), data.charge_time, data.waiting_time);
 
-                // Clean up charging start time tracking
-                charging_start_times_.erase(data.aircraft_id);
+            timelines_[data.fleet_index].state = AircraftState::IDLE;
 
-                if (current_time_hours_ < simulation_duration_hours_ && !aircraft->is_faulty())
-                {
-                    log_event("Aircraft " + std::to_string(data.aircraft_id) + " ready for next flight");
-                    schedule_flight(aircraft.get());
-                }
-                else if (current_time_hours_ >= simulation_duration_hours_)
-                {
-                    log_event("Aircraft " + std::to_string(data.aircraft_id) + " charging complete but simulation time exceeded");
-                }
+            if (current_time_hours_ < simulation_duration_hours_ && !aircraft->is_faulty())
+            {
+                log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " ready for next flight"; });
+                schedule_flight(fleet, data.fleet_index);
+            }
+            else if (current_time_hours_ >= simulation_duration_hours_)
+            {
+                log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " charging complete but simulation time exceeded"; });
+            }
 
-                // start charging any waiting aircraft
-                int next_aircraft_id = charger_mgr.get_next_from_queue();
-                if (next_aircraft_id != -1)
+            // start charging any waiting aircraft
+            int next_aircraft_id = charger_mgr.get_next_from_queue(charger_mgr.get_home_pool(aircraft->get_id()));
+            if (next_aircraft_id != -1)
+            {
+                size_t next_index = fleet_index_.index_of(next_aircraft_id);
+                if (next_index != FleetIndex::npos)
                 {
-                    auto next_aircraft_it = fleet.end();
-                    for (auto it = fleet.begin(); it != fleet.end(); ++it)
-                    {
-                        if ((*it)->get_id() == next_aircraft_id)
-                        {
-                            next_aircraft_it = it;
-                            break;
-                        }
-                    }
-
-                    if (next_aircraft_it != fleet.end())
+                    charger_mgr.assign_charger(next_aircraft_id);
+                    
+                    double waiting_time = 0.0;
+                    const AircraftTimeline &waiting = timelines_[next_index];
+                    if (waiting.state == AircraftState::WAITING_FOR_CHARGER)
                     {
-                        charger_mgr.assign_charger(next_aircraft_id);
-                        
-                        double waiting_time = 0.0;
-                        auto waiting_it = waiting_start_times_.find(next_aircraft_id);
-                        if (waiting_it != waiting_start_times_.end())
-                        {
-                            waiting_time = current_time_hours_ - waiting_it->second;
-                            waiting_start_times_.erase(waiting_it);
-                        }
-                        
-                        log_event("Aircraft " + std::to_string(next_aircraft_id) + " removed from queue and assigned charger (waited " + 
-                                 std::to_string(waiting_time) + "h)");
-                        schedule_charging(next_aircraft_it->get(), waiting_time);
+                        waiting_time = current_time_hours_ - waiting.start_time_hours;
                     }
+                    
+                    log_event([&] { return "Aircraft " + std::to_string(next_aircraft_id) + " removed from queue and assigned charger (waited " + 
+                                          std::to_string(waiting_time) + "h)"; });
+                    schedule_charging(fleet, next_index, waiting_time);
                 }
-                else
-                {
-                    log_event("Charger freed but no aircraft waiting in queue");
-                }
+            }
+            else
+            {
+                log_event("Charger freed but no aircraft waiting in queue");
             }
         }
 
         template <typename Fleet>
         void handle_fault(const FaultData &data, Fleet &fleet)
         {
-            auto aircraft_it = std::find_if(fleet.begin(), fleet.end(),
-                                            [&](const auto &aircraft)
-                                            { return aircraft->get_id() == data.aircraft_id; });
-
-            if (aircraft_it != fleet.end())
-            {
-                auto &aircraft = *aircraft_it;
-                log_event("Aircraft " + std::to_string(data.aircraft_id) + " experienced fault during flight - aircraft grounded");
-                aircraft->set_faulty(true);
-                stats_collector_.record_fault(aircraft->get_type());
-            }
+            auto &&aircraft = fleet[data.fleet_index];
+            log_event([&] { return "Aircraft " + std::to_string(data.aircraft_id) + " experienced fault during flight - aircraft grounded"; });
+            aircraft->set_faulty(true);
+            timelines_[data.fleet_index].fault_time_hours = -1.0;
+            stats_recorder_.record_fault(aircraft->get_type());
+            trace(data.aircraft_id, TraceEventType::FAULT, aircraft->get_type(), data.fault_time);
         }
 
-        template <typename Aircraft>
-        void schedule_charging(Aircraft *aircraft, double waiting_time)
+        template <typename Fleet>
+        void schedule_charging(Fleet &fleet, size_t fleet_index, double waiting_time)
         {
+            auto &&aircraft = fleet[fleet_index];
             double charge_time = aircraft->get_charge_time_hours();
 
-            log_event("Starting charging for aircraft " + std::to_string(aircraft->get_id()) + 
-                     " (charge time: " + std::to_string(charge_time) + "h, waited: " + 
-                     std::to_string(waiting_time) + "h)");
+            log_event([&] { return "Starting charging for aircraft " + std::to_string(aircraft->get_id()) + 
+                                  " (charge time: " + std::to_string(charge_time) + "h, waited: " + 
+                                  std::to_string(waiting_time) + "h)"; });
 
-            // Record charging start time
-            charging_start_times_[aircraft->get_id()] = current_time_hours_;
+            AircraftTimeline &timeline = timelines_[fleet_index];
+            timeline.state = AircraftState::CHARGING;
+            timeline.start_time_hours = current_time_hours_;
+            timeline.end_time_hours = current_time_hours_ + charge_time;
+            timeline.activity_hours = charge_time;
+            timeline.waiting_time_hours = waiting_time;
+            trace(aircraft->get_id(), TraceEventType::CHARGE_START, aircraft->get_type(), charge_time, waiting_time);
 
             ChargingCompleteData charge_data{
                 aircraft->get_id(),
+                fleet_index,
                 charge_time,
                 waiting_time};
 
-            schedule_event(EventType::CHARGING_COMPLETE,
-                           current_time_hours_ + charge_time,
-                           charge_data);
+            schedule_event(EventType::CHARGING_COMPLETE, timeline.end_time_hours, charge_data);
         }
 
         template <typename Fleet>
@@ -405,90 +680,59 @@ namespace evtol
             // Set current time to simulation end for partial calculation
             current_time_hours_ = simulation_duration_hours_;
 
-            // Process remaining unprocessed events to record partial activities
-            while (!event_queue_.empty())
+            // Flights and charges still under way end as partial activities, in fleet order; ones due
+            // past the limit only count with partial activities enabled
+            for (size_t i = 0; i < timelines_.size(); ++i)
             {
-                auto event = event_queue_.top();
-                event_queue_.pop();
-
-                std::visit([&](const auto &data)
+                const AircraftTimeline &timeline = timelines_[i];
+                bool counts = timeline.end_time_hours <= simulation_duration_hours_ || enable_partial_flights_;
+                if (timeline.state == AircraftState::FLYING && counts)
                 {
-                    using T = std::decay_t<decltype(data)>;
-                    
-                    if constexpr (std::is_same_v<T, FlightCompleteData>) {
-                        handle_partial_flight(data, fleet);
-                    } else if constexpr (std::is_same_v<T, ChargingCompleteData>) {
-                        handle_partial_charge(data, fleet);
-                    }
-                }, event.data);
+                    handle_partial_flight(fleet, i, timeline);
+                }
+                else if (timeline.state == AircraftState::CHARGING && counts)
+                {
+                    handle_partial_charge(fleet, i, timeline);
+                }
             }
+            event_queue_.clear();
         }
 
         template <typename Fleet>
-        void handle_partial_flight(const FlightCompleteData &data, Fleet &fleet)
+        void handle_partial_flight(Fleet &fleet, size_t fleet_index, const AircraftTimeline &timeline)
         {
-            auto aircraft_it = std::find_if(fleet.begin(), fleet.end(),
-                                            [&](const auto &aircraft)
-                                            { return aircraft->get_id() == data.aircraft_id; });
+            auto &&aircraft = fleet[fleet_index];
+            double partial_flight_time = simulation_duration_hours_ - timeline.start_time_hours;
 
-            if (aircraft_it != fleet.end())
-            {
-                auto &aircraft = *aircraft_it;
-                
-                // Find flight start time
-                auto start_it = flight_start_times_.find(data.aircraft_id);
-                if (start_it != flight_start_times_.end())
-                {
-                    double flight_start_time = start_it->second;
-                    double partial_flight_time = simulation_duration_hours_ - flight_start_time;
-                    
-                    // Calculate partial distance based on partial flight time
-                    double partial_distance = (partial_flight_time / data.flight_time) * data.distance;
-                    
-                    if (enable_detailed_logging_)
-                    {
-                        log_event("Processing partial flight for aircraft " + std::to_string(data.aircraft_id) + 
-                                 " (flew " + std::to_string(partial_flight_time) + "h/" + std::to_string(data.flight_time) + 
-                                 "h, " + std::to_string(partial_distance) + "/" + std::to_string(data.distance) + " miles)");
-                    }
-                    
-                    stats_collector_.record_partial_flight(aircraft->get_type(), partial_flight_time,
-                                                          partial_distance, aircraft->get_passenger_count());
-                }
-            }
+            // Calculate partial distance based on partial flight time
+            double partial_distance = (partial_flight_time / timeline.activity_hours) * timeline.flight_distance_miles;
+
+            log_event([&] { return "Processing partial flight for aircraft " + std::to_string(aircraft->get_id()) + 
+                                  " (flew " + std::to_string(partial_flight_time) + "h/" + std::to_string(timeline.activity_hours) + 
+                                  "h, " + std::to_string(partial_distance) + "/" + std::to_string(timeline.flight_distance_miles) + " miles)"; });
+
+            stats_recorder_.record_partial_flight(aircraft->get_type(), partial_flight_time,
+                                                  partial_distance, aircraft->get_passenger_count());
+            trace(aircraft->get_id(), TraceEventType::PARTIAL_FLIGHT, aircraft->get_type(), partial_flight_time, partial_distance);
         }
 
         template <typename Fleet>
-        void handle_partial_charge(const ChargingCompleteData &data, Fleet &fleet)
+        void handle_partial_charge(Fleet &fleet, size_t fleet_index, const AircraftTimeline &timeline)
         {
-            auto aircraft_it = std::find_if(fleet.begin(), fleet.end(),
-                                            [&](const auto &aircraft)
-                                            { return aircraft->get_id() == data.aircraft_id; });
+            auto &&aircraft = fleet[fleet_index];
+            double partial_charge_time = simulation_duration_hours_ - timeline.start_time_hours;
 
-            if (aircraft_it != fleet.end())
-            {
-                auto &aircraft = *aircraft_it;
-                
-                // Find charging start time
-                auto start_it = charging_start_times_.find(data.aircraft_id);
-                if (start_it != charging_start_times_.end())
-                {
-                    double charge_start_time = start_it->second;
-                    double partial_charge_time = simulation_duration_hours_ - charge_start_time;
-                    
-                    if (enable_detailed_logging_)
-                    {
-                        log_event("Processing partial charge for aircraft " + std::to_string(data.aircraft_id) + 
-                                 " (charged " + std::to_string(partial_charge_time) + "h/" + std::to_string(data.charge_time) + 
-                                 "h, waited: " + std::to_string(data.waiting_time) + "h)");
-                    }
-                    
-                    stats_collector_.record_partial_charge(aircraft->get_type(), partial_charge_time);
-                }
-            }
+            log_event([&] { return "Processing partial charge for aircraft " + std::to_string(aircraft->get_id()) + 
+                                  " (charged " + std::to_string(partial_charge_time) + "h/" + std::to_string(timeline.activity_hours) + 
+                                  "h, waited: " + std::to_string(timeline.waiting_time_hours) + "h)"; });
+
+            stats_recorder_.record_partial_charge(aircraft->get_type(), partial_charge_time);
+            trace(aircraft->get_id(), TraceEventType::PARTIAL_CHARGE, aircraft->get_type(), partial_charge_time);
         }
     };
 
+    using EventDrivenSimulation = BasicEventDrivenSimulation<BinaryHeapScheduler<EventData>>;
+
     /**
      * Event-driven simulation engine with complete simulation logic
      * This provides a consistent interface for the simulation factory and runner
@@ -496,30 +740,109 @@ namespace evtol
     class EventDrivenSimulationEngine : public SimulationEngineBase
     {
     private:
-        std::unique_ptr<EventDrivenSimulation> simulation_;
+        using SimulationVariant = std::variant<
+            std::unique_ptr<BasicEventDrivenSimulation<BinaryHeapScheduler<EventData>>>,
+            std::unique_ptr<BasicEventDrivenSimulation<QuaternaryHeapScheduler<EventData>>>,
+            std::unique_ptr<BasicEventDrivenSimulation<CalendarQueueScheduler<EventData>>>>;
+
+        SimulationVariant simulation_;
+        EventSchedulerType scheduler_type_;
+
+        static SimulationVariant make_simulation(EventSchedulerType scheduler, StatisticsCollector &stats, double duration_hours,
+                                                 bool detailed_logging, bool partial_flights, std::optional<std::uint64_t> random_seed)
+        {
+            switch (scheduler)
+            {
+            case EventSchedulerType::QUATERNARY_HEAP:
+                return std::make_unique<BasicEventDrivenSimulation<QuaternaryHeapScheduler<EventData>>>(
+                    stats, duration_hours, detailed_logging, partial_flights, random_seed);
+            case EventSchedulerType::CALENDAR_QUEUE:
+                return std::make_unique<BasicEventDrivenSimulation<CalendarQueueScheduler<EventData>>>(
+                    stats, duration_hours, detailed_logging, partial_flights, random_seed);
+            case EventSchedulerType::BINARY_HEAP:
+            default:
+                return std::make_unique<BasicEventDrivenSimulation<BinaryHeapScheduler<EventData>>>(
+                    stats, duration_hours, detailed_logging, partial_flights, random_seed);
+            }
+        }
 
     public:
-        EventDrivenSimulationEngine(StatisticsCollector &stats, double duration_hours = 3.0, bool detailed_logging = false, bool partial_flights = true)
+        EventDrivenSimulationEngine(StatisticsCollector &stats, double duration_hours = 3.0, bool detailed_logging = false, bool partial_flights = true,
+                                    std::optional<std::uint64_t> random_seed = std::nullopt,
+                                    EventSchedulerType scheduler = EventSchedulerType::BINARY_HEAP,
+                                    bool analytic_solver = false,
+                                    FaultModel fault_model = FaultModel::LINEAR)
             : SimulationEngineBase(stats, duration_hours), 
-              simulation_(std::make_unique<EventDrivenSimulation>(stats, duration_hours, detailed_logging, partial_flights))
+              simulation_(make_simulation(scheduler, stats, duration_hours, detailed_logging, partial_flights, random_seed)),
+              scheduler_type_(scheduler)
         {
+            std::visit([&](auto &simulation)
+                       {
+                simulation->set_analytic_solver(analytic_solver);
+                simulation->set_fault_model(fault_model); }, simulation_);
         }
 
-    protected:
-        void run_simulation_impl(ChargerManager &charger_mgr, void *fleet_ptr) override
+        EventSchedulerType get_scheduler_type() const { return scheduler_type_; }
+
+        /**
+         * Whether the last run was solved without the event queue (see UncontendedSolver)
+         */
+        bool solved_analytically() const
+        {
+            return std::visit([](const auto &simulation)
+                              { return simulation->solved_analytically(); }, simulation_);
+        }
+
+        void set_trace_writer(TraceWriter *writer) override
+        {
+            SimulationEngineBase::set_trace_writer(writer);
+            std::visit([&](auto &simulation)
+                       { simulation->set_trace_writer(writer); }, simulation_);
+        }
+
+        void set_checkpoint_options(const CheckpointOptions &options) override
+        {
+            SimulationEngineBase::set_checkpoint_options(options);
+            std::visit([&](auto &simulation)
+                       { simulation->set_checkpoint_options(options); }, simulation_);
+        }
+
+        void set_profile(ProfileCounters *counters) override
+        {
+            SimulationEngineBase::set_profile(counters);
+            std::visit([&](auto &simulation)
+                       { simulation->set_profile(counters); }, simulation_);
+        }
+
+        void set_progress_channel(ProgressChannel *channel) override
+        {
+            SimulationEngineBase::set_progress_channel(channel);
+            std::visit([&](auto &simulation)
+                       { simulation->set_progress_channel(channel); }, simulation_);
+        }
+
+        /**
+         * Run on any fleet container; statically dispatched, so the fleet's calls inline into the event loop
+         */
+        template <SimulationFleet Fleet>
+        void run(ChargerManager &charger_mgr, Fleet &fleet)
         {
             is_running_ = true;
 
-            // Type-erase back to template - this is a limitation of the current design
-            // In a real implementation, we might use std::function or type erasure
-            // For now, we'll use a simple approach
-            auto *fleet = static_cast<std::vector<std::unique_ptr<AircraftBase>> *>(fleet_ptr);
-            simulation_->run_simulation(charger_mgr, *fleet);
+            std::visit([&](auto &simulation)
+                       {
+                simulation->run_simulation(charger_mgr, fleet);
 
-            // Update our time tracking from the simulation
-            current_time_hours_ = simulation_->get_current_time();
+                // Update our time tracking from the simulation
+                current_time_hours_ = simulation->get_current_time(); }, simulation_);
             
             is_running_ = false;
         }
+
+    protected:
+        void run_simulation_impl(ChargerManager &charger_mgr, AircraftFleet &fleet) override
+        {
+            run(charger_mgr, fleet);
+        }
     };
 }
\ No newline at end of file
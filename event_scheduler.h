@@ -0,0 +1,572 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace evtol
+{
+    enum class EventType
+    {
+        FLIGHT_COMPLETE,
+        CHARGING_COMPLETE,
+        FAULT_OCCURRED
+    };
+
+    template <typename T>
+    struct Event
+    {
+        EventType type;
+        double time_hours;
+        T data;
+        std::uint64_t sequence; // insertion order, breaks ties between events at the same time
+
+        Event(EventType t, double time, T d, std::uint64_t seq = 0)
+            : type(t), time_hours(time), data(std::move(d)), sequence(seq) {}
+
+        bool operator<(const Event &other) const
+        {
+            if (time_hours != other.time_hours)
+            {
+                return time_hours > other.time_hours;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    /**
+     * Event queue implementations selectable via SimulationConfig
+     */
+    enum class EventSchedulerType
+    {
+        BINARY_HEAP,
+        QUATERNARY_HEAP,
+        CALENDAR_QUEUE
+    };
+
+    inline const char *scheduler_type_to_string(EventSchedulerType type)
+    {
+        switch (type)
+        {
+        case EventSchedulerType::BINARY_HEAP:
+            return "heap";
+        case EventSchedulerType::QUATERNARY_HEAP:
+            return "4-ary";
+        case EventSchedulerType::CALENDAR_QUEUE:
+            return "calendar";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Parse a scheduler name as accepted by --scheduler
+     * @throws std::invalid_argument for unknown names
+     */
+    inline EventSchedulerType parse_scheduler_type(const std::string &name)
+    {
+        if (name == "heap")
+            return EventSchedulerType::BINARY_HEAP;
+        if (name == "4-ary" || name == "dary")
+            return EventSchedulerType::QUATERNARY_HEAP;
+        if (name == "calendar")
+            return EventSchedulerType::CALENDAR_QUEUE;
+        throw std::invalid_argument("Unknown event scheduler: " + name);
+    }
+
+    /**
+     * What EventDrivenSimulation needs from an event queue
+     * Events come out ordered by (time, insertion order), so every scheduler yields the same
+     * event sequence and therefore bit-identical simulation results. pending_events and restore
+     * let checkpoints save and reload a queue, keeping every event's sequence number.
+     */
+    template <typename Scheduler>
+    concept EventScheduler = requires(Scheduler &scheduler, const Scheduler &const_scheduler,
+                                      EventType type, double time, typename Scheduler::payload_type data) {
+        scheduler.push(type, time, std::move(data));
+        { scheduler.pop() } -> std::same_as<Event<typename Scheduler::payload_type>>;
+        { const_scheduler.next_time() } -> std::convertible_to<double>;
+        { const_scheduler.empty() } -> std::convertible_to<bool>;
+        { const_scheduler.size() } -> std::convertible_to<size_t>;
+        scheduler.clear();
+        { const_scheduler.pending_events() } -> std::same_as<std::vector<Event<typename Scheduler::payload_type>>>;
+        { const_scheduler.get_next_sequence() } -> std::convertible_to<std::uint64_t>;
+        scheduler.restore(std::vector<Event<typename Scheduler::payload_type>>{}, std::uint64_t{0});
+    };
+
+    /**
+     * Queued events in insertion order, for checkpoints
+     */
+    template <typename T>
+    void sort_by_sequence(std::vector<Event<T>> &events)
+    {
+        std::sort(events.begin(), events.end(), [](const Event<T> &a, const Event<T> &b)
+                  { return a.sequence < b.sequence; });
+    }
+
+    /**
+     * Binary heap of full events, the original scheduler
+     * Same algorithm as the std::priority_queue it started as, on a vector that checkpoints can read.
+     */
+    template <typename T>
+    class BinaryHeapScheduler
+    {
+    private:
+        std::vector<Event<T>> heap_;
+        std::uint64_t next_sequence_ = 0;
+
+    public:
+        using payload_type = T;
+
+        void push(EventType type, double time_hours, T data)
+        {
+            heap_.emplace_back(type, time_hours, std::move(data), next_sequence_++);
+            std::push_heap(heap_.begin(), heap_.end());
+        }
+
+        Event<T> pop()
+        {
+            std::pop_heap(heap_.begin(), heap_.end());
+            Event<T> event = std::move(heap_.back());
+            heap_.pop_back();
+            return event;
+        }
+
+        double next_time() const { return heap_.front().time_hours; }
+        bool empty() const { return heap_.empty(); }
+        size_t size() const { return heap_.size(); }
+
+        void clear()
+        {
+            heap_.clear();
+            next_sequence_ = 0;
+        }
+
+        std::vector<Event<T>> pending_events() const
+        {
+            std::vector<Event<T>> events = heap_;
+            sort_by_sequence(events);
+            return events;
+        }
+
+        std::uint64_t get_next_sequence() const { return next_sequence_; }
+
+        /**
+         * Replace the queue with saved events, keeping their sequence numbers
+         */
+        void restore(std::vector<Event<T>> events, std::uint64_t next_sequence)
+        {
+            heap_ = std::move(events);
+            std::make_heap(heap_.begin(), heap_.end());
+            next_sequence_ = next_sequence;
+        }
+    };
+
+    /**
+     * Compact ordering key; the payload lives in a separate slot table
+     */
+    struct EventKey
+    {
+        double time_hours;
+        std::uint64_t sequence;
+        std::uint32_t slot;
+
+        bool operator<(const EventKey &other) const
+        {
+            if (time_hours != other.time_hours)
+            {
+                return time_hours < other.time_hours;
+            }
+            return sequence < other.sequence;
+        }
+    };
+
+    /**
+     * Off-heap payload storage with slot reuse
+     */
+    template <typename T>
+    class EventSlotTable
+    {
+    private:
+        std::vector<EventType> types_;
+        std::vector<T> payloads_;
+        std::vector<std::uint32_t> free_slots_;
+
+    public:
+        std::uint32_t store(EventType type, T data)
+        {
+            if (!free_slots_.empty())
+            {
+                std::uint32_t slot = free_slots_.back();
+                free_slots_.pop_back();
+                types_[slot] = type;
+                payloads_[slot] = std::move(data);
+                return slot;
+            }
+
+            types_.push_back(type);
+            payloads_.push_back(std::move(data));
+            return static_cast<std::uint32_t>(payloads_.size() - 1);
+        }
+
+        Event<T> peek(const EventKey &key) const
+        {
+            return Event<T>(types_[key.slot], key.time_hours, payloads_[key.slot], key.sequence);
+        }
+
+        Event<T> release(const EventKey &key)
+        {
+            free_slots_.push_back(key.slot);
+            return Event<T>(types_[key.slot], key.time_hours, std::move(payloads_[key.slot]), key.sequence);
+        }
+
+        void clear()
+        {
+            types_.clear();
+            payloads_.clear();
+            free_slots_.clear();
+        }
+    };
+
+    /**
+     * Implicit d-ary min-heap of EventKey with payloads stored off-heap
+     * Sifting moves 24-byte keys instead of whole events, and the wider fan-out halves the tree depth.
+     */
+    template <typename T, size_t Arity = 4>
+    class DaryHeapScheduler
+    {
+        static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    private:
+        std::vector<EventKey> heap_;
+        EventSlotTable<T> slots_;
+        std::uint64_t next_sequence_ = 0;
+
+        void sift_up(size_t index)
+        {
+            EventKey key = heap_[index];
+            while (index > 0)
+            {
+                size_t parent = (index - 1) / Arity;
+                if (!(key < heap_[parent]))
+                {
+                    break;
+                }
+                heap_[index] = heap_[parent];
+                index = parent;
+            }
+            heap_[index] = key;
+        }
+
+        void sift_down(size_t index)
+        {
+            EventKey key = heap_[index];
+            size_t count = heap_.size();
+            while (true)
+            {
+                size_t first_child = index * Arity + 1;
+                if (first_child >= count)
+                {
+                    break;
+                }
+
+                size_t last_child = std::min(first_child + Arity, count);
+                size_t best = first_child;
+                for (size_t child = first_child + 1; child < last_child; ++child)
+                {
+                    if (heap_[child] < heap_[best])
+                    {
+                        best = child;
+                    }
+                }
+
+                if (!(heap_[best] < key))
+                {
+                    break;
+                }
+                heap_[index] = heap_[best];
+                index = best;
+            }
+            heap_[index] = key;
+        }
+
+    public:
+        using payload_type = T;
+
+        void push(EventType type, double time_hours, T data)
+        {
+            insert(type, time_hours, std::move(data), next_sequence_++);
+        }
+
+        // push with a saved sequence number, used by restore
+        void insert(EventType type, double time_hours, T data, std::uint64_t sequence)
+        {
+            std::uint32_t slot = slots_.store(type, std::move(data));
+            heap_.push_back({time_hours, sequence, slot});
+            sift_up(heap_.size() - 1);
+        }
+
+        Event<T> pop()
+        {
+            EventKey top = heap_.front();
+            heap_.front() = heap_.back();
+            heap_.pop_back();
+            if (!heap_.empty())
+            {
+                sift_down(0);
+            }
+            return slots_.release(top);
+        }
+
+        double next_time() const { return heap_.front().time_hours; }
+        bool empty() const { return heap_.empty(); }
+        size_t size() const { return heap_.size(); }
+
+        void clear()
+        {
+            heap_.clear();
+            slots_.clear();
+            next_sequence_ = 0;
+        }
+
+        std::vector<Event<T>> pending_events() const
+        {
+            std::vector<Event<T>> events;
+            events.reserve(heap_.size());
+            for (const EventKey &key : heap_)
+            {
+                events.push_back(slots_.peek(key));
+            }
+            sort_by_sequence(events);
+            return events;
+        }
+
+        std::uint64_t get_next_sequence() const { return next_sequence_; }
+
+        /**
+         * Replace the queue with saved events, keeping their sequence numbers
+         */
+        void restore(std::vector<Event<T>> events, std::uint64_t next_sequence)
+        {
+            clear();
+            for (Event<T> &event : events)
+            {
+                insert(event.type, event.time_hours, std::move(event.data), event.sequence);
+            }
+            next_sequence_ = next_sequence;
+        }
+    };
+
+    template <typename T>
+    using QuaternaryHeapScheduler = DaryHeapScheduler<T, 4>;
+
+    /**
+     * Calendar queue (Brown, "Calendar Queues: A Fast O(1) Priority Queue Implementation
+     * for the Simulation Event Set Problem", CACM 1988)
+     * Time is cut into buckets of a fixed width that wrap around like days of a year. Each bucket
+     * is a small heap, so the many same-time events of a large fleet do not degrade to linear
+     * inserts. The bucket count follows the queue size and the width is re-estimated from the
+     * spacing of the earliest events on every resize.
+     */
+    template <typename T>
+    class CalendarQueueScheduler
+    {
+    private:
+        static constexpr size_t MIN_BUCKETS = 16;
+        static constexpr size_t WIDTH_SAMPLE = 32;
+
+        using Bucket = std::vector<EventKey>;
+
+        std::vector<Bucket> buckets_ = std::vector<Bucket>(MIN_BUCKETS);
+        double bucket_width_ = 1.0;
+        mutable std::int64_t current_day_ = 0; // absolute bucket number of the last dequeue
+        size_t size_ = 0;
+
+        EventSlotTable<T> slots_;
+        std::uint64_t next_sequence_ = 0;
+
+        static bool later(const EventKey &a, const EventKey &b) { return b < a; }
+
+        std::int64_t day_of(double time_hours) const
+        {
+            return static_cast<std::int64_t>(std::floor(std::max(time_hours, 0.0) / bucket_width_));
+        }
+
+        size_t bucket_index(std::int64_t day) const
+        {
+            return static_cast<size_t>(day) % buckets_.size();
+        }
+
+        void insert_key(const EventKey &key)
+        {
+            Bucket &bucket = buckets_[bucket_index(day_of(key.time_hours))];
+            bucket.push_back(key);
+            std::push_heap(bucket.begin(), bucket.end(), later);
+        }
+
+        /**
+         * Index of the bucket holding the earliest event; advances current_day_ to that event's day
+         */
+        size_t find_next_bucket() const
+        {
+            // Scan one year of days from the current one
+            for (size_t step = 0; step < buckets_.size(); ++step)
+            {
+                size_t index = bucket_index(current_day_);
+                const Bucket &bucket = buckets_[index];
+                if (!bucket.empty() && day_of(bucket.front().time_hours) <= current_day_)
+                {
+                    return index;
+                }
+                ++current_day_;
+            }
+
+            // Sparse queue: jump straight to the globally earliest event
+            size_t earliest = buckets_.size();
+            for (size_t index = 0; index < buckets_.size(); ++index)
+            {
+                const Bucket &bucket = buckets_[index];
+                if (!bucket.empty() && (earliest == buckets_.size() || bucket.front() < buckets_[earliest].front()))
+                {
+                    earliest = index;
+                }
+            }
+            current_day_ = day_of(buckets_[earliest].front().time_hours);
+            return earliest;
+        }
+
+        void resize(size_t bucket_count)
+        {
+            std::vector<EventKey> keys;
+            keys.reserve(size_);
+            for (Bucket &bucket : buckets_)
+            {
+                keys.insert(keys.end(), bucket.begin(), bucket.end());
+            }
+
+            // Width ~ 3x the average gap between distinct times among the earliest events
+            size_t sample = std::min(keys.size(), WIDTH_SAMPLE);
+            if (sample >= 2)
+            {
+                std::partial_sort(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(sample), keys.end());
+                double gap_sum = 0.0;
+                size_t gap_count = 0;
+                for (size_t i = 1; i < sample; ++i)
+                {
+                    double gap = keys[i].time_hours - keys[i - 1].time_hours;
+                    if (gap > 0.0)
+                    {
+                        gap_sum += gap;
+                        ++gap_count;
+                    }
+                }
+                if (gap_count > 0)
+                {
+                    bucket_width_ = 3.0 * gap_sum / static_cast<double>(gap_count);
+                }
+            }
+
+            buckets_.assign(bucket_count, Bucket{});
+            current_day_ = keys.empty() ? 0 : day_of(std::min_element(keys.begin(), keys.end())->time_hours);
+            for (const EventKey &key : keys)
+            {
+                insert_key(key);
+            }
+        }
+
+    public:
+        using payload_type = T;
+
+        void push(EventType type, double time_hours, T data)
+        {
+            insert(type, time_hours, std::move(data), next_sequence_++);
+        }
+
+        // push with a saved sequence number, used by restore
+        void insert(EventType type, double time_hours, T data, std::uint64_t sequence)
+        {
+            EventKey key{time_hours, sequence, slots_.store(type, std::move(data))};
+
+            std::int64_t day = day_of(time_hours);
+            if (day < current_day_)
+            {
+                current_day_ = day;
+            }
+            insert_key(key);
+            ++size_;
+
+            if (size_ > 2 * buckets_.size())
+            {
+                resize(2 * buckets_.size());
+            }
+        }
+
+        Event<T> pop()
+        {
+            Bucket &bucket = buckets_[find_next_bucket()];
+            std::pop_heap(bucket.begin(), bucket.end(), later);
+            EventKey key = bucket.back();
+            bucket.pop_back();
+            --size_;
+
+            if (buckets_.size() > MIN_BUCKETS && size_ < buckets_.size() / 2)
+            {
+                resize(buckets_.size() / 2);
+            }
+            return slots_.release(key);
+        }
+
+        double next_time() const
+        {
+            return buckets_[find_next_bucket()].front().time_hours;
+        }
+
+        bool empty() const { return size_ == 0; }
+        size_t size() const { return size_; }
+
+        void clear()
+        {
+            buckets_.assign(MIN_BUCKETS, Bucket{});
+            bucket_width_ = 1.0;
+            current_day_ = 0;
+            size_ = 0;
+            slots_.clear();
+            next_sequence_ = 0;
+        }
+
+        std::vector<Event<T>> pending_events() const
+        {
+            std::vector<Event<T>> events;
+            events.reserve(size_);
+            for (const Bucket &bucket : buckets_)
+            {
+                for (const EventKey &key : bucket)
+                {
+                    events.push_back(slots_.peek(key));
+                }
+            }
+            sort_by_sequence(events);
+            return events;
+        }
+
+        std::uint64_t get_next_sequence() const { return next_sequence_; }
+
+        /**
+         * Replace the queue with saved events, keeping their sequence numbers
+         */
+        void restore(std::vector<Event<T>> events, std::uint64_t next_sequence)
+        {
+            clear();
+            for (Event<T> &event : events)
+            {
+                insert(event.type, event.time_hours, std::move(event.data), event.sequence);
+            }
+            next_sequence_ = next_sequence;
+        }
+    };
+}
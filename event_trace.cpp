@@ -0,0 +1,199 @@
+#include "event_trace.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace evtol
+{
+    const char *trace_event_name(TraceEventType type)
+    {
+        static const char *names[NUM_TRACE_EVENT_TYPES] = {
+            "FLIGHT_START", "FLIGHT_COMPLETE", "FAULT", "CHARGER_QUEUED",
+            "CHARGE_START", "CHARGE_COMPLETE", "PARTIAL_FLIGHT", "PARTIAL_CHARGE"};
+
+        auto index = static_cast<size_t>(type);
+        return index < NUM_TRACE_EVENT_TYPES ? names[index] : "UNKNOWN";
+    }
+
+    TraceWriter::TraceWriter(const std::string &path, size_t block_records, size_t block_count)
+        : block_records_(block_records)
+    {
+        if (block_records == 0 || block_count == 0)
+        {
+            throw std::invalid_argument("Trace blocks need at least one record and one block");
+        }
+
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_)
+        {
+            throw std::runtime_error("Cannot create trace file: " + path);
+        }
+
+        TraceFileHeader header{};
+        std::memcpy(header.magic, TraceFileHeader::MAGIC, sizeof(header.magic));
+        header.version = TraceFileHeader::VERSION;
+        header.record_size = sizeof(TraceRecord);
+        if (std::fwrite(&header, sizeof(header), 1, file_) != 1)
+        {
+            std::fclose(file_);
+            throw std::runtime_error("Cannot write trace file header: " + path);
+        }
+
+        blocks_.resize(block_count);
+        for (auto &block : blocks_)
+        {
+            block.reserve(block_records);
+            free_blocks_.push_back(&block);
+        }
+        current_ = free_blocks_.back();
+        free_blocks_.pop_back();
+
+        writer_ = std::thread([this]
+                              { writer_loop(); });
+    }
+
+    TraceWriter::~TraceWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (const std::exception &)
+        {
+            // Nothing to report to from a destructor; call close() to see write errors
+        }
+    }
+
+    void TraceWriter::submit_current()
+    {
+        records_written_ += current_->size();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        full_blocks_.push_back(current_);
+        work_ready_.notify_one();
+
+        block_free_.wait(lock, [this]
+                         { return !free_blocks_.empty(); });
+        current_ = free_blocks_.back();
+        free_blocks_.pop_back();
+    }
+
+    void TraceWriter::writer_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            work_ready_.wait(lock, [this]
+                             { return stopping_ || !full_blocks_.empty(); });
+            if (full_blocks_.empty())
+            {
+                return; // stopping with nothing left to write
+            }
+
+            Block *block = full_blocks_.front();
+            full_blocks_.pop_front();
+            ++blocks_in_write_;
+            lock.unlock();
+
+            bool ok = std::fwrite(block->data(), sizeof(TraceRecord), block->size(), file_) == block->size();
+            ok = std::fflush(file_) == 0 && ok;
+            block->clear();
+
+            lock.lock();
+            write_failed_ = write_failed_ || !ok;
+            --blocks_in_write_;
+            free_blocks_.push_back(block);
+            block_free_.notify_all();
+        }
+    }
+
+    void TraceWriter::flush()
+    {
+        if (!file_)
+        {
+            return;
+        }
+
+        if (!current_->empty())
+        {
+            submit_current();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        block_free_.wait(lock, [this]
+                         { return full_blocks_.empty() && blocks_in_write_ == 0; });
+        if (write_failed_)
+        {
+            throw std::runtime_error("Writing the trace file failed");
+        }
+    }
+
+    void TraceWriter::close()
+    {
+        if (!file_)
+        {
+            return;
+        }
+
+        bool failed = false;
+        try
+        {
+            flush();
+        }
+        catch (const std::runtime_error &)
+        {
+            failed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_ready_.notify_one();
+        writer_.join();
+
+        failed = std::fclose(file_) != 0 || failed;
+        file_ = nullptr;
+        current_ = nullptr;
+
+        if (failed)
+        {
+            throw std::runtime_error("Writing the trace file failed");
+        }
+    }
+
+    TraceReader::TraceReader(const std::string &path)
+    {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_)
+        {
+            throw std::runtime_error("Cannot open trace file: " + path);
+        }
+
+        TraceFileHeader header{};
+        if (std::fread(&header, sizeof(header), 1, file_) != 1 ||
+            std::memcmp(header.magic, TraceFileHeader::MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != TraceFileHeader::VERSION || header.record_size != sizeof(TraceRecord))
+        {
+            std::fclose(file_);
+            throw std::runtime_error("Not a version " + std::to_string(TraceFileHeader::VERSION) + " trace file: " + path);
+        }
+    }
+
+    TraceReader::~TraceReader()
+    {
+        std::fclose(file_);
+    }
+
+    bool TraceReader::next(TraceRecord &record)
+    {
+        return std::fread(&record, sizeof(TraceRecord), 1, file_) == 1;
+    }
+
+    size_t TraceReader::read_batch(std::vector<TraceRecord> &out, size_t max_records)
+    {
+        out.resize(max_records);
+        size_t count = std::fread(out.data(), sizeof(TraceRecord), max_records, file_);
+        out.resize(count);
+        return count;
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "aircraft.h"
+
+namespace evtol
+{
+    enum class TraceEventType : std::uint8_t
+    {
+        FLIGHT_START,    // value_a: planned flight time (h), value_b: planned distance (miles)
+        FLIGHT_COMPLETE, // value_a: flight time (h), value_b: distance (miles)
+        FAULT,           // value_a: hours into the flight
+        CHARGER_QUEUED,  // value_a: aircraft already waiting at the pool
+        CHARGE_START,    // value_a: charge time (h), value_b: wait before charging (h)
+        CHARGE_COMPLETE, // value_a: charge time (h), value_b: wait before charging (h)
+        PARTIAL_FLIGHT,  // value_a: flown time (h), value_b: flown distance (miles)
+        PARTIAL_CHARGE   // value_a: charged time (h)
+    };
+
+    inline constexpr size_t NUM_TRACE_EVENT_TYPES = 8;
+
+    const char *trace_event_name(TraceEventType type);
+
+    /**
+     * One fixed-size trace record, written to disk as-is (native byte order)
+     */
+    struct TraceRecord
+    {
+        double time_hours;
+        std::int32_t aircraft_id;
+        TraceEventType event_type;
+        std::uint8_t aircraft_type; // AircraftType
+        std::uint16_t reserved;
+        double value_a;
+        double value_b;
+    };
+
+    static_assert(sizeof(TraceRecord) == 32 && std::is_trivially_copyable_v<TraceRecord>);
+
+    /**
+     * Trace file layout: this header, then TraceRecords back to back until end of file
+     */
+    struct TraceFileHeader
+    {
+        static constexpr char MAGIC[8] = {'E', 'V', 'T', 'L', 'T', 'R', 'C', '1'};
+        static constexpr std::uint32_t VERSION = 1;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t record_size;
+    };
+
+    /**
+     * Binary event trace written by a background thread
+     * record() appends to an in-memory block; full blocks are handed to the writer thread and
+     * recycled once written, so the simulation thread never touches the file. With every block
+     * in flight, record() waits for the writer rather than growing without bound.
+     * Not thread-safe: one producer per writer.
+     */
+    class TraceWriter
+    {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_RECORDS = 16384; // 512 KiB blocks
+        static constexpr size_t DEFAULT_BLOCK_COUNT = 4;
+
+    private:
+        using Block = std::vector<TraceRecord>;
+
+        std::FILE *file_ = nullptr;
+        std::vector<Block> blocks_;
+        Block *current_ = nullptr;
+        size_t block_records_;
+        std::uint64_t records_written_ = 0;
+
+        std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable block_free_;
+        std::deque<Block *> full_blocks_;
+        std::vector<Block *> free_blocks_;
+        size_t blocks_in_write_ = 0;
+        bool stopping_ = false;
+        bool write_failed_ = false;
+        std::thread writer_;
+
+        void submit_current();
+        void writer_loop();
+
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be created
+         * @throws std::invalid_argument for zero block sizes or counts
+         */
+        explicit TraceWriter(const std::string &path, size_t block_records = DEFAULT_BLOCK_RECORDS,
+                             size_t block_count = DEFAULT_BLOCK_COUNT);
+        ~TraceWriter();
+
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter &operator=(const TraceWriter &) = delete;
+
+        void record(double time_hours, int aircraft_id, TraceEventType event_type, AircraftType aircraft_type,
+                    double value_a = 0.0, double value_b = 0.0)
+        {
+            current_->push_back({time_hours, aircraft_id, event_type, static_cast<std::uint8_t>(aircraft_type), 0,
+                                 value_a, value_b});
+            if (current_->size() == block_records_)
+            {
+                submit_current();
+            }
+        }
+
+        /**
+         * Write everything recorded so far and wait until it is in the file
+         * @throws std::runtime_error if a write failed
+         */
+        void flush();
+
+        /**
+         * Flush, stop the writer thread and close the file; record() must not be called afterwards
+         * @throws std::runtime_error if a write failed
+         */
+        void close();
+
+        std::uint64_t get_record_count() const { return records_written_ + (current_ ? current_->size() : 0); }
+    };
+
+    /**
+     * Sequential reader for trace files
+     */
+    class TraceReader
+    {
+    private:
+        std::FILE *file_ = nullptr;
+
+    public:
+        /**
+         * @throws std::runtime_error if the file is missing or not a trace of this version
+         */
+        explicit TraceReader(const std::string &path);
+        ~TraceReader();
+
+        TraceReader(const TraceReader &) = delete;
+        TraceReader &operator=(const TraceReader &) = delete;
+
+        /**
+         * @return False at end of file
+         */
+        bool next(TraceRecord &record);
+
+        /**
+         * Read up to max_records into out, replacing its contents
+         * @return Number of records read
+         */
+        size_t read_batch(std::vector<TraceRecord> &out, size_t max_records);
+    };
+}
@@ -1,11 +1,18 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <fstream>
 
 #include "aircraft.h"
 #include "aircraft_types.h"
+#include "arena_fleet.h"
 #include "simulation_runner.h"
 #include "simulation_config.h"
+#include "scenario_file.h"
+#include "sweep_runner.h"
+#if EVTOL_DISTRIBUTED
+#include "distributed_batch.h"
+#endif
 
 using namespace std;
 using namespace evtol;
@@ -35,10 +42,10 @@ class EvtolSimulationApp
 {
 private:
     static constexpr int FLEET_SIZE = 20;
-    static constexpr int NUM_CHARGERS = 3;
     static constexpr double SIMULATION_DURATION_HOURS = 3.0;
 
-    std::vector<std::unique_ptr<AircraftBase>> fleet_;
+    ArenaFleet fleet_;
+    SoaFleet scenario_fleet_; // columns mapped from config_.scenario_path, when given
     std::unique_ptr<StatisticsCollector> stats_collector_;
     std::unique_ptr<evtol::SimulationRunner> sim_runner_;
     ChargerManager charger_manager_;
@@ -54,50 +61,302 @@ public:
     void run_simulation()
     {
         cout << "========== eVTOL Aircraft Simulation ==========\n";
-        cout << "Fleet Size: " << FLEET_SIZE << " aircraft\n";
-        cout << "Chargers Available: " << NUM_CHARGERS << "\n";
+#if EVTOL_DISTRIBUTED
+        if (!config_.worker_address.empty())
+        {
+            run_worker();
+            return;
+        }
+#endif
+        if (!config_.scenario_path.empty())
+        {
+            cout << "Scenario: " << config_.scenario_path << "\n";
+        }
+        cout << "Fleet Size: " << config_.fleet_size << " aircraft\n";
+        if (!(config_.fleet_mix == FleetMix{}))
+        {
+            cout << "Fleet Mix: " << config_.fleet_mix.to_string() << "\n";
+        }
+        cout << "Chargers Available: " << charger_manager_.get_total_chargers() << "\n";
+        if (charger_manager_.get_pool_count() > 1)
+        {
+            for (size_t pool = 0; pool < charger_manager_.get_pool_count(); ++pool)
+            {
+                cout << "  " << charger_manager_.get_pool_name(pool) << ": "
+                     << charger_manager_.get_pool_charger_count(pool) << "\n";
+            }
+        }
         cout << "Simulation Duration: " << config_.simulation_duration_hours << " hours\n";
-        cout << "Mode: " << (config_.mode == SimulationMode::FRAME_BASED ? "Frame-Based" : "Event-Driven") << "\n";
+        cout << "Random Seed: " << *config_.random_seed << "\n";
+        if (config_.fault_model != FaultModel::LINEAR)
+        {
+            cout << "Fault Model: " << fault_model_to_string(config_.fault_model) << "\n";
+        }
+        if (config_.dispatch_policy != DispatchPolicy::FIFO)
+        {
+            cout << "Dispatch Policy: " << dispatch_policy_to_string(config_.dispatch_policy) << "\n";
+        }
+        cout << "Mode: " << (config_.mode == SimulationMode::FRAME_BASED ? "Frame-Based"
+                             : config_.mode == SimulationMode::COROUTINE ? "Coroutine"
+                                                                          : "Event-Driven")
+             << "\n";
 
         if (config_.mode == SimulationMode::FRAME_BASED)
         {
             cout << "Frame Time: " << config_.frame_time_seconds << " seconds\n";
         }
+        else if (config_.mode == SimulationMode::EVENT_DRIVEN && config_.enable_network)
+        {
+            cout << "Vertiport Network: " << charger_manager_.get_pool_count() << " vertiports\n";
+        }
+        else if (config_.mode == SimulationMode::EVENT_DRIVEN)
+        {
+            cout << "Event Scheduler: " << scheduler_type_to_string(config_.scheduler) << "\n";
+        }
+
+        if (!config_.sweep_csv_path.empty())
+        {
+            run_sweep();
+            return;
+        }
+
+        if (config_.replications > 1)
+        {
+            run_batch();
+            return;
+        }
 
         cout << "Starting simulation...\n\n";
 
         PerformanceTimer<std::chrono::microseconds> timer;
 
-        sim_runner_->run_simulation(charger_manager_, fleet_);
+        if (scenario_fleet_.is_mapped())
+        {
+            sim_runner_->run_simulation(charger_manager_, scenario_fleet_);
+        }
+        else
+        {
+            sim_runner_->run_simulation(charger_manager_, fleet_);
+        }
 
         auto elapsed = timer.elapsed();
 
         cout << "Simulation completed in " << elapsed.count() << " microseconds ("
-             << std::fixed << std::setprecision(3) << elapsed.count() / 1000.0 << " ms)\n\n";
+             << std::fixed << std::setprecision(3) << elapsed.count() / 1000.0 << " ms)\n";
+        if (auto *network = dynamic_cast<NetworkSimulationEngine *>(sim_runner_->get_engine()))
+        {
+            cout << "Network: " << network->get_window_count() << " windows of up to " << network->get_lookahead_hours()
+                 << " hours, " << network->get_flights_between_vertiports() << " flights between vertiports\n";
+        }
+        if (auto *coroutines = dynamic_cast<CoroutineSimulationEngine *>(sim_runner_->get_engine()))
+        {
+            cout << "Coroutines: " << config_.fleet_size << " aircraft frames of " << coroutines->get_frame_size() << " bytes\n";
+        }
+        cout << "\n";
 
-        display_results();
+        RunProfile *profile = sim_runner_->get_profile();
+        {
+            ScopedPhaseTimer report_timer(profile ? &profile->local(0) : nullptr, ProfilePhase::REPORT);
+            display_results();
+        }
+        display_profile(profile);
     }
 
 private:
+    void run_batch()
+    {
+        ConfidenceStoppingRule rule = config_.stopping_rule();
+        cout << "Replications: " << (rule.enabled() ? "up to " : "") << config_.replications << "\n";
+        if (rule.enabled())
+        {
+            cout << "CI Target: +/-" << 100.0 * rule.relative_half_width << "% of the mean for";
+            for (const WatchedMetric &metric : rule.metrics)
+            {
+                cout << " " << metric.to_string();
+            }
+            cout << ", from " << rule.min_replications << " replications\n";
+        }
+#if EVTOL_DISTRIBUTED
+        if (config_.coordinator_port > 0)
+        {
+            BatchCoordinator coordinator(config_, DistributedBatchOptions::from_config(config_, &std::cerr));
+            cout << "Coordinator: port " << coordinator.port() << "\n";
+            cout << "Starting distributed batch...\n\n";
+
+            PerformanceTimer<std::chrono::microseconds> timer;
+            DistributedBatchResult result = coordinator.run_replications();
+            auto elapsed = timer.elapsed();
+
+            cout << "Batch completed in " << elapsed.count() << " microseconds ("
+                 << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(elapsed).count() << " ms)\n";
+            display_distributed_report(result.report);
+            display_stopping(rule, result.batch, result.report.converged);
+            cout << result.batch.generate_report();
+            return;
+        }
+#endif
+        cout << "Threads: " << ThreadPool::resolve_thread_count(config_.num_threads) << "\n";
+        cout << "Starting batch...\n\n";
+
+        PerformanceTimer<std::chrono::microseconds> timer;
+
+        auto make_fleet = [this]
+        { return ArenaFleet(config_.fleet_size, config_.fleet_mix); };
+        SequentialBatchResult result;
+        if (rule.enabled())
+        {
+            result = sim_runner_->run_replications_until(make_fleet, rule);
+        }
+        else
+        {
+            result.batch = sim_runner_->run_replications(make_fleet);
+        }
+
+        auto elapsed = timer.elapsed();
+
+        cout << "Batch completed in " << elapsed.count() << " microseconds ("
+             << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(elapsed).count() << " ms)\n";
+        display_stopping(rule, result.batch, result.converged);
+
+        cout << result.batch.generate_report();
+        display_profile(sim_runner_->get_profile());
+    }
+
+    void display_stopping(const ConfidenceStoppingRule &rule, const BatchStatistics &batch, bool converged)
+    {
+        if (!rule.enabled())
+        {
+            return;
+        }
+        auto [width, metric] = rule.widest(batch);
+        cout << (converged ? "Converged after " : "Reached the cap of ") << batch.get_replication_count()
+             << " replications: widest 95% CI +/-" << std::setprecision(2) << 100.0 * width << "% ("
+             << metric->to_string() << "), target +/-" << 100.0 * rule.relative_half_width << "%\n";
+    }
+
+    void run_sweep()
+    {
+        SweepRunner sweep(config_);
+        cout << "Sweep Scenarios: " << sweep.get_points().size();
+        if (sweep.get_duplicate_count() > 0)
+        {
+            cout << " (" << sweep.get_duplicate_count() << " duplicates skipped)";
+        }
+        cout << "\n";
+
+        std::ofstream csv(config_.sweep_csv_path);
+        if (!csv)
+        {
+            throw std::runtime_error("Cannot create sweep CSV " + config_.sweep_csv_path);
+        }
+
+#if EVTOL_DISTRIBUTED
+        if (config_.coordinator_port > 0)
+        {
+            BatchCoordinator coordinator(config_, DistributedBatchOptions::from_config(config_, &std::cerr));
+            cout << "Coordinator: port " << coordinator.port() << "\n";
+            cout << "Starting distributed sweep...\n\n";
+
+            PerformanceTimer<std::chrono::microseconds> timer;
+            DistributedSweepResult result = coordinator.run_sweep(csv);
+            auto elapsed = timer.elapsed();
+
+            cout << "Sweep completed in " << elapsed.count() << " microseconds ("
+                 << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(elapsed).count() << " ms)\n";
+            display_distributed_report(result.report);
+            cout << "Results written to " << config_.sweep_csv_path << "\n";
+            return;
+        }
+#endif
+        cout << "Threads: " << ThreadPool::resolve_thread_count(config_.num_threads) << "\n";
+        cout << "Starting sweep...\n\n";
+
+        PerformanceTimer<std::chrono::microseconds> timer;
+
+        sweep.run(csv);
+
+        auto elapsed = timer.elapsed();
+
+        cout << "Sweep completed in " << elapsed.count() << " microseconds ("
+             << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(elapsed).count() << " ms)\n";
+        cout << "Results written to " << config_.sweep_csv_path << "\n";
+    }
+
+#if EVTOL_DISTRIBUTED
+    void run_worker()
+    {
+        cout << "Worker for " << config_.worker_address << ", "
+             << ThreadPool::resolve_thread_count(config_.num_threads) << " threads\n";
+
+        size_t tasks = BatchWorker(config_.num_threads).run(config_.worker_address);
+
+        cout << "Worker finished " << tasks << " tasks\n";
+    }
+
+    void display_distributed_report(const DistributedRunReport &report)
+    {
+        cout << "Distributed: " << report.tasks_done << "/" << report.tasks_total << " tasks from "
+             << report.workers_seen << " workers (" << report.workers_lost << " lost)\n";
+        if (!report.complete())
+        {
+            cout << "Warning: partial results, " << report.tasks_total - report.tasks_done << " tasks never finished\n";
+        }
+        cout << "\n";
+    }
+#endif
+
     void initialize_configuration(int argc, char *argv[])
     {
         // use default 3.0 duration as specified in problem statement
         config_.simulation_duration_hours = SIMULATION_DURATION_HOURS;
+        config_.fleet_size = FLEET_SIZE;
         config_.parse_args(argc, argv);
 
         if (!config_.validate())
         {
             throw std::runtime_error("Invalid configuration");
         }
+
+        // Always run seeded and report the seed, so any run can be reproduced with --seed
+        if (!config_.random_seed)
+        {
+            config_.random_seed = RandomStream::entropy_seed();
+        }
     }
 
     void initialize_simulation()
     {
-        fleet_ = AircraftFactory<>::create_fleet(FLEET_SIZE);
         stats_collector_ = std::make_unique<StatisticsCollector>();
+        if (config_.enable_percentiles)
+        {
+            stats_collector_->enable_distributions();
+        }
 
-        // Set aircraft counts for proper reporting
-        stats_collector_->set_aircraft_counts(fleet_);
+        bool use_scenario = !config_.scenario_path.empty() && config_.replications <= 1 && config_.sweep_csv_path.empty();
+        if (use_scenario)
+        {
+            // The fleet's columns stay in the mapped file; only the pool table is copied
+            auto scenario = MappedScenario::open(config_.scenario_path);
+            if (config_.verify_scenario)
+            {
+                scenario->verify();
+            }
+            config_.fleet_size = static_cast<int>(scenario->size());
+            config_.charger_pools = scenario->charger_pools();
+            charger_manager_ = config_.make_charger_manager();
+            scenario->assign_home_pools(charger_manager_);
+            scenario_fleet_ = MappedScenario::map_fleet(scenario);
+            stats_collector_->set_aircraft_counts(scenario_fleet_);
+        }
+        else
+        {
+            fleet_.reset(config_.fleet_size, config_.fleet_mix);
+            charger_manager_ = config_.make_charger_manager();
+            charger_manager_.reserve_aircraft(config_.fleet_size - 1);
+
+            // Set aircraft counts for proper reporting
+            stats_collector_->set_aircraft_counts(fleet_);
+        }
 
         sim_runner_ = std::make_unique<evtol::SimulationRunner>(*stats_collector_, config_);
     }
@@ -107,6 +366,25 @@ private:
         cout << stats_collector_->generate_report(config_.enable_detailed_logging);
     }
 
+    void display_profile(const RunProfile *profile)
+    {
+        if (!profile)
+        {
+            return;
+        }
+        cout << profile->generate_report();
+        if (!config_.profile_json_path.empty())
+        {
+            std::ofstream json(config_.profile_json_path);
+            if (!json)
+            {
+                throw std::runtime_error("Cannot create profile JSON " + config_.profile_json_path);
+            }
+            json << profile->to_json();
+            cout << "Profile written to " << config_.profile_json_path << "\n";
+        }
+    }
+
     void display_performance_metrics()
     {
         auto summary = stats_collector_->get_summary_stats();
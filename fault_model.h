@@ -0,0 +1,86 @@
+#pragma once
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "random_stream.h"
+
+namespace evtol
+{
+    /**
+     * How a flight's fault is drawn from an aircraft's fault rate (faults per hour)
+     */
+    enum class FaultModel
+    {
+        LINEAR,     // fault with probability rate * flight time, then a uniform time within the flight
+        EXPONENTIAL // exponential time to the next fault; one draw decides the fault and places it
+    };
+
+    inline const char *fault_model_to_string(FaultModel model)
+    {
+        switch (model)
+        {
+        case FaultModel::LINEAR:
+            return "linear";
+        case FaultModel::EXPONENTIAL:
+            return "exponential";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Parse a fault model name as accepted by --fault-model
+     * @throws std::invalid_argument for unknown names
+     */
+    inline FaultModel parse_fault_model(const std::string &name)
+    {
+        if (name == "linear")
+            return FaultModel::LINEAR;
+        if (name == "exponential" || name == "exp")
+            return FaultModel::EXPONENTIAL;
+        throw std::invalid_argument("Unknown fault model: " + name);
+    }
+
+    /**
+     * Draw the fault of one flight from an aircraft's stream
+     * LINEAR takes one draw, plus a second for the time when the flight faults; the probability
+     * rate * flight time is a first-order approximation that saturates at 1 for long flights.
+     * EXPONENTIAL always takes exactly one draw: the time to the first fault of a Poisson process
+     * with the given rate, so flight k of an aircraft uses draw k of its stream, and the fault
+     * probability is the exact 1 - exp(-rate * flight time).
+     * @return Hours into the flight at which the fault happens, or -1 for no fault
+     */
+    inline double sample_flight_fault(RandomStream &rng, FaultModel model, double fault_rate, double flight_time_hours)
+    {
+        if (fault_rate <= 0.0)
+            return -1.0; // never faults
+
+        if (model == FaultModel::EXPONENTIAL)
+        {
+            // u is in [0, 1), so log1p(-u) is finite
+            double fault_time = -std::log1p(-rng.next_uniform()) / fault_rate;
+            return fault_time < flight_time_hours ? fault_time : -1.0;
+        }
+
+        // Simple probability check for fault during this flight
+        double flight_fault_probability = fault_rate * flight_time_hours;
+        if (rng.next_uniform() < flight_fault_probability)
+        {
+            // Fault occurs - randomly pick a time during the flight
+            return rng.next_uniform() * flight_time_hours;
+        }
+        return -1.0;
+    }
+
+    /**
+     * Switch every aircraft of a fleet to model; like the seed, it is set at the start of each run
+     */
+    template <typename Fleet>
+    void apply_fault_model(Fleet &fleet, FaultModel model)
+    {
+        for (auto &&aircraft : fleet)
+        {
+            aircraft->set_fault_model(model);
+        }
+    }
+}
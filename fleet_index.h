@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace evtol
+{
+    /**
+     * Dense aircraft id -> fleet position table
+     * Fleets from AircraftFactory use ids 0..N-1, so a flat vector gives O(1) lookups
+     */
+    class FleetIndex
+    {
+    private:
+        std::vector<size_t> id_to_index_;
+
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        template <typename Fleet>
+        void build(const Fleet &fleet)
+        {
+            id_to_index_.clear();
+
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                int id = fleet[i]->get_id();
+                if (id < 0)
+                {
+                    continue;
+                }
+
+                size_t slot = static_cast<size_t>(id);
+                if (slot >= id_to_index_.size())
+                {
+                    id_to_index_.resize(slot + 1, npos);
+                }
+                id_to_index_[slot] = i;
+            }
+        }
+
+        /**
+         * @return Fleet position of the aircraft, or npos if the id is unknown
+         */
+        size_t index_of(int aircraft_id) const
+        {
+            if (aircraft_id < 0 || static_cast<size_t>(aircraft_id) >= id_to_index_.size())
+            {
+                return npos;
+            }
+            return id_to_index_[static_cast<size_t>(aircraft_id)];
+        }
+    };
+}
@@ -1,5 +1,9 @@
 #include "frame_based_simulation.h"
 #include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <iostream>
 #include <stdexcept>
 
@@ -13,51 +17,238 @@ namespace evtol
         {
             throw std::invalid_argument("Invalid simulation configuration");
         }
+
+        // frame_time = mantissa * 2^(exponent - 53) with an integer mantissa; strip its trailing zero bits
+        int exponent = 0;
+        double mantissa = std::frexp(frame_time_seconds_, &exponent);
+        auto mantissa_bits = static_cast<std::uint64_t>(std::ldexp(mantissa, 53));
+        int trailing_zeros = std::countr_zero(mantissa_bits);
+        frame_time_odd_multiple_ = mantissa_bits >> trailing_zeros;
+        frame_time_exponent_ = exponent - 53 + trailing_zeros;
+
+        size_t thread_count = ThreadPool::resolve_thread_count(config_.num_threads);
+        if (thread_count > 1)
+        {
+            thread_pool_ = std::make_unique<ThreadPool>(thread_count);
+        }
+    }
+
+    void FrameBasedSimulationEngine::note_retargeted(size_t aircraft_idx)
+    {
+        // Lower indices already had their turn this frame, so only later ones are replayed
+        if (arbitration_active_ && aircraft_idx > arbitration_index_ && !retargeted_flags_[aircraft_idx])
+        {
+            retargeted_flags_[aircraft_idx] = 1;
+            retargeted_.push_back(aircraft_idx);
+            std::push_heap(retargeted_.begin(), retargeted_.end(), std::greater<size_t>());
+        }
+    }
+
+    void FrameBasedSimulationEngine::advance_all_timers()
+    {
+        std::vector<double> &timers = frame_state_.time_remaining_column();
+        const size_t fleet_size = timers.size();
+        expired_.clear();
+
+        if (thread_pool_ && fleet_size >= PARALLEL_MIN_FLEET_SIZE)
+        {
+            size_t chunk_count = std::min(fleet_size, thread_pool_->size() * CHUNKS_PER_WORKER);
+            size_t chunk_size = (fleet_size + chunk_count - 1) / chunk_count;
+            chunk_size = (chunk_size + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+            chunk_count = (fleet_size + chunk_size - 1) / chunk_size;
+            chunk_expired_.resize(chunk_count);
+
+            thread_pool_->parallel_for(chunk_count, [&](size_t chunk, size_t /*worker*/)
+                                       {
+                chunk_expired_[chunk].clear();
+                size_t begin = chunk * chunk_size;
+                size_t end = std::min(fleet_size, begin + chunk_size);
+                advance_frame_timers(timers, begin, end, frame_time_seconds_, chunk_expired_[chunk]); });
+
+            for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+            {
+                expired_.insert(expired_.end(), chunk_expired_[chunk].begin(), chunk_expired_[chunk].end());
+            }
+            ++parallel_frames_;
+        }
+        else
+        {
+            advance_frame_timers(timers, 0, fleet_size, frame_time_seconds_, expired_);
+        }
+
+        // Activities started with no duration never cross zero, but are due this frame all the same
+        if (frame_state_.has_zero_duration_activities())
+        {
+            frame_state_.take_zero_duration_activities(expired_);
+            std::sort(expired_.begin(), expired_.end());
+            expired_.erase(std::unique(expired_.begin(), expired_.end()), expired_.end());
+        }
     }
 
-    void FrameBasedSimulationEngine::run_simulation_impl(ChargerManager &charger_mgr, void *fleet_ptr)
+    void FrameBasedSimulationEngine::advance_frame_clock()
     {
-        // A bit ugly, but works - Type-erase back to template - cast to the expected fleet type
-        auto *fleet = static_cast<std::vector<std::unique_ptr<AircraftBase>> *>(fleet_ptr);
-        run_frame_based_simulation(charger_mgr, *fleet);
+        // Advance time
+        current_time_hours_ = (frame_count_ * frame_time_seconds_) / 3600.0;
+        frame_count_++;
+
+        // Log frame progress every 0.5 hours
+        if (current_time_hours_ - last_log_time_ >= 0.5)
+        {
+            log_event([&] { return "Frame " + std::to_string(frame_count_) + " completed - Time: " + std::to_string(current_time_hours_) + "h"; });
+            last_log_time_ = current_time_hours_;
+        }
     }
 
-    void FrameBasedSimulationEngine::handle_partial_flight(std::unique_ptr<AircraftBase> &aircraft, AircraftFrameData &frame_data)
+    size_t FrameBasedSimulationEngine::count_quiet_frames(const ChargerManager &charger_mgr)
+    {
+        // A frame is quiet if no aircraft changes state: nobody idle, no poll that can win a
+        // charger, and no timer reaching zero
+        bool charger_free = charger_mgr.get_available_chargers() > 0;
+        if (!frame_state_.idle_aircraft().empty() || (charger_free && !frame_state_.waiting_aircraft().empty()))
+        {
+            return 0;
+        }
+
+        double min_active_remaining = std::numeric_limits<double>::infinity();
+        double max_remaining = 0.0;
+        const std::vector<double> &timers = frame_state_.time_remaining_column();
+        const std::vector<AircraftState> &states = frame_state_.state_column();
+
+        for (size_t i = 0; i < timers.size(); ++i)
+        {
+            if (states[i] == AircraftState::FLYING || states[i] == AircraftState::CHARGING)
+            {
+                min_active_remaining = std::min(min_active_remaining, timers[i]);
+            }
+            max_remaining = std::max(max_remaining, timers[i]);
+        }
+
+        size_t quiet_frames = std::isinf(min_active_remaining)
+                                  ? std::numeric_limits<size_t>::max()
+                                  : frames_until_expiry(min_active_remaining) - 1;
+        bulk_decrement_exact_ = quiet_frames > 0 && is_exact_decrement(max_remaining, std::min(quiet_frames, size_t{1} << 32));
+        return quiet_frames;
+    }
+
+    bool FrameBasedSimulationEngine::is_exact_decrement(double time_remaining_sec, size_t frames) const
+    {
+        // Every value of the chain t, t - dt, ... is a double no larger than t. Its subtraction is exact when
+        // dt is a multiple of ulp(t), and frames * dt is exact while its odd multiple fits in 53 bits.
+        if (frames > (std::uint64_t{1} << 53) / frame_time_odd_multiple_)
+        {
+            return false;
+        }
+        return time_remaining_sec <= 0.0 || std::ilogb(time_remaining_sec) - 52 <= frame_time_exponent_;
+    }
+
+    size_t FrameBasedSimulationEngine::frames_until_expiry(double time_remaining_sec) const
+    {
+        double frames = std::ceil(time_remaining_sec / frame_time_seconds_);
+        auto count = static_cast<size_t>(std::max(frames, 1.0));
+
+        if (!is_exact_decrement(time_remaining_sec, count + 1))
+        {
+            // Rounding can only shift the chain by a tiny fraction of a frame; stay a frame short
+            return std::max<size_t>(1, count - 1);
+        }
+
+        // Exact arithmetic: the smallest k with t - k * dt <= 0
+        while (count > 1 && time_remaining_sec - static_cast<double>(count - 1) * frame_time_seconds_ <= 0.0)
+        {
+            --count;
+        }
+        while (time_remaining_sec - static_cast<double>(count) * frame_time_seconds_ > 0.0)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    void FrameBasedSimulationEngine::advance_timers(size_t frames)
+    {
+        if (frames == 0)
+        {
+            return;
+        }
+
+        if (bulk_decrement_exact_ && is_exact_decrement(0.0, frames))
+        {
+            double elapsed_sec = static_cast<double>(frames) * frame_time_seconds_;
+            for (double &time_remaining_sec : frame_state_.time_remaining_column())
+            {
+                time_remaining_sec = std::max(0.0, time_remaining_sec - elapsed_sec);
+            }
+            return;
+        }
+
+        for (double &time_remaining_sec : frame_state_.time_remaining_column())
+        {
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                time_remaining_sec = std::max(0.0, time_remaining_sec - frame_time_seconds_);
+            }
+        }
+    }
+
+    void FrameBasedSimulationEngine::save_state(SnapshotWriter &out) const
+    {
+        out.begin_section(snapshot_tag("FRAM"));
+        out.write(current_time_hours_);
+        out.write(frame_count_);
+        out.write(last_log_time_);
+        out.write(static_cast<std::uint64_t>(skipped_frames_));
+        frame_state_.save_state(out);
+    }
+
+    void FrameBasedSimulationEngine::restore_state(SnapshotReader &in, size_t fleet_size)
+    {
+        in.expect_section(snapshot_tag("FRAM"));
+        current_time_hours_ = in.read<double>();
+        frame_count_ = in.read<int>();
+        last_log_time_ = in.read<double>();
+        skipped_frames_ = static_cast<size_t>(in.read<std::uint64_t>());
+        frame_state_.restore_state(in, fleet_size);
+    }
+
+    void FrameBasedSimulationEngine::run_simulation_impl(ChargerManager &charger_mgr, AircraftFleet &fleet)
+    {
+        run_frame_based_simulation(charger_mgr, fleet);
+    }
+
+    void FrameBasedSimulationEngine::handle_partial_flight(int aircraft_id, AircraftType type, int passengers, double time_remaining_sec,
+                                                           const AircraftActivityData &activity)
     {
         // Calculate how much of the flight was completed
-        double total_flight_time = frame_data.current_flight_time_hrs;
-        double remaining_time_seconds = frame_data.time_remaining_sec;
+        double total_flight_time = activity.current_flight_time_hrs;
+        double remaining_time_seconds = time_remaining_sec;
         double completed_flight_time = total_flight_time - (remaining_time_seconds / 3600.0); // Convert to hours
 
         // Calculate partial distance
-        double partial_distance = (completed_flight_time / total_flight_time) * frame_data.current_flight_distance;
+        double partial_distance = (completed_flight_time / total_flight_time) * activity.current_flight_distance;
 
-        if (config_.enable_detailed_logging)
-        {
-            log_event("Processing partial flight for aircraft " + std::to_string(aircraft->get_id()) +
-                      " (flew " + std::to_string(completed_flight_time) + "h/" + std::to_string(total_flight_time) +
-                      "h, " + std::to_string(partial_distance) + "/" + std::to_string(frame_data.current_flight_distance) + " miles)");
-        }
+        log_event([&] { return "Processing partial flight for aircraft " + std::to_string(aircraft_id) +
+                               " (flew " + std::to_string(completed_flight_time) + "h/" + std::to_string(total_flight_time) +
+                               "h, " + std::to_string(partial_distance) + "/" + std::to_string(activity.current_flight_distance) + " miles)"; });
 
         // Record partial flight statistics
-        stats_collector_.record_partial_flight(aircraft->get_type(), completed_flight_time, partial_distance, aircraft->get_passenger_count());
+        stats_recorder_.record_partial_flight(type, completed_flight_time, partial_distance, passengers);
+        trace(aircraft_id, TraceEventType::PARTIAL_FLIGHT, type, completed_flight_time, partial_distance);
     }
-    void FrameBasedSimulationEngine::handle_partial_charging(std::unique_ptr<AircraftBase> &aircraft, AircraftFrameData &frame_data)
+    void FrameBasedSimulationEngine::handle_partial_charging(int aircraft_id, AircraftType type, double charge_time_hours, double time_remaining_sec,
+                                                             const AircraftActivityData &activity)
     {
         // Calculate how much charging was completed
-        double total_charge_time = aircraft->get_charge_time_hours();
-        double remaining_time_seconds = frame_data.time_remaining_sec;
+        double total_charge_time = charge_time_hours;
+        double remaining_time_seconds = time_remaining_sec;
         double completed_charge_time = total_charge_time - (remaining_time_seconds / 3600.0); // Convert to hours
 
-        if (config_.enable_detailed_logging)
-        {
-            log_event("Processing partial charge for aircraft " + std::to_string(aircraft->get_id()) +
-                      " (charged " + std::to_string(completed_charge_time) + "h/" + std::to_string(total_charge_time) +
-                      "h, waited: " + std::to_string(frame_data.accumulated_waiting_time_sec / 3600.0) + "h)");
-        }
+        log_event([&] { return "Processing partial charge for aircraft " + std::to_string(aircraft_id) +
+                               " (charged " + std::to_string(completed_charge_time) + "h/" + std::to_string(total_charge_time) +
+                               "h, waited: " + std::to_string(activity.accumulated_waiting_time_sec / 3600.0) + "h)"; });
 
         // Record partial charging statistics
-        stats_collector_.record_partial_charge(aircraft->get_type(), completed_charge_time);
+        stats_recorder_.record_partial_charge(type, completed_charge_time);
+        trace(aircraft_id, TraceEventType::PARTIAL_CHARGE, type, completed_charge_time);
     }
 
     std::string FrameBasedSimulationEngine::aircraft_type_to_string(AircraftType type)
@@ -8,10 +8,18 @@
 #include <chrono>
 #include <future>
 #include <iostream>
+#include <string>
 
 #include "simulation_interface.h"
+#include "simulation_log.h"
 #include "simulation_config.h"
 #include "aircraft_state.h"
+#include "frame_state_table.h"
+#include "frame_timer_kernel.h"
+#include "random_stream.h"
+#include "fleet_index.h"
+#include "thread_pool.h"
+#include "checkpoint.h"
 
 namespace evtol
 {
@@ -24,17 +32,52 @@ namespace evtol
         SimulationConfig config_;
 
         // Frame-based state
-        std::vector<AircraftFrameData> aircraft_frame_data_;
+        FrameStateTable frame_state_;
+        FleetIndex fleet_index_;
+
+        // Frame update: the timer kernel runs over the whole fleet (in parallel chunks for large
+        // fleets), then only aircraft with something to do are dispatched, in index order
+        static constexpr size_t PARALLEL_MIN_FLEET_SIZE = 1024;
+        static constexpr size_t CHUNKS_PER_WORKER = 4;
+        static constexpr size_t CHUNK_ALIGNMENT = 64; // one bitmap word, and a whole number of SIMD blocks
+        static constexpr size_t NO_AIRCRAFT = SIZE_MAX;
+
+        std::unique_ptr<ThreadPool> thread_pool_;
+        std::vector<std::vector<size_t>> chunk_expired_; // per chunk: timers that reached zero this frame
+        std::vector<size_t> expired_;
+        std::vector<size_t> retargeted_; // min-heap of aircraft whose state a lower index changed this frame
+        std::vector<std::uint8_t> retargeted_flags_;
+        std::vector<RandomStream *> fault_streams_; // streams of the aircraft starting flights this frame
+        bool arbitration_active_ = false;
+        size_t arbitration_index_ = 0;
 
         // Performance tracking
         double frame_time_seconds_;
 
+        // Skip-ahead: frame time as odd_multiple * 2^exponent, used to prove bulk decrements exact
+        std::uint64_t frame_time_odd_multiple_ = 0;
+        int frame_time_exponent_ = 0;
+        bool bulk_decrement_exact_ = false;
+        size_t skipped_frames_ = 0;
+        size_t parallel_frames_ = 0;
+
+        // Frame clock
+        int frame_count_ = 0;
+        double last_log_time_ = 0.0;
+
+        CheckpointSchedule checkpoints_;
+
         // Logging helper
-        void log_event(const std::string &message) const
+        // Logging helper: message is a string or a callable returning one, only formatted when enabled
+        template <typename Message>
+        void log_event(Message &&message) const
         {
-            if (config_.enable_detailed_logging)
+            if constexpr (DETAILED_LOGGING_COMPILED_IN)
             {
-                std::cout << "[" << current_time_hours_ << "h] " << message << std::endl;
+                if (config_.enable_detailed_logging)
+                {
+                    write_log_event(current_time_hours_, std::forward<Message>(message));
+                }
             }
         }
 
@@ -42,23 +85,76 @@ namespace evtol
         FrameBasedSimulationEngine(StatisticsCollector &stats, const SimulationConfig &config);
         ~FrameBasedSimulationEngine() = default;
 
+        /**
+         * Run the frame loop directly on any fleet container (e.g. std::vector of aircraft or SoaFleet)
+         */
+        template <SimulationFleet Fleet>
+        void run_frame_based_simulation(ChargerManager &charger_mgr, Fleet &fleet);
+
+        /**
+         * Same as run_frame_based_simulation; matches EventDrivenSimulationEngine::run for static dispatch
+         */
+        template <SimulationFleet Fleet>
+        void run(ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            run_frame_based_simulation(charger_mgr, fleet);
+        }
+
+        /**
+         * Frames advanced by skip-ahead instead of a full update (0 unless enable_skip_ahead)
+         */
+        size_t get_skipped_frame_count() const { return skipped_frames_; }
+
+        /**
+         * Frames of this run whose timers were advanced in parallel chunks on the thread pool
+         */
+        size_t get_parallel_frame_count() const { return parallel_frames_; }
+
+        /**
+         * Clock and frame state table, for checkpoints
+         */
+        void save_state(SnapshotWriter &out) const;
+
+        /**
+         * @throws std::runtime_error if the saved state is not for fleet_size aircraft
+         */
+        void restore_state(SnapshotReader &in, size_t fleet_size);
+
     protected:
-        void run_simulation_impl(ChargerManager &charger_mgr, void *fleet_ptr) override;
+        void run_simulation_impl(ChargerManager &charger_mgr, AircraftFleet &fleet) override;
 
     private:
         template <typename Fleet>
-        void run_frame_based_simulation(ChargerManager &charger_mgr, Fleet &fleet);
+        void initialize_aircraft_states(Fleet &fleet);
 
         template <typename Fleet>
-        void initialize_aircraft_states(Fleet &fleet);
+        void resume_from_checkpoint(ChargerManager &charger_mgr, Fleet &fleet);
+
+        template <typename Fleet>
+        void write_due_checkpoints(const ChargerManager &charger_mgr, const Fleet &fleet);
 
         template <typename Fleet>
         void update_frame(ChargerManager &charger_mgr, Fleet &fleet);
 
+        void advance_all_timers();
+
         template <typename Fleet>
         void process_aircraft_state(ChargerManager &charger_mgr, Fleet &fleet,
                                     size_t aircraft_idx);
 
+        template <typename Fleet>
+        void dispatch_aircraft_state(ChargerManager &charger_mgr, Fleet &fleet,
+                                     size_t aircraft_idx);
+
+        void note_retargeted(size_t aircraft_idx);
+
+        // Skip-ahead helpers
+        void advance_frame_clock();
+        size_t count_quiet_frames(const ChargerManager &charger_mgr);
+        size_t frames_until_expiry(double time_remaining_sec) const;
+        bool is_exact_decrement(double time_remaining_sec, size_t frames) const;
+        void advance_timers(size_t frames);
+
         template <typename Fleet>
         void handle_flight_completion(ChargerManager &charger_mgr, Fleet &fleet,
                                       size_t aircraft_idx);
@@ -70,6 +166,9 @@ namespace evtol
         template <typename Fleet>
         void start_new_flight(Fleet &fleet, size_t aircraft_idx);
 
+        template <typename Fleet>
+        void prefetch_fault_draws(Fleet &fleet, const IndexBitmap &starting);
+
         template <typename Fleet>
         void start_charging(ChargerManager &charger_mgr, Fleet &fleet, size_t aircraft_idx);
 
@@ -77,9 +176,11 @@ namespace evtol
         template <typename Fleet>
         void finalize_simulation(Fleet &fleet);
 
-        void handle_partial_flight(std::unique_ptr<AircraftBase> &aircraft, AircraftFrameData &frame_data);
+        void handle_partial_flight(int aircraft_id, AircraftType type, int passengers, double time_remaining_sec,
+                                   const AircraftActivityData &activity);
 
-        void handle_partial_charging(std::unique_ptr<AircraftBase> &aircraft, AircraftFrameData &frame_data);
+        void handle_partial_charging(int aircraft_id, AircraftType type, double charge_time_hours, double time_remaining_sec,
+                                     const AircraftActivityData &activity);
 
         // State validation
         template <typename Fleet>
@@ -90,98 +191,289 @@ namespace evtol
     };
 
     // Template implementation
-    template <typename Fleet>
+    template <SimulationFleet Fleet>
     void FrameBasedSimulationEngine::run_frame_based_simulation(ChargerManager &charger_mgr, Fleet &fleet)
     {
-        log_event("=== Starting frame-based simulation ===");
-        log_event("Fleet size: " + std::to_string(fleet.size()));
-        log_event("Available chargers: " + std::to_string(charger_mgr.get_available_chargers()));
-        log_event("Frame time: " + std::to_string(frame_time_seconds_) + " seconds");
+        ProfileCounters *profile = active_profile();
+        ScopedPhaseTimer phase_timer(profile, ProfilePhase::INIT);
+        parallel_frames_ = 0;
+        if (checkpoint_options_.restore_path.empty())
+        {
+            log_event("=== Starting frame-based simulation ===");
+            log_event([&] { return "Fleet size: " + std::to_string(fleet.size()); });
+            log_event([&] { return "Available chargers: " + std::to_string(charger_mgr.get_available_chargers()); });
+            log_event([&] { return "Frame time: " + std::to_string(frame_time_seconds_) + " seconds"; });
 
-        initialize_aircraft_states(fleet);
+            if (config_.random_seed)
+            {
+                seed_fleet_streams(fleet, *config_.random_seed);
+            }
+            apply_fault_model(fleet, config_.fault_model);
 
-        is_running_ = true;
+            initialize_aircraft_states(fleet);
 
-        int frame_count = 0;
-        double last_log_time = 0.0;
+            frame_count_ = 0;
+            last_log_time_ = 0.0;
+            skipped_frames_ = 0;
+            checkpoints_.start(checkpoint_options_.every_hours);
+        }
+        else
+        {
+            resume_from_checkpoint(charger_mgr, fleet);
+        }
+
+        is_running_ = true;
+        if (profile)
+        {
+            profile->begin_run(current_time_hours_);
+            profile->sample_charger_queue(current_time_hours_, charger_mgr.get_queue_size());
+        }
+        phase_timer.next(ProfilePhase::MAIN_LOOP);
 
         while (is_running_ && current_time_hours_ < simulation_duration_hours_)
         {
+            size_t quiet_frames = config_.enable_skip_ahead ? count_quiet_frames(charger_mgr) : 0;
+            if (quiet_frames > 0)
+            {
+                // Nothing but timers moves in these frames: step the clock, then apply their elapsed time in one pass.
+                // A checkpoint ends the skip early, which changes nothing since skipping is exact.
+                size_t skipped = 0;
+                while (skipped < quiet_frames && is_running_ && current_time_hours_ < simulation_duration_hours_ &&
+                       !checkpoints_.due(current_time_hours_, simulation_duration_hours_))
+                {
+                    advance_frame_clock();
+                    ++skipped;
+                }
+                advance_timers(skipped);
+                skipped_frames_ += skipped;
+                if (profile)
+                {
+                    profile->skipped_frames += skipped;
+                }
+                publish_progress(charger_mgr);
+                write_due_checkpoints(charger_mgr, fleet);
+                continue;
+            }
+
             // Update frame
+            std::uint64_t state_changes = profile ? profile->state_changes : 0;
             update_frame(charger_mgr, fleet);
-
-            // Advance time
-            current_time_hours_ = (frame_count * frame_time_seconds_) / 3600.0;
-            frame_count++;
-
-            // Log frame progress every 0.5 hours
-            if (current_time_hours_ - last_log_time >= 0.5)
+            if (profile)
             {
-                log_event("Frame " + std::to_string(frame_count) + " completed - Time: " + std::to_string(current_time_hours_) + "h");
-                last_log_time = current_time_hours_;
+                profile->frames++;
+                profile->active_frames += profile->state_changes != state_changes;
+                profile->sample_charger_queue(current_time_hours_, charger_mgr.get_queue_size());
             }
+
+            advance_frame_clock();
+            publish_progress(charger_mgr);
+            write_due_checkpoints(charger_mgr, fleet);
         }
 
         // Handle partial activities if enabled
+        phase_timer.next(ProfilePhase::FINALIZE);
         if (config_.enable_partial_flights)
         {
             log_event("=== Processing partial activities ===");
             finalize_simulation(fleet);
         }
+        if (profile)
+        {
+            profile->end_run(simulation_duration_hours_);
+        }
+        publish_progress(charger_mgr, true);
 
         log_event("=== Frame-based simulation completed ===");
-        log_event("Total frames processed: " + std::to_string(frame_count));
+        log_event([&] { return "Total frames processed: " + std::to_string(frame_count_); });
         is_running_ = false;
     }
 
+    /**
+     * Restore the clock, frame state, chargers, fleet and statistics from checkpoint_options.restore_path
+     * The run may be longer or shorter than the one that wrote the checkpoint; the frame time must match.
+     * @throws std::runtime_error if the checkpoint cannot be read or does not fit this set-up
+     */
+    template <typename Fleet>
+    void FrameBasedSimulationEngine::resume_from_checkpoint(ChargerManager &charger_mgr, Fleet &fleet)
+    {
+        const std::string &path = checkpoint_options_.restore_path;
+        CheckpointHeader expected{SimulationMode::FRAME_BASED, 0.0, frame_time_seconds_, fleet.size()};
+        CheckpointHeader header = read_checkpoint(
+            path, expected, simulation_duration_hours_, [&](SnapshotReader &in)
+            { restore_state(in, fleet.size()); },
+            charger_mgr, fleet, stats_collector_);
+
+        fleet_index_.build(fleet);
+        retargeted_.clear();
+        retargeted_flags_.assign(fleet.size(), 0);
+
+        log_event([&] { return "=== Resuming frame-based simulation from " + path + " (" +
+                               std::to_string(header.time_hours) + "h) ==="; });
+        if (checkpoint_options_.branch_seed)
+        {
+            seed_fleet_streams(fleet, *checkpoint_options_.branch_seed);
+        }
+        apply_fault_model(fleet, config_.fault_model);
+
+        checkpoints_.start(checkpoint_options_.every_hours, header.time_hours);
+    }
+
+    /**
+     * Checkpoints are taken between frames, at the first frame boundary at or after each checkpoint time
+     */
+    template <typename Fleet>
+    void FrameBasedSimulationEngine::write_due_checkpoints(const ChargerManager &charger_mgr, const Fleet &fleet)
+    {
+        while (checkpoints_.due(current_time_hours_, simulation_duration_hours_))
+        {
+            std::string path = checkpoint_file_name(checkpoint_options_.path_prefix, checkpoints_.take());
+            write_checkpoint(path, {SimulationMode::FRAME_BASED, current_time_hours_, frame_time_seconds_, fleet.size()},
+                             [&](SnapshotWriter &out)
+                             { save_state(out); },
+                             charger_mgr, fleet, stats_collector_);
+            log_event([&] { return "Checkpoint written: " + path; });
+        }
+    }
+
     template <typename Fleet>
     void FrameBasedSimulationEngine::initialize_aircraft_states(Fleet &fleet)
     {
         log_event("Initializing aircraft states...");
-        aircraft_frame_data_.resize(fleet.size());
+        frame_state_.reset(fleet.size());
+        fleet_index_.build(fleet);
+        retargeted_.clear();
+        retargeted_flags_.assign(fleet.size(), 0);
 
         for (size_t i = 0; i < fleet.size(); ++i)
         {
-            auto &frame_data = aircraft_frame_data_[i];
-            frame_data.reset_for_activity(AircraftState::IDLE, 0.0);
+            frame_state_.reset_for_activity(i, AircraftState::IDLE, 0.0);
+        }
+        prefetch_fault_draws(fleet, frame_state_.idle_aircraft());
 
+        for (size_t i = 0; i < fleet.size(); ++i)
+        {
             // Schedule initial flight
             start_new_flight(fleet, i);
         }
         log_event("Aircraft states initialized - all aircraft scheduled for initial flights");
     }
 
+    /**
+     * Same result as processing every aircraft in index order (full_frame_scan), bit for bit
+     * advance_all_timers applies the frame's decrement to every timer and lists those that ran out.
+     * Only those aircraft, idle aircraft and (while a charger is free) queued aircraft take part in
+     * the serial pass, which replays them in fleet order so charger requests, queue order, RNG draws
+     * and statistics happen exactly as in a full per-aircraft loop. The only cross-aircraft write is
+     * a charging completion handing its charger to a queued aircraft; if that aircraft has a higher
+     * index, the full loop would still process it this frame, so it is re-run from scratch at its turn.
+     */
     template <typename Fleet>
     void FrameBasedSimulationEngine::update_frame(ChargerManager &charger_mgr, Fleet &fleet)
     {
-        for (size_t i = 0; i < fleet.size(); ++i)
+        if (config_.full_frame_scan)
         {
-            process_aircraft_state(charger_mgr, fleet, i);
+            // Reference stepping: every aircraft through the scalar timer step and its state, in fleet
+            // order, so zero-duration activities and retargeted aircraft need no bookkeeping
+            expired_.clear();
+            frame_state_.take_zero_duration_activities(expired_);
+            expired_.clear();
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                process_aircraft_state(charger_mgr, fleet, i);
+            }
+            return;
+        }
+
+        advance_all_timers();
+
+        // State changes during the pass only touch the bitmaps at the current index, apart from
+        // retargeted aircraft leaving the queue, which are visited through retargeted_ anyway
+        const IndexBitmap &idle = frame_state_.idle_aircraft();
+        const IndexBitmap &waiting = frame_state_.waiting_aircraft();
+        prefetch_fault_draws(fleet, idle);
+        size_t expired_pos = 0;
+        size_t next_idle = idle.next(0);
+        size_t next_waiting = waiting.next(0);
+
+        arbitration_active_ = true;
+        while (true)
+        {
+            size_t next_expired = expired_pos < expired_.size() ? expired_[expired_pos] : NO_AIRCRAFT;
+            size_t next_retargeted = retargeted_.empty() ? NO_AIRCRAFT : retargeted_.front();
+            size_t next_event = std::min({next_expired, next_idle, next_retargeted});
+
+            // With every charger taken, polls fail without side effects up to the next event
+            if (next_waiting < next_event && charger_mgr.get_available_chargers() == 0)
+            {
+                next_waiting = next_event == NO_AIRCRAFT ? NO_AIRCRAFT : waiting.next(next_event);
+            }
+
+            size_t aircraft_idx = std::min(next_event, next_waiting);
+            if (aircraft_idx == NO_AIRCRAFT)
+            {
+                break;
+            }
+            if (aircraft_idx == next_expired)
+            {
+                ++expired_pos;
+            }
+            while (!retargeted_.empty() && retargeted_.front() == aircraft_idx)
+            {
+                std::pop_heap(retargeted_.begin(), retargeted_.end(), std::greater<size_t>());
+                retargeted_.pop_back();
+            }
+
+            arbitration_index_ = aircraft_idx;
+            if (retargeted_flags_[aircraft_idx])
+            {
+                // The kernel's decrement applied to the state it had before being retargeted
+                retargeted_flags_[aircraft_idx] = 0;
+                process_aircraft_state(charger_mgr, fleet, aircraft_idx);
+            }
+            else
+            {
+                dispatch_aircraft_state(charger_mgr, fleet, aircraft_idx);
+            }
+
+            if (aircraft_idx == next_idle)
+            {
+                next_idle = idle.next(aircraft_idx + 1);
+            }
+            if (aircraft_idx == next_waiting)
+            {
+                next_waiting = waiting.next(aircraft_idx + 1);
+            }
         }
+        arbitration_active_ = false;
     }
 
     template <typename Fleet>
     void FrameBasedSimulationEngine::process_aircraft_state(ChargerManager &charger_mgr, Fleet &fleet,
                                                             size_t aircraft_idx)
     {
-        auto &frame_data = aircraft_frame_data_[aircraft_idx];
-
         double delta_time_sec = frame_time_seconds_; // This is in seconds
 
-        frame_data.update_time_remaining(delta_time_sec);
+        frame_state_.update_time_remaining(aircraft_idx, delta_time_sec);
 
+        dispatch_aircraft_state(charger_mgr, fleet, aircraft_idx);
+    }
+
+    template <typename Fleet>
+    void FrameBasedSimulationEngine::dispatch_aircraft_state(ChargerManager &charger_mgr, Fleet &fleet,
+                                                             size_t aircraft_idx)
+    {
         // Process based on current state
-        switch (frame_data.get_state())
+        switch (frame_state_.get_state(aircraft_idx))
         {
         case AircraftState::FLYING:
-            if (frame_data.time_remaining_sec <= 0.0)
+            if (frame_state_.get_time_remaining(aircraft_idx) <= 0.0)
             {
                 handle_flight_completion(charger_mgr, fleet, aircraft_idx);
             }
             break;
 
         case AircraftState::CHARGING:
-            if (frame_data.time_remaining_sec <= 0.0)
+            if (frame_state_.get_time_remaining(aircraft_idx) <= 0.0)
             {
                 handle_charging_completion(charger_mgr, fleet, aircraft_idx);
             }
@@ -192,11 +484,12 @@ namespace evtol
             if (charger_mgr.request_charger(fleet[aircraft_idx]->get_id()))
             {
                 // Calculate waiting time
-                double waiting_time = (current_time_hours_ - frame_data.waiting_start_time) * 3600.0; // Convert to seconds
-                frame_data.accumulated_waiting_time_sec = waiting_time;
+                auto &activity = frame_state_.activity(aircraft_idx);
+                double waiting_time = (current_time_hours_ - activity.waiting_start_time) * 3600.0; // Convert to seconds
+                activity.accumulated_waiting_time_sec = waiting_time;
 
-                log_event("Aircraft " + std::to_string(fleet[aircraft_idx]->get_id()) + " assigned charger after waiting " +
-                          std::to_string(waiting_time / 3600.0) + "h");
+                log_event([&] { return "Aircraft " + std::to_string(fleet[aircraft_idx]->get_id()) + " assigned charger after waiting " +
+                                       std::to_string(waiting_time / 3600.0) + "h"; });
                 start_charging(charger_mgr, fleet, aircraft_idx);
             }
             break;
@@ -216,43 +509,50 @@ namespace evtol
     void FrameBasedSimulationEngine::handle_flight_completion(ChargerManager &charger_mgr, Fleet &fleet,
                                                               size_t aircraft_idx)
     {
-        auto &aircraft = fleet[aircraft_idx];
-        auto &frame_data = aircraft_frame_data_[aircraft_idx];
+        auto &&aircraft = fleet[aircraft_idx];
+        auto &activity = frame_state_.activity(aircraft_idx);
 
-        log_event("Aircraft " + std::to_string(aircraft->get_id()) + " completed flight (" +
-                  std::to_string(frame_data.current_flight_distance) + " miles, " +
-                  std::to_string(frame_data.current_flight_time_hrs) + "h)");
+        log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " completed flight (" +
+                               std::to_string(activity.current_flight_distance) + " miles, " +
+                               std::to_string(activity.current_flight_time_hrs) + "h)"; });
 
         // Discharge battery (this really should be called each update_frame, but for simplicity lets do it here)
         aircraft->discharge_battery();
 
         // Record statistics
-        stats_collector_.record_flight(aircraft->get_type(),
-                                       frame_data.current_flight_time_hrs,
-                                       frame_data.current_flight_distance,
+        stats_recorder_.record_flight(aircraft->get_type(),
+                                       activity.current_flight_time_hrs,
+                                       activity.current_flight_distance,
                                        aircraft->get_passenger_count());
+        trace(aircraft->get_id(), TraceEventType::FLIGHT_COMPLETE, aircraft->get_type(),
+              activity.current_flight_time_hrs, activity.current_flight_distance);
 
-        if (frame_data.fault_occurred)
+        if (activity.fault_occurred)
         {
-            log_event("Aircraft " + std::to_string(aircraft->get_id()) + " experienced fault during flight - aircraft grounded");
-            stats_collector_.record_fault(aircraft->get_type());
-            frame_data.transition_to(AircraftState::FAULT);
+            log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " experienced fault during flight - aircraft grounded"; });
+            stats_recorder_.record_fault(aircraft->get_type());
+            trace(aircraft->get_id(), TraceEventType::FAULT, aircraft->get_type(), activity.current_flight_time_hrs);
+            frame_state_.transition_to(aircraft_idx, AircraftState::FAULT);
             return;
         }
 
         // Try to get a charger
         if (charger_mgr.request_charger(aircraft->get_id()))
         {
-            log_event("Aircraft " + std::to_string(aircraft->get_id()) + " assigned to charger immediately");
+            log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " assigned to charger immediately"; });
+            stats_recorder_.record_queue_length(aircraft->get_type(), 0);
             start_charging(charger_mgr, fleet, aircraft_idx);
         }
         else
         {
-            log_event("Aircraft " + std::to_string(aircraft->get_id()) + " added to charging queue (no chargers available)");
-            charger_mgr.add_to_queue(aircraft->get_id());
-            frame_data.waiting_start_time = current_time_hours_;
-            frame_data.accumulated_waiting_time_sec = 0.0;
-            frame_data.transition_to(AircraftState::WAITING_FOR_CHARGER);
+            log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " added to charging queue (no chargers available)"; });
+            int queue_length = charger_mgr.get_queue_size(charger_mgr.get_home_pool(aircraft->get_id()));
+            stats_recorder_.record_queue_length(aircraft->get_type(), queue_length);
+            trace(aircraft->get_id(), TraceEventType::CHARGER_QUEUED, aircraft->get_type(), queue_length);
+            charger_mgr.queue_for_charger(aircraft);
+            activity.waiting_start_time = current_time_hours_;
+            activity.accumulated_waiting_time_sec = 0.0;
+            frame_state_.transition_to(aircraft_idx, AircraftState::WAITING_FOR_CHARGER);
         }
     }
 
@@ -260,47 +560,45 @@ namespace evtol
     void FrameBasedSimulationEngine::handle_charging_completion(ChargerManager &charger_mgr, Fleet &fleet,
                                                                 size_t aircraft_idx)
     {
-        auto &aircraft = fleet[aircraft_idx];
-        auto &frame_data = aircraft_frame_data_[aircraft_idx];
+        auto &&aircraft = fleet[aircraft_idx];
 
-        double waiting_time_hours = frame_data.accumulated_waiting_time_sec / 3600.0; // Convert to hours
-        log_event("Aircraft " + std::to_string(aircraft->get_id()) + " completed charging (" +
-                  std::to_string(aircraft->get_charge_time_hours()) + "h charge, " +
-                  std::to_string(waiting_time_hours) + "h wait)");
+        double waiting_time_hours = frame_state_.activity(aircraft_idx).accumulated_waiting_time_sec / 3600.0; // Convert to hours
+        log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " completed charging (" +
+                               std::to_string(aircraft->get_charge_time_hours()) + "h charge, " +
+                               std::to_string(waiting_time_hours) + "h wait)"; });
 
         // Charge battery
         aircraft->charge_battery();
 
         // Record statistics including waiting time
-        stats_collector_.record_charge_session(aircraft->get_type(),
+        stats_recorder_.record_charge_session(aircraft->get_type(),
                                                aircraft->get_charge_time_hours(),
                                                waiting_time_hours);
+        trace(aircraft->get_id(), TraceEventType::CHARGE_COMPLETE, aircraft->get_type(),
+              aircraft->get_charge_time_hours(), waiting_time_hours);
 
         // Release charger
         charger_mgr.release_charger(aircraft->get_id());
-        frame_data.charger_id = -1;
+        frame_state_.set_charger_id(aircraft_idx, -1);
 
         // Start next aircraft in queue
-        int next_aircraft_id = charger_mgr.get_next_from_queue();
+        int next_aircraft_id = charger_mgr.get_next_from_queue(charger_mgr.get_home_pool(aircraft->get_id()));
         if (next_aircraft_id != -1)
         {
-            // Find the aircraft in the fleet
-            for (size_t i = 0; i < fleet.size(); ++i)
+            size_t next_index = fleet_index_.index_of(next_aircraft_id);
+            if (next_index != FleetIndex::npos)
             {
-                if (fleet[i]->get_id() == next_aircraft_id)
-                {
-                    charger_mgr.assign_charger(next_aircraft_id);
+                charger_mgr.assign_charger(next_aircraft_id);
 
-                    // Calculate waiting time for this aircraft
-                    auto &next_frame_data = aircraft_frame_data_[i];
-                    double waiting_time = (current_time_hours_ - next_frame_data.waiting_start_time) * 3600.0; // Convert to seconds
-                    next_frame_data.accumulated_waiting_time_sec = waiting_time;
+                // Calculate waiting time for this aircraft
+                auto &next_activity = frame_state_.activity(next_index);
+                double waiting_time = (current_time_hours_ - next_activity.waiting_start_time) * 3600.0; // Convert to seconds
+                next_activity.accumulated_waiting_time_sec = waiting_time;
 
-                    log_event("Aircraft " + std::to_string(next_aircraft_id) + " removed from queue and assigned charger (waited " +
-                              std::to_string(waiting_time / 3600.0) + "h)");
-                    start_charging(charger_mgr, fleet, i);
-                    break;
-                }
+                log_event([&] { return "Aircraft " + std::to_string(next_aircraft_id) + " removed from queue and assigned charger (waited " +
+                                       std::to_string(waiting_time / 3600.0) + "h)"; });
+                start_charging(charger_mgr, fleet, next_index);
+                note_retargeted(next_index);
             }
         }
         else
@@ -308,19 +606,19 @@ namespace evtol
             log_event("Charger freed but no aircraft waiting in queue");
         }
 
-        log_event("Aircraft " + std::to_string(aircraft->get_id()) + " ready for next flight");
+        log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " ready for next flight"; });
         // Transition to idle state
-        frame_data.transition_to(AircraftState::IDLE);
+        frame_state_.transition_to(aircraft_idx, AircraftState::IDLE);
     }
 
     template <typename Fleet>
     void FrameBasedSimulationEngine::start_new_flight(Fleet &fleet, size_t aircraft_idx)
     {
-        auto &aircraft = fleet[aircraft_idx];
-        auto &frame_data = aircraft_frame_data_[aircraft_idx];
+        auto &&aircraft = fleet[aircraft_idx];
+        auto &activity = frame_state_.activity(aircraft_idx);
 
         // Only start if aircraft is idle
-        if (frame_data.get_state() != AircraftState::IDLE)
+        if (frame_state_.get_state(aircraft_idx) != AircraftState::IDLE)
         {
             return;
         }
@@ -329,43 +627,65 @@ namespace evtol
         double flight_distance = aircraft->get_flight_distance_miles();
 
         // Set flight-specific data first
-        frame_data.current_flight_time_hrs = flight_time;
-        frame_data.current_flight_distance = flight_distance;
+        activity.current_flight_time_hrs = flight_time;
+        activity.current_flight_distance = flight_distance;
         bool will_fault = aircraft->check_fault_during_flight(flight_time) > 0;
 
-        log_event("Starting flight for aircraft " + std::to_string(aircraft->get_id()) +
-                  " (distance: " + std::to_string(flight_distance) + " miles, flight time: " +
-                  std::to_string(flight_time) + "h)");
+        log_event([&] { return "Starting flight for aircraft " + std::to_string(aircraft->get_id()) +
+                               " (distance: " + std::to_string(flight_distance) + " miles, flight time: " +
+                               std::to_string(flight_time) + "h)"; });
 
         if (will_fault)
         {
-            log_event("Aircraft " + std::to_string(aircraft->get_id()) + " will experience fault during this flight");
+            log_event([&] { return "Aircraft " + std::to_string(aircraft->get_id()) + " will experience fault during this flight"; });
         }
 
-        frame_data.reset_for_activity(AircraftState::FLYING, flight_time * 3600.0); // Convert to seconds
+        frame_state_.reset_for_activity(aircraft_idx, AircraftState::FLYING, flight_time * 3600.0); // Convert to seconds
+        trace(aircraft->get_id(), TraceEventType::FLIGHT_START, aircraft->get_type(), flight_time, flight_distance);
 
         // Set fault status after reset (since reset clears fault_occurred)
-        frame_data.fault_occurred = will_fault;
+        activity.fault_occurred = will_fault;
+    }
+
+    /**
+     * Idle aircraft at the start of a pass are exactly the ones that start flights in it, each taking
+     * one or two fault draws; their blocks are generated together, FILL_LANES streams at a time.
+     * The draws themselves still happen in start_new_flight, in fleet order, with the same values.
+     */
+    template <typename Fleet>
+    void FrameBasedSimulationEngine::prefetch_fault_draws(Fleet &fleet, const IndexBitmap &starting)
+    {
+        if (config_.full_frame_scan || starting.count() < 2)
+        {
+            return;
+        }
+
+        fault_streams_.clear();
+        for (size_t i = starting.next(0); i != IndexBitmap::npos; i = starting.next(i + 1))
+        {
+            fault_streams_.push_back(fleet[i]->random_stream());
+        }
+        RandomStream::prefetch_blocks(fault_streams_);
     }
 
     template <typename Fleet>
     void FrameBasedSimulationEngine::start_charging(ChargerManager &charger_mgr, Fleet &fleet, size_t aircraft_idx)
     {
-        auto &aircraft = fleet[aircraft_idx];
-        auto &frame_data = aircraft_frame_data_[aircraft_idx];
+        auto &&aircraft = fleet[aircraft_idx];
 
         double charge_time_hrs = aircraft->get_charge_time_hours();
-        frame_data.charger_id = charger_mgr.get_charger_id(aircraft->get_id());
+        frame_state_.set_charger_id(aircraft_idx, charger_mgr.get_charger_id(aircraft->get_id()));
 
-        double waiting_time_hours = frame_data.accumulated_waiting_time_sec / 3600.0; // Convert to hours
-        log_event("Starting charging for aircraft " + std::to_string(aircraft->get_id()) +
-                  " (charge time: " + std::to_string(charge_time_hrs) + "h, waited: " +
-                  std::to_string(waiting_time_hours) + "h)");
+        double waiting_time_hours = frame_state_.activity(aircraft_idx).accumulated_waiting_time_sec / 3600.0; // Convert to hours
+        log_event([&] { return "Starting charging for aircraft " + std::to_string(aircraft->get_id()) +
+                               " (charge time: " + std::to_string(charge_time_hrs) + "h, waited: " +
+                               std::to_string(waiting_time_hours) + "h)"; });
 
         // If accumulated_waiting_time_sec is 0, it means this aircraft got a charger immediately
         // and wasn't waiting
 
-        frame_data.reset_for_activity(AircraftState::CHARGING, charge_time_hrs * 3600.0); // Convert to seconds
+        frame_state_.reset_for_activity(aircraft_idx, AircraftState::CHARGING, charge_time_hrs * 3600.0); // Convert to seconds
+        trace(aircraft->get_id(), TraceEventType::CHARGE_START, aircraft->get_type(), charge_time_hrs, waiting_time_hours);
     }
 
     template <typename Fleet>
@@ -377,17 +697,19 @@ namespace evtol
         // Process partial activities for aircraft still in flight or charging
         for (size_t i = 0; i < fleet.size(); ++i)
         {
-            auto &aircraft = fleet[i];
-            auto &frame_data = aircraft_frame_data_[i];
+            auto &&aircraft = fleet[i];
+            double time_remaining_sec = frame_state_.get_time_remaining(i);
 
-            switch (frame_data.get_state())
+            switch (frame_state_.get_state(i))
             {
             case AircraftState::FLYING:
-                handle_partial_flight(aircraft, frame_data);
+                handle_partial_flight(aircraft->get_id(), aircraft->get_type(), aircraft->get_passenger_count(),
+                                      time_remaining_sec, frame_state_.activity(i));
                 break;
 
             case AircraftState::CHARGING:
-                handle_partial_charging(aircraft, frame_data);
+                handle_partial_charging(aircraft->get_id(), aircraft->get_type(), aircraft->get_charge_time_hours(),
+                                        time_remaining_sec, frame_state_.activity(i));
                 break;
 
             default:
@@ -403,10 +725,10 @@ namespace evtol
         // Validate that all aircraft are in valid states
         for (size_t i = 0; i < fleet.size(); ++i)
         {
-            auto state = aircraft_frame_data_[i].get_state();
+            auto state = frame_state_.get_state(i);
             if (state == AircraftState::CHARGING)
             {
-                if (aircraft_frame_data_[i].charger_id == -1)
+                if (frame_state_.get_charger_id(i) == -1)
                 {
                     return false; // Aircraft charging but no charger assigned
                 }
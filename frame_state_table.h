@@ -0,0 +1,265 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "aircraft_state.h"
+#include "snapshot.h"
+
+namespace evtol
+{
+    /**
+     * Per-activity bookkeeping that the frame loop only touches when an aircraft changes state
+     */
+    struct AircraftActivityData
+    {
+        double current_flight_time_hrs{0.0};      // Current flight duration
+        double current_flight_distance{0.0};      // Current flight distance
+        bool fault_occurred{false};
+        double waiting_start_time{0.0};           // Time when waiting started
+        double accumulated_waiting_time_sec{0.0}; // Total waiting time for current charge cycle
+    };
+
+    /**
+     * Set of fleet positions with ordered iteration
+     */
+    class IndexBitmap
+    {
+    private:
+        std::vector<std::uint64_t> words_;
+        size_t count_ = 0;
+
+    public:
+        static constexpr size_t npos = SIZE_MAX;
+
+        void assign(size_t size)
+        {
+            words_.assign((size + 63) / 64, 0);
+            count_ = 0;
+        }
+
+        void insert(size_t index)
+        {
+            std::uint64_t bit = std::uint64_t{1} << (index % 64);
+            std::uint64_t &word = words_[index / 64];
+            count_ += (word & bit) == 0;
+            word |= bit;
+        }
+
+        void erase(size_t index)
+        {
+            std::uint64_t bit = std::uint64_t{1} << (index % 64);
+            std::uint64_t &word = words_[index / 64];
+            count_ -= (word & bit) != 0;
+            word &= ~bit;
+        }
+
+        bool empty() const { return count_ == 0; }
+        size_t count() const { return count_; }
+
+        /**
+         * @return Smallest member >= from, or npos
+         */
+        size_t next(size_t from) const
+        {
+            size_t word_index = from / 64;
+            if (word_index >= words_.size())
+            {
+                return npos;
+            }
+
+            std::uint64_t word = words_[word_index] & (~std::uint64_t{0} << (from % 64));
+            while (word == 0)
+            {
+                if (++word_index == words_.size())
+                {
+                    return npos;
+                }
+                word = words_[word_index];
+            }
+            return word_index * 64 + static_cast<size_t>(std::countr_zero(word));
+        }
+    };
+
+    /**
+     * Structure-of-arrays frame state for the frame-based engine
+     * The columns scanned every frame (timer, state, charger) are dense, and idle / waiting aircraft
+     * are tracked in bitmaps, so a frame only visits the aircraft that actually act.
+     * State changes mirror AircraftFrameData::transition_to and reset_for_activity.
+     */
+    class FrameStateTable
+    {
+    private:
+        std::vector<double> time_remaining_sec_;
+        std::vector<AircraftState> states_;
+        std::vector<int> charger_ids_;
+        std::vector<AircraftActivityData> activities_;
+
+        IndexBitmap idle_;
+        IndexBitmap waiting_;
+
+        // Timed activities started with no duration; their timer never crosses zero in the kernel
+        std::vector<size_t> zero_duration_;
+
+        void set_state(size_t index, AircraftState new_state)
+        {
+            AircraftState old_state = states_[index];
+            if (old_state == AircraftState::IDLE)
+                idle_.erase(index);
+            else if (old_state == AircraftState::WAITING_FOR_CHARGER)
+                waiting_.erase(index);
+
+            if (new_state == AircraftState::IDLE)
+                idle_.insert(index);
+            else if (new_state == AircraftState::WAITING_FOR_CHARGER)
+                waiting_.insert(index);
+
+            states_[index] = new_state;
+        }
+
+    public:
+        /**
+         * Size the table for a fleet, every aircraft idle with no timer or charger
+         */
+        void reset(size_t count)
+        {
+            time_remaining_sec_.assign(count, 0.0);
+            states_.assign(count, AircraftState::IDLE);
+            charger_ids_.assign(count, -1);
+            activities_.assign(count, AircraftActivityData{});
+            idle_.assign(count);
+            waiting_.assign(count);
+            zero_duration_.clear();
+            for (size_t i = 0; i < count; ++i)
+            {
+                idle_.insert(i);
+            }
+        }
+
+        size_t size() const { return states_.size(); }
+
+        AircraftState get_state(size_t index) const { return states_[index]; }
+
+        /**
+         * Safely transition to a new state
+         * @return True if transition was successful
+         */
+        bool transition_to(size_t index, AircraftState new_state)
+        {
+            if (!AircraftStateMachine::is_valid_transition(states_[index], new_state))
+            {
+                std::cerr << "ERROR: Invalid Transition State Machine Attempted" << std::endl;
+                return false;
+            }
+
+            set_state(index, new_state);
+            return true;
+        }
+
+        /**
+         * Start a new timed activity
+         * @param duration_sec Duration of the new activity
+         */
+        void reset_for_activity(size_t index, AircraftState new_state, double duration_sec)
+        {
+            set_state(index, new_state);
+            time_remaining_sec_[index] = duration_sec;
+
+            AircraftActivityData &activity = activities_[index];
+            activity.fault_occurred = false;
+            if (new_state == AircraftState::FLYING)
+            {
+                activity.current_flight_time_hrs = duration_sec / 3600.0;
+            }
+
+            bool timed = new_state == AircraftState::FLYING || new_state == AircraftState::CHARGING;
+            if (timed && !(duration_sec > 0.0))
+            {
+                zero_duration_.push_back(index);
+            }
+        }
+
+        double get_time_remaining(size_t index) const { return time_remaining_sec_[index]; }
+
+        /**
+         * Scalar timer step, identical to AircraftFrameData::update_time_remaining
+         */
+        double update_time_remaining(size_t index, double delta_time_sec)
+        {
+            double new_time = std::max(0.0, time_remaining_sec_[index] - delta_time_sec);
+            time_remaining_sec_[index] = new_time;
+            return new_time;
+        }
+
+        int get_charger_id(size_t index) const { return charger_ids_[index]; }
+        void set_charger_id(size_t index, int charger_id) { charger_ids_[index] = charger_id; }
+
+        AircraftActivityData &activity(size_t index) { return activities_[index]; }
+        const AircraftActivityData &activity(size_t index) const { return activities_[index]; }
+
+        const IndexBitmap &idle_aircraft() const { return idle_; }
+        const IndexBitmap &waiting_aircraft() const { return waiting_; }
+
+        /**
+         * Move the aircraft whose last activity started already expired into out (unordered)
+         */
+        void take_zero_duration_activities(std::vector<size_t> &out)
+        {
+            out.insert(out.end(), zero_duration_.begin(), zero_duration_.end());
+            zero_duration_.clear();
+        }
+
+        bool has_zero_duration_activities() const { return !zero_duration_.empty(); }
+
+        /**
+         * Every column, for checkpoints; the bitmaps are rebuilt from the states on restore
+         */
+        void save_state(SnapshotWriter &out) const
+        {
+            out.begin_section(snapshot_tag("FRST"));
+            out.write_vector(time_remaining_sec_);
+            out.write_vector(states_);
+            out.write_vector(charger_ids_);
+            out.write_vector(activities_);
+            out.write_vector(zero_duration_);
+        }
+
+        /**
+         * @throws std::runtime_error if the saved table is not for count aircraft
+         */
+        void restore_state(SnapshotReader &in, size_t count)
+        {
+            in.expect_section(snapshot_tag("FRST"));
+            time_remaining_sec_ = in.read_vector<double>();
+            states_ = in.read_vector<AircraftState>();
+            charger_ids_ = in.read_vector<int>();
+            activities_ = in.read_vector<AircraftActivityData>();
+            zero_duration_ = in.read_vector<size_t>();
+
+            if (time_remaining_sec_.size() != count || states_.size() != count ||
+                charger_ids_.size() != count || activities_.size() != count)
+            {
+                throw std::runtime_error("Checkpoint frame state does not match the fleet size");
+            }
+
+            idle_.assign(count);
+            waiting_.assign(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (states_[i] == AircraftState::IDLE)
+                    idle_.insert(i);
+                else if (states_[i] == AircraftState::WAITING_FOR_CHARGER)
+                    waiting_.insert(i);
+            }
+        }
+
+        // Column access for the frame kernels
+        std::vector<double> &time_remaining_column() { return time_remaining_sec_; }
+        const std::vector<double> &time_remaining_column() const { return time_remaining_sec_; }
+        const std::vector<AircraftState> &state_column() const { return states_; }
+    };
+}
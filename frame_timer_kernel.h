@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#if !defined(EVTOL_NO_SIMD) && __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+
+#if !defined(EVTOL_NO_SIMD) && defined(__cpp_lib_experimental_parallel_simd)
+#define EVTOL_SIMD_TIMERS 1
+#endif
+
+namespace evtol
+{
+    /**
+     * One frame of timer updates for positions [begin, end)
+     * Every timer becomes max(0, t - delta_time_sec), exactly as AircraftFrameData::update_time_remaining,
+     * and the positions whose timer reaches zero in this step are appended to expired in ascending order.
+     */
+    inline void advance_frame_timers_scalar(std::vector<double> &timers, size_t begin, size_t end,
+                                            double delta_time_sec, std::vector<size_t> &expired)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            double old_time = timers[i];
+            double new_time = old_time - delta_time_sec;
+            bool running = new_time > 0.0;
+            timers[i] = running ? new_time : 0.0;
+            if (old_time > 0.0 && !running)
+            {
+                expired.push_back(i);
+            }
+        }
+    }
+
+    /**
+     * Vectorized form of advance_frame_timers_scalar (std::experimental::simd when available)
+     * Blocks without an expiring timer are written back without touching the expired list, which is
+     * the common case: most aircraft are mid-flight or mid-charge in any given frame.
+     */
+    inline void advance_frame_timers(std::vector<double> &timers, size_t begin, size_t end,
+                                     double delta_time_sec, std::vector<size_t> &expired)
+    {
+#ifdef EVTOL_SIMD_TIMERS
+        namespace stdx = std::experimental;
+        using Block = stdx::native_simd<double>;
+        constexpr size_t WIDTH = Block::size();
+
+        const Block delta(delta_time_sec);
+        const Block zero(0.0);
+
+        size_t i = begin;
+        for (; i + WIDTH <= end; i += WIDTH)
+        {
+            Block old_time(&timers[i], stdx::element_aligned);
+            Block new_time = old_time - delta;
+            auto running = new_time > zero;
+            auto expiring = (old_time > zero) && !running;
+
+            stdx::where(!running, new_time) = zero;
+            new_time.copy_to(&timers[i], stdx::element_aligned);
+
+            if (stdx::any_of(expiring))
+            {
+                for (size_t lane = 0; lane < WIDTH; ++lane)
+                {
+                    if (expiring[lane])
+                    {
+                        expired.push_back(i + lane);
+                    }
+                }
+            }
+        }
+        advance_frame_timers_scalar(timers, i, end, delta_time_sec, expired);
+#else
+        advance_frame_timers_scalar(timers, begin, end, delta_time_sec, expired);
+#endif
+    }
+}
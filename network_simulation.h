@@ -0,0 +1,485 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "aircraft_state.h"
+#include "aircraft_types.h"
+#include "charger_manager.h"
+#include "event_driven_simulation.h"
+#include "event_scheduler.h"
+#include "fleet_index.h"
+#include "random_stream.h"
+#include "simulation_config.h"
+#include "simulation_interface.h"
+#include "stats_shard.h"
+#include "thread_pool.h"
+
+namespace evtol
+{
+    /**
+     * A flight on its way to another vertiport: the landing event, sent when the aircraft takes off
+     */
+    struct NetworkFlight
+    {
+        double arrival_time_hours;
+        FlightCompleteData flight;
+    };
+
+    /**
+     * Charger pools as the vertiports of a network, each simulated as its own logical process
+     *
+     * Every pool becomes a vertiport with its own event queue, single-pool ChargerManager and
+     * statistics shard. Aircraft start at their home pool; a charged aircraft takes off for another
+     * vertiport drawn from the departure vertiport's routing stream, and its landing is a message to
+     * the destination. Unlike the single-queue engine, a finished charge frees its charger.
+     *
+     * Execution is conservative and window-synchronized. Every flight after the first starts on a
+     * full battery, so it lasts at least the lookahead (the fleet's shortest full-charge flight) and
+     * nothing sent in [T, T + lookahead) lands before T + lookahead. Vertiports run the events of a
+     * window in parallel, then the flights they sent are delivered, destination by destination in
+     * vertiport order, before the next window. Takeoffs at time zero are delivered before the first
+     * window, as a partial battery may fly for less than the lookahead. Every random draw belongs to
+     * an aircraft or a vertiport and deliveries happen in a fixed order, so results do not depend on
+     * the thread count.
+     *
+     * Vertiports use the binary heap whatever config.scheduler says. Runs are not traced, logged or
+     * checkpointed, and statistics are merged into the collector once, at the end of the run.
+     */
+    class NetworkSimulationEngine : public SimulationEngineBase
+    {
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+        static constexpr std::uint64_t ROUTING_SEED_INDEX = 0x524F555445ull; // "ROUTE"
+
+        struct alignas(CACHE_LINE_SIZE) Vertiport
+        {
+            ChargerManager chargers;
+            BinaryHeapScheduler<EventData> events;
+            StatsShard stats;
+            RandomStream routes;
+            ProfileCounters profile;
+            std::vector<std::vector<NetworkFlight>> outbox; // by destination, in takeoff order
+            double current_time_hours = 0.0;
+            std::uint64_t flights_out = 0; // takeoffs for another vertiport
+
+            Vertiport(const ChargerPoolSpec &pool, DispatchPolicy policy, RandomStream routing_stream, size_t vertiport_count)
+                : chargers(std::vector<ChargerPoolSpec>{pool}, policy), routes(routing_stream), outbox(vertiport_count)
+            {
+            }
+        };
+
+        SimulationConfig config_;
+        std::vector<Vertiport> vertiports_;
+        FleetIndex fleet_index_;
+        std::vector<AircraftTimeline> timelines_; // by fleet position
+        std::vector<std::uint32_t> locations_;    // by fleet position: vertiport the aircraft is at or flying to
+        double lookahead_hours_ = 0.0;
+        size_t window_count_ = 0;
+
+        /**
+         * Shortest flight any aircraft of the fleet can take on a full battery
+         */
+        template <typename Fleet>
+        static double shortest_full_charge_flight(const Fleet &fleet)
+        {
+            double shortest = std::numeric_limits<double>::infinity();
+            std::array<bool, NUM_AIRCRAFT_TYPES> seen{};
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                size_t type = static_cast<size_t>(fleet[i]->get_type());
+                if (!seen[type])
+                {
+                    seen[type] = true;
+                    shortest = std::min(shortest, aircraft_type_table()[type].full_charge_flight_time_hours);
+                }
+            }
+            return shortest;
+        }
+
+        size_t pick_destination(Vertiport &origin, size_t origin_index)
+        {
+            if (vertiports_.size() == 1)
+            {
+                return 0;
+            }
+            // Uniform over the other vertiports
+            size_t others = vertiports_.size() - 1;
+            size_t pick = std::min(static_cast<size_t>(origin.routes.next_uniform() * static_cast<double>(others)), others - 1);
+            return pick >= origin_index ? pick + 1 : pick;
+        }
+
+        void build_vertiports(const ChargerManager &charger_mgr)
+        {
+            std::uint64_t seed = RandomStream::derive_seed(config_.random_seed.value_or(RandomStream::entropy_seed()), ROUTING_SEED_INDEX);
+            size_t count = charger_mgr.get_pool_count();
+            vertiports_.clear();
+            vertiports_.reserve(count);
+            for (size_t v = 0; v < count; ++v)
+            {
+                ChargerPoolSpec pool{charger_mgr.get_pool_name(v), charger_mgr.get_pool_charger_count(v)};
+                vertiports_.emplace_back(pool, config_.dispatch_policy, RandomStream(seed, v), count);
+                if (stats_collector_.has_distributions())
+                {
+                    vertiports_.back().stats.enable_distributions();
+                }
+            }
+        }
+
+        template <typename Fleet>
+        void take_off(Vertiport &origin, size_t origin_index, Fleet &fleet, size_t fleet_index)
+        {
+            auto &&aircraft = fleet[fleet_index];
+            double now = origin.current_time_hours;
+            double distance = aircraft->get_flight_distance_miles();
+            double flight_time = aircraft->get_flight_time_hours();
+
+            // The fault is counted by the vertiport the flight leaves, as the landing may come after the run ends
+            double fault_time = aircraft->check_fault_during_flight(flight_time);
+            bool fault_occurred = (fault_time >= 0.0);
+            if (fault_occurred && now + fault_time < simulation_duration_hours_)
+            {
+                origin.stats.record_fault(aircraft->get_type());
+            }
+
+            size_t destination = pick_destination(origin, origin_index);
+            if (destination != origin_index)
+            {
+                origin.flights_out++;
+            }
+            locations_[fleet_index] = static_cast<std::uint32_t>(destination);
+
+            AircraftTimeline &timeline = timelines_[fleet_index];
+            timeline.state = AircraftState::FLYING;
+            timeline.start_time_hours = now;
+            timeline.end_time_hours = now + flight_time;
+            timeline.activity_hours = flight_time;
+            timeline.flight_distance_miles = distance;
+            timeline.fault_time_hours = fault_occurred ? now + fault_time : -1.0;
+
+            origin.outbox[destination].push_back(
+                {timeline.end_time_hours, FlightCompleteData{aircraft->get_id(), fleet_index, flight_time, distance, fault_occurred}});
+        }
+
+        template <typename Fleet>
+        void start_charging(Vertiport &port, Fleet &fleet, size_t fleet_index, double waiting_time)
+        {
+            auto &&aircraft = fleet[fleet_index];
+            double charge_time = aircraft->get_charge_time_hours();
+
+            AircraftTimeline &timeline = timelines_[fleet_index];
+            timeline.state = AircraftState::CHARGING;
+            timeline.start_time_hours = port.current_time_hours;
+            timeline.end_time_hours = port.current_time_hours + charge_time;
+            timeline.activity_hours = charge_time;
+            timeline.waiting_time_hours = waiting_time;
+
+            port.events.push(EventType::CHARGING_COMPLETE, timeline.end_time_hours,
+                             ChargingCompleteData{aircraft->get_id(), fleet_index, charge_time, waiting_time});
+        }
+
+        template <typename Fleet>
+        void land(Vertiport &port, Fleet &fleet, const FlightCompleteData &data)
+        {
+            auto &&aircraft = fleet[data.fleet_index];
+            aircraft->discharge_battery();
+            if (data.fault_occurred)
+            {
+                aircraft->set_faulty(true);
+            }
+            port.stats.record_flight(aircraft->get_type(), data.flight_time, data.distance, aircraft->get_passenger_count());
+
+            AircraftTimeline &timeline = timelines_[data.fleet_index];
+            timeline.fault_time_hours = -1.0;
+            if (aircraft->is_faulty())
+            {
+                timeline.state = AircraftState::FAULT;
+            }
+            else if (port.chargers.request_charger(data.aircraft_id))
+            {
+                port.stats.record_queue_length(aircraft->get_type(), 0);
+                start_charging(port, fleet, data.fleet_index, 0.0);
+            }
+            else
+            {
+                port.stats.record_queue_length(aircraft->get_type(), port.chargers.get_queue_size());
+                port.chargers.queue_for_charger(aircraft);
+                timeline.state = AircraftState::WAITING_FOR_CHARGER;
+                timeline.start_time_hours = port.current_time_hours;
+            }
+        }
+
+        template <typename Fleet>
+        void finish_charging(Vertiport &port, size_t port_index, Fleet &fleet, const ChargingCompleteData &data)
+        {
+            auto &&aircraft = fleet[data.fleet_index];
+            aircraft->charge_battery();
+            port.stats.record_charge_session(aircraft->get_type(), data.charge_time, data.waiting_time);
+            timelines_[data.fleet_index].state = AircraftState::IDLE;
+
+            port.chargers.release_charger(data.aircraft_id);
+            int next_aircraft_id = port.chargers.get_next_from_queue(0);
+            size_t next_index = fleet_index_.index_of(next_aircraft_id);
+            if (next_index != FleetIndex::npos)
+            {
+                port.chargers.request_charger(next_aircraft_id);
+                double waiting_time = port.current_time_hours - timelines_[next_index].start_time_hours;
+                start_charging(port, fleet, next_index, waiting_time);
+            }
+
+            if (port.current_time_hours < simulation_duration_hours_ && !aircraft->is_faulty())
+            {
+                take_off(port, port_index, fleet, data.fleet_index);
+            }
+        }
+
+        /**
+         * Process the vertiport's events before window_end; runs on a worker thread
+         */
+        template <typename Fleet>
+        void run_window(size_t port_index, Fleet &fleet, double window_end, bool profiling)
+        {
+            Vertiport &port = vertiports_[port_index];
+            while (!port.events.empty() && port.events.next_time() < window_end)
+            {
+                auto event = port.events.pop();
+                port.current_time_hours = event.time_hours;
+                if (profiling)
+                {
+                    port.profile.record_event(event.type, port.events.size() + 1);
+                    port.profile.state_changes++;
+                }
+
+                std::visit([&](const auto &data)
+                           {
+                    using T = std::decay_t<decltype(data)>;
+                    if constexpr (std::is_same_v<T, FlightCompleteData>) {
+                        land(port, fleet, data);
+                    } else if constexpr (std::is_same_v<T, ChargingCompleteData>) {
+                        finish_charging(port, port_index, fleet, data);
+                    } }, event.data);
+            }
+        }
+
+        /**
+         * Move the flights every vertiport sent into the destination's queue, in vertiport order
+         */
+        void deliver(size_t destination)
+        {
+            Vertiport &port = vertiports_[destination];
+            for (Vertiport &origin : vertiports_)
+            {
+                for (const NetworkFlight &flight : origin.outbox[destination])
+                {
+                    port.events.push(EventType::FLIGHT_COMPLETE, flight.arrival_time_hours, flight.flight);
+                }
+                origin.outbox[destination].clear();
+            }
+        }
+
+        double earliest_event() const
+        {
+            double earliest = std::numeric_limits<double>::infinity();
+            for (const Vertiport &port : vertiports_)
+            {
+                if (!port.events.empty())
+                {
+                    earliest = std::min(earliest, port.events.next_time());
+                }
+            }
+            return earliest;
+        }
+
+        // Snapshots merge the shards, so they are only taken when a reader waits or the run is finished
+        void publish_network_progress(bool finished)
+        {
+            if (!progress_ || !(finished || progress_->requested()))
+            {
+                return;
+            }
+
+            int in_use = 0, total = 0, queued = 0;
+            for (const Vertiport &port : vertiports_)
+            {
+                in_use += port.chargers.get_active_chargers();
+                total += port.chargers.get_total_chargers();
+                queued += port.chargers.get_queue_size();
+            }
+            if (finished)
+            {
+                progress_->publish(ProgressSnapshot::capture(current_time_hours_, simulation_duration_hours_, stats_collector_,
+                                                             in_use, total, queued, true));
+                return;
+            }
+            StatisticsCollector so_far;
+            for (const Vertiport &port : vertiports_)
+            {
+                so_far.merge(port.stats);
+            }
+            progress_->publish(ProgressSnapshot::capture(current_time_hours_, simulation_duration_hours_, so_far,
+                                                         in_use, total, queued, false));
+        }
+
+        template <typename Fleet>
+        void finalize(Fleet &fleet)
+        {
+            // Flights and charges under way end as partial activities at the vertiport they are bound for
+            for (size_t i = 0; i < timelines_.size(); ++i)
+            {
+                const AircraftTimeline &timeline = timelines_[i];
+                bool counts = timeline.end_time_hours <= simulation_duration_hours_ || config_.enable_partial_flights;
+                if (!counts)
+                {
+                    continue;
+                }
+
+                auto &&aircraft = fleet[i];
+                StatsShard &stats = vertiports_[locations_[i]].stats;
+                double partial_hours = simulation_duration_hours_ - timeline.start_time_hours;
+                if (timeline.state == AircraftState::FLYING)
+                {
+                    double partial_distance = (partial_hours / timeline.activity_hours) * timeline.flight_distance_miles;
+                    stats.record_partial_flight(aircraft->get_type(), partial_hours, partial_distance, aircraft->get_passenger_count());
+                }
+                else if (timeline.state == AircraftState::CHARGING)
+                {
+                    stats.record_partial_charge(aircraft->get_type(), partial_hours);
+                }
+            }
+
+            for (Vertiport &port : vertiports_)
+            {
+                port.events.clear();
+                stats_collector_.merge(port.stats);
+            }
+        }
+
+    public:
+        NetworkSimulationEngine(StatisticsCollector &stats, const SimulationConfig &config)
+            : SimulationEngineBase(stats, config.simulation_duration_hours), config_(config)
+        {
+        }
+
+        /**
+         * Run the network on any fleet container; charger_mgr supplies the vertiports (its pools) and
+         * each aircraft's home vertiport, and is left untouched
+         */
+        template <SimulationFleet Fleet>
+        void run(ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            is_running_ = true;
+            current_time_hours_ = 0.0;
+            window_count_ = 0;
+            build_vertiports(charger_mgr);
+            if (simulation_duration_hours_ <= 0.0)
+            {
+                is_running_ = false;
+                return;
+            }
+
+            ProfileCounters *profile = active_profile();
+            ScopedPhaseTimer phase_timer(profile, ProfilePhase::INIT);
+            if (config_.random_seed)
+            {
+                seed_fleet_streams(fleet, *config_.random_seed);
+            }
+            apply_fault_model(fleet, config_.fault_model);
+
+            fleet_index_.build(fleet);
+            timelines_.assign(fleet.size(), AircraftTimeline{});
+            locations_.assign(fleet.size(), 0);
+            lookahead_hours_ = shortest_full_charge_flight(fleet);
+
+            // Every aircraft takes off from its home vertiport at time zero
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                size_t home = charger_mgr.get_home_pool(fleet[i]->get_id());
+                take_off(vertiports_[home], home, fleet, i);
+            }
+
+            ThreadPool pool(std::min(ThreadPool::resolve_thread_count(config_.num_threads), vertiports_.size()));
+            for (size_t v = 0; v < vertiports_.size(); ++v)
+            {
+                deliver(v);
+            }
+
+            if (profile)
+            {
+                profile->begin_run(0.0);
+            }
+            phase_timer.next(ProfilePhase::MAIN_LOOP);
+
+            // Windows start at the earliest pending event, skipping stretches where nothing happens
+            double window_start = earliest_event();
+            while (window_start < simulation_duration_hours_)
+            {
+                double window_end = std::min(window_start + lookahead_hours_, simulation_duration_hours_);
+                pool.parallel_for(vertiports_.size(), [&](size_t v, size_t)
+                                  { run_window(v, fleet, window_end, profile != nullptr); });
+                pool.parallel_for(vertiports_.size(), [&](size_t v, size_t)
+                                  { deliver(v); });
+
+                ++window_count_;
+                current_time_hours_ = window_end;
+                publish_network_progress(false);
+                window_start = std::max(window_end, earliest_event());
+            }
+
+            phase_timer.next(ProfilePhase::FINALIZE);
+            current_time_hours_ = simulation_duration_hours_;
+            finalize(fleet);
+            if (profile)
+            {
+                for (const Vertiport &port : vertiports_)
+                {
+                    profile->merge(port.profile);
+                }
+                profile->end_run(simulation_duration_hours_);
+            }
+            publish_network_progress(true);
+            is_running_ = false;
+        }
+
+        size_t get_vertiport_count() const { return vertiports_.size(); }
+
+        /**
+         * Window length of the last run: the fleet's shortest full-charge flight
+         */
+        double get_lookahead_hours() const { return lookahead_hours_; }
+
+        /**
+         * Synchronization windows the last run took
+         */
+        size_t get_window_count() const { return window_count_; }
+
+        /**
+         * Statistics the last run recorded at one vertiport
+         */
+        const StatsShard &get_vertiport_stats(size_t vertiport) const { return vertiports_.at(vertiport).stats; }
+
+        /**
+         * Takeoffs for another vertiport in the last run, i.e. messages between logical processes
+         */
+        std::uint64_t get_flights_between_vertiports() const
+        {
+            std::uint64_t flights = 0;
+            for (const Vertiport &port : vertiports_)
+            {
+                flights += port.flights_out;
+            }
+            return flights;
+        }
+
+    protected:
+        void run_simulation_impl(ChargerManager &charger_mgr, AircraftFleet &fleet) override
+        {
+            run(charger_mgr, fleet);
+        }
+    };
+}
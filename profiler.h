@@ -0,0 +1,354 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "event_scheduler.h"
+
+/**
+ * Compile-time switch for the engines' profiling hooks (--profile)
+ * 0 (default) compiles every hook out; 1 keeps them behind the runtime flag. The Makefile builds
+ * debug and test binaries with 1, release binaries with PROFILE (default 0).
+ */
+#ifndef EVTOL_PROFILE
+#define EVTOL_PROFILE 0
+#endif
+
+namespace evtol
+{
+    inline constexpr bool PROFILING_COMPILED_IN = EVTOL_PROFILE > 0;
+
+    inline constexpr size_t NUM_EVENT_TYPES = static_cast<size_t>(EventType::FAULT_OCCURRED) + 1;
+
+    /**
+     * Timed parts of a run; REPORT is the app printing the results
+     */
+    enum class ProfilePhase
+    {
+        INIT,
+        MAIN_LOOP,
+        FINALIZE,
+        REPORT
+    };
+
+    inline constexpr size_t NUM_PROFILE_PHASES = 4;
+
+    inline const char *profile_phase_name(ProfilePhase phase)
+    {
+        switch (phase)
+        {
+        case ProfilePhase::INIT:
+            return "init";
+        case ProfilePhase::MAIN_LOOP:
+            return "main_loop";
+        case ProfilePhase::FINALIZE:
+            return "finalize";
+        case ProfilePhase::REPORT:
+            return "report";
+        }
+        return "unknown";
+    }
+
+    inline const char *event_type_name(EventType type)
+    {
+        switch (type)
+        {
+        case EventType::FLIGHT_COMPLETE:
+            return "flight_complete";
+        case EventType::CHARGING_COMPLETE:
+            return "charging_complete";
+        case EventType::FAULT_OCCURRED:
+            return "fault";
+        }
+        return "unknown";
+    }
+
+    /**
+     * Cheapest monotonic tick source: the time-stamp counter on x86, steady_clock nanoseconds elsewhere
+     * Ticks are converted to seconds with the rate measured over a RunProfile's lifetime.
+     */
+    struct ProfileClock
+    {
+        static std::uint64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                  std::chrono::steady_clock::now().time_since_epoch())
+                                                  .count());
+#endif
+        }
+    };
+
+    /**
+     * Counters of the runs one thread profiles; plain adds, no synchronization
+     */
+    struct ProfileCounters
+    {
+        std::array<std::uint64_t, NUM_PROFILE_PHASES> phase_ticks{};
+
+        // Event-driven: events popped, and the queue depth each one was popped at
+        std::array<std::uint64_t, NUM_EVENT_TYPES> events{};
+        std::uint64_t event_queue_depth_sum = 0;
+        std::uint64_t event_queue_depth_peak = 0;
+
+        // Frame-based: frames run in full, those where an aircraft changed state, and skipped frames
+        std::uint64_t frames = 0;
+        std::uint64_t active_frames = 0;
+        std::uint64_t skipped_frames = 0;
+
+        std::uint64_t state_changes = 0;
+
+        // Charger queue length integrated over simulated time
+        double charger_queue_hours = 0.0; // sum of length * hours
+        double simulated_hours = 0.0;
+        std::uint64_t charger_queue_peak = 0;
+
+        void record_event(EventType type, size_t queue_depth)
+        {
+            events[static_cast<size_t>(type)]++;
+            event_queue_depth_sum += queue_depth;
+            event_queue_depth_peak = std::max<std::uint64_t>(event_queue_depth_peak, queue_depth);
+        }
+
+        void begin_run(double start_hours)
+        {
+            run_start_hours_ = start_hours;
+            sample_time_hours_ = start_hours;
+            charger_queue_length_ = 0;
+        }
+
+        /**
+         * The charger queue holds length aircraft from time_hours until the next sample
+         */
+        void sample_charger_queue(double time_hours, size_t length)
+        {
+            charger_queue_hours += static_cast<double>(charger_queue_length_) * (time_hours - sample_time_hours_);
+            sample_time_hours_ = time_hours;
+            charger_queue_length_ = length;
+            charger_queue_peak = std::max<std::uint64_t>(charger_queue_peak, length);
+        }
+
+        void end_run(double end_hours)
+        {
+            sample_charger_queue(std::max(end_hours, sample_time_hours_), charger_queue_length_);
+            simulated_hours += sample_time_hours_ - run_start_hours_;
+        }
+
+        std::uint64_t event_count() const
+        {
+            std::uint64_t total = 0;
+            for (std::uint64_t count : events)
+            {
+                total += count;
+            }
+            return total;
+        }
+
+        void merge(const ProfileCounters &other)
+        {
+            for (size_t p = 0; p < NUM_PROFILE_PHASES; ++p)
+            {
+                phase_ticks[p] += other.phase_ticks[p];
+            }
+            for (size_t t = 0; t < NUM_EVENT_TYPES; ++t)
+            {
+                events[t] += other.events[t];
+            }
+            event_queue_depth_sum += other.event_queue_depth_sum;
+            event_queue_depth_peak = std::max(event_queue_depth_peak, other.event_queue_depth_peak);
+            frames += other.frames;
+            active_frames += other.active_frames;
+            skipped_frames += other.skipped_frames;
+            state_changes += other.state_changes;
+            charger_queue_hours += other.charger_queue_hours;
+            simulated_hours += other.simulated_hours;
+            charger_queue_peak = std::max(charger_queue_peak, other.charger_queue_peak);
+        }
+
+    private:
+        // The current run's last charger queue sample
+        double run_start_hours_ = 0.0;
+        double sample_time_hours_ = 0.0;
+        std::uint64_t charger_queue_length_ = 0;
+    };
+
+    /**
+     * Adds the ticks from construction to destruction to the current phase; next() moves on to
+     * another phase, so a run's phases are timed back to back by one object
+     */
+    class ScopedPhaseTimer
+    {
+    private:
+        ProfileCounters *counters_;
+        ProfilePhase phase_;
+        std::uint64_t start_;
+
+    public:
+        /**
+         * @param counters Counters to add to; nullptr times nothing
+         */
+        ScopedPhaseTimer(ProfileCounters *counters, ProfilePhase phase)
+            : counters_(counters), phase_(phase), start_(counters ? ProfileClock::now() : 0)
+        {
+        }
+
+        ~ScopedPhaseTimer() { next(phase_); }
+
+        ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+        ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+        void next(ProfilePhase phase)
+        {
+            if (counters_)
+            {
+                std::uint64_t now = ProfileClock::now();
+                counters_->phase_ticks[static_cast<size_t>(phase_)] += now - start_;
+                start_ = now;
+            }
+            phase_ = phase;
+        }
+    };
+
+    /**
+     * Profile of the runs behind one --profile report
+     * One ProfileCounters per thread, each on its own cache lines, merged in thread order like
+     * ShardedStats. The tick rate is measured against steady_clock between construction and report.
+     */
+    class RunProfile
+    {
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        struct alignas(CACHE_LINE_SIZE) PaddedCounters
+        {
+            ProfileCounters counters;
+        };
+
+        std::vector<PaddedCounters> threads_;
+        std::uint64_t start_ticks_;
+        std::chrono::steady_clock::time_point start_time_;
+
+        double seconds_per_tick() const
+        {
+            std::uint64_t ticks = ProfileClock::now() - start_ticks_;
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+            return ticks > 0 ? seconds / static_cast<double>(ticks) : 0.0;
+        }
+
+    public:
+        explicit RunProfile(size_t thread_count = 1)
+            : threads_(std::max<size_t>(thread_count, 1)), start_ticks_(ProfileClock::now()),
+              start_time_(std::chrono::steady_clock::now())
+        {
+        }
+
+        size_t size() const { return threads_.size(); }
+
+        ProfileCounters &local(size_t thread = 0) { return threads_[thread].counters; }
+        const ProfileCounters &local(size_t thread = 0) const { return threads_[thread].counters; }
+
+        ProfileCounters merged() const
+        {
+            ProfileCounters total;
+            for (const auto &padded : threads_)
+            {
+                total.merge(padded.counters);
+            }
+            return total;
+        }
+
+        /**
+         * Milliseconds spent in each phase, summed over threads
+         */
+        std::array<double, NUM_PROFILE_PHASES> phase_milliseconds() const
+        {
+            ProfileCounters total = merged();
+            double scale = seconds_per_tick() * 1000.0;
+            std::array<double, NUM_PROFILE_PHASES> milliseconds{};
+            for (size_t p = 0; p < NUM_PROFILE_PHASES; ++p)
+            {
+                milliseconds[p] = static_cast<double>(total.phase_ticks[p]) * scale;
+            }
+            return milliseconds;
+        }
+
+        std::string generate_report() const
+        {
+            ProfileCounters total = merged();
+            auto milliseconds = phase_milliseconds();
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(3);
+            out << "\n========== Profile ==========\n";
+            out << "Phases (ms):";
+            for (size_t p = 0; p < NUM_PROFILE_PHASES; ++p)
+            {
+                out << (p == 0 ? " " : ", ") << profile_phase_name(static_cast<ProfilePhase>(p)) << " " << milliseconds[p];
+            }
+            out << "\n";
+
+            std::uint64_t events = total.event_count();
+            if (events > 0)
+            {
+                out << "Events: " << events << " (";
+                for (size_t t = 0; t < NUM_EVENT_TYPES; ++t)
+                {
+                    out << (t == 0 ? "" : ", ") << event_type_name(static_cast<EventType>(t)) << " " << total.events[t];
+                }
+                out << ")\n";
+                out << "Event queue depth: mean " << static_cast<double>(total.event_queue_depth_sum) / static_cast<double>(events)
+                    << ", peak " << total.event_queue_depth_peak << "\n";
+            }
+            if (total.frames + total.skipped_frames > 0)
+            {
+                out << "Frames: " << total.frames << " updated, " << total.active_frames << " with a state change, "
+                    << total.skipped_frames << " skipped ahead\n";
+            }
+            out << "State changes: " << total.state_changes << "\n";
+            out << "Charger queue length: mean " << (total.simulated_hours > 0.0 ? total.charger_queue_hours / total.simulated_hours : 0.0)
+                << " over time, peak " << total.charger_queue_peak << "\n";
+            return out.str();
+        }
+
+        std::string to_json() const
+        {
+            ProfileCounters total = merged();
+            auto milliseconds = phase_milliseconds();
+            std::ostringstream out;
+            out << std::setprecision(17);
+            out << "{\n  \"phases_ms\": {";
+            for (size_t p = 0; p < NUM_PROFILE_PHASES; ++p)
+            {
+                out << (p == 0 ? "" : ", ") << "\"" << profile_phase_name(static_cast<ProfilePhase>(p)) << "\": " << milliseconds[p];
+            }
+            out << "},\n  \"events\": {";
+            for (size_t t = 0; t < NUM_EVENT_TYPES; ++t)
+            {
+                out << (t == 0 ? "" : ", ") << "\"" << event_type_name(static_cast<EventType>(t)) << "\": " << total.events[t];
+            }
+            std::uint64_t events = total.event_count();
+            out << "},\n  \"event_queue_depth\": {\"mean\": "
+                << (events > 0 ? static_cast<double>(total.event_queue_depth_sum) / static_cast<double>(events) : 0.0)
+                << ", \"peak\": " << total.event_queue_depth_peak << "},\n";
+            out << "  \"frames\": {\"updated\": " << total.frames << ", \"active\": " << total.active_frames
+                << ", \"skipped\": " << total.skipped_frames << "},\n";
+            out << "  \"state_changes\": " << total.state_changes << ",\n";
+            out << "  \"charger_queue_length\": {\"mean\": "
+                << (total.simulated_hours > 0.0 ? total.charger_queue_hours / total.simulated_hours : 0.0)
+                << ", \"peak\": " << total.charger_queue_peak << "},\n";
+            out << "  \"threads\": " << threads_.size() << "\n}\n";
+            return out.str();
+        }
+    };
+}
@@ -0,0 +1,268 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "charger_manager.h"
+#include "statistics_engine.h"
+
+namespace evtol
+{
+    /**
+     * Single-writer seqlock around a trivially copyable value
+     * The writer never waits: it makes the sequence odd, stores the value, and makes it even again.
+     * Readers copy the value and retry if the sequence was odd or changed meanwhile. The value is
+     * kept as relaxed atomic words, so a torn read is detected rather than being a data race.
+     */
+    template <typename T>
+    class SeqlockSlot
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "seqlock values are copied word by word");
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        std::atomic<std::uint64_t> sequence_{0};
+        std::array<std::atomic<std::uint64_t>, WORDS> words_{};
+
+    public:
+        /**
+         * Only one thread may store
+         */
+        void store(const T &value)
+        {
+            std::array<std::uint64_t, WORDS> words{};
+            std::memcpy(words.data(), &value, sizeof(T));
+
+            std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; ++i)
+            {
+                words_[i].store(words[i], std::memory_order_relaxed);
+            }
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        /**
+         * Copy the last stored value; any number of threads may read
+         * @return False (value untouched) if nothing has been stored yet
+         */
+        bool load(T &value) const
+        {
+            std::array<std::uint64_t, WORDS> words{};
+            while (true)
+            {
+                std::uint64_t before = sequence_.load(std::memory_order_acquire);
+                if (before == 0)
+                {
+                    return false;
+                }
+                if ((before & 1) != 0)
+                {
+                    continue; // a store is under way
+                }
+                for (size_t i = 0; i < WORDS; ++i)
+                {
+                    words[i] = words_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence_.load(std::memory_order_relaxed) == before)
+                {
+                    break;
+                }
+            }
+            std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T)); // T is trivially copyable
+            return true;
+        }
+
+        /**
+         * Values stored so far
+         */
+        std::uint64_t store_count() const { return sequence_.load(std::memory_order_acquire) / 2; }
+    };
+
+    /**
+     * State of a run at one moment, as the engine publishes it
+     */
+    struct ProgressSnapshot
+    {
+        double time_hours = 0.0;
+        double duration_hours = 0.0;
+        SummaryStats summary{}; // fleet totals recorded so far
+        std::array<int, NUM_AIRCRAFT_TYPES> flights_by_type{};
+        std::array<int, NUM_AIRCRAFT_TYPES> faults_by_type{};
+        int chargers_in_use = 0;
+        int total_chargers = 0;
+        int charger_queue_length = 0;
+        bool finished = false;
+
+        static ProgressSnapshot capture(double time_hours, double duration_hours, const StatisticsCollector &stats,
+                                        const ChargerManager &charger_mgr, bool finished)
+        {
+            return capture(time_hours, duration_hours, stats, charger_mgr.get_active_chargers(),
+                           charger_mgr.get_total_chargers(), charger_mgr.get_queue_size(), finished);
+        }
+
+        /**
+         * Charger totals given directly, for engines that spread their chargers over several managers
+         */
+        static ProgressSnapshot capture(double time_hours, double duration_hours, const StatisticsCollector &stats,
+                                        int chargers_in_use, int total_chargers, int charger_queue_length, bool finished)
+        {
+            ProgressSnapshot snapshot;
+            snapshot.time_hours = time_hours;
+            snapshot.duration_hours = duration_hours;
+            snapshot.summary = stats.get_summary_stats();
+            const auto &by_type = stats.shard().by_type();
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                snapshot.flights_by_type[t] = by_type[t].flight_count;
+                snapshot.faults_by_type[t] = by_type[t].total_faults;
+            }
+            snapshot.chargers_in_use = chargers_in_use;
+            snapshot.total_chargers = total_chargers;
+            snapshot.charger_queue_length = charger_queue_length;
+            snapshot.finished = finished;
+            return snapshot;
+        }
+
+        /**
+         * One line of rolling progress
+         */
+        std::string to_string() const
+        {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(2);
+            line << "[progress] " << time_hours << "/" << duration_hours << "h";
+            if (duration_hours > 0.0)
+            {
+                line << " (" << std::setprecision(1) << 100.0 * time_hours / duration_hours << "%)" << std::setprecision(2);
+            }
+            line << " flights " << summary.total_flights << ", faults " << summary.total_faults
+                 << ", flight hours " << summary.total_flight_time
+                 << ", chargers " << chargers_in_use << "/" << total_chargers << " busy, queue " << charger_queue_length;
+            if (finished)
+            {
+                line << " (done)";
+            }
+            return line.str();
+        }
+    };
+
+    /**
+     * Where an engine publishes progress for other threads
+     * Publishing is on demand: the engine only captures a snapshot after a reader has called
+     * request() (and once at the end of the run), so an attached channel nobody reads costs one
+     * relaxed load per event or frame.
+     */
+    class ProgressChannel
+    {
+    private:
+        SeqlockSlot<ProgressSnapshot> slot_;
+        std::atomic<bool> requested_{false};
+
+    public:
+        /**
+         * Ask the engine for a fresh snapshot at its next event or frame
+         */
+        void request() { requested_.store(true, std::memory_order_relaxed); }
+
+        /**
+         * Engine side: whether a reader is waiting for a snapshot
+         */
+        bool requested() const { return requested_.load(std::memory_order_relaxed); }
+
+        /**
+         * Engine side (one thread): publish and clear the request
+         */
+        void publish(const ProgressSnapshot &snapshot)
+        {
+            requested_.store(false, std::memory_order_relaxed);
+            slot_.store(snapshot);
+        }
+
+        /**
+         * @return False if nothing has been published yet
+         */
+        bool read(ProgressSnapshot &snapshot) const { return slot_.load(snapshot); }
+
+        std::uint64_t publish_count() const { return slot_.store_count(); }
+    };
+
+    /**
+     * Background thread that requests a snapshot every period and writes it as a progress line
+     * Stopping (or destruction) prints the final snapshot if a new one arrived since the last line.
+     */
+    class ProgressMonitor
+    {
+    private:
+        ProgressChannel &channel_;
+        std::ostream &out_;
+        std::chrono::milliseconds period_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stop_ = false;
+        std::uint64_t printed_count_ = 0;
+        std::thread thread_;
+
+        void print_latest()
+        {
+            ProgressSnapshot snapshot;
+            std::uint64_t count = channel_.publish_count();
+            if (count != printed_count_ && channel_.read(snapshot))
+            {
+                printed_count_ = count;
+                out_ << snapshot.to_string() << std::endl;
+            }
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!stop_)
+            {
+                channel_.request();
+                wake_.wait_for(lock, period_, [this]
+                               { return stop_; });
+                print_latest();
+            }
+        }
+
+    public:
+        ProgressMonitor(ProgressChannel &channel, std::ostream &out, std::chrono::milliseconds period)
+            : channel_(channel), out_(out), period_(period), thread_([this]
+                                                                       { run(); })
+        {
+        }
+
+        ~ProgressMonitor() { stop(); }
+
+        ProgressMonitor(const ProgressMonitor &) = delete;
+        ProgressMonitor &operator=(const ProgressMonitor &) = delete;
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            wake_.notify_one();
+            if (thread_.joinable())
+            {
+                thread_.join();
+            }
+        }
+    };
+}
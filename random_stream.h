@@ -0,0 +1,340 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace evtol
+{
+    /**
+     * Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3")
+     * Output is a pure function of (counter, key), so any draw of any stream can be computed independently.
+     */
+    struct Philox4x32
+    {
+        using Counter = std::array<std::uint32_t, 4>;
+        using Key = std::array<std::uint32_t, 2>;
+
+        static constexpr Counter generate(Counter ctr, Key key)
+        {
+            constexpr std::uint32_t M0 = 0xD2511F53u;
+            constexpr std::uint32_t M1 = 0xCD9E8D57u;
+            constexpr std::uint32_t W0 = 0x9E3779B9u;
+            constexpr std::uint32_t W1 = 0xBB67AE85u;
+
+            for (int round = 0; round < 10; ++round)
+            {
+                std::uint64_t product0 = static_cast<std::uint64_t>(M0) * ctr[0];
+                std::uint64_t product1 = static_cast<std::uint64_t>(M1) * ctr[2];
+                std::uint32_t hi0 = static_cast<std::uint32_t>(product0 >> 32);
+                std::uint32_t lo0 = static_cast<std::uint32_t>(product0);
+                std::uint32_t hi1 = static_cast<std::uint32_t>(product1 >> 32);
+                std::uint32_t lo1 = static_cast<std::uint32_t>(product1);
+
+                ctr = {hi1 ^ ctr[1] ^ key[0], lo1, hi0 ^ ctr[3] ^ key[1], lo0};
+                key = {key[0] + W0, key[1] + W1};
+            }
+            return ctr;
+        }
+
+        /**
+         * generate() for LANES independent (counter, key) pairs, in place: blocks holds the counters
+         * on entry and the generated blocks on return.
+         * The rounds run over plain per-word arrays so the compiler can vectorize across lanes
+         * (the 32x32->64 multiplies map onto packed multiplies); the results equal generate() bit for bit.
+         */
+        template <size_t LANES>
+        static void generate_lanes(std::array<Counter, LANES> &blocks, const std::array<Key, LANES> &keys)
+        {
+            constexpr std::uint32_t M0 = 0xD2511F53u;
+            constexpr std::uint32_t M1 = 0xCD9E8D57u;
+            constexpr std::uint32_t W0 = 0x9E3779B9u;
+            constexpr std::uint32_t W1 = 0xBB67AE85u;
+
+            std::array<std::uint32_t, LANES> c0, c1, c2, c3, k0, k1;
+            for (size_t lane = 0; lane < LANES; ++lane)
+            {
+                c0[lane] = blocks[lane][0];
+                c1[lane] = blocks[lane][1];
+                c2[lane] = blocks[lane][2];
+                c3[lane] = blocks[lane][3];
+                k0[lane] = keys[lane][0];
+                k1[lane] = keys[lane][1];
+            }
+
+            for (int round = 0; round < 10; ++round)
+            {
+                for (size_t lane = 0; lane < LANES; ++lane)
+                {
+                    std::uint64_t product0 = static_cast<std::uint64_t>(M0) * c0[lane];
+                    std::uint64_t product1 = static_cast<std::uint64_t>(M1) * c2[lane];
+                    std::uint32_t next0 = static_cast<std::uint32_t>(product1 >> 32) ^ c1[lane] ^ k0[lane];
+                    std::uint32_t next2 = static_cast<std::uint32_t>(product0 >> 32) ^ c3[lane] ^ k1[lane];
+                    c1[lane] = static_cast<std::uint32_t>(product1);
+                    c3[lane] = static_cast<std::uint32_t>(product0);
+                    c0[lane] = next0;
+                    c2[lane] = next2;
+                    k0[lane] += W0;
+                    k1[lane] += W1;
+                }
+            }
+
+            for (size_t lane = 0; lane < LANES; ++lane)
+            {
+                blocks[lane] = {c0[lane], c1[lane], c2[lane], c3[lane]};
+            }
+        }
+
+        /**
+         * generate_lanes() for LANES consecutive blocks of one stream: lane l gets
+         * ctr = {first_block + l (low, high), stream_words}
+         */
+        template <size_t LANES>
+        static void generate_lanes(std::uint64_t first_block, std::array<std::uint32_t, 2> stream_words, Key key,
+                                   std::array<Counter, LANES> &out)
+        {
+            std::array<Key, LANES> keys;
+            for (size_t lane = 0; lane < LANES; ++lane)
+            {
+                std::uint64_t block = first_block + lane;
+                out[lane] = {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32),
+                             stream_words[0], stream_words[1]};
+                keys[lane] = key;
+            }
+            generate_lanes(out, keys);
+        }
+    };
+
+    /**
+     * Reproducible stream of uniform doubles keyed by (seed, stream id)
+     * Each aircraft owns one stream, so results do not depend on event order or thread count.
+     * The only mutable state is the draw index, which makes the stream cheap to checkpoint.
+     */
+    class RandomStream
+    {
+    private:
+        std::uint64_t seed_;
+        std::uint64_t stream_id_;
+        std::uint64_t draw_index_ = 0;
+
+        // The block for draw_index_ / 2 is cached; every block yields two doubles
+        Philox4x32::Counter block_{};
+        std::uint64_t cached_block_ = UINT64_MAX;
+
+        Philox4x32::Key key() const
+        {
+            return {static_cast<std::uint32_t>(seed_), static_cast<std::uint32_t>(seed_ >> 32)};
+        }
+
+        std::array<std::uint32_t, 2> stream_words() const
+        {
+            return {static_cast<std::uint32_t>(stream_id_), static_cast<std::uint32_t>(stream_id_ >> 32)};
+        }
+
+        // word and the one after it of a block give one double
+        static double to_uniform(const Philox4x32::Counter &block, size_t word)
+        {
+            std::uint64_t bits = (static_cast<std::uint64_t>(block[word]) << 21) ^ (block[word + 1] >> 11);
+            return static_cast<double>(bits) * 0x1.0p-53;
+        }
+
+        // Cache the block for the current draw index
+        void cache_current_block()
+        {
+            std::uint64_t block = draw_index_ >> 1;
+            auto words = stream_words();
+            block_ = Philox4x32::generate(
+                {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32), words[0], words[1]}, key());
+            cached_block_ = block;
+        }
+
+        // First of count consecutive stream ids for unseeded streams
+        static std::uint64_t next_default_stream(std::uint64_t count = 1)
+        {
+            static std::atomic<std::uint64_t> next_stream{0};
+            return next_stream.fetch_add(count, std::memory_order_relaxed);
+        }
+
+    public:
+        // Blocks generated together by fill_uniforms and prefetch_blocks
+        static constexpr size_t FILL_LANES = 8;
+
+        /**
+         * Unseeded streams draw from a process-wide entropy seed, each on a distinct stream id
+         */
+        RandomStream() : RandomStream(entropy_seed(), next_default_stream() | (1ull << 63)) {}
+
+        RandomStream(std::uint64_t seed, std::uint64_t stream_id) : seed_(seed), stream_id_(stream_id) {}
+
+        /**
+         * count unseeded streams, as count default constructions would give, with one atomic update
+         */
+        static std::vector<RandomStream> make_unseeded(size_t count)
+        {
+            std::uint64_t seed = entropy_seed();
+            std::uint64_t first_stream = next_default_stream(count);
+            std::vector<RandomStream> streams;
+            streams.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                streams.emplace_back(seed, (first_stream + i) | (1ull << 63));
+            }
+            return streams;
+        }
+
+        void reseed(std::uint64_t seed, std::uint64_t stream_id)
+        {
+            seed_ = seed;
+            stream_id_ = stream_id;
+            draw_index_ = 0;
+            cached_block_ = UINT64_MAX;
+        }
+
+        /**
+         * Uniform double in [0, 1) with 53 bits of precision
+         */
+        double next_uniform()
+        {
+            if ((draw_index_ >> 1) != cached_block_)
+            {
+                cache_current_block();
+            }
+
+            size_t word = static_cast<size_t>(draw_index_ & 1) * 2;
+            ++draw_index_;
+            return to_uniform(block_, word);
+        }
+
+        /**
+         * Fill out with the next out.size() draws, the values next_uniform() would return in turn
+         * Whole blocks are generated FILL_LANES at a time through Philox4x32::generate_lanes; the
+         * stream ends at the same draw index as after out.size() single draws.
+         */
+        void fill_uniforms(std::span<double> out)
+        {
+            size_t filled = 0;
+            // Finish a half-used block so the batches start on a block boundary
+            if ((draw_index_ & 1) != 0 && filled < out.size())
+            {
+                out[filled++] = next_uniform();
+            }
+
+            std::array<Philox4x32::Counter, FILL_LANES> blocks;
+            while (out.size() - filled >= 2 * FILL_LANES)
+            {
+                Philox4x32::generate_lanes(draw_index_ >> 1, stream_words(), key(), blocks);
+                for (const Philox4x32::Counter &block : blocks)
+                {
+                    out[filled++] = to_uniform(block, 0);
+                    out[filled++] = to_uniform(block, 2);
+                }
+                draw_index_ += 2 * FILL_LANES;
+            }
+
+            while (filled < out.size())
+            {
+                out[filled++] = next_uniform();
+            }
+        }
+
+        /**
+         * Generate the block holding each stream's next draw, FILL_LANES streams per generate_lanes call
+         * A stream that draws once or twice gets no use out of fill_uniforms; this batches across
+         * streams instead. Null entries and streams whose block is already cached are skipped, and
+         * the draws that follow are the ones next_uniform() would have returned anyway.
+         */
+        static void prefetch_blocks(std::span<RandomStream *const> streams)
+        {
+            std::array<RandomStream *, FILL_LANES> pending{};
+            std::array<Philox4x32::Counter, FILL_LANES> blocks{};
+            std::array<Philox4x32::Key, FILL_LANES> keys{};
+            size_t lanes = 0;
+
+            auto flush = [&]
+            {
+                Philox4x32::generate_lanes(blocks, keys);
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    pending[lane]->block_ = blocks[lane];
+                    pending[lane]->cached_block_ = pending[lane]->draw_index_ >> 1;
+                }
+                lanes = 0;
+            };
+
+            for (RandomStream *stream : streams)
+            {
+                if (stream == nullptr || (stream->draw_index_ >> 1) == stream->cached_block_)
+                {
+                    continue;
+                }
+                std::uint64_t block = stream->draw_index_ >> 1;
+                auto words = stream->stream_words();
+                pending[lanes] = stream;
+                blocks[lanes] = {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32), words[0], words[1]};
+                keys[lanes] = stream->key();
+                if (++lanes == FILL_LANES)
+                {
+                    flush();
+                }
+            }
+
+            // A lone leftover is cheaper as a single generate()
+            if (lanes == 1)
+            {
+                pending[0]->cache_current_block();
+            }
+            else if (lanes > 1)
+            {
+                flush();
+            }
+        }
+
+        std::uint64_t get_seed() const { return seed_; }
+        std::uint64_t get_stream_id() const { return stream_id_; }
+        std::uint64_t get_draw_index() const { return draw_index_; }
+
+        /**
+         * Jump to an absolute position in the stream (used when restoring state)
+         */
+        void set_draw_index(std::uint64_t draw_index) { draw_index_ = draw_index; }
+
+        /**
+         * Non-deterministic seed drawn once per process
+         */
+        static std::uint64_t entropy_seed()
+        {
+            static const std::uint64_t seed = []
+            {
+                std::random_device rd;
+                return (static_cast<std::uint64_t>(rd()) << 32) ^ rd();
+            }();
+            return seed;
+        }
+
+        /**
+         * Derive a decorrelated child seed (e.g. per replication) using splitmix64
+         */
+        static constexpr std::uint64_t derive_seed(std::uint64_t base_seed, std::uint64_t index)
+        {
+            std::uint64_t z = base_seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+    };
+
+    /**
+     * Key every aircraft's fault stream by (seed, aircraft id)
+     */
+    template <typename Fleet>
+    void seed_fleet_streams(Fleet &fleet, std::uint64_t seed)
+    {
+        for (auto &&aircraft : fleet)
+        {
+            aircraft->seed_random_stream(seed, static_cast<std::uint64_t>(aircraft->get_id()));
+        }
+    }
+}
@@ -0,0 +1,441 @@
+#include "scenario_file.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aircraft_types.h"
+
+namespace evtol
+{
+    namespace
+    {
+        constexpr std::uint64_t align_up(std::uint64_t offset)
+        {
+            return (offset + ScenarioFileHeader::ALIGNMENT - 1) / ScenarioFileHeader::ALIGNMENT * ScenarioFileHeader::ALIGNMENT;
+        }
+
+        AircraftType parse_aircraft_type(const std::string &text)
+        {
+            std::string name = text;
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+
+            auto *found = std::find(std::begin(FleetMix::type_names), std::end(FleetMix::type_names), name);
+            if (found == std::end(FleetMix::type_names))
+            {
+                throw std::invalid_argument("unknown aircraft type '" + text + "'");
+            }
+            return static_cast<AircraftType>(found - std::begin(FleetMix::type_names));
+        }
+
+        /**
+         * First problem with the aircraft columns, or an empty string
+         */
+        std::string find_aircraft_error(size_t pool_count, std::span<const int> ids, std::span<const AircraftType> types,
+                                        std::span<const double> battery_levels, std::span<const std::uint16_t> home_pools)
+        {
+            int max_id = -1;
+            for (size_t i = 0; i < ids.size(); ++i)
+            {
+                auto aircraft = [&]
+                { return "aircraft " + std::to_string(ids[i]); };
+                if (ids[i] < 0)
+                {
+                    return "negative aircraft id " + std::to_string(ids[i]);
+                }
+                if (static_cast<size_t>(types[i]) >= NUM_AIRCRAFT_TYPES)
+                {
+                    return aircraft() + " has an unknown type";
+                }
+                if (!(battery_levels[i] >= 0.0 && battery_levels[i] <= 1.0))
+                {
+                    return aircraft() + " has a battery level outside [0, 1]";
+                }
+                if (home_pools[i] >= pool_count)
+                {
+                    return aircraft() + " has an unknown pool";
+                }
+                max_id = std::max(max_id, ids[i]);
+            }
+
+            // Engines index aircraft by id, so ids must be unique
+            std::vector<bool> seen(static_cast<size_t>(max_id + 1), false);
+            for (int id : ids)
+            {
+                if (seen[static_cast<size_t>(id)])
+                {
+                    return "duplicate aircraft id " + std::to_string(id);
+                }
+                seen[static_cast<size_t>(id)] = true;
+            }
+            return "";
+        }
+
+        bool write_padding(std::FILE *file, std::uint64_t &position, std::uint64_t offset)
+        {
+            static const char zeros[ScenarioFileHeader::ALIGNMENT] = {};
+            size_t padding = static_cast<size_t>(offset - position);
+            position = offset;
+            return padding == 0 || std::fwrite(zeros, 1, padding, file) == padding;
+        }
+
+        template <typename T>
+        bool write_column(std::FILE *file, std::uint64_t &position, std::uint64_t offset, const std::vector<T> &values)
+        {
+            if (!write_padding(file, position, offset))
+            {
+                return false;
+            }
+            position += values.size() * sizeof(T);
+            return values.empty() || std::fwrite(values.data(), sizeof(T), values.size(), file) == values.size();
+        }
+    }
+
+    Scenario parse_scenario_text(std::istream &in)
+    {
+        Scenario scenario;
+        std::vector<int> named_pools; // -1: id % pool count, resolved once every pool is known
+        std::string line;
+        size_t line_number = 0;
+
+        while (std::getline(in, line))
+        {
+            ++line_number;
+            std::string context = "Scenario line " + std::to_string(line_number) + ": ";
+            std::istringstream fields(line.substr(0, line.find('#')));
+            std::string keyword;
+            if (!(fields >> keyword))
+            {
+                continue;
+            }
+
+            try
+            {
+                if (keyword == "pool")
+                {
+                    ChargerPoolSpec pool;
+                    if (!(fields >> pool.name >> pool.charger_count))
+                    {
+                        throw std::invalid_argument("expected 'pool <name> <chargers>'");
+                    }
+                    for (const auto &existing : scenario.charger_pools)
+                    {
+                        if (existing.name == pool.name)
+                        {
+                            throw std::invalid_argument("pool '" + pool.name + "' is declared twice");
+                        }
+                    }
+                    scenario.charger_pools.push_back(pool);
+                }
+                else if (keyword == "aircraft")
+                {
+                    int id = 0;
+                    std::string type_name;
+                    if (!(fields >> id >> type_name))
+                    {
+                        throw std::invalid_argument("expected 'aircraft <id> <type> [<battery level> [<pool>]]'");
+                    }
+                    double battery_level = 1.0;
+                    std::string pool_name;
+                    if (fields >> battery_level)
+                    {
+                        fields >> pool_name;
+                    }
+                    else if (!fields.eof())
+                    {
+                        throw std::invalid_argument("malformed battery level");
+                    }
+
+                    int pool = -1;
+                    if (!pool_name.empty())
+                    {
+                        auto found = std::find_if(scenario.charger_pools.begin(), scenario.charger_pools.end(),
+                                                  [&](const ChargerPoolSpec &spec)
+                                                  { return spec.name == pool_name; });
+                        if (found == scenario.charger_pools.end())
+                        {
+                            throw std::invalid_argument("unknown pool '" + pool_name + "'");
+                        }
+                        pool = static_cast<int>(found - scenario.charger_pools.begin());
+                    }
+
+                    scenario.ids.push_back(id);
+                    scenario.types.push_back(parse_aircraft_type(type_name));
+                    scenario.battery_levels.push_back(battery_level);
+                    named_pools.push_back(pool);
+                }
+                else
+                {
+                    throw std::invalid_argument("unknown entry '" + keyword + "'");
+                }
+
+                std::string extra;
+                if (fields >> extra)
+                {
+                    throw std::invalid_argument("unexpected '" + extra + "'");
+                }
+            }
+            catch (const std::invalid_argument &e)
+            {
+                throw std::invalid_argument(context + e.what());
+            }
+        }
+
+        if (scenario.charger_pools.empty())
+        {
+            throw std::invalid_argument("Scenario declares no charger pool");
+        }
+
+        int pool_count = static_cast<int>(scenario.charger_pools.size());
+        scenario.home_pools.reserve(named_pools.size());
+        for (size_t i = 0; i < named_pools.size(); ++i)
+        {
+            int pool = named_pools[i] >= 0 ? named_pools[i] : ((scenario.ids[i] % pool_count) + pool_count) % pool_count;
+            scenario.home_pools.push_back(static_cast<std::uint16_t>(pool));
+        }
+        return scenario;
+    }
+
+    void write_scenario_file(const std::string &path, const Scenario &scenario)
+    {
+        size_t count = scenario.size();
+        if (scenario.types.size() != count || scenario.battery_levels.size() != count || scenario.home_pools.size() != count)
+        {
+            throw std::invalid_argument("Scenario columns differ in length");
+        }
+        if (scenario.charger_pools.empty() || scenario.charger_pools.size() > UINT16_MAX)
+        {
+            throw std::invalid_argument("Scenario needs between 1 and " + std::to_string(UINT16_MAX) + " charger pools");
+        }
+
+        std::vector<ScenarioPoolRecord> pools(scenario.charger_pools.size());
+        for (size_t p = 0; p < pools.size(); ++p)
+        {
+            const ChargerPoolSpec &spec = scenario.charger_pools[p];
+            if (spec.name.empty() || spec.name.size() > ScenarioPoolRecord::MAX_NAME_LENGTH)
+            {
+                throw std::invalid_argument("Charger pool names must be 1 to " +
+                                            std::to_string(ScenarioPoolRecord::MAX_NAME_LENGTH) + " characters: '" + spec.name + "'");
+            }
+            if (spec.charger_count < 1)
+            {
+                throw std::invalid_argument("Charger pool '" + spec.name + "' needs at least one charger");
+            }
+            std::memcpy(pools[p].name, spec.name.data(), spec.name.size());
+            pools[p].charger_count = spec.charger_count;
+        }
+
+        std::string error = find_aircraft_error(pools.size(), scenario.ids, scenario.types, scenario.battery_levels, scenario.home_pools);
+        if (!error.empty())
+        {
+            throw std::invalid_argument("Invalid scenario: " + error);
+        }
+
+        ScenarioFileHeader header{};
+        std::memcpy(header.magic, ScenarioFileHeader::MAGIC, sizeof(header.magic));
+        header.version = ScenarioFileHeader::VERSION;
+        header.header_size = sizeof(ScenarioFileHeader);
+        header.aircraft_count = count;
+        header.pool_count = static_cast<std::uint32_t>(pools.size());
+        header.max_aircraft_id = scenario.ids.empty() ? -1 : *std::max_element(scenario.ids.begin(), scenario.ids.end());
+
+        // Same grouping rule as SoaFleet::add_aircraft
+        bool grouped = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t t = static_cast<size_t>(scenario.types[i]);
+            if (header.type_end[t] == header.type_begin[t])
+            {
+                header.type_begin[t] = i;
+                header.type_end[t] = i + 1;
+            }
+            else if (header.type_end[t] == i)
+            {
+                header.type_end[t] = i + 1;
+            }
+            else
+            {
+                grouped = false;
+            }
+        }
+        header.grouped = grouped ? 1 : 0;
+
+        header.pools_offset = align_up(sizeof(ScenarioFileHeader));
+        header.ids_offset = align_up(header.pools_offset + pools.size() * sizeof(ScenarioPoolRecord));
+        header.types_offset = align_up(header.ids_offset + count * sizeof(std::int32_t));
+        header.battery_offset = align_up(header.types_offset + count * sizeof(AircraftType));
+        header.home_pool_offset = align_up(header.battery_offset + count * sizeof(double));
+        header.file_size = header.home_pool_offset + count * sizeof(std::uint16_t);
+
+        std::string temp_path = path + ".tmp";
+        std::FILE *file = std::fopen(temp_path.c_str(), "wb");
+        if (!file)
+        {
+            throw std::runtime_error("Cannot create scenario file: " + temp_path);
+        }
+
+        std::uint64_t position = sizeof(header);
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && write_column(file, position, header.pools_offset, pools);
+        ok = ok && write_column(file, position, header.ids_offset, scenario.ids);
+        ok = ok && write_column(file, position, header.types_offset, scenario.types);
+        ok = ok && write_column(file, position, header.battery_offset, scenario.battery_levels);
+        ok = ok && write_column(file, position, header.home_pool_offset, scenario.home_pools);
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("Writing the scenario file failed: " + path);
+        }
+    }
+
+    MappedScenario::MappedScenario(const std::string &path) : path_(path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Cannot open scenario file: " + path);
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ScenarioFileHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("Not a scenario file: " + path);
+        }
+
+        size_ = static_cast<size_t>(info.st_size);
+        void *mapping = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error("Cannot map scenario file: " + path + " (" + std::strerror(errno) + ")");
+        }
+        data_ = static_cast<std::byte *>(mapping);
+        header_ = reinterpret_cast<const ScenarioFileHeader *>(data_);
+
+        const ScenarioFileHeader &header = *header_;
+        auto section_fits = [&](std::uint64_t offset, std::uint64_t element_size, std::uint64_t count)
+        {
+            return offset % ScenarioFileHeader::ALIGNMENT == 0 && offset <= size_ &&
+                   count <= (size_ - offset) / element_size;
+        };
+        bool valid = std::memcmp(header.magic, ScenarioFileHeader::MAGIC, sizeof(header.magic)) == 0 &&
+                     header.version == ScenarioFileHeader::VERSION && header.header_size == sizeof(ScenarioFileHeader) &&
+                     header.file_size == size_ && header.pool_count > 0 && header.pool_count <= UINT16_MAX &&
+                     section_fits(header.pools_offset, sizeof(ScenarioPoolRecord), header.pool_count) &&
+                     section_fits(header.ids_offset, sizeof(std::int32_t), header.aircraft_count) &&
+                     section_fits(header.types_offset, sizeof(AircraftType), header.aircraft_count) &&
+                     section_fits(header.battery_offset, sizeof(double), header.aircraft_count) &&
+                     section_fits(header.home_pool_offset, sizeof(std::uint16_t), header.aircraft_count);
+        // map_fleet hands the type ranges to the fleet as indices into the columns
+        for (size_t t = 0; t < NUM_AIRCRAFT_TYPES && valid; ++t)
+        {
+            valid = header.type_begin[t] <= header.type_end[t] && header.type_end[t] <= header.aircraft_count;
+        }
+        if (!valid)
+        {
+            ::munmap(data_, size_);
+            throw std::runtime_error("Not a version " + std::to_string(ScenarioFileHeader::VERSION) + " scenario file: " + path);
+        }
+
+        // Start reading the columns in; the first run touches all of them anyway
+        ::madvise(data_, size_, MADV_WILLNEED);
+    }
+
+    MappedScenario::~MappedScenario()
+    {
+        ::munmap(data_, size_);
+    }
+
+    SoaFleet MappedScenario::map_fleet(const std::shared_ptr<MappedScenario> &scenario)
+    {
+        const ScenarioFileHeader &header = scenario->header();
+        SoaFleet::MappedColumns columns;
+        columns.storage = scenario;
+        columns.ids = {scenario->column<int>(header.ids_offset), scenario->size()};
+        columns.types = {scenario->column<AircraftType>(header.types_offset), scenario->size()};
+        columns.battery_levels = {scenario->column<double>(header.battery_offset), scenario->size()};
+        columns.grouped = header.grouped != 0;
+        for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+        {
+            columns.type_begin[t] = static_cast<size_t>(header.type_begin[t]);
+            columns.type_end[t] = static_cast<size_t>(header.type_end[t]);
+        }
+
+        SoaFleet fleet;
+        fleet.map_columns(columns);
+        return fleet;
+    }
+
+    std::vector<ChargerPoolSpec> MappedScenario::charger_pools() const
+    {
+        const auto *records = column<const ScenarioPoolRecord>(header_->pools_offset);
+        std::vector<ChargerPoolSpec> pools;
+        pools.reserve(header_->pool_count);
+        for (size_t p = 0; p < header_->pool_count; ++p)
+        {
+            const ScenarioPoolRecord &record = records[p];
+            pools.push_back({std::string(record.name, strnlen(record.name, sizeof(record.name))), record.charger_count});
+        }
+        return pools;
+    }
+
+    void MappedScenario::assign_home_pools(ChargerManager &charger_mgr) const
+    {
+        charger_mgr.reserve_aircraft(max_aircraft_id());
+        if (charger_mgr.get_pool_count() == 1)
+        {
+            return; // every aircraft's default
+        }
+
+        auto aircraft_ids = ids();
+        auto pools = home_pools();
+        for (size_t i = 0; i < aircraft_ids.size(); ++i)
+        {
+            charger_mgr.set_home_pool(aircraft_ids[i], pools[i]);
+        }
+    }
+
+    void MappedScenario::verify() const
+    {
+        for (const auto &pool : charger_pools())
+        {
+            if (pool.charger_count < 1)
+            {
+                throw std::runtime_error("Scenario " + path_ + ": charger pool '" + pool.name + "' needs at least one charger");
+            }
+        }
+
+        std::string error = find_aircraft_error(header_->pool_count, ids(), types(), battery_levels(), home_pools());
+        if (error.empty() && size() > 0 && *std::max_element(ids().begin(), ids().end()) != max_aircraft_id())
+        {
+            error = "the header's largest aircraft id does not match the ids";
+        }
+        if (error.empty() && header_->grouped != 0)
+        {
+            for (size_t i = 0; i < size() && error.empty(); ++i)
+            {
+                size_t t = static_cast<size_t>(types()[i]);
+                if (i < header_->type_begin[t] || i >= header_->type_end[t])
+                {
+                    error = "aircraft " + std::to_string(ids()[i]) + " lies outside its type's range";
+                }
+            }
+        }
+        if (!error.empty())
+        {
+            throw std::runtime_error("Scenario " + path_ + ": " + error);
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "aircraft.h"
+#include "charger_manager.h"
+#include "soa_fleet.h"
+
+namespace evtol
+{
+    /**
+     * A fleet and charger layout loaded from a scenario instead of built from --fleet-size
+     * Each aircraft has its own id, type, initial battery level and home vertiport (charger pool).
+     */
+    struct Scenario
+    {
+        std::vector<ChargerPoolSpec> charger_pools;
+        std::vector<int> ids;
+        std::vector<AircraftType> types;
+        std::vector<double> battery_levels;
+        std::vector<std::uint16_t> home_pools; // index into charger_pools
+
+        size_t size() const { return ids.size(); }
+    };
+
+    /**
+     * Parse the text scenario format
+     *   # comment
+     *   pool <name> <chargers>
+     *   aircraft <id> <type> [<battery level> [<pool name>]]
+     * Types are alpha..echo, case-insensitive. The battery level defaults to 1.0; without a pool
+     * name an aircraft uses pool id % pool count, as ChargerManager does. A pool must be declared
+     * before an aircraft names it.
+     * @throws std::invalid_argument naming the line of the first malformed entry
+     */
+    Scenario parse_scenario_text(std::istream &in);
+
+    /**
+     * Scenario file layout: this header, the pool table, then one column per aircraft field
+     * Every section starts at a multiple of ALIGNMENT, so the columns can be used in place from a
+     * mapping. Values are stored as-is (native byte order), like the event trace.
+     */
+    struct ScenarioFileHeader
+    {
+        static constexpr char MAGIC[8] = {'E', 'V', 'T', 'L', 'S', 'C', 'N', '1'};
+        static constexpr std::uint32_t VERSION = 1;
+        static constexpr std::uint64_t ALIGNMENT = 64;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t header_size;
+        std::uint64_t file_size;
+        std::uint64_t aircraft_count;
+        std::uint32_t pool_count;
+        std::uint32_t grouped; // 1 if each type's aircraft occupy one contiguous range
+        std::uint64_t type_begin[NUM_AIRCRAFT_TYPES];
+        std::uint64_t type_end[NUM_AIRCRAFT_TYPES];
+        std::int32_t max_aircraft_id; // -1 without aircraft
+        std::uint32_t reserved;
+
+        // Byte offsets from the start of the file
+        std::uint64_t pools_offset;     // ScenarioPoolRecord[pool_count]
+        std::uint64_t ids_offset;       // int32_t[aircraft_count]
+        std::uint64_t types_offset;     // AircraftType[aircraft_count]
+        std::uint64_t battery_offset;   // double[aircraft_count]
+        std::uint64_t home_pool_offset; // uint16_t[aircraft_count]
+    };
+
+    static_assert(std::is_trivially_copyable_v<ScenarioFileHeader>);
+    static_assert(sizeof(AircraftType) == sizeof(std::int32_t), "the types column stores AircraftType as-is");
+
+    struct ScenarioPoolRecord
+    {
+        static constexpr size_t MAX_NAME_LENGTH = 55;
+
+        char name[MAX_NAME_LENGTH + 1]; // NUL-terminated
+        std::int32_t charger_count;
+        std::uint32_t reserved;
+    };
+
+    static_assert(sizeof(ScenarioPoolRecord) == 64 && std::is_trivially_copyable_v<ScenarioPoolRecord>);
+
+    /**
+     * Write scenario in the binary format MappedScenario reads
+     * @throws std::invalid_argument if the scenario is inconsistent (no pools, duplicate or negative
+     *         ids, battery levels outside [0, 1], unknown pools, pools without chargers, names too long)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void write_scenario_file(const std::string &path, const Scenario &scenario);
+
+    /**
+     * Private read-write mapping of a binary scenario file
+     * Opening checks the header, section bounds and type ranges only; nothing is parsed or copied per aircraft,
+     * so opening costs the same for ten aircraft or ten million, and pages come in as the columns
+     * are first touched. Writes (a fleet's battery levels) stay in this process's copy-on-write pages
+     * and never reach the file.
+     */
+    class MappedScenario
+    {
+    private:
+        std::string path_;
+        std::byte *data_ = nullptr;
+        size_t size_ = 0;
+        const ScenarioFileHeader *header_ = nullptr;
+
+        template <typename T>
+        T *column(std::uint64_t offset) const
+        {
+            return reinterpret_cast<T *>(data_ + offset);
+        }
+
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be mapped or is not a valid scenario of this version
+         */
+        explicit MappedScenario(const std::string &path);
+        ~MappedScenario();
+
+        MappedScenario(const MappedScenario &) = delete;
+        MappedScenario &operator=(const MappedScenario &) = delete;
+
+        static std::shared_ptr<MappedScenario> open(const std::string &path)
+        {
+            return std::make_shared<MappedScenario>(path);
+        }
+
+        /**
+         * A SoaFleet whose id, type and battery columns are this mapping's pages
+         * The fleet keeps the mapping alive and writes its battery levels into it, so give each
+         * fleet its own open() of the file.
+         */
+        static SoaFleet map_fleet(const std::shared_ptr<MappedScenario> &scenario);
+
+        const std::string &path() const { return path_; }
+        const ScenarioFileHeader &header() const { return *header_; }
+        size_t size() const { return static_cast<size_t>(header_->aircraft_count); }
+        int max_aircraft_id() const { return header_->max_aircraft_id; }
+
+        std::vector<ChargerPoolSpec> charger_pools() const;
+
+        std::span<const int> ids() const { return {column<const int>(header_->ids_offset), size()}; }
+        std::span<const AircraftType> types() const { return {column<const AircraftType>(header_->types_offset), size()}; }
+        std::span<const double> battery_levels() const { return {column<const double>(header_->battery_offset), size()}; }
+        std::span<const std::uint16_t> home_pools() const
+        {
+            return {column<const std::uint16_t>(header_->home_pool_offset), size()};
+        }
+
+        /**
+         * Give every aircraft its home pool in charger_mgr, which must have been built from charger_pools()
+         */
+        void assign_home_pools(ChargerManager &charger_mgr) const;
+
+        /**
+         * Check every record, as write_scenario_file does before writing; reads the whole file
+         * Types and home pools index per-type tables and pools, so run this before using a file
+         * that was not just written by write_scenario_file.
+         * @throws std::runtime_error describing the first bad record
+         */
+        void verify() const;
+    };
+}
@@ -1,11 +1,123 @@
 #include "simulation_config.h"
+#include "simulation_log.h"
+#include <algorithm>
+#include <cctype>
 #include <cstring>
 #include <cstdlib>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <sstream>
+#include <string>
+#include <utility>
 
 namespace evtol
 {
+    namespace
+    {
+        /**
+         * Parse "name:count,name:count,..."
+         * @param what Entry description for error messages
+         * @throws std::invalid_argument for malformed entries
+         */
+        std::vector<std::pair<std::string, int>> parse_named_counts(const std::string &list, const std::string &what)
+        {
+            std::vector<std::pair<std::string, int>> entries;
+            size_t begin = 0;
+            while (begin <= list.size())
+            {
+                size_t end = std::min(list.find(',', begin), list.size());
+                std::string entry = list.substr(begin, end - begin);
+                size_t colon = entry.find(':');
+                if (colon == std::string::npos || colon == 0 || colon + 1 == entry.size())
+                {
+                    throw std::invalid_argument(what + " must be name:count, got '" + entry + "'");
+                }
+                entries.emplace_back(entry.substr(0, colon), std::stoi(entry.substr(colon + 1)));
+                begin = end + 1;
+            }
+            return entries;
+        }
+
+        std::vector<ChargerPoolSpec> parse_charger_pools(const std::string &list)
+        {
+            std::vector<ChargerPoolSpec> pools;
+            for (auto &[name, count] : parse_named_counts(list, "Charger pool"))
+            {
+                pools.push_back({name, count});
+            }
+            return pools;
+        }
+
+        /**
+         * Parse "1,2,3" into values
+         * @throws std::invalid_argument for an empty or malformed entry
+         */
+        template <typename T, typename Parse>
+        std::vector<T> parse_list(const std::string &list, Parse parse)
+        {
+            std::vector<T> values;
+            size_t begin = 0;
+            while (begin <= list.size())
+            {
+                size_t end = std::min(list.find(',', begin), list.size());
+                std::string entry = list.substr(begin, end - begin);
+                if (entry.empty())
+                {
+                    throw std::invalid_argument("Empty entry in list '" + list + "'");
+                }
+                values.push_back(static_cast<T>(parse(entry)));
+                begin = end + 1;
+            }
+            return values;
+        }
+
+        std::vector<int> parse_int_list(const std::string &list)
+        {
+            return parse_list<int>(list, [](const std::string &entry)
+                                   { return std::stoi(entry); });
+        }
+
+        /**
+         * Parse "type:weight,type:weight,..."; types not listed get no aircraft
+         * @throws std::invalid_argument for unknown types or malformed entries
+         */
+        FleetMix parse_fleet_mix(const std::string &list)
+        {
+            FleetMix mix;
+            mix.weights.fill(0);
+            for (const auto &[type_name, weight] : parse_named_counts(list, "Fleet mix entry"))
+            {
+                std::string name = type_name;
+                std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c)
+                               { return static_cast<char>(std::tolower(c)); });
+
+                auto *found = std::find(std::begin(FleetMix::type_names), std::end(FleetMix::type_names), name);
+                if (found == std::end(FleetMix::type_names))
+                {
+                    throw std::invalid_argument("Unknown aircraft type '" + type_name + "' in fleet mix");
+                }
+                mix.weights[static_cast<size_t>(found - std::begin(FleetMix::type_names))] = weight;
+            }
+            return mix;
+        }
+
+        /**
+         * @return An error message, or empty if the mix can build a fleet
+         */
+        std::string check_fleet_mix(const FleetMix &mix)
+        {
+            for (int weight : mix.weights)
+            {
+                if (weight < 0)
+                {
+                    return "Fleet mix weights must not be negative";
+                }
+            }
+            return mix.period() > 0 ? "" : "Fleet mix needs at least one aircraft type";
+        }
+    }
+
     void SimulationConfig::parse_args(int argc, char *argv[])
     {
         for (int i = 1; i < argc; ++i)
@@ -18,6 +130,10 @@ namespace evtol
             {
                 mode = SimulationMode::EVENT_DRIVEN;
             }
+            else if (strcmp(argv[i], "--coroutine") == 0)
+            {
+                mode = SimulationMode::COROUTINE;
+            }
             else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
             {
                 simulation_duration_hours = std::stod(argv[++i]);
@@ -26,6 +142,34 @@ namespace evtol
             {
                 frame_time_seconds = std::stod(argv[++i]);
             }
+            else if (strcmp(argv[i], "--scheduler") == 0 && i + 1 < argc)
+            {
+                scheduler = parse_scheduler_type(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--analytic") == 0)
+            {
+                enable_analytic_solver = true;
+            }
+            else if (strcmp(argv[i], "--network") == 0)
+            {
+                enable_network = true;
+            }
+            else if (strcmp(argv[i], "--fault-model") == 0 && i + 1 < argc)
+            {
+                fault_model = parse_fault_model(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--dispatch") == 0 && i + 1 < argc)
+            {
+                dispatch_policy = parse_dispatch_policy(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--skip-ahead") == 0)
+            {
+                enable_skip_ahead = true;
+            }
+            else if (strcmp(argv[i], "--full-frame-scan") == 0)
+            {
+                full_frame_scan = true;
+            }
             else if (strcmp(argv[i], "--detailed-logging") == 0)
             {
                 enable_detailed_logging = true;
@@ -34,15 +178,178 @@ namespace evtol
             {
                 enable_partial_flights = false;
             }
+            else if (strcmp(argv[i], "--no-verify-scenario") == 0)
+            {
+                verify_scenario = false;
+            }
+            else if (strcmp(argv[i], "--profile") == 0)
+            {
+                enable_profile = true;
+            }
+            else if (strcmp(argv[i], "--profile-json") == 0 && i + 1 < argc)
+            {
+                enable_profile = true;
+                profile_json_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--progress") == 0 && i + 1 < argc)
+            {
+                progress_seconds = std::stod(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            {
+                trace_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc)
+            {
+                checkpoint.every_hours = std::stod(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--checkpoint-prefix") == 0 && i + 1 < argc)
+            {
+                checkpoint.path_prefix = argv[++i];
+            }
+            else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc)
+            {
+                checkpoint.restore_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--branch-seed") == 0 && i + 1 < argc)
+            {
+                checkpoint.branch_seed = std::stoull(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--percentiles") == 0)
+            {
+                enable_percentiles = true;
+            }
+            else if (strcmp(argv[i], "--fleet-size") == 0 && i + 1 < argc)
+            {
+                fleet_size = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--fleet-mix") == 0 && i + 1 < argc)
+            {
+                fleet_mix = parse_fleet_mix(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--chargers") == 0 && i + 1 < argc)
+            {
+                num_chargers = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--charger-pools") == 0 && i + 1 < argc)
+            {
+                charger_pools = parse_charger_pools(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc)
+            {
+                scenario_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            {
+                random_seed = std::stoull(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--replications") == 0 && i + 1 < argc)
+            {
+                replications = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--ci-target") == 0 && i + 1 < argc)
+            {
+                ci_target = std::stod(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--ci-metrics") == 0 && i + 1 < argc)
+            {
+                ci_metrics = parse_list<WatchedMetric>(argv[++i], [](const std::string &entry)
+                                                       { return WatchedMetric::parse(entry); });
+            }
+            else if (strcmp(argv[i], "--min-replications") == 0 && i + 1 < argc)
+            {
+                min_replications = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            {
+                num_threads = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--coordinator") == 0 && i + 1 < argc)
+            {
+                coordinator_port = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--worker") == 0 && i + 1 < argc)
+            {
+                worker_address = argv[++i];
+            }
+            else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+            {
+                distributed_chunk = std::stoi(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--worker-wait") == 0 && i + 1 < argc)
+            {
+                worker_wait_seconds = std::stod(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--sweep-csv") == 0 && i + 1 < argc)
+            {
+                sweep_csv_path = argv[++i];
+            }
+            else if (strcmp(argv[i], "--sweep-chargers") == 0 && i + 1 < argc)
+            {
+                sweep.charger_counts = parse_int_list(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--sweep-fleet-sizes") == 0 && i + 1 < argc)
+            {
+                sweep.fleet_sizes = parse_int_list(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--sweep-mix") == 0 && i + 1 < argc)
+            {
+                sweep.fleet_mixes.push_back(parse_fleet_mix(argv[++i]));
+            }
+            else if (strcmp(argv[i], "--sweep-seeds") == 0 && i + 1 < argc)
+            {
+                sweep.seeds = parse_list<std::uint64_t>(argv[++i], [](const std::string &entry)
+                                                        { return std::stoull(entry); });
+            }
             else if (strcmp(argv[i], "--help") == 0)
             {
                 std::cout << "eVTOL Simulation Options:" << std::endl;
                 std::cout << "  --frame-based              Use frame-based simulation" << std::endl;
                 std::cout << "  --event-driven             Use event-driven simulation (default)" << std::endl;
+                std::cout << "  --coroutine                Event-driven with one coroutine per aircraft (same results, no event payloads)" << std::endl;
                 std::cout << "  --duration <hours>         Simulation duration in hours (default: 3.0)" << std::endl;
                 std::cout << "  --frame-time <seconds>     Frame time in seconds (default: 60.0)" << std::endl;
+                std::cout << "  --skip-ahead               Frame-based: jump straight to the next frame where an aircraft acts" << std::endl;
+                std::cout << "  --full-frame-scan          Frame-based: step every aircraft every frame (reference for the sparse update)" << std::endl;
+                std::cout << "  --scheduler <name>         Event queue: heap, 4-ary or calendar (default: heap)" << std::endl;
+                std::cout << "  --analytic                 Event-driven: solve runs whose chargers never run out without the event queue" << std::endl;
+                std::cout << "  --network                  Event-driven: fly between the charger pools as vertiports, one parallel event queue each" << std::endl;
                 std::cout << "  --detailed-logging         Enable detailed logging" << std::endl;
                 std::cout << "  --no-partial-flights       Disable partial flights/charging at simulation end" << std::endl;
+                std::cout << "  --profile                  Report event/frame counters, queue depths and phase times (EVTOL_PROFILE=1 builds)" << std::endl;
+                std::cout << "  --profile-json <file>      Also write the profile as JSON" << std::endl;
+                std::cout << "  --progress <seconds>       Print rolling progress to stderr every <seconds> of wall time (single runs)" << std::endl;
+                std::cout << "  --trace <file>             Write every aircraft state change to a binary trace (single runs)" << std::endl;
+                std::cout << "  --checkpoint-every <hours> Save the full simulation state every <hours> (single runs)" << std::endl;
+                std::cout << "  --checkpoint-prefix <path> Checkpoint files are <path>_<hours>h.ckpt (default: evtol_checkpoint)" << std::endl;
+                std::cout << "  --restore <file>           Resume from a checkpoint; --duration may differ from the original run" << std::endl;
+                std::cout << "  --branch-seed <value>      With --restore, re-key every random stream to branch off the checkpoint" << std::endl;
+                std::cout << "  --percentiles              Report p50/p95/p99 flight time, charge wait and queue length" << std::endl;
+                std::cout << "  --fleet-size <count>       Number of aircraft (default: 20)" << std::endl;
+                std::cout << "  --fleet-mix <list>         Type shares, e.g. alpha:2,echo:1 (default: one of each type in turn)" << std::endl;
+                std::cout << "  --chargers <count>         Number of chargers (default: 3)" << std::endl;
+                std::cout << "  --charger-pools <list>     Named charger pools, e.g. north:4,south:2 (aircraft id % pools picks the pool)" << std::endl;
+                std::cout << "  --dispatch <policy>        Waiting aircraft order: fifo, shortest-charge or most-passengers (default: fifo)" << std::endl;
+                std::cout << "  --scenario <file>          Load the fleet and charger pools from a binary scenario (tools/scenario_to_binary)" << std::endl;
+                std::cout << "  --no-verify-scenario       Skip checking every --scenario record before the run (trusted files only)" << std::endl;
+                std::cout << "  --seed <value>             Seed fault sampling for reproducible runs (default: random)" << std::endl;
+                std::cout << "  --fault-model <name>       Flight faults: linear (rate x flight time) or exponential (default: linear)" << std::endl;
+                std::cout << "  --replications <count>     Run independent replications and report mean/stddev/CI (default: 1)" << std::endl;
+                std::cout << "  --ci-target <fraction>     Stop replications once every --ci-metrics 95% CI is within +/- fraction of" << std::endl;
+                std::cout << "                             its mean, e.g. 0.02; --replications is then the cap (default: 0 = off)" << std::endl;
+                std::cout << "  --ci-metrics <list>        Metrics --ci-target watches, fleet-wide or type:metric, e.g." << std::endl;
+                std::cout << "                             avg_waiting_time,echo:total_faults (default: total_passenger_miles,avg_waiting_time)" << std::endl;
+                std::cout << "  --min-replications <count> Replications before --ci-target may stop a batch (default: 10)" << std::endl;
+                std::cout << "  --threads <count>          Worker threads for batch runs and frame-based updates (default: 0 = all cores)" << std::endl;
+                std::cout << "  --sweep-csv <file>         Run every scenario of the sweep grid below, one CSV row per scenario" << std::endl;
+                std::cout << "  --sweep-chargers <list>    Sweep: charger counts, e.g. 1,2,4" << std::endl;
+                std::cout << "  --sweep-fleet-sizes <list> Sweep: fleet sizes, e.g. 20,50,100" << std::endl;
+                std::cout << "  --sweep-mix <list>         Sweep: add a fleet mix (repeatable)" << std::endl;
+                std::cout << "  --sweep-seeds <list>       Sweep: seeds; with --restore each seed branches from the checkpoint" << std::endl;
+                std::cout << "  --coordinator <port>       Serve the replications or sweep to --worker processes on <port> (make distributed)" << std::endl;
+                std::cout << "  --worker <host:port>       Run tasks for a coordinator until it is done (make distributed)" << std::endl;
+                std::cout << "  --chunk <count>            Coordinator: replications or sweep points per task (default: 0 = automatic)" << std::endl;
+                std::cout << "  --worker-wait <seconds>    Coordinator: report partial results after this long without workers (default: 60)" << std::endl;
                 std::cout << "  --help                     Show this help message" << std::endl;
                 exit(0);
             }
@@ -69,7 +376,194 @@ namespace evtol
             return false;
         }
 
+        if (replications < 1)
+        {
+            std::cerr << "Error: Replication count must be at least 1" << std::endl;
+            return false;
+        }
+
+        if (ci_target < 0.0)
+        {
+            std::cerr << "Error: CI target must not be negative" << std::endl;
+            return false;
+        }
+
+        if (ci_target > 0.0 && (min_replications < 2 || min_replications > replications))
+        {
+            std::cerr << "Error: --ci-target needs 2 <= --min-replications <= --replications (the cap)" << std::endl;
+            return false;
+        }
+
+        if (num_chargers < 1)
+        {
+            std::cerr << "Error: Charger count must be at least 1" << std::endl;
+            return false;
+        }
+
+        for (const auto &pool : charger_pools)
+        {
+            if (pool.charger_count < 1)
+            {
+                std::cerr << "Error: Charger pool '" << pool.name << "' needs at least one charger" << std::endl;
+                return false;
+            }
+        }
+
+        if (fleet_size < 0)
+        {
+            std::cerr << "Error: Fleet size must not be negative" << std::endl;
+            return false;
+        }
+
+        std::string mix_error = check_fleet_mix(fleet_mix);
+        if (!mix_error.empty())
+        {
+            std::cerr << "Error: " << mix_error << std::endl;
+            return false;
+        }
+
+        if (num_threads < 0)
+        {
+            std::cerr << "Error: Thread count must not be negative" << std::endl;
+            return false;
+        }
+
+        if ((coordinator_port != 0 || !worker_address.empty()) && !DISTRIBUTED_COMPILED_IN)
+        {
+            std::cerr << "Error: --coordinator and --worker need a build with distributed batches (make distributed)" << std::endl;
+            return false;
+        }
+
+        if (coordinator_port < 0 || coordinator_port > 65535)
+        {
+            std::cerr << "Error: Coordinator port must be between 1 and 65535" << std::endl;
+            return false;
+        }
+
+        if (distributed_chunk < 0 || worker_wait_seconds < 0.0)
+        {
+            std::cerr << "Error: Task chunk and worker wait must not be negative" << std::endl;
+            return false;
+        }
+
+        if (progress_seconds < 0.0)
+        {
+            std::cerr << "Error: Progress interval must not be negative" << std::endl;
+            return false;
+        }
+
+        if (checkpoint.every_hours < 0.0)
+        {
+            std::cerr << "Error: Checkpoint interval must not be negative" << std::endl;
+            return false;
+        }
+
+        for (int count : sweep.charger_counts)
+        {
+            if (count < 1)
+            {
+                std::cerr << "Error: Swept charger counts must be at least 1" << std::endl;
+                return false;
+            }
+        }
+
+        for (int size : sweep.fleet_sizes)
+        {
+            if (size < 0)
+            {
+                std::cerr << "Error: Swept fleet sizes must not be negative" << std::endl;
+                return false;
+            }
+        }
+
+        for (const auto &mix : sweep.fleet_mixes)
+        {
+            mix_error = check_fleet_mix(mix);
+            if (!mix_error.empty())
+            {
+                std::cerr << "Error: Swept fleet mix: " << mix_error << std::endl;
+                return false;
+            }
+        }
+
         // Warn about potentially problematic settings
+        if (!sweep.empty() && sweep_csv_path.empty())
+        {
+            std::cerr << "Warning: The sweep grid only applies together with --sweep-csv" << std::endl;
+        }
+
+        if (!sweep_csv_path.empty() && (replications > 1 || !trace_path.empty() || checkpoint.every_hours > 0.0))
+        {
+            std::cerr << "Warning: Sweeps run each scenario once; --replications, --trace and --checkpoint-every are ignored (use --sweep-seeds)" << std::endl;
+        }
+
+        if (ci_target > 0.0 && !sweep_csv_path.empty())
+        {
+            std::cerr << "Warning: Sweeps run each scenario once; --ci-target is ignored" << std::endl;
+        }
+
+        if (replications > 1 && (checkpoint.every_hours > 0.0 || !checkpoint.restore_path.empty()))
+        {
+            std::cerr << "Warning: Checkpoints apply to single runs; --checkpoint-every and --restore are ignored for replications" << std::endl;
+        }
+
+        if (checkpoint.branch_seed && checkpoint.restore_path.empty())
+        {
+            std::cerr << "Warning: --branch-seed only applies together with --restore" << std::endl;
+        }
+
+        if (enable_analytic_solver && mode != SimulationMode::EVENT_DRIVEN)
+        {
+            std::cerr << "Warning: --analytic only applies to the event-driven engine" << std::endl;
+        }
+
+        if (enable_network && mode != SimulationMode::EVENT_DRIVEN)
+        {
+            std::cerr << "Warning: --network only applies to the event-driven engine" << std::endl;
+        }
+
+        if (enable_network && mode == SimulationMode::EVENT_DRIVEN &&
+            (!trace_path.empty() || checkpoint.every_hours > 0.0 || !checkpoint.restore_path.empty() || enable_analytic_solver || enable_detailed_logging))
+        {
+            std::cerr << "Warning: Network runs are not traced, checkpointed, logged or solved analytically; those options are ignored" << std::endl;
+        }
+
+        if (mode == SimulationMode::COROUTINE &&
+            (checkpoint.every_hours > 0.0 || !checkpoint.restore_path.empty() || enable_detailed_logging))
+        {
+            std::cerr << "Warning: Coroutine runs are not checkpointed or logged; those options are ignored" << std::endl;
+        }
+
+        if (enable_profile && !PROFILING_COMPILED_IN)
+        {
+            std::cerr << "Warning: Profiling was compiled out (EVTOL_PROFILE=0); rebuild with PROFILE=1 for --profile" << std::endl;
+        }
+
+        if (enable_profile && !sweep_csv_path.empty())
+        {
+            std::cerr << "Warning: --profile applies to single runs and replications, not sweeps" << std::endl;
+        }
+
+        if (!scenario_path.empty() && (replications > 1 || !sweep_csv_path.empty()))
+        {
+            std::cerr << "Warning: --scenario applies to single runs; replications and sweeps use --fleet-size and --chargers" << std::endl;
+        }
+
+        if (progress_seconds > 0.0 && (replications > 1 || !sweep_csv_path.empty()))
+        {
+            std::cerr << "Warning: --progress applies to single runs, not replications or sweeps" << std::endl;
+        }
+
+        if (coordinator_port != 0 && replications <= 1 && sweep_csv_path.empty())
+        {
+            std::cerr << "Warning: --coordinator serves replications and sweeps; a single run stays local" << std::endl;
+        }
+
+        if (enable_detailed_logging && !DETAILED_LOGGING_COMPILED_IN)
+        {
+            std::cerr << "Warning: Detailed logging was compiled out (EVTOL_LOG_LEVEL=0); --detailed-logging has no effect" << std::endl;
+        }
+
         if (frame_time_seconds > 300.0) // 5 minutes
         {
             std::cerr << "Warning: Frame time is quite large (" << frame_time_seconds
@@ -78,4 +572,101 @@ namespace evtol
 
         return true;
     }
+
+    std::vector<std::string> SimulationConfig::to_args() const
+    {
+        auto number = [](double value)
+        {
+            std::ostringstream text;
+            text << std::setprecision(17) << value;
+            return text.str();
+        };
+        auto join = [](const auto &values, auto format)
+        {
+            std::string text;
+            for (const auto &value : values)
+            {
+                text += (text.empty() ? "" : ",") + format(value);
+            }
+            return text;
+        };
+
+        std::vector<std::string> args;
+        args.push_back(mode == SimulationMode::FRAME_BASED ? "--frame-based"
+                       : mode == SimulationMode::COROUTINE ? "--coroutine"
+                                                           : "--event-driven");
+        args.insert(args.end(), {"--duration", number(simulation_duration_hours)});
+        args.insert(args.end(), {"--frame-time", number(frame_time_seconds)});
+        args.insert(args.end(), {"--scheduler", scheduler_type_to_string(scheduler)});
+        args.insert(args.end(), {"--fault-model", fault_model_to_string(fault_model)});
+        args.insert(args.end(), {"--dispatch", dispatch_policy_to_string(dispatch_policy)});
+        if (enable_skip_ahead)
+            args.push_back("--skip-ahead");
+        if (full_frame_scan)
+            args.push_back("--full-frame-scan");
+        if (enable_analytic_solver)
+            args.push_back("--analytic");
+        if (enable_network)
+            args.push_back("--network");
+        if (!enable_partial_flights)
+            args.push_back("--no-partial-flights");
+        if (enable_percentiles)
+            args.push_back("--percentiles");
+        if (random_seed)
+            args.insert(args.end(), {"--seed", std::to_string(*random_seed)});
+
+        args.insert(args.end(), {"--fleet-size", std::to_string(fleet_size)});
+        args.insert(args.end(), {"--fleet-mix", fleet_mix.to_string()});
+        args.insert(args.end(), {"--chargers", std::to_string(num_chargers)});
+        if (!charger_pools.empty())
+        {
+            args.insert(args.end(), {"--charger-pools", join(charger_pools, [](const ChargerPoolSpec &pool)
+                                                             { return pool.name + ":" + std::to_string(pool.charger_count); })});
+        }
+        args.insert(args.end(), {"--replications", std::to_string(replications)});
+
+        if (!checkpoint.restore_path.empty())
+        {
+            args.insert(args.end(), {"--restore", checkpoint.restore_path});
+        }
+        if (checkpoint.branch_seed)
+        {
+            args.insert(args.end(), {"--branch-seed", std::to_string(*checkpoint.branch_seed)});
+        }
+
+        auto integer = [](auto value)
+        { return std::to_string(value); };
+        if (!sweep.charger_counts.empty())
+            args.insert(args.end(), {"--sweep-chargers", join(sweep.charger_counts, integer)});
+        if (!sweep.fleet_sizes.empty())
+            args.insert(args.end(), {"--sweep-fleet-sizes", join(sweep.fleet_sizes, integer)});
+        for (const FleetMix &mix : sweep.fleet_mixes)
+            args.insert(args.end(), {"--sweep-mix", mix.to_string()});
+        if (!sweep.seeds.empty())
+            args.insert(args.end(), {"--sweep-seeds", join(sweep.seeds, integer)});
+        return args;
+    }
+
+    ConfidenceStoppingRule SimulationConfig::stopping_rule() const
+    {
+        ConfidenceStoppingRule rule;
+        rule.relative_half_width = ci_target;
+        rule.min_replications = static_cast<size_t>(std::max(min_replications, 1));
+        rule.max_replications = static_cast<size_t>(replications);
+        rule.metrics = ci_metrics;
+        if (rule.metrics.empty())
+        {
+            rule.metrics = {WatchedMetric::parse("total_passenger_miles"), WatchedMetric::parse("avg_waiting_time")};
+        }
+        return rule;
+    }
+
+    std::vector<ChargerPoolSpec> SimulationConfig::get_charger_pools() const
+    {
+        if (!charger_pools.empty())
+        {
+            return charger_pools;
+        }
+        return {{"default", num_chargers}};
+    }
 }
\ No newline at end of file
@@ -1,9 +1,44 @@
 #pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
 #include <thread>
+#include <vector>
 #include "simulation_interface.h"
+#include "event_scheduler.h"
+#include "charger_manager.h"
+#include "aircraft_types.h"
+#include "batch_statistics.h"
+
+/**
+ * Compile-time switch for distributed batches (--coordinator, --worker)
+ * 0 (default) leaves the sockets code out; `make distributed` and the tests build with 1 and link
+ * distributed_batch.cpp.
+ */
+#ifndef EVTOL_DISTRIBUTED
+#define EVTOL_DISTRIBUTED 0
+#endif
 
 namespace evtol
 {
+    inline constexpr bool DISTRIBUTED_COMPILED_IN = EVTOL_DISTRIBUTED > 0;
+
+    /**
+     * Parameter grid of a sweep; an empty dimension keeps the base configuration's value
+     */
+    struct SweepGrid
+    {
+        std::vector<int> charger_counts;   // one pool of each count
+        std::vector<int> fleet_sizes;
+        std::vector<FleetMix> fleet_mixes;
+        std::vector<std::uint64_t> seeds;
+
+        bool empty() const
+        {
+            return charger_counts.empty() && fleet_sizes.empty() && fleet_mixes.empty() && seeds.empty();
+        }
+    };
+
     /**
      * Configuration for simulation engines
      */
@@ -12,12 +47,71 @@ namespace evtol
         SimulationMode mode = SimulationMode::EVENT_DRIVEN;
         double simulation_duration_hours = 3.0;
         
+        // Event-driven specific settings
+        EventSchedulerType scheduler = EventSchedulerType::BINARY_HEAP;
+        bool enable_analytic_solver = false; // solve runs whose chargers never run out directly, see uncontended_solver.h
+        bool enable_network = false;         // fly between charger pools as vertiports in parallel, see network_simulation.h
+
         // Frame-based specific settings
         double frame_time_seconds = 60.0;  // 1 minute frames
+        bool enable_skip_ahead = false;    // jump over frames where only timers change
+        bool full_frame_scan = false;      // reference stepping: every aircraft every frame, no sparse dispatch
         
         // Performance settings
         bool enable_detailed_logging = false;
         bool enable_partial_flights = true;
+        bool enable_percentiles = false;   // p50/p95/p99 histograms of flight time, charge wait and queue length
+
+        // Binary event trace (empty = no trace); single runs only, see tools/trace_to_csv.cpp
+        std::string trace_path;
+
+        // Hot-path counters and phase timers (needs a build with EVTOL_PROFILE=1), see profiler.h
+        bool enable_profile = false;
+        std::string profile_json_path; // also write the profile as JSON (implies enable_profile)
+
+        // Rolling progress lines on stderr every progress_seconds of wall time (0 = off); single runs only
+        double progress_seconds = 0.0;
+
+        // Checkpoints of single runs: --checkpoint-every, --checkpoint-prefix, --restore, --branch-seed
+        CheckpointOptions checkpoint;
+
+        // Random number settings (unset = non-deterministic)
+        std::optional<std::uint64_t> random_seed;
+        FaultModel fault_model = FaultModel::LINEAR; // how flights draw their faults, see fault_model.h
+
+        // Fleet: fleet_size aircraft with types dealt out by fleet_mix
+        int fleet_size = 20;
+        FleetMix fleet_mix;
+
+        // Charger settings: one pool of num_chargers unless named pools are given
+        int num_chargers = ChargerManager::DEFAULT_NUM_CHARGERS;
+        std::vector<ChargerPoolSpec> charger_pools;
+        DispatchPolicy dispatch_policy = DispatchPolicy::FIFO; // order waiting aircraft get chargers, see dispatch_policy.h
+
+        // Binary scenario file (--scenario) giving the fleet, charger pools and home pools instead; single runs only
+        std::string scenario_path;
+        bool verify_scenario = true; // check every record of the scenario before the run
+
+        // Batch settings
+        int replications = 1;  // independent simulations to run and aggregate
+        int num_threads = 0;   // worker threads for batches and frame updates (0 = hardware concurrency)
+
+        // Sequential stopping: with ci_target set, replications stop once every ci_metrics 95% CI is
+        // within ci_target of its mean, after at least min_replications; replications is then the cap
+        double ci_target = 0.0;             // relative CI half-width, e.g. 0.02 (0 = run all replications)
+        std::vector<WatchedMetric> ci_metrics; // empty = fleet total_passenger_miles and avg_waiting_time
+        int min_replications = static_cast<int>(ConfidenceStoppingRule::DEFAULT_MIN_REPLICATIONS);
+
+        // Parameter sweep: with sweep_csv_path set, every scenario of the grid runs once, see sweep_runner.h
+        SweepGrid sweep;
+        std::string sweep_csv_path;
+
+        // Distributed batches: a coordinator hands replications or sweep points to worker processes
+        // over TCP (needs a build with EVTOL_DISTRIBUTED=1), see distributed_batch.h
+        int coordinator_port = 0;          // serve the batch or sweep on this port (0 = run it here)
+        std::string worker_address;        // host:port of a coordinator to run tasks for
+        int distributed_chunk = 0;         // replications or sweep points per task (0 = automatic)
+        double worker_wait_seconds = 60.0; // give up with the tasks finished so far after this long without workers
         
         /**
          * Parse configuration from command line arguments
@@ -31,5 +125,26 @@ namespace evtol
          * @return True if configuration is valid
          */
         bool validate() const;
+
+        /**
+         * Options that make another process run the same replications or sweep points: everything
+         * the simulations depend on, nothing about output, distribution, threads or single runs
+         */
+        std::vector<std::string> to_args() const;
+
+        /**
+         * Pools to build the ChargerManager from
+         */
+        std::vector<ChargerPoolSpec> get_charger_pools() const;
+
+        /**
+         * ChargerManager of the configured pools and dispatch policy
+         */
+        ChargerManager make_charger_manager() const { return ChargerManager(get_charger_pools(), dispatch_policy); }
+
+        /**
+         * Stopping rule of the replications; disabled (run them all) without ci_target
+         */
+        ConfidenceStoppingRule stopping_rule() const;
     };
 }
\ No newline at end of file
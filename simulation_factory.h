@@ -1,9 +1,12 @@
 #pragma once
 #include <memory>
+#include <stdexcept>
 #include "simulation_interface.h"
 #include "simulation_config.h"
 #include "event_driven_simulation.h"
 #include "frame_based_simulation.h"
+#include "network_simulation.h"
+#include "coroutine_simulation.h"
 
 namespace evtol
 {
@@ -26,16 +29,54 @@ namespace evtol
             switch (config.mode)
             {
             case SimulationMode::EVENT_DRIVEN:
-                return std::make_unique<EventDrivenSimulationEngine>(stats, config.simulation_duration_hours, config.enable_detailed_logging, config.enable_partial_flights);
+                if (config.enable_network)
+                {
+                    return std::make_unique<NetworkSimulationEngine>(stats, config);
+                }
+                return std::make_unique<EventDrivenSimulationEngine>(stats, config.simulation_duration_hours, config.enable_detailed_logging, config.enable_partial_flights, config.random_seed, config.scheduler, config.enable_analytic_solver, config.fault_model);
 
             case SimulationMode::FRAME_BASED:
                 return std::make_unique<FrameBasedSimulationEngine>(stats, config);
 
+            case SimulationMode::COROUTINE:
+                return std::make_unique<CoroutineSimulationEngine>(stats, config);
+
             default:
                 throw std::invalid_argument("Unknown simulation mode");
             }
         }
 
+        /**
+         * Call func with the concrete engine behind an ISimulationEngine
+         * Lets templated callers hand any SimulationFleet to the engine's run<Fleet> without type erasure.
+         * @param engine Engine created by create_engine
+         * @param func Callable invoked as func(ConcreteEngine &)
+         */
+        template <typename Func>
+        static void visit_engine(ISimulationEngine &engine, Func &&func)
+        {
+            if (auto *event_engine = dynamic_cast<EventDrivenSimulationEngine *>(&engine))
+            {
+                func(*event_engine);
+            }
+            else if (auto *network_engine = dynamic_cast<NetworkSimulationEngine *>(&engine))
+            {
+                func(*network_engine);
+            }
+            else if (auto *frame_engine = dynamic_cast<FrameBasedSimulationEngine *>(&engine))
+            {
+                func(*frame_engine);
+            }
+            else if (auto *coroutine_engine = dynamic_cast<CoroutineSimulationEngine *>(&engine))
+            {
+                func(*coroutine_engine);
+            }
+            else
+            {
+                throw std::invalid_argument("Unknown simulation engine type");
+            }
+        }
+
         /**
          * Create a complete simulation setup
          * @param config Simulation configuration
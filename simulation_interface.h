@@ -1,16 +1,69 @@
 #pragma once
+#include <concepts>
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <string>
+#include "aircraft.h"
 #include "charger_manager.h"
 #include "statistics_engine.h"
+#include "event_trace.h"
+#include "profiler.h"
+#include "progress_monitor.h"
 
 namespace evtol
 {
     enum class SimulationMode
     {
         EVENT_DRIVEN,
-        FRAME_BASED
+        FRAME_BASED,
+        COROUTINE // event-driven, one coroutine per aircraft, see coroutine_simulation.h
     };
 
+    /**
+     * Checkpointing for single runs (see checkpoint.h)
+     */
+    struct CheckpointOptions
+    {
+        double every_hours = 0.0;                     // 0: no checkpoints
+        std::string path_prefix = "evtol_checkpoint"; // files are <prefix>_<hours>h.ckpt
+        std::string restore_path;                     // start from this checkpoint instead of time zero
+        std::optional<std::uint64_t> branch_seed;     // re-key every random stream after restoring
+    };
+
+    /**
+     * Any fleet container the engine templates can run on
+     * Elements are reached as fleet[i]->..., so both owning pointers (AircraftFleet) and
+     * value handles with operator-> (SoaFleet) qualify.
+     */
+    template <typename Fleet>
+    concept SimulationFleet = requires(Fleet &fleet, size_t index, double hours, std::uint64_t seed) {
+        { fleet.size() } -> std::convertible_to<size_t>;
+        fleet.begin();
+        fleet.end();
+        { fleet[index]->get_id() } -> std::convertible_to<int>;
+        { fleet[index]->get_type() } -> std::same_as<AircraftType>;
+        { fleet[index]->get_flight_time_hours() } -> std::convertible_to<double>;
+        { fleet[index]->get_flight_distance_miles() } -> std::convertible_to<double>;
+        { fleet[index]->get_charge_time_hours() } -> std::convertible_to<double>;
+        { fleet[index]->get_passenger_count() } -> std::convertible_to<int>;
+        { fleet[index]->check_fault_during_flight(hours) } -> std::convertible_to<double>;
+        fleet[index]->discharge_battery();
+        fleet[index]->charge_battery();
+        fleet[index]->set_faulty(true);
+        fleet[index]->seed_random_stream(seed, seed);
+        fleet[index]->set_fault_model(FaultModel::LINEAR);
+        { fleet[index]->save_state() } -> std::same_as<AircraftSnapshot>;
+        fleet[index]->restore_state(AircraftSnapshot{});
+    };
+
+    /**
+     * A fleet that can return to its freshly created state in place (e.g. ArenaFleet),
+     * so batch replications can reuse one per worker instead of building one per run
+     */
+    template <typename Fleet>
+    concept ResettableFleet = requires(Fleet &fleet) { fleet.reset(); };
+
     /**
      * Abstract base interface for simulation engines
      * Provides polymorphic behavior for different simulation strategies
@@ -22,13 +75,13 @@ namespace evtol
 
         /**
          * Run the simulation with the given fleet and charger manager
+         * Other fleet containers go through the concrete engine's run<Fleet>, see SimulationFactory::visit_engine
          * @param charger_mgr Reference to charger manager
          * @param fleet Reference to aircraft fleet
          */
-        template <typename Fleet>
-        void run_simulation(ChargerManager &charger_mgr, Fleet &fleet)
+        void run_simulation(ChargerManager &charger_mgr, AircraftFleet &fleet)
         {
-            run_simulation_impl(charger_mgr, static_cast<void *>(&fleet));
+            run_simulation_impl(charger_mgr, fleet);
         }
 
         /**
@@ -49,13 +102,36 @@ namespace evtol
          */
         virtual bool is_running() const = 0;
 
+        /**
+         * Record every state change of the following runs to a binary trace
+         * @param writer Trace to append to, owned by the caller; nullptr stops tracing
+         */
+        virtual void set_trace_writer(TraceWriter *writer) = 0;
+
+        /**
+         * Write periodic checkpoints during the following runs, and/or resume them from one
+         */
+        virtual void set_checkpoint_options(const CheckpointOptions &options) = 0;
+
+        /**
+         * Count the following runs into counters (see profiler.h)
+         * @param counters Owned by the caller; nullptr stops profiling. Ignored unless built with EVTOL_PROFILE=1
+         */
+        virtual void set_profile(ProfileCounters *counters) = 0;
+
+        /**
+         * Publish snapshots of the following runs to channel whenever a reader requests one, and at their end
+         * @param channel Owned by the caller; nullptr stops publishing
+         */
+        virtual void set_progress_channel(ProgressChannel *channel) = 0;
+
     protected:
         /**
          * Implementation-specific simulation runner
          * @param charger_mgr Reference to charger manager
-         * @param fleet_ptr Pointer to fleet (type-erased)
+         * @param fleet Reference to aircraft fleet
          */
-        virtual void run_simulation_impl(ChargerManager &charger_mgr, void *fleet_ptr) = 0;
+        virtual void run_simulation_impl(ChargerManager &charger_mgr, AircraftFleet &fleet) = 0;
     };
 
     /**
@@ -67,16 +143,59 @@ namespace evtol
         double current_time_hours_;
         double simulation_duration_hours_;
         StatisticsCollector &stats_collector_;
+        StatsRecorder stats_recorder_; // non-virtual recording into stats_collector_
         bool is_running_;
+        TraceWriter *trace_writer_ = nullptr;
+        CheckpointOptions checkpoint_options_;
+        ProfileCounters *profile_ = nullptr;
+        ProgressChannel *progress_ = nullptr;
+
+        // Null unless profiling is compiled in and requested, so every hook folds away otherwise
+        ProfileCounters *active_profile() const
+        {
+            if constexpr (PROFILING_COMPILED_IN)
+            {
+                return profile_;
+            }
+            return nullptr;
+        }
+
+        // Every state change is traced, so this is also where the profile counts them
+        void trace(int aircraft_id, TraceEventType event_type, AircraftType aircraft_type,
+                   double value_a = 0.0, double value_b = 0.0)
+        {
+            if (ProfileCounters *profile = active_profile())
+            {
+                profile->state_changes++;
+            }
+            if (trace_writer_)
+            {
+                trace_writer_->record(current_time_hours_, aircraft_id, event_type, aircraft_type, value_a, value_b);
+            }
+        }
+
+        // One relaxed load per call unless a reader is waiting or the run is finished
+        void publish_progress(const ChargerManager &charger_mgr, bool finished = false)
+        {
+            if (progress_ && (finished || progress_->requested()))
+            {
+                progress_->publish(ProgressSnapshot::capture(current_time_hours_, simulation_duration_hours_,
+                                                             stats_collector_, charger_mgr, finished));
+            }
+        }
 
     public:
         SimulationEngineBase(StatisticsCollector &stats, double duration_hours = 3.0)
-            : current_time_hours_(0.0), simulation_duration_hours_(duration_hours), stats_collector_(stats), is_running_(false)
+            : current_time_hours_(0.0), simulation_duration_hours_(duration_hours), stats_collector_(stats), stats_recorder_(stats), is_running_(false)
         {
         }
 
         double get_current_time() const override { return current_time_hours_; }
         double get_duration() const override { return simulation_duration_hours_; }
         bool is_running() const override { return is_running_; }
+        void set_trace_writer(TraceWriter *writer) override { trace_writer_ = writer; }
+        void set_checkpoint_options(const CheckpointOptions &options) override { checkpoint_options_ = options; }
+        void set_profile(ProfileCounters *counters) override { profile_ = counters; }
+        void set_progress_channel(ProgressChannel *channel) override { progress_ = channel; }
     };
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Compile-time logging level
+ * 0 strips --detailed-logging out of the engines entirely; 1 (default) keeps it behind the runtime flag.
+ */
+#ifndef EVTOL_LOG_LEVEL
+#define EVTOL_LOG_LEVEL 1
+#endif
+
+namespace evtol
+{
+    inline constexpr bool DETAILED_LOGGING_COMPILED_IN = EVTOL_LOG_LEVEL > 0;
+
+    /**
+     * Print one detailed-log line
+     * @param message A string, or a callable returning one; the callable only runs here, so callers
+     *                that build messages with std::to_string pay nothing while logging is off
+     */
+    template <typename Message>
+    void write_log_event(double time_hours, Message &&message)
+    {
+        if constexpr (std::is_invocable_v<Message>)
+        {
+            std::cout << "[" << time_hours << "h] " << std::forward<Message>(message)() << '\n';
+        }
+        else
+        {
+            std::cout << "[" << time_hours << "h] " << message << '\n';
+        }
+    }
+}
@@ -1,8 +1,19 @@
 #pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include "simulation_interface.h"
 #include "simulation_config.h"
 #include "simulation_factory.h"
+#include "batch_statistics.h"
+#include "thread_pool.h"
 
 namespace evtol
 {
@@ -15,28 +26,236 @@ namespace evtol
         SimulationConfig config_;
         StatisticsCollector &stats_collector_;
         std::unique_ptr<ISimulationEngine> engine_;
+        std::unique_ptr<TraceWriter> trace_writer_;
+        std::string trace_path_;
+        std::unique_ptr<RunProfile> profile_;
+        std::unique_ptr<ProgressChannel> progress_channel_;
+
+        void attach_trace()
+        {
+            if (config_.trace_path != trace_path_)
+            {
+                trace_writer_.reset();
+                trace_path_ = config_.trace_path;
+                if (!trace_path_.empty())
+                {
+                    trace_writer_ = std::make_unique<TraceWriter>(trace_path_);
+                }
+            }
+            engine_->set_trace_writer(trace_writer_.get());
+        }
+
+        // One thread's counters per possible replication worker; single runs use the first
+        void attach_profile()
+        {
+            if (!PROFILING_COMPILED_IN || !config_.enable_profile)
+            {
+                profile_.reset();
+            }
+            else if (!profile_ || profile_->size() < ThreadPool::resolve_thread_count(config_.num_threads))
+            {
+                profile_ = std::make_unique<RunProfile>(ThreadPool::resolve_thread_count(config_.num_threads));
+            }
+            engine_->set_profile(profile_ ? &profile_->local(0) : nullptr);
+        }
+
+        // The channel outlives engines so a reader may keep a pointer to it across update_config
+        void attach_progress()
+        {
+            if (config_.progress_seconds > 0.0 && !progress_channel_)
+            {
+                progress_channel_ = std::make_unique<ProgressChannel>();
+            }
+            engine_->set_progress_channel(config_.progress_seconds > 0.0 ? progress_channel_.get() : nullptr);
+        }
+
+        template <typename Fleet>
+        static void run_on_engine(ISimulationEngine &engine, ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            if constexpr (std::is_same_v<Fleet, AircraftFleet>)
+            {
+                engine.run_simulation(charger_mgr, fleet);
+            }
+            else
+            {
+                SimulationFactory::visit_engine(engine, [&](auto &concrete_engine)
+                                                { concrete_engine.run(charger_mgr, fleet); });
+            }
+        }
 
     public:
         SimulationRunner(StatisticsCollector &stats, const SimulationConfig &config = SimulationConfig{})
             : config_(config), stats_collector_(stats)
         {
             engine_ = SimulationFactory::create_simulation_setup(config_, stats_collector_);
+            attach_trace();
+            attach_profile();
+            attach_progress();
+            engine_->set_checkpoint_options(config_.checkpoint);
         }
 
         /**
          * Run the simulation with the given fleet and charger manager
+         * AircraftFleet goes through the engine interface; any other SimulationFleet (e.g. SoaFleet)
+         * is handed to the concrete engine's template so its calls are resolved statically.
+         * With config.trace_path set, the run is appended to that trace and flushed before returning.
+         * config.checkpoint writes checkpoints during the run and/or resumes it from one.
+         * With config.enable_profile (in EVTOL_PROFILE builds) the run is counted into get_profile().
+         * With config.progress_seconds set, a monitor thread prints the run's progress to stderr at
+         * that period; the engine publishes to get_progress_channel() only when the monitor asks.
+         * Waiting aircraft are served in charger_mgr's dispatch policy, which the report names.
          * @param charger_mgr Reference to charger manager
          * @param fleet Reference to aircraft fleet
          */
-        template <typename Fleet>
+        template <SimulationFleet Fleet>
         void run_simulation(ChargerManager &charger_mgr, Fleet &fleet)
         {
             if (!engine_)
             {
                 throw std::runtime_error("Simulation engine not initialized");
             }
+            stats_collector_.set_dispatch_policy(charger_mgr.get_dispatch_policy());
+
+            if (config_.progress_seconds > 0.0)
+            {
+                auto period = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::duration<double>(config_.progress_seconds));
+                ProgressMonitor monitor(*progress_channel_, std::cerr, std::max(period, std::chrono::milliseconds(1)));
+                run_on_engine(*engine_, charger_mgr, fleet);
+            }
+            else
+            {
+                run_on_engine(*engine_, charger_mgr, fleet);
+            }
+
+            if (trace_writer_)
+            {
+                trace_writer_->flush();
+            }
+        }
+
+        /**
+         * Run config.replications independent simulations across a thread pool
+         * Each replication owns its fleet, charger manager and statistics collector and is seeded
+         * from config.random_seed and its index, so a batch is reproducible for any thread count.
+         * With config.enable_percentiles the histograms of every replication are pooled into the result.
+         * Replications are not traced, checkpointed or monitored for progress. A ResettableFleet is made once per worker and
+         * reset between replications. With config.enable_profile each worker counts its replications
+         * into its own thread of get_profile().
+         * @param make_fleet Callable returning a freshly constructed fleet
+         * @return Cross-replication statistics
+         */
+        template <typename FleetFactory>
+        BatchStatistics run_replications(FleetFactory make_fleet) const
+        {
+            return run_replications(make_fleet, 0, static_cast<size_t>(config_.replications));
+        }
+
+        /**
+         * Run replications first .. first + replication_count - 1 of the batch, seeded as in the
+         * whole batch, e.g. one node's share of a distributed batch (see distributed_batch.h)
+         * @param batch_seed Seed of the whole batch if the config has none; drawn here if neither is set
+         */
+        template <typename FleetFactory>
+        BatchStatistics run_replications(FleetFactory make_fleet, size_t first, size_t replication_count,
+                                         std::optional<std::uint64_t> batch_seed = std::nullopt) const
+        {
+            std::vector<ReplicationResult> results(replication_count);
+            std::uint64_t base_seed = config_.random_seed.value_or(batch_seed.value_or(RandomStream::entropy_seed()));
+
+            ThreadPool pool(std::max<size_t>(1, std::min(ThreadPool::resolve_thread_count(config_.num_threads), replication_count)));
+
+            // Percentile histograms are pooled per worker rather than kept per replication
+            ShardedStats worker_distributions(config_.enable_percentiles ? pool.size() : 0);
+            worker_distributions.enable_distributions();
+
+            // Fleets that reset in place are built once per worker and reused across replications
+            using Fleet = std::invoke_result_t<FleetFactory &>;
+            std::vector<std::optional<Fleet>> worker_fleets(ResettableFleet<Fleet> ? pool.size() : 0);
+
+            pool.parallel_for(replication_count, [&](size_t replication, size_t worker)
+                              {
+                auto run_replication = [&](Fleet &fleet)
+                {
+                    ChargerManager charger_mgr = config_.make_charger_manager();
+                    StatisticsCollector stats;
+                    stats.set_aircraft_counts(fleet);
+                    if (config_.enable_percentiles)
+                    {
+                        stats.enable_distributions();
+                    }
+
+                    SimulationConfig replication_config = config_;
+                    replication_config.random_seed = RandomStream::derive_seed(base_seed, first + replication);
+                    replication_config.num_threads = 1; // replications already occupy the pool
+
+                    auto engine = SimulationFactory::create_engine(replication_config, stats);
+                    engine->set_profile(profile_ ? &profile_->local(worker) : nullptr);
+                    run_on_engine(*engine, charger_mgr, fleet);
+
+                    results[replication] = BatchStatistics::capture(stats);
+                    if (config_.enable_percentiles)
+                    {
+                        worker_distributions.local(worker).merge(stats.shard());
+                    }
+                };
+
+                if constexpr (ResettableFleet<Fleet>)
+                {
+                    std::optional<Fleet> &fleet = worker_fleets[worker];
+                    if (fleet)
+                    {
+                        fleet->reset();
+                    }
+                    else
+                    {
+                        fleet.emplace(make_fleet());
+                    }
+                    run_replication(*fleet);
+                }
+                else
+                {
+                    auto fleet = make_fleet();
+                    run_replication(fleet);
+                } });
+
+            BatchStatistics batch;
+            for (const auto &result : results)
+            {
+                batch.add_replication(result);
+            }
+            if (config_.enable_percentiles)
+            {
+                batch.add_distributions(worker_distributions.merged());
+            }
+            return batch;
+        }
 
-            engine_->run_simulation(charger_mgr, fleet);
+        /**
+         * Run replications in rounds until rule is met or rule.max_replications have run
+         * Round k covers the replications right after round k - 1 and is seeded as in the whole
+         * batch, so a batch that runs to the cap equals run_replications() over the same count,
+         * up to the rounding of merging the rounds.
+         * @param make_fleet Callable returning a freshly constructed fleet
+         */
+        template <typename FleetFactory>
+        SequentialBatchResult run_replications_until(FleetFactory make_fleet, const ConfidenceStoppingRule &rule) const
+        {
+            SequentialBatchResult result;
+            std::uint64_t batch_seed = config_.random_seed.value_or(RandomStream::entropy_seed());
+            size_t done = 0;
+            while (size_t round = rule.next_round(done))
+            {
+                result.batch.merge(run_replications(make_fleet, done, round, batch_seed));
+                done += round;
+                ++result.rounds;
+                if (rule.is_met(result.batch))
+                {
+                    result.converged = true;
+                    break;
+                }
+            }
+            return result;
         }
 
         /**
@@ -53,8 +272,28 @@ namespace evtol
         {
             config_ = new_config;
             engine_ = SimulationFactory::create_simulation_setup(config_, stats_collector_);
+            attach_trace();
+            attach_profile();
+            attach_progress();
+            engine_->set_checkpoint_options(config_.checkpoint);
         }
 
+        /**
+         * Trace the runs are written to, or nullptr without config.trace_path
+         */
+        TraceWriter *get_trace_writer() { return trace_writer_.get(); }
+
+        /**
+         * Counters of every run so far, or nullptr unless profiling is compiled in and config.enable_profile set
+         */
+        RunProfile *get_profile() { return profile_.get(); }
+
+        /**
+         * Where single runs publish progress snapshots, or nullptr unless config.progress_seconds is set
+         * Any thread may read() it and request() a fresh snapshot while a run is under way.
+         */
+        ProgressChannel *get_progress_channel() { return config_.progress_seconds > 0.0 ? progress_channel_.get() : nullptr; }
+
         /**
          * Get current configuration
          * @return Current configuration
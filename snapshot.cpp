@@ -0,0 +1,77 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <utility>
+
+namespace evtol
+{
+    SnapshotWriter::SnapshotWriter()
+    {
+        SnapshotFileHeader header{};
+        std::memcpy(header.magic, SnapshotFileHeader::MAGIC, sizeof(header.magic));
+        header.version = SnapshotFileHeader::VERSION;
+        write(header);
+    }
+
+    void SnapshotWriter::save(const std::string &path) const
+    {
+        std::string temp_path = path + ".tmp";
+        std::FILE *file = std::fopen(temp_path.c_str(), "wb");
+        if (!file)
+        {
+            throw std::runtime_error("Cannot create snapshot file: " + temp_path);
+        }
+
+        bool ok = std::fwrite(buffer_.data(), 1, buffer_.size(), file) == buffer_.size();
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(temp_path.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp_path.c_str());
+            throw std::runtime_error("Writing the snapshot file failed: " + path);
+        }
+    }
+
+    SnapshotReader::SnapshotReader(const std::string &path)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            throw std::runtime_error("Cannot open snapshot file: " + path);
+        }
+
+        bool ok = std::fseek(file, 0, SEEK_END) == 0;
+        long size = ok ? std::ftell(file) : -1;
+        ok = size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+        if (ok)
+        {
+            buffer_.resize(static_cast<size_t>(size));
+            ok = std::fread(buffer_.data(), 1, buffer_.size(), file) == buffer_.size();
+        }
+        std::fclose(file);
+
+        if (!ok)
+        {
+            throw std::runtime_error("Cannot read snapshot file: " + path);
+        }
+        check_header();
+    }
+
+    SnapshotReader::SnapshotReader(std::vector<std::byte> data) : buffer_(std::move(data))
+    {
+        check_header();
+    }
+
+    void SnapshotReader::check_header()
+    {
+        if (buffer_.size() < sizeof(SnapshotFileHeader))
+        {
+            throw std::runtime_error("Not a snapshot file");
+        }
+
+        auto header = read<SnapshotFileHeader>();
+        if (std::memcmp(header.magic, SnapshotFileHeader::MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != SnapshotFileHeader::VERSION)
+        {
+            throw std::runtime_error("Not a version " + std::to_string(SnapshotFileHeader::VERSION) + " snapshot file");
+        }
+    }
+}
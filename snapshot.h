@@ -0,0 +1,179 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace evtol
+{
+    /**
+     * Four-character section tag, e.g. snapshot_tag("CHRG")
+     */
+    constexpr std::uint32_t snapshot_tag(const char (&name)[5])
+    {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(name[0])) |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(name[1])) << 8 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(name[2])) << 16 |
+               static_cast<std::uint32_t>(static_cast<unsigned char>(name[3])) << 24;
+    }
+
+    /**
+     * Snapshot file layout: this header, then tagged sections written by each component
+     * Values are stored as-is (native byte order), like the event trace.
+     */
+    struct SnapshotFileHeader
+    {
+        static constexpr char MAGIC[8] = {'E', 'V', 'T', 'L', 'C', 'K', 'P', 'T'};
+        static constexpr std::uint32_t VERSION = 4;
+
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    /**
+     * Builds a snapshot in memory; save() writes it in one go
+     */
+    class SnapshotWriter
+    {
+    private:
+        std::vector<std::byte> buffer_;
+
+        void append(const void *data, size_t size)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+            size_t offset = buffer_.size();
+            buffer_.resize(offset + size);
+            std::memcpy(buffer_.data() + offset, data, size);
+        }
+
+    public:
+        SnapshotWriter();
+
+        void begin_section(std::uint32_t tag) { write(tag); }
+
+        template <typename T>
+        void write(const T &value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+            append(&value, sizeof(T));
+        }
+
+        /**
+         * Element count, then the elements back to back
+         */
+        template <typename T>
+        void write_vector(const std::vector<T> &values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+            write(static_cast<std::uint64_t>(values.size()));
+            append(values.data(), values.size() * sizeof(T));
+        }
+
+        void write_string(const std::string &value)
+        {
+            write(static_cast<std::uint64_t>(value.size()));
+            append(value.data(), value.size());
+        }
+
+        const std::vector<std::byte> &data() const { return buffer_; }
+
+        /**
+         * Write the snapshot to a temporary file and rename it over path, so a crash never leaves half a snapshot
+         * @throws std::runtime_error if the file cannot be written
+         */
+        void save(const std::string &path) const;
+    };
+
+    /**
+     * Reads a snapshot from memory; the file is loaded with a single read and vectors are copied out in bulk
+     * Every read is bounds-checked, and a missing section or a short file throws std::runtime_error.
+     */
+    class SnapshotReader
+    {
+    private:
+        std::vector<std::byte> buffer_;
+        size_t offset_ = 0;
+
+        const std::byte *take(size_t size)
+        {
+            if (size > buffer_.size() - offset_)
+            {
+                throw std::runtime_error("Snapshot is truncated");
+            }
+            const std::byte *data = buffer_.data() + offset_;
+            offset_ += size;
+            return data;
+        }
+
+        void check_header();
+
+    public:
+        /**
+         * @throws std::runtime_error if the file is missing or not a snapshot of this version
+         */
+        explicit SnapshotReader(const std::string &path);
+
+        /**
+         * Read a snapshot built in memory, e.g. SnapshotWriter::data()
+         */
+        explicit SnapshotReader(std::vector<std::byte> data);
+
+        /**
+         * @throws std::runtime_error if the next section is not tag
+         */
+        void expect_section(std::uint32_t tag)
+        {
+            if (read<std::uint32_t>() != tag)
+            {
+                throw std::runtime_error("Snapshot sections are out of order or corrupt");
+            }
+        }
+
+        template <typename T>
+        T read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        std::vector<T> read_vector()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+            auto count = read<std::uint64_t>();
+            if (count > (buffer_.size() - offset_) / sizeof(T))
+            {
+                throw std::runtime_error("Snapshot is truncated");
+            }
+
+            std::vector<T> values(static_cast<size_t>(count));
+            if (!values.empty())
+            {
+                std::memcpy(values.data(), take(values.size() * sizeof(T)), values.size() * sizeof(T));
+            }
+            return values;
+        }
+
+        std::string read_string()
+        {
+            auto size = read<std::uint64_t>();
+            if (size > buffer_.size() - offset_)
+            {
+                throw std::runtime_error("Snapshot is truncated");
+            }
+            const auto *data = reinterpret_cast<const char *>(take(static_cast<size_t>(size)));
+            return std::string(data, static_cast<size_t>(size));
+        }
+
+        bool at_end() const { return offset_ == buffer_.size(); }
+    };
+}
@@ -0,0 +1,554 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aircraft.h"
+#include "aircraft_types.h"
+#include "fault_model.h"
+#include "random_stream.h"
+
+namespace evtol
+{
+    class SoaFleet;
+
+    /**
+     * One SoaFleet column: owned storage, or a view of storage kept alive elsewhere (map())
+     * Element access goes through one pointer either way. Anything that changes the size first
+     * copies a view into owned storage, and copies of a column are always owned.
+     */
+    template <typename T>
+    class SoaColumn
+    {
+    private:
+        std::vector<T> owned_;
+        T *data_ = nullptr;
+        size_t size_ = 0;
+        bool mapped_ = false;
+
+        void sync()
+        {
+            data_ = owned_.data();
+            size_ = owned_.size();
+        }
+
+        void own()
+        {
+            if (mapped_)
+            {
+                owned_.assign(data_, data_ + size_);
+                mapped_ = false;
+                sync();
+            }
+        }
+
+    public:
+        SoaColumn() = default;
+
+        SoaColumn(const SoaColumn &other) : owned_(other.begin(), other.end()) { sync(); }
+
+        SoaColumn(SoaColumn &&other) noexcept
+            : owned_(std::move(other.owned_)), data_(other.data_), size_(other.size_), mapped_(other.mapped_)
+        {
+            other.clear();
+        }
+
+        SoaColumn &operator=(const SoaColumn &other)
+        {
+            if (this != &other)
+            {
+                owned_.assign(other.begin(), other.end());
+                mapped_ = false;
+                sync();
+            }
+            return *this;
+        }
+
+        SoaColumn &operator=(SoaColumn &&other) noexcept
+        {
+            if (this != &other)
+            {
+                owned_ = std::move(other.owned_);
+                data_ = other.data_;
+                size_ = other.size_;
+                mapped_ = other.mapped_;
+                other.clear();
+            }
+            return *this;
+        }
+
+        /**
+         * View size elements at data instead of owning them; the caller keeps them alive
+         */
+        void map(T *data, size_t size)
+        {
+            std::vector<T>().swap(owned_);
+            data_ = data;
+            size_ = size;
+            mapped_ = true;
+        }
+
+        bool is_mapped() const { return mapped_; }
+
+        void push_back(const T &value)
+        {
+            own();
+            owned_.push_back(value);
+            sync();
+        }
+
+        void reserve(size_t capacity)
+        {
+            own();
+            owned_.reserve(capacity);
+            sync();
+        }
+
+        void clear()
+        {
+            mapped_ = false;
+            owned_.clear();
+            sync();
+        }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+        T *data() { return data_; }
+        const T *data() const { return data_; }
+        T &operator[](size_t index) { return data_[index]; }
+        const T &operator[](size_t index) const { return data_[index]; }
+        T &back() { return data_[size_ - 1]; }
+
+        T *begin() { return data_; }
+        T *end() { return data_ + size_; }
+        const T *begin() const { return data_; }
+        const T *end() const { return data_ + size_; }
+    };
+
+    /**
+     * Lightweight handle to one aircraft in a SoaFleet
+     * Mirrors the AircraftBase interface with non-virtual calls; operator-> returns the handle
+     * itself so engine code written against fleet[i]->... works unchanged.
+     * Handles into a const fleet expose only the read-only half of the interface.
+     */
+    template <typename FleetT>
+    class BasicSoaAircraftRef
+    {
+    private:
+        static constexpr bool is_mutable = !std::is_const_v<FleetT>;
+
+        FleetT *fleet_;
+        size_t index_;
+
+    public:
+        BasicSoaAircraftRef(FleetT &fleet, size_t index) : fleet_(&fleet), index_(index) {}
+
+        const BasicSoaAircraftRef *operator->() const { return this; }
+
+        size_t get_index() const { return index_; }
+
+        const AircraftTypeParameters &get_parameters() const
+        {
+            return (*fleet_->type_table_)[static_cast<size_t>(fleet_->types_[index_])];
+        }
+
+        const AircraftSpec &get_spec() const { return *get_parameters().spec; }
+
+        // Same values as Aircraft<Derived>::get_flight_time_hours, so results are bit-identical
+        double get_flight_time_hours() const
+        {
+            const AircraftTypeParameters &params = get_parameters();
+            double battery_level = fleet_->battery_levels_[index_];
+            if (battery_level == 1.0)
+            {
+                return params.full_charge_flight_time_hours;
+            }
+            return params.spec->flight_time_hours(battery_level, params.energy_consumption_per_mile);
+        }
+
+        double get_flight_distance_miles() const
+        {
+            if (get_battery_level() == 1.0)
+            {
+                return get_parameters().full_charge_flight_distance_miles;
+            }
+            return get_flight_time_hours() * get_spec().cruise_speed_mph;
+        }
+
+        // Same sampling as Aircraft<Derived>::check_fault_during_flight
+        double check_fault_during_flight(double flight_time_hours) const
+            requires is_mutable
+        {
+            return sample_flight_fault(fleet_->streams_[index_], fleet_->fault_model_,
+                                       get_spec().fault_probability_per_hour, flight_time_hours);
+        }
+
+        void discharge_battery() const
+            requires is_mutable
+        {
+            fleet_->battery_levels_[index_] = 0.0;
+        }
+
+        void charge_battery() const
+            requires is_mutable
+        {
+            fleet_->battery_levels_[index_] = 1.0;
+        }
+
+        void set_faulty(bool faulty) const
+            requires is_mutable
+        {
+            fleet_->faulty_[index_] = faulty ? 1 : 0;
+        }
+
+        void seed_random_stream(std::uint64_t seed, std::uint64_t stream_id) const
+            requires is_mutable
+        {
+            fleet_->streams_[index_].reseed(seed, stream_id);
+        }
+
+        RandomStream *random_stream() const
+            requires is_mutable
+        {
+            return &fleet_->streams_[index_];
+        }
+
+        // The model is kept once for the whole fleet, which only ever runs with one
+        void set_fault_model(FaultModel model) const
+            requires is_mutable
+        {
+            fleet_->fault_model_ = model;
+        }
+
+        // Same state as Aircraft<Derived>::save_state / restore_state
+        AircraftSnapshot save_state() const
+        {
+            const RandomStream &rng = fleet_->streams_[index_];
+            return {get_battery_level(), is_faulty(), rng.get_seed(), rng.get_stream_id(), rng.get_draw_index()};
+        }
+
+        void restore_state(const AircraftSnapshot &state) const
+            requires is_mutable
+        {
+            fleet_->battery_levels_[index_] = state.battery_level;
+            fleet_->faulty_[index_] = state.faulty ? 1 : 0;
+            fleet_->streams_[index_].reseed(state.rng_seed, state.rng_stream_id);
+            fleet_->streams_[index_].set_draw_index(state.rng_draw_index);
+        }
+
+        double get_battery_level() const { return fleet_->battery_levels_[index_]; }
+        int get_id() const { return fleet_->ids_[index_]; }
+        AircraftType get_type() const { return fleet_->types_[index_]; }
+        std::string get_manufacturer() const { return std::string(get_spec().manufacturer); }
+        int get_passenger_count() const { return get_spec().passenger_count; }
+        double get_charge_time_hours() const { return get_spec().time_to_charge_hours; }
+        bool is_faulty() const { return fleet_->faulty_[index_] != 0; }
+    };
+
+    using SoaAircraftRef = BasicSoaAircraftRef<SoaFleet>;
+    using SoaAircraftConstRef = BasicSoaAircraftRef<const SoaFleet>;
+
+    /**
+     * Structure-of-arrays fleet store
+     * Aircraft state lives in dense columns and per-type constants come from aircraft_type_table(),
+     * so no call goes through a vtable or a heap pointer. Fleets built by create_fleet are grouped
+     * by AircraftType, which lets for_each_type_batch run type-specialized loops.
+     */
+    class SoaFleet
+    {
+    private:
+        template <typename>
+        friend class BasicSoaAircraftRef;
+
+        SoaColumn<int> ids_;
+        SoaColumn<AircraftType> types_;
+        SoaColumn<double> battery_levels_;
+        std::vector<std::uint8_t> faulty_;
+        std::vector<RandomStream> streams_;
+        FaultModel fault_model_ = FaultModel::LINEAR;
+        std::shared_ptr<void> mapped_storage_; // keeps the storage of mapped columns alive
+
+        // [begin, end) positions of each type; only meaningful when grouped_
+        std::array<size_t, NUM_AIRCRAFT_TYPES> type_begin_{};
+        std::array<size_t, NUM_AIRCRAFT_TYPES> type_end_{};
+        bool grouped_ = true;
+
+        const AircraftTypeTable *type_table_ = &aircraft_type_table();
+
+        void update_grouping(AircraftType type)
+        {
+            size_t t = static_cast<size_t>(type);
+            size_t position = types_.size() - 1;
+
+            if (type_end_[t] == type_begin_[t])
+            {
+                type_begin_[t] = position;
+                type_end_[t] = position + 1;
+            }
+            else if (type_end_[t] == position)
+            {
+                type_end_[t] = position + 1;
+            }
+            else
+            {
+                grouped_ = false;
+            }
+        }
+
+    public:
+        template <typename FleetT>
+        class basic_iterator
+        {
+        private:
+            FleetT *fleet_;
+            size_t index_;
+
+        public:
+            basic_iterator(FleetT *fleet, size_t index) : fleet_(fleet), index_(index) {}
+
+            BasicSoaAircraftRef<FleetT> operator*() const { return BasicSoaAircraftRef<FleetT>(*fleet_, index_); }
+            basic_iterator &operator++()
+            {
+                ++index_;
+                return *this;
+            }
+            bool operator==(const basic_iterator &other) const { return index_ == other.index_; }
+            bool operator!=(const basic_iterator &other) const { return index_ != other.index_; }
+        };
+
+        using iterator = basic_iterator<SoaFleet>;
+        using const_iterator = basic_iterator<const SoaFleet>;
+
+        SoaFleet() = default;
+
+        /**
+         * Build a fleet with the factory's type mix (round-robin id % 5 by default),
+         * laid out grouped by type
+         */
+        static SoaFleet create_fleet(int size, const FleetMix &mix = {})
+        {
+            SoaFleet fleet;
+            fleet.assign(size, mix);
+            return fleet;
+        }
+
+        /**
+         * Copy an existing pointer-based fleet, preserving its order and per-aircraft state
+         */
+        template <typename Fleet>
+        static SoaFleet from_fleet(const Fleet &source)
+        {
+            SoaFleet fleet;
+            fleet.reserve(source.size());
+
+            for (const auto &aircraft : source)
+            {
+                fleet.add_aircraft(aircraft->get_type(), aircraft->get_id(), aircraft->get_battery_level());
+                fleet.faulty_.back() = aircraft->is_faulty() ? 1 : 0;
+            }
+            return fleet;
+        }
+
+        /**
+         * Rebuild as create_fleet(size, mix) would, reusing the columns' storage
+         * @param group_by_type False keeps the pointer factory's id order instead, which it matches run for run
+         */
+        void assign(int size, const FleetMix &mix = {}, bool group_by_type = true)
+        {
+            clear();
+            reserve(static_cast<size_t>(std::max(size, 0)));
+
+            if (!group_by_type)
+            {
+                for (int id = 0; id < size; ++id)
+                {
+                    add_aircraft(mix.type_of(id), id);
+                }
+                return;
+            }
+
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                if (mix.weights[t] == 0)
+                {
+                    continue;
+                }
+                for (int id = 0; id < size; ++id)
+                {
+                    if (mix.type_of(id) == static_cast<AircraftType>(t))
+                    {
+                        add_aircraft(static_cast<AircraftType>(t), id);
+                    }
+                }
+            }
+        }
+
+        void reserve(size_t capacity)
+        {
+            ids_.reserve(capacity);
+            types_.reserve(capacity);
+            battery_levels_.reserve(capacity);
+            faulty_.reserve(capacity);
+            streams_.reserve(capacity);
+        }
+
+        void add_aircraft(AircraftType type, int id, double battery_level = 1.0)
+        {
+            ids_.push_back(id);
+            types_.push_back(type);
+            battery_levels_.push_back(battery_level);
+            faulty_.push_back(0);
+            streams_.emplace_back();
+            update_grouping(type);
+        }
+
+        /**
+         * Columns of a fleet held in storage the fleet does not own, such as a memory-mapped scenario
+         * Lengths must all match; type_begin/type_end are only read when grouped.
+         */
+        struct MappedColumns
+        {
+            std::shared_ptr<void> storage; // kept alive while any column maps it
+            std::span<int> ids;
+            std::span<AircraftType> types;
+            std::span<double> battery_levels; // written in place during runs
+            std::array<size_t, NUM_AIRCRAFT_TYPES> type_begin{};
+            std::array<size_t, NUM_AIRCRAFT_TYPES> type_end{};
+            bool grouped = false;
+        };
+
+        /**
+         * Replace the fleet with a view of columns, without copying them
+         * Only the fault flags and random streams are allocated, each in one block; every aircraft
+         * starts without a fault and with an unseeded stream, like add_aircraft. Adding aircraft or reassigning later
+         * copies the columns into owned storage.
+         * @throws std::invalid_argument if the column lengths differ
+         */
+        void map_columns(const MappedColumns &columns)
+        {
+            size_t count = columns.ids.size();
+            if (columns.types.size() != count || columns.battery_levels.size() != count)
+            {
+                throw std::invalid_argument("Mapped fleet columns differ in length");
+            }
+
+            clear();
+            ids_.map(columns.ids.data(), count);
+            types_.map(columns.types.data(), count);
+            battery_levels_.map(columns.battery_levels.data(), count);
+            faulty_.assign(count, 0);
+            streams_ = RandomStream::make_unseeded(count);
+            mapped_storage_ = columns.storage;
+            grouped_ = columns.grouped;
+            if (grouped_)
+            {
+                type_begin_ = columns.type_begin;
+                type_end_ = columns.type_end;
+            }
+        }
+
+        /**
+         * True while the id, type and battery columns view storage the fleet does not own
+         */
+        bool is_mapped() const { return ids_.is_mapped(); }
+
+        void clear()
+        {
+            ids_.clear();
+            types_.clear();
+            battery_levels_.clear();
+            faulty_.clear();
+            streams_.clear();
+            type_begin_.fill(0);
+            type_end_.fill(0);
+            grouped_ = true;
+            fault_model_ = FaultModel::LINEAR;
+            mapped_storage_.reset();
+        }
+
+        size_t size() const { return ids_.size(); }
+        bool empty() const { return ids_.empty(); }
+
+        SoaAircraftRef operator[](size_t index) { return SoaAircraftRef(*this, index); }
+        SoaAircraftConstRef operator[](size_t index) const { return SoaAircraftConstRef(*this, index); }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+        /**
+         * True if every type occupies one contiguous range of positions
+         */
+        bool is_grouped() const { return grouped_; }
+
+        size_t type_begin(AircraftType type) const { return type_begin_[static_cast<size_t>(type)]; }
+        size_t type_end(AircraftType type) const { return type_end_[static_cast<size_t>(type)]; }
+
+        /**
+         * Run func(std::type_identity<T>{}, begin, end) once per aircraft class over its position range
+         * Inside func the class T is known at compile time, so its spec calls resolve statically.
+         * Requires is_grouped().
+         */
+        template <typename Func>
+        void for_each_type_batch(Func &&func) const
+        {
+            for_each_aircraft_class([&](auto type_tag)
+                                    {
+                using T = typename decltype(type_tag)::type;
+                size_t t = static_cast<size_t>(T::get_aircraft_type());
+                if (type_end_[t] > type_begin_[t])
+                {
+                    func(type_tag, type_begin_[t], type_end_[t]);
+                } });
+        }
+
+        /**
+         * Number of aircraft of each type
+         */
+        std::array<int, NUM_AIRCRAFT_TYPES> count_by_type() const
+        {
+            std::array<int, NUM_AIRCRAFT_TYPES> counts{};
+            if (grouped_)
+            {
+                for_each_type_batch([&](auto type_tag, size_t begin, size_t end)
+                                    {
+                    using T = typename decltype(type_tag)::type;
+                    counts[static_cast<size_t>(T::get_aircraft_type())] = static_cast<int>(end - begin); });
+                return counts;
+            }
+
+            for (AircraftType type : types_)
+            {
+                counts[static_cast<size_t>(type)]++;
+            }
+            return counts;
+        }
+
+        /**
+         * Restore every aircraft to a full battery with no fault, keeping the layout
+         */
+        void reset_state()
+        {
+            std::fill(battery_levels_.begin(), battery_levels_.end(), 1.0);
+            std::fill(faulty_.begin(), faulty_.end(), std::uint8_t{0});
+        }
+
+        // Column access for type-batched kernels
+        std::span<const int> ids() const { return {ids_.data(), ids_.size()}; }
+        std::span<const AircraftType> types() const { return {types_.data(), types_.size()}; }
+        std::span<double> battery_levels() { return {battery_levels_.data(), battery_levels_.size()}; }
+        std::span<const double> battery_levels() const { return {battery_levels_.data(), battery_levels_.size()}; }
+        std::vector<std::uint8_t> &faulty_flags() { return faulty_; }
+        const std::vector<std::uint8_t> &faulty_flags() const { return faulty_; }
+    };
+}
@@ -1,9 +1,12 @@
 #pragma once
 #include "aircraft.h"
-#include <unordered_map>
+#include "dispatch_policy.h"
+#include "stats_shard.h"
+#include <array>
 #include <iomanip>
 #include <sstream>
 #include <type_traits>
+#include <typeinfo>
 #include <vector>
 
 namespace evtol
@@ -31,34 +34,106 @@ namespace evtol
         int partial_charges = 0;
     };
 
+    /**
+     * Per-type flight, charging and fault statistics
+     * Totals live in a StatsShard indexed by AircraftType, and reports list types in enum order.
+     */
     class StatisticsCollector
     {
     private:
-        std::unordered_map<AircraftType, FlightStats> stats_;
-        std::unordered_map<AircraftType, int> aircraft_counts_;
+        StatsShard stats_;
+        std::array<int, NUM_AIRCRAFT_TYPES> aircraft_counts_{};
+        DispatchPolicy dispatch_policy_ = DispatchPolicy::FIFO; // only reported
 
         static constexpr const char *aircraft_type_names[] = {
             "Alpha", "Beta", "Charlie", "Delta", "Echo"};
 
-    public:
-        StatisticsCollector()
+        static AircraftType type_at(size_t index) { return static_cast<AircraftType>(index); }
+
+        static void write_percentiles(std::ostringstream &oss, const char *indent, const TypeDistributions &distributions)
         {
-            stats_.emplace(AircraftType::ALPHA, FlightStats{});
-            stats_.emplace(AircraftType::BETA, FlightStats{});
-            stats_.emplace(AircraftType::CHARLIE, FlightStats{});
-            stats_.emplace(AircraftType::DELTA, FlightStats{});
-            stats_.emplace(AircraftType::ECHO, FlightStats{});
-            
-            // Initialize aircraft counts to 0
-            aircraft_counts_[AircraftType::ALPHA] = 0;
-            aircraft_counts_[AircraftType::BETA] = 0;
-            aircraft_counts_[AircraftType::CHARLIE] = 0;
-            aircraft_counts_[AircraftType::DELTA] = 0;
-            aircraft_counts_[AircraftType::ECHO] = 0;
+            auto write_line = [&](const char *label, const StreamingHistogram &histogram, const char *units)
+            {
+                oss << indent << label << " p50/p95/p99: " << histogram.value_at_percentile(50.0) << " / "
+                    << histogram.value_at_percentile(95.0) << " / " << histogram.value_at_percentile(99.0) << units << "\n";
+            };
+
+            write_line("Flight Time", distributions.flight_time_hours, " hours");
+            write_line("Charge Wait", distributions.charge_wait_hours, " hours");
+            write_line("Queue Length on Arrival", distributions.queue_length, " aircraft");
         }
 
+    public:
+        StatisticsCollector() = default;
+
         virtual ~StatisticsCollector() = default;
 
+        /**
+         * The collector's own shard when no subclass overrides the record_* methods, else nullptr
+         * Engines record straight into it, skipping the virtual calls; mocks still see every call.
+         */
+        StatsShard *direct_shard()
+        {
+            return typeid(*this) == typeid(StatisticsCollector) ? &stats_ : nullptr;
+        }
+
+        /**
+         * Add the totals of a shard filled elsewhere (e.g. by a worker thread)
+         */
+        void merge(const StatsShard &shard)
+        {
+            stats_.merge(shard);
+        }
+
+        const StatsShard &shard() const { return stats_; }
+
+        /**
+         * Also keep flight time, charge wait and queue length histograms for p50/p95/p99
+         */
+        void enable_distributions() { stats_.enable_distributions(); }
+
+        bool has_distributions() const { return stats_.has_distributions(); }
+
+        /**
+         * @pre has_distributions()
+         */
+        const TypeDistributions &get_distributions(AircraftType type) const
+        {
+            return stats_.distributions(type);
+        }
+
+        /**
+         * All types merged into one set of distributions
+         * @pre has_distributions()
+         */
+        TypeDistributions get_fleet_distributions() const
+        {
+            TypeDistributions fleet;
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                fleet.merge(stats_.distributions(type_at(t)));
+            }
+            return fleet;
+        }
+
+        /**
+         * Totals, histograms and aircraft counts, for checkpoints
+         * Only the collector's own shard is saved; a subclass keeping its own records saves those itself.
+         */
+        void save_state(SnapshotWriter &out) const
+        {
+            out.begin_section(snapshot_tag("STAT"));
+            stats_.save_state(out);
+            out.write(aircraft_counts_);
+        }
+
+        void restore_state(SnapshotReader &in)
+        {
+            in.expect_section(snapshot_tag("STAT"));
+            stats_.restore_state(in);
+            aircraft_counts_ = in.read<std::array<int, NUM_AIRCRAFT_TYPES>>();
+        }
+
         /**
          * Set the count of aircraft for each type
          * @param fleet The fleet to count aircraft types from
@@ -67,28 +142,32 @@ namespace evtol
         void set_aircraft_counts(const Fleet& fleet)
         {
             // Reset counts
-            for (auto& [type, count] : aircraft_counts_)
-            {
-                count = 0;
-            }
-            
+            aircraft_counts_.fill(0);
+
             // Count aircraft by type
             for (const auto& aircraft : fleet)
             {
-                aircraft_counts_[aircraft->get_type()]++;
+                aircraft_counts_[static_cast<size_t>(aircraft->get_type())]++;
             }
         }
 
+        /**
+         * Charger dispatch policy of the recorded runs, named in the report unless it is FIFO
+         */
+        void set_dispatch_policy(DispatchPolicy policy) { dispatch_policy_ = policy; }
+
+        DispatchPolicy get_dispatch_policy() const { return dispatch_policy_; }
+
         // allow mock classes to override (since not allowed with template methods)
         virtual void record_flight(AircraftType type, double flight_time, double distance, int passengers)
         {
-            stats_[type].add_flight(flight_time, distance, passengers);
+            stats_.record_flight(type, flight_time, distance, passengers);
         }
 
         template <typename... MetricArgs>
         void record_flight(AircraftType type, double flight_time, double distance, int passengers, MetricArgs &&...args)
         {
-            stats_[type].add_flight(flight_time, distance, passengers);
+            stats_.record_flight(type, flight_time, distance, passengers);
 
             if constexpr (sizeof...(args) > 0)
             {
@@ -98,23 +177,28 @@ namespace evtol
         // allow mock classes to override (since not allowed with template methods)
         virtual void record_charge_session(AircraftType type, double charge_time)
         {
-            stats_[type].add_charge_session(charge_time);
+            stats_.get(type).add_charge_session(charge_time);
         }
 
         virtual void record_charge_session(AircraftType type, double charge_time, double waiting_time)
         {
-            stats_[type].add_charge_session(charge_time, waiting_time);
+            stats_.record_charge_session(type, charge_time, waiting_time);
+        }
+
+        virtual void record_queue_length(AircraftType type, int queue_length)
+        {
+            stats_.record_queue_length(type, queue_length);
         }
 
         virtual void record_waiting_time(AircraftType type, double waiting_time)
         {
-            stats_[type].add_waiting_time(waiting_time);
+            stats_.get(type).add_waiting_time(waiting_time);
         }
 
         template <typename... MetricArgs>
         void record_charge_session(AircraftType type, double charge_time, MetricArgs &&...args)
         {
-            stats_[type].add_charge_session(charge_time);
+            stats_.get(type).add_charge_session(charge_time);
 
             if constexpr (sizeof...(args) > 0)
             {
@@ -124,17 +208,17 @@ namespace evtol
 
         virtual void record_fault(AircraftType type)
         {
-            stats_[type].add_fault();
+            stats_.get(type).add_fault();
         }
 
         virtual void record_partial_flight(AircraftType type, double flight_time, double distance, int passengers)
         {
-            stats_[type].add_partial_flight(flight_time, distance, passengers);
+            stats_.get(type).add_partial_flight(flight_time, distance, passengers);
         }
 
         virtual void record_partial_charge(AircraftType type, double charge_time)
         {
-            stats_[type].add_partial_charge(charge_time);
+            stats_.get(type).add_partial_charge(charge_time);
         }
 
         // Experimenting with fancy templates, but not utilized
@@ -143,7 +227,7 @@ namespace evtol
         {
             if constexpr (std::is_arithmetic_v<std::decay_t<Metric>>)
             {
-                stats_[type].total_passenger_miles += static_cast<double>(metric);
+                stats_.get(type).total_passenger_miles += static_cast<double>(metric);
             }
 
             if constexpr (sizeof...(rest) > 0)
@@ -154,7 +238,7 @@ namespace evtol
 
         const FlightStats &get_stats(AircraftType type) const
         {
-            return stats_.at(type);
+            return stats_.get(type);
         }
 
         template <typename Predicate>
@@ -162,11 +246,12 @@ namespace evtol
         {
             std::vector<std::pair<AircraftType, FlightStats>> filtered;
 
-            for (const auto &[type, stats] : stats_)
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
             {
-                if (pred(type, stats))
+                const FlightStats &stats = stats_.by_type()[t];
+                if (pred(type_at(t), stats))
                 {
-                    filtered.emplace_back(type, stats);
+                    filtered.emplace_back(type_at(t), stats);
                 }
             }
 
@@ -176,7 +261,7 @@ namespace evtol
         template <typename Aggregator>
         auto aggregate_stats(Aggregator agg) const
         {
-            return agg(stats_);
+            return agg(stats_.by_type());
         }
 
         std::string generate_report(bool show_partial_activities = true) const
@@ -186,10 +271,10 @@ namespace evtol
             oss << std::fixed << std::setprecision(2);
             oss << "\n========== eVTOL Simulation Results ==========\n\n";
 
-            for (const auto &[type, stats] : stats_)
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
             {
-                int count = aircraft_counts_.at(type);
-                oss << aircraft_type_names[static_cast<int>(type)] << " Aircraft(" << count << "):\n";
+                const FlightStats &stats = stats_.by_type()[t];
+                oss << aircraft_type_names[t] << " Aircraft(" << aircraft_counts_[t] << "):\n";
                 oss << "  Average Flight Time: " << stats.avg_flight_time() << " hours\n";
                 oss << "  Average Distance: " << stats.avg_distance() << " miles\n";
                 oss << "  Average Charging Time: " << stats.avg_charging_time() << " hours\n";
@@ -199,6 +284,10 @@ namespace evtol
                 oss << "  Total Passenger Miles: " << stats.total_passenger_miles << "\n";
                 oss << "  Total Flights: " << stats.flight_count << "\n";
                 oss << "  Total Charge Sessions: " << stats.charge_count << "\n";
+                if (has_distributions())
+                {
+                    write_percentiles(oss, "  ", stats_.distributions(type_at(t)));
+                }
                 
                 // Add partial activities reporting (only if enabled)
                 if (show_partial_activities && (stats.partial_flight_count > 0 || stats.partial_charge_count > 0)) {
@@ -221,6 +310,10 @@ namespace evtol
             // Add summary statistics
             SummaryStats summary = get_summary_stats();
             oss << "========== Summary Statistics ==========\n";
+            if (dispatch_policy_ != DispatchPolicy::FIFO)
+            {
+                oss << "Dispatch Policy: " << dispatch_policy_to_string(dispatch_policy_) << "\n";
+            }
             oss << "Total Flight Time: " << summary.total_flight_time << " hours\n";
             oss << "Total Distance: " << summary.total_distance << " miles\n";
             oss << "Total Charging Time: " << summary.total_charging_time << " hours\n";
@@ -229,6 +322,10 @@ namespace evtol
             oss << "Total Passenger Miles: " << summary.total_passenger_miles << "\n";
             oss << "Total Flights: " << summary.total_flights << "\n";
             oss << "Total Charge Sessions: " << summary.total_charges << "\n";
+            if (has_distributions())
+            {
+                write_percentiles(oss, "", get_fleet_distributions());
+            }
             
             // Add partial activities summary if enabled
             if (show_partial_activities && (summary.partial_flights > 0 || summary.partial_charges > 0)) {
@@ -253,7 +350,7 @@ namespace evtol
         {
             SummaryStats summary;
 
-            for (const auto &[type, stats] : stats_)
+            for (const FlightStats &stats : stats_.by_type())
             {
                 summary.total_flight_time += stats.total_flight_time_hours;
                 summary.total_distance += stats.total_distance_miles;
@@ -279,24 +376,86 @@ namespace evtol
         template <typename ComparisonFunc>
         AircraftType get_best_performing(ComparisonFunc comp) const
         {
-            auto best_it = stats_.begin();
-            for (auto it = stats_.begin(); it != stats_.end(); ++it)
+            const auto &by_type = stats_.by_type();
+            size_t best = 0;
+            for (size_t t = 1; t < NUM_AIRCRAFT_TYPES; ++t)
             {
-                if (comp(it->second, best_it->second))
+                if (comp(by_type[t], by_type[best]))
                 {
-                    best_it = it;
+                    best = t;
                 }
             }
 
-            return best_it->first;
+            return type_at(best);
         }
 
         void reset_stats()
         {
-            for (auto &[type, stats] : stats_)
-            {
-                stats = FlightStats{};
-            }
+            stats_.reset();
+        }
+    };
+
+    /**
+     * Engine-side recording handle
+     * Writes straight into the collector's shard unless a subclass overrides the record_* methods,
+     * in which case every call goes through the virtual interface as before.
+     */
+    class StatsRecorder
+    {
+    private:
+        StatisticsCollector &collector_;
+        StatsShard *direct_;
+
+    public:
+        explicit StatsRecorder(StatisticsCollector &collector)
+            : collector_(collector), direct_(collector.direct_shard()) {}
+
+        void record_flight(AircraftType type, double flight_time, double distance, int passengers)
+        {
+            if (direct_)
+                direct_->record_flight(type, flight_time, distance, passengers);
+            else
+                collector_.record_flight(type, flight_time, distance, passengers);
+        }
+
+        void record_charge_session(AircraftType type, double charge_time, double waiting_time)
+        {
+            if (direct_)
+                direct_->record_charge_session(type, charge_time, waiting_time);
+            else
+                collector_.record_charge_session(type, charge_time, waiting_time);
+        }
+
+        void record_queue_length(AircraftType type, int queue_length)
+        {
+            if (direct_)
+                direct_->record_queue_length(type, queue_length);
+            else
+                collector_.record_queue_length(type, queue_length);
+        }
+
+        void record_fault(AircraftType type)
+        {
+            if (direct_)
+                direct_->record_fault(type);
+            else
+                collector_.record_fault(type);
+        }
+
+        void record_partial_flight(AircraftType type, double flight_time, double distance, int passengers)
+        {
+            if (direct_)
+                direct_->record_partial_flight(type, flight_time, distance, passengers);
+            else
+                collector_.record_partial_flight(type, flight_time, distance, passengers);
+        }
+
+        void record_partial_charge(AircraftType type, double charge_time)
+        {
+            if (direct_)
+                direct_->record_partial_charge(type, charge_time);
+            else
+                collector_.record_partial_charge(type, charge_time);
         }
     };
 
@@ -0,0 +1,250 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "aircraft.h"
+#include "streaming_histogram.h"
+
+namespace evtol
+{
+    /**
+     * Per-type statistics in a flat array indexed by AircraftType
+     * Every call is non-virtual and inline, so recording costs one indexed add with no hashing.
+     * StatisticsCollector keeps its totals in one of these. Percentile histograms are optional: they
+     * cost nothing until enable_distributions() is called, and a fixed amount of memory after that.
+     */
+    class StatsShard
+    {
+    public:
+        using TypeStats = std::array<FlightStats, NUM_AIRCRAFT_TYPES>;
+
+    private:
+        TypeStats stats_{};
+        std::vector<TypeDistributions> distributions_; // empty, or one per type
+
+        // Calls func on every FlightStats member, in declaration order
+        template <typename Stats, typename Func>
+        static void for_each_field(Stats &stats, Func &&func)
+        {
+            func(stats.total_flight_time_hours);
+            func(stats.total_distance_miles);
+            func(stats.total_charging_time_hours);
+            func(stats.total_waiting_time_hours);
+            func(stats.total_faults);
+            func(stats.total_passenger_miles);
+            func(stats.flight_count);
+            func(stats.charge_count);
+            func(stats.partial_flight_time_hours);
+            func(stats.partial_distance_miles);
+            func(stats.partial_charging_time_hours);
+            func(stats.partial_passenger_miles);
+            func(stats.partial_flight_count);
+            func(stats.partial_charge_count);
+        }
+
+    public:
+        FlightStats &get(AircraftType type) { return stats_[static_cast<size_t>(type)]; }
+        const FlightStats &get(AircraftType type) const { return stats_[static_cast<size_t>(type)]; }
+
+        const TypeStats &by_type() const { return stats_; }
+
+        void enable_distributions()
+        {
+            if (distributions_.empty())
+            {
+                distributions_.resize(NUM_AIRCRAFT_TYPES);
+            }
+        }
+
+        bool has_distributions() const { return !distributions_.empty(); }
+
+        /**
+         * @pre has_distributions()
+         */
+        const TypeDistributions &distributions(AircraftType type) const
+        {
+            return distributions_[static_cast<size_t>(type)];
+        }
+
+        void record_flight(AircraftType type, double flight_time, double distance, int passengers)
+        {
+            get(type).add_flight(flight_time, distance, passengers);
+            if (!distributions_.empty())
+            {
+                distributions_[static_cast<size_t>(type)].flight_time_hours.record(flight_time);
+            }
+        }
+
+        void record_charge_session(AircraftType type, double charge_time)
+        {
+            get(type).add_charge_session(charge_time);
+        }
+
+        void record_charge_session(AircraftType type, double charge_time, double waiting_time)
+        {
+            get(type).add_charge_session(charge_time, waiting_time);
+            if (!distributions_.empty())
+            {
+                distributions_[static_cast<size_t>(type)].charge_wait_hours.record(waiting_time);
+            }
+        }
+
+        /**
+         * Number of aircraft already waiting when an aircraft of this type asked for a charger
+         * Only feeds the distributions; there is no running total.
+         */
+        void record_queue_length(AircraftType type, int queue_length)
+        {
+            if (!distributions_.empty())
+            {
+                distributions_[static_cast<size_t>(type)].queue_length.record(queue_length);
+            }
+        }
+
+        void record_waiting_time(AircraftType type, double waiting_time)
+        {
+            get(type).add_waiting_time(waiting_time);
+        }
+
+        void record_fault(AircraftType type)
+        {
+            get(type).add_fault();
+        }
+
+        void record_partial_flight(AircraftType type, double flight_time, double distance, int passengers)
+        {
+            get(type).add_partial_flight(flight_time, distance, passengers);
+        }
+
+        void record_partial_charge(AircraftType type, double charge_time)
+        {
+            get(type).add_partial_charge(charge_time);
+        }
+
+        void merge(const StatsShard &other)
+        {
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                stats_[t].merge(other.stats_[t]);
+            }
+
+            if (other.has_distributions())
+            {
+                enable_distributions();
+                for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+                {
+                    distributions_[t].merge(other.distributions_[t]);
+                }
+            }
+        }
+
+        void save_state(SnapshotWriter &out) const
+        {
+            for (const FlightStats &stats : stats_)
+            {
+                for_each_field(stats, [&](const auto &field)
+                               { out.write(field); });
+            }
+
+            out.write(static_cast<std::uint8_t>(has_distributions()));
+            for (const auto &distributions : distributions_)
+            {
+                distributions.save_state(out);
+            }
+        }
+
+        /**
+         * Replace the totals with saved ones
+         * Saved histograms replace these; if none were saved, enabled histograms start out empty.
+         */
+        void restore_state(SnapshotReader &in)
+        {
+            for (FlightStats &stats : stats_)
+            {
+                for_each_field(stats, [&](auto &field)
+                               { field = in.read<std::decay_t<decltype(field)>>(); });
+            }
+
+            bool saved_distributions = in.read<std::uint8_t>() != 0;
+            if (saved_distributions)
+            {
+                enable_distributions();
+                for (auto &distributions : distributions_)
+                {
+                    distributions.restore_state(in);
+                }
+            }
+            else
+            {
+                for (auto &distributions : distributions_)
+                {
+                    distributions.reset();
+                }
+            }
+        }
+
+        void reset()
+        {
+            stats_.fill(FlightStats{});
+            for (auto &distributions : distributions_)
+            {
+                distributions.reset();
+            }
+        }
+    };
+
+    /**
+     * One StatsShard per worker, each on its own cache lines so parallel producers never share one
+     * Workers record into local(worker) without synchronization; merged() combines the shards in
+     * worker order, so the result does not depend on scheduling.
+     */
+    class ShardedStats
+    {
+    private:
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        struct alignas(CACHE_LINE_SIZE) PaddedShard
+        {
+            StatsShard shard;
+        };
+
+        std::vector<PaddedShard> shards_;
+
+    public:
+        explicit ShardedStats(size_t worker_count) : shards_(worker_count) {}
+
+        size_t size() const { return shards_.size(); }
+
+        void enable_distributions()
+        {
+            for (auto &padded : shards_)
+            {
+                padded.shard.enable_distributions();
+            }
+        }
+
+        StatsShard &local(size_t worker) { return shards_[worker].shard; }
+        const StatsShard &local(size_t worker) const { return shards_[worker].shard; }
+
+        StatsShard merged() const
+        {
+            StatsShard total;
+            for (const auto &padded : shards_)
+            {
+                total.merge(padded.shard);
+            }
+            return total;
+        }
+
+        void reset()
+        {
+            for (auto &padded : shards_)
+            {
+                padded.shard.reset();
+            }
+        }
+    };
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "snapshot.h"
+
+namespace evtol
+{
+    /**
+     * Fixed-memory log-linear histogram (HDR style) for streaming percentiles
+     * Values are counted in multiples of a unit: the first 64 units get one bucket each, and every
+     * octave above that is split into 32 buckets, so a reported percentile is within one unit below
+     * 64 units and within 1/32 (about 3%) above. Memory is fixed at BUCKET_COUNT counters however many
+     * values are recorded; values beyond 2^40 units share the last bucket. Bucket counts are integers,
+     * so merging shards gives the same histogram in any order.
+     */
+    class StreamingHistogram
+    {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 5;
+        static constexpr size_t SUB_BUCKET_HALF = size_t{1} << SUB_BUCKET_BITS;       // buckets per octave
+        static constexpr size_t LINEAR_BUCKETS = 2 * SUB_BUCKET_HALF;                  // one per unit below this
+        static constexpr int MAX_EXPONENT = 40;                                        // values up to 2^40 units
+        static constexpr size_t BUCKET_COUNT =
+            LINEAR_BUCKETS + static_cast<size_t>(MAX_EXPONENT - SUB_BUCKET_BITS - 1) * SUB_BUCKET_HALF;
+
+    private:
+        double unit_;
+        std::vector<std::uint64_t> counts_;
+        std::uint64_t total_count_ = 0;
+        double min_ = std::numeric_limits<double>::infinity();
+        double max_ = 0.0;
+
+        size_t bucket_index(double value) const
+        {
+            double units = value / unit_;
+            if (units < static_cast<double>(LINEAR_BUCKETS))
+            {
+                return static_cast<size_t>(units);
+            }
+
+            int exponent = std::ilogb(units); // units in [2^exponent, 2^(exponent + 1))
+            if (exponent >= MAX_EXPONENT)
+            {
+                return BUCKET_COUNT - 1;
+            }
+
+            int shift = exponent - SUB_BUCKET_BITS;
+            auto sub_bucket = static_cast<size_t>(std::ldexp(units, -shift)); // in [HALF, 2 * HALF)
+            return LINEAR_BUCKETS + static_cast<size_t>(shift - 1) * SUB_BUCKET_HALF + (sub_bucket - SUB_BUCKET_HALF);
+        }
+
+        double bucket_lower_bound(size_t index) const
+        {
+            if (index < LINEAR_BUCKETS)
+            {
+                return static_cast<double>(index) * unit_;
+            }
+
+            size_t offset = index - LINEAR_BUCKETS;
+            int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+            double sub_bucket = static_cast<double>(SUB_BUCKET_HALF + offset % SUB_BUCKET_HALF);
+            return std::ldexp(sub_bucket, shift) * unit_;
+        }
+
+    public:
+        /**
+         * @param unit Resolution of the histogram, e.g. one second for times recorded in hours
+         * @throws std::invalid_argument if unit is not positive
+         */
+        explicit StreamingHistogram(double unit = 1.0) : unit_(unit), counts_(BUCKET_COUNT, 0)
+        {
+            if (!(unit > 0.0))
+            {
+                throw std::invalid_argument("StreamingHistogram unit must be positive");
+            }
+        }
+
+        /**
+         * Count a value; negative and NaN values are counted as zero
+         */
+        void record(double value, std::uint64_t count = 1)
+        {
+            if (!(value > 0.0))
+            {
+                value = 0.0;
+            }
+
+            counts_[bucket_index(value)] += count;
+            total_count_ += count;
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+
+        /**
+         * @throws std::invalid_argument if the histograms have different units
+         */
+        void merge(const StreamingHistogram &other)
+        {
+            if (other.unit_ != unit_)
+            {
+                throw std::invalid_argument("Cannot merge histograms with different units");
+            }
+
+            for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            {
+                counts_[i] += other.counts_[i];
+            }
+            total_count_ += other.total_count_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        void reset()
+        {
+            std::fill(counts_.begin(), counts_.end(), std::uint64_t{0});
+            total_count_ = 0;
+            min_ = std::numeric_limits<double>::infinity();
+            max_ = 0.0;
+        }
+
+        /**
+         * Smallest recorded value v with at least percentile% of the values at or below v,
+         * resolved to its bucket's lower bound and clamped to the exact min/max (the top rank is the max)
+         * @param percentile In [0, 100]
+         * @return 0 when nothing was recorded
+         */
+        double value_at_percentile(double percentile) const
+        {
+            if (total_count_ == 0)
+            {
+                return 0.0;
+            }
+
+            double clamped = std::clamp(percentile, 0.0, 100.0);
+            auto rank = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total_count_)));
+            rank = std::clamp<std::uint64_t>(rank, 1, total_count_);
+            if (rank == total_count_)
+            {
+                return max_;
+            }
+
+            std::uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKET_COUNT; ++i)
+            {
+                seen += counts_[i];
+                if (seen >= rank)
+                {
+                    return std::clamp(bucket_lower_bound(i), min_, max_);
+                }
+            }
+            return max_;
+        }
+
+        void save_state(SnapshotWriter &out) const
+        {
+            out.write(unit_);
+            out.write_vector(counts_);
+            out.write(total_count_);
+            out.write(min_);
+            out.write(max_);
+        }
+
+        /**
+         * @throws std::runtime_error if the saved histogram has a different bucket layout
+         */
+        void restore_state(SnapshotReader &in)
+        {
+            double unit = in.read<double>();
+            std::vector<std::uint64_t> counts = in.read_vector<std::uint64_t>();
+            if (!(unit > 0.0) || counts.size() != BUCKET_COUNT)
+            {
+                throw std::runtime_error("Checkpoint histogram has a different bucket layout");
+            }
+
+            unit_ = unit;
+            counts_ = std::move(counts);
+            total_count_ = in.read<std::uint64_t>();
+            min_ = in.read<double>();
+            max_ = in.read<double>();
+        }
+
+        std::uint64_t count() const { return total_count_; }
+        double unit() const { return unit_; }
+        double min() const { return total_count_ > 0 ? min_ : 0.0; }
+        double max() const { return max_; }
+    };
+
+    /**
+     * The distributions tracked for one aircraft type
+     */
+    struct TypeDistributions
+    {
+        static constexpr double ONE_SECOND_IN_HOURS = 1.0 / 3600.0;
+
+        StreamingHistogram flight_time_hours{ONE_SECOND_IN_HOURS};   // completed flights
+        StreamingHistogram charge_wait_hours{ONE_SECOND_IN_HOURS};   // wait before each charge session
+        StreamingHistogram queue_length{1.0};                        // aircraft already waiting on arrival
+
+        void merge(const TypeDistributions &other)
+        {
+            flight_time_hours.merge(other.flight_time_hours);
+            charge_wait_hours.merge(other.charge_wait_hours);
+            queue_length.merge(other.queue_length);
+        }
+
+        void reset()
+        {
+            flight_time_hours.reset();
+            charge_wait_hours.reset();
+            queue_length.reset();
+        }
+
+        void save_state(SnapshotWriter &out) const
+        {
+            flight_time_hours.save_state(out);
+            charge_wait_hours.save_state(out);
+            queue_length.save_state(out);
+        }
+
+        void restore_state(SnapshotReader &in)
+        {
+            flight_time_hours.restore_state(in);
+            charge_wait_hours.restore_state(in);
+            queue_length.restore_state(in);
+        }
+    };
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "batch_statistics.h"
+#include "simulation_config.h"
+#include "simulation_factory.h"
+#include "soa_fleet.h"
+#include "thread_pool.h"
+
+namespace evtol
+{
+    /**
+     * One scenario of a sweep
+     */
+    struct SweepPoint
+    {
+        size_t index = 0;        // position among the distinct scenarios, in grid order
+        SimulationConfig config; // complete configuration the scenario runs with
+    };
+
+    /**
+     * Final per-type statistics of one scenario
+     */
+    struct SweepResult
+    {
+        SweepPoint point;
+        ReplicationResult stats{};
+    };
+
+    /**
+     * Runs every scenario of a parameter grid once across a thread pool
+     * The grid is the product of config.sweep (charger counts x fleet sizes x mixes x seeds) applied
+     * to a base configuration; scenarios that would run identically are only run once. Points are
+     * claimed dynamically, largest fleet first, and each worker rebuilds one SoaFleet in place, so a
+     * sweep allocates fleet storage once per worker instead of once per aircraft and scenario.
+     * With checkpoint.restore_path set every scenario resumes that checkpoint, branching off it with
+     * its seed when seeds are swept; the fleet and chargers must then match the checkpoint.
+     */
+    class SweepRunner
+    {
+    private:
+        // Everything that differs between scenarios; equal keys run identically
+        using ScenarioKey = std::tuple<int, int, std::array<int, NUM_AIRCRAFT_TYPES>, std::uint64_t>;
+
+        SimulationConfig base_;
+        std::vector<SweepPoint> points_;
+        size_t duplicate_count_ = 0;
+
+        SimulationConfig make_config(int charger_count, int fleet_size, const FleetMix &mix, std::uint64_t seed) const
+        {
+            SimulationConfig config = base_;
+            config.sweep = SweepGrid{};
+            config.sweep_csv_path.clear();
+            config.trace_path.clear();
+            config.replications = 1;
+            config.num_threads = 1; // scenarios already occupy the pool
+            config.checkpoint.every_hours = 0.0;
+            config.progress_seconds = 0.0;
+
+            if (charger_count > 0)
+            {
+                config.num_chargers = charger_count;
+                config.charger_pools.clear();
+            }
+            config.fleet_size = fleet_size;
+            config.fleet_mix = mix;
+            config.random_seed = seed;
+            if (!config.checkpoint.restore_path.empty() && !base_.sweep.seeds.empty())
+            {
+                config.checkpoint.branch_seed = seed;
+            }
+            return config;
+        }
+
+        static ReplicationResult run_point(const SimulationConfig &config, SoaFleet &fleet)
+        {
+            // Id order, as in the app's pointer fleet: simultaneous events then resolve the same way,
+            // so a scenario reproduces the single run with its settings and can resume its checkpoints
+            fleet.assign(config.fleet_size, config.fleet_mix, false);
+
+            ChargerManager charger_mgr = config.make_charger_manager();
+            charger_mgr.reserve_aircraft(config.fleet_size - 1);
+            StatisticsCollector stats;
+            stats.set_aircraft_counts(fleet);
+            if (config.enable_percentiles)
+            {
+                stats.enable_distributions();
+            }
+
+            auto engine = SimulationFactory::create_engine(config, stats);
+            engine->set_checkpoint_options(config.checkpoint);
+            SimulationFactory::visit_engine(*engine, [&](auto &concrete_engine)
+                                            { concrete_engine.run(charger_mgr, fleet); });
+            return BatchStatistics::capture(stats);
+        }
+
+    public:
+        /**
+         * CSV row of a finished scenario (fleet totals), in csv_header() column order
+         */
+        static std::string format_row(const SweepResult &result)
+        {
+            const SimulationConfig &config = result.point.config;
+            int total_chargers = 0;
+            for (const auto &pool : config.get_charger_pools())
+            {
+                total_chargers += pool.charger_count;
+            }
+
+            std::ostringstream row;
+            row << std::setprecision(17);
+            row << result.point.index << ","
+                << (config.mode == SimulationMode::FRAME_BASED ? "frame"
+                    : config.mode == SimulationMode::COROUTINE ? "coroutine"
+                                                               : "event")
+                << ","
+                << config.fleet_size << "," << total_chargers << ",\"" << config.fleet_mix.to_string() << "\","
+                << config.checkpoint.branch_seed.value_or(*config.random_seed);
+
+            FlightStats totals = BatchStatistics::fleet_totals(result.stats);
+            for (const auto &metric : FLIGHT_STATS_METRICS)
+            {
+                row << "," << metric.extract(totals);
+            }
+            row << "\n";
+            return row.str();
+        }
+
+        /**
+         * Expand base.sweep into its distinct scenarios
+         * An empty grid dimension keeps the base value; without a base seed one is drawn for the whole sweep.
+         */
+        explicit SweepRunner(const SimulationConfig &base) : base_(base)
+        {
+            const SweepGrid &grid = base_.sweep;
+            std::uint64_t base_seed = base_.random_seed.value_or(RandomStream::entropy_seed());
+
+            // -1 keeps the base configuration's charger pools
+            std::vector<int> charger_counts = grid.charger_counts.empty() ? std::vector<int>{-1} : grid.charger_counts;
+            std::vector<int> fleet_sizes = grid.fleet_sizes.empty() ? std::vector<int>{base_.fleet_size} : grid.fleet_sizes;
+            std::vector<FleetMix> mixes = grid.fleet_mixes.empty() ? std::vector<FleetMix>{base_.fleet_mix} : grid.fleet_mixes;
+            std::vector<std::uint64_t> seeds = grid.seeds.empty() ? std::vector<std::uint64_t>{base_seed} : grid.seeds;
+
+            std::set<ScenarioKey> seen;
+            for (int charger_count : charger_counts)
+            {
+                for (int fleet_size : fleet_sizes)
+                {
+                    for (const FleetMix &mix : mixes)
+                    {
+                        for (std::uint64_t seed : seeds)
+                        {
+                            if (!seen.emplace(charger_count, fleet_size, mix.normalized().weights, seed).second)
+                            {
+                                ++duplicate_count_;
+                                continue;
+                            }
+                            points_.push_back({points_.size(), make_config(charger_count, fleet_size, mix, seed)});
+                        }
+                    }
+                }
+            }
+        }
+
+        const std::vector<SweepPoint> &get_points() const { return points_; }
+
+        /**
+         * Grid combinations skipped because an identical scenario is already in the sweep
+         */
+        size_t get_duplicate_count() const { return duplicate_count_; }
+
+        static std::string csv_header()
+        {
+            std::string header = "point,mode,fleet_size,chargers,fleet_mix,seed";
+            for (const auto &metric : FLIGHT_STATS_METRICS)
+            {
+                header += ",";
+                header += metric.name;
+            }
+            return header + "\n";
+        }
+
+        /**
+         * Run every scenario; each row (fleet totals) is written to csv and flushed as soon as its
+         * scenario finishes, so rows arrive in completion order and carry their point index
+         * @return Results in point order
+         * @throws The first exception raised by any scenario, after the others have finished
+         */
+        std::vector<SweepResult> run(std::ostream &csv) const
+        {
+            csv << csv_header() << std::flush;
+            return run_points(0, points_.size(), &csv);
+        }
+
+        /**
+         * Run points first .. first + count - 1 only, e.g. one node's share of a distributed sweep
+         * @param csv Where to stream each row as it finishes (no header), or nullptr
+         * @return Results of those points, in point order
+         * @throws The first exception raised by any scenario, after the others have finished
+         */
+        std::vector<SweepResult> run_points(size_t first, size_t count, std::ostream *csv = nullptr) const
+        {
+            first = std::min(first, points_.size());
+            count = std::min(count, points_.size() - first);
+            std::vector<SweepResult> results(count);
+
+            // Largest fleets first, so the longest scenarios do not trail at the end of the sweep
+            std::vector<size_t> order(count);
+            std::iota(order.begin(), order.end(), first);
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                             { return points_[a].config.fleet_size > points_[b].config.fleet_size; });
+
+            ThreadPool pool(std::max<size_t>(1, std::min(ThreadPool::resolve_thread_count(base_.num_threads), count)));
+            std::vector<SoaFleet> worker_fleets(pool.size());
+            std::mutex output_mutex;
+            std::exception_ptr first_error;
+
+            pool.parallel_for(order.size(), [&](size_t i, size_t worker)
+                              {
+                const SweepPoint &point = points_[order[i]];
+                try
+                {
+                    SweepResult &result = results[point.index - first];
+                    result.point = point;
+                    result.stats = run_point(point.config, worker_fleets[worker]);
+
+                    if (csv)
+                    {
+                        std::string row = format_row(result);
+                        std::lock_guard<std::mutex> lock(output_mutex);
+                        *csv << row << std::flush;
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(output_mutex);
+                    if (!first_error)
+                    {
+                        first_error = std::current_exception();
+                    }
+                } });
+
+            if (first_error)
+            {
+                std::rethrow_exception(first_error);
+            }
+            return results;
+        }
+    };
+}
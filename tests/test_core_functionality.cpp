@@ -1,4 +1,20 @@
 #include "test_utilities.h"
+#include "batch_statistics.h"
+#include "soa_fleet.h"
+#include "arena_fleet.h"
+#include "simulation_runner.h"
+#include "event_scheduler.h"
+#include "frame_based_simulation.h"
+#include "frame_state_table.h"
+#include "frame_timer_kernel.h"
+#include "stats_shard.h"
+#include "streaming_histogram.h"
+#include "event_trace.h"
+#include "snapshot.h"
+#include "progress_monitor.h"
+#include "dispatch_policy.h"
+#include <cstdio>
+#include <deque>
 
 namespace evtol_test
 {
@@ -181,4 +197,1133 @@ namespace evtol_test
         EXPECT_NE(report.find("Total Passenger Miles"), std::string::npos);
     }
 
-} // namespace evtol_test
\ No newline at end of file
+    // Test 9: Merged running statistics match a single accumulator
+    TEST_F(CoreFunctionalityTest, RunningStatMergeMatchesSequential)
+    {
+        const std::vector<double> values = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+
+        evtol::RunningStat sequential;
+        evtol::RunningStat left;
+        evtol::RunningStat right;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            sequential.add(values[i]);
+            (i < 3 ? left : right).add(values[i]);
+        }
+        left.merge(right);
+
+        EXPECT_EQ(left.count(), sequential.count());
+        EXPECT_NEAR_TOLERANCE(sequential.mean(), 5.0);
+        EXPECT_NEAR_TOLERANCE(left.mean(), sequential.mean());
+        EXPECT_NEAR_TOLERANCE(left.variance(), sequential.variance());
+        EXPECT_NEAR_TOLERANCE(sequential.variance(), 32.0 / 7.0);
+        EXPECT_GT(sequential.ci95_half_width(), 0.0);
+    }
+
+    // Test 10: Counter-based random streams are reproducible and independent per stream id
+    TEST_F(CoreFunctionalityTest, RandomStreamReproducibility)
+    {
+        evtol::RandomStream first(1234, 7);
+        evtol::RandomStream second(1234, 7);
+        evtol::RandomStream other_stream(1234, 8);
+
+        bool any_difference = false;
+        std::vector<double> draws;
+        for (int i = 0; i < 100; ++i)
+        {
+            double value = first.next_uniform();
+            draws.push_back(value);
+            EXPECT_EQ(value, second.next_uniform());
+            EXPECT_GE(value, 0.0);
+            EXPECT_LT(value, 1.0);
+            any_difference |= (value != other_stream.next_uniform());
+        }
+        EXPECT_TRUE(any_difference);
+
+        // Jumping to a draw index replays the same values
+        evtol::RandomStream replay(1234, 7);
+        replay.set_draw_index(41);
+        EXPECT_EQ(replay.next_uniform(), draws[41]);
+        EXPECT_EQ(replay.next_uniform(), draws[42]);
+    }
+
+    // Test 11: Structure-of-arrays fleet is grouped by type and matches the CRTP aircraft exactly
+    TEST_F(CoreFunctionalityTest, SoaFleetLayoutMatchesAircraftClasses)
+    {
+        auto soa_fleet = evtol::SoaFleet::create_fleet(12);
+        auto pointer_fleet = evtol::AircraftFactory<>::create_fleet(12);
+
+        ASSERT_EQ(soa_fleet.size(), 12u);
+        EXPECT_TRUE(soa_fleet.is_grouped());
+
+        auto counts = soa_fleet.count_by_type();
+        EXPECT_EQ(counts[static_cast<size_t>(evtol::AircraftType::ALPHA)], 3);
+        EXPECT_EQ(counts[static_cast<size_t>(evtol::AircraftType::ECHO)], 2);
+
+        soa_fleet.for_each_type_batch([&](auto type_tag, size_t begin, size_t end)
+                                      {
+            using T = typename decltype(type_tag)::type;
+            for (size_t i = begin; i < end; ++i)
+            {
+                auto aircraft = soa_fleet[i];
+                const auto &reference = pointer_fleet[static_cast<size_t>(aircraft->get_id())];
+                EXPECT_EQ(aircraft->get_type(), T::get_aircraft_type());
+                EXPECT_EQ(aircraft->get_flight_time_hours(), reference->get_flight_time_hours());
+                EXPECT_EQ(aircraft->get_flight_distance_miles(), reference->get_flight_distance_miles());
+                EXPECT_EQ(aircraft->get_charge_time_hours(), reference->get_charge_time_hours());
+                EXPECT_EQ(aircraft->get_manufacturer(), reference->get_manufacturer());
+            } });
+    }
+
+    // Test 12: Both engines produce identical results on a SoA fleet and a pointer fleet
+    TEST_F(CoreFunctionalityTest, SoaFleetMatchesPointerFleetInBothEngines)
+    {
+        const std::uint64_t seed = 99;
+
+        {
+            auto pointer_fleet = evtol::AircraftFactory<>::create_fleet(25);
+            auto soa_fleet = evtol::SoaFleet::from_fleet(pointer_fleet);
+            evtol::StatisticsCollector soa_stats;
+            evtol::ChargerManager soa_chargers;
+
+            evtol::EventDrivenSimulation reference(*stats_collector_, 3.0, false, true, seed);
+            reference.run_simulation(*charger_manager_, pointer_fleet);
+            evtol::EventDrivenSimulation soa(soa_stats, 3.0, false, true, seed);
+            soa.run_simulation(soa_chargers, soa_fleet);
+
+            auto expected = stats_collector_->get_summary_stats();
+            auto actual = soa_stats.get_summary_stats();
+            EXPECT_EQ(actual.total_flights, expected.total_flights);
+            EXPECT_EQ(actual.total_faults, expected.total_faults);
+            EXPECT_EQ(actual.total_distance, expected.total_distance);
+            EXPECT_EQ(actual.total_waiting_time, expected.total_waiting_time);
+        }
+
+        {
+            evtol::SimulationConfig config;
+            config.random_seed = seed;
+            auto pointer_fleet = evtol::AircraftFactory<>::create_fleet(25);
+            auto soa_fleet = evtol::SoaFleet::from_fleet(pointer_fleet);
+            evtol::StatisticsCollector reference_stats;
+            evtol::StatisticsCollector soa_stats;
+            evtol::ChargerManager reference_chargers;
+            evtol::ChargerManager soa_chargers;
+
+            evtol::FrameBasedSimulationEngine reference(reference_stats, config);
+            reference.run_frame_based_simulation(reference_chargers, pointer_fleet);
+            evtol::FrameBasedSimulationEngine soa(soa_stats, config);
+            soa.run_frame_based_simulation(soa_chargers, soa_fleet);
+
+            auto expected = reference_stats.get_summary_stats();
+            auto actual = soa_stats.get_summary_stats();
+            EXPECT_EQ(actual.total_flights, expected.total_flights);
+            EXPECT_EQ(actual.total_faults, expected.total_faults);
+            EXPECT_EQ(actual.total_distance, expected.total_distance);
+            EXPECT_EQ(actual.total_charging_time, expected.total_charging_time);
+        }
+    }
+
+    // Test 13: Every scheduler pops events in (time, insertion order), including ties
+    template <typename Scheduler>
+    std::vector<std::pair<double, int>> drain_scheduler(const std::vector<double> &times)
+    {
+        Scheduler scheduler;
+        std::vector<std::pair<double, int>> order;
+        size_t next = 0;
+
+        // Interleave pushes and pops the way a simulation does
+        while (next < times.size() || !scheduler.empty())
+        {
+            for (int burst = 0; burst < 3 && next < times.size(); ++burst, ++next)
+            {
+                double base = order.empty() ? 0.0 : order.back().first;
+                scheduler.push(evtol::EventType::FLIGHT_COMPLETE, base + times[next], static_cast<int>(next));
+            }
+            EXPECT_DOUBLE_EQ(scheduler.next_time(), scheduler.next_time());
+            auto event = scheduler.pop();
+            order.emplace_back(event.time_hours, event.data);
+        }
+        return order;
+    }
+
+    TEST_F(CoreFunctionalityTest, EventSchedulersAgreeOnOrder)
+    {
+        static_assert(evtol::EventScheduler<evtol::BinaryHeapScheduler<int>>);
+        static_assert(evtol::EventScheduler<evtol::QuaternaryHeapScheduler<int>>);
+        static_assert(evtol::EventScheduler<evtol::CalendarQueueScheduler<int>>);
+
+        std::mt19937 gen(12345);
+        std::uniform_int_distribution<int> quarter_hours(0, 12);
+        std::vector<double> times(2000);
+        for (double &time : times)
+        {
+            time = 0.25 * quarter_hours(gen); // coarse grid, so many events tie
+        }
+
+        auto expected = drain_scheduler<evtol::BinaryHeapScheduler<int>>(times);
+        ASSERT_EQ(expected.size(), times.size());
+        for (size_t i = 1; i < expected.size(); ++i)
+        {
+            ASSERT_LE(expected[i - 1].first, expected[i].first);
+            if (expected[i - 1].first == expected[i].first)
+            {
+                ASSERT_LT(expected[i - 1].second, expected[i].second);
+            }
+        }
+
+        EXPECT_EQ(drain_scheduler<evtol::QuaternaryHeapScheduler<int>>(times), expected);
+        EXPECT_EQ(drain_scheduler<evtol::CalendarQueueScheduler<int>>(times), expected);
+    }
+
+    // Test 14: The frame timer kernel matches the scalar per-aircraft update and flags exactly the expiries
+    TEST_F(CoreFunctionalityTest, FrameTimerKernelMatchesScalarUpdate)
+    {
+        const double frame_time = 60.0;
+        std::mt19937 gen(2024);
+        std::uniform_real_distribution<double> seconds(0.0, 600.0);
+
+        // Odd size so the SIMD path leaves a scalar tail; include idle zeros and exact frame multiples
+        std::vector<double> timers(1003);
+        for (size_t i = 0; i < timers.size(); ++i)
+        {
+            timers[i] = i % 7 == 0 ? 0.0 : (i % 11 == 0 ? frame_time * static_cast<double>(i % 4) : seconds(gen));
+        }
+
+        std::vector<evtol::AircraftFrameData> reference(timers.size());
+        for (size_t i = 0; i < timers.size(); ++i)
+        {
+            reference[i].time_remaining_sec = timers[i];
+        }
+
+        for (int frame = 0; frame < 12; ++frame)
+        {
+            std::vector<size_t> expected_expired;
+            for (size_t i = 0; i < reference.size(); ++i)
+            {
+                double before = reference[i].time_remaining_sec;
+                if (before > 0.0 && reference[i].update_time_remaining(frame_time) <= 0.0)
+                {
+                    expected_expired.push_back(i);
+                }
+            }
+
+            // Split at an unaligned position the way parallel chunks would
+            std::vector<size_t> expired;
+            evtol::advance_frame_timers(timers, 0, 333, frame_time, expired);
+            evtol::advance_frame_timers(timers, 333, timers.size(), frame_time, expired);
+
+            EXPECT_EQ(expired, expected_expired) << "frame " << frame;
+            for (size_t i = 0; i < timers.size(); ++i)
+            {
+                ASSERT_EQ(timers[i], reference[i].time_remaining_sec) << "aircraft " << i << " frame " << frame;
+            }
+        }
+
+        // Zero-duration activities never cross zero, so the table hands them over separately
+        evtol::FrameStateTable table;
+        table.reset(4);
+        table.reset_for_activity(1, evtol::AircraftState::FLYING, 0.0);
+        table.reset_for_activity(2, evtol::AircraftState::FLYING, 30.0);
+        EXPECT_EQ(table.idle_aircraft().count(), 2u);
+        EXPECT_EQ(table.idle_aircraft().next(1), 3u);
+
+        std::vector<size_t> zero_duration;
+        table.take_zero_duration_activities(zero_duration);
+        EXPECT_EQ(zero_duration, std::vector<size_t>{1});
+        EXPECT_FALSE(table.has_zero_duration_activities());
+    }
+
+    // Test 15: Named charger pools keep separate capacity, free lists and FIFO queues
+    TEST_F(CoreFunctionalityTest, ChargerPoolsKeepSeparateCapacityAndQueues)
+    {
+        evtol::ChargerManager chargers({{"north", 2}, {"south", 1}});
+        ASSERT_EQ(chargers.get_pool_count(), 2u);
+        EXPECT_EQ(chargers.get_total_chargers(), 3);
+        EXPECT_EQ(chargers.find_pool("south"), 1u);
+        EXPECT_EQ(chargers.get_charger_pool(2), 1u);
+
+        // Home pool defaults to id % pool count
+        EXPECT_EQ(chargers.get_home_pool(4), 0u);
+        EXPECT_EQ(chargers.get_home_pool(7), 1u);
+        chargers.set_home_pool(7, 0);
+        EXPECT_EQ(chargers.get_home_pool(7), 0u);
+
+        EXPECT_TRUE(chargers.request_charger(0));
+        EXPECT_TRUE(chargers.request_charger(2));
+        EXPECT_FALSE(chargers.request_charger(4)); // north is full
+        EXPECT_EQ(chargers.get_available_chargers(1), 1);
+        EXPECT_TRUE(chargers.request_charger(1));  // south still had a charger
+        EXPECT_EQ(chargers.get_available_chargers(), 0);
+
+        EXPECT_EQ(chargers.get_charger_id(0), 0);
+        EXPECT_EQ(chargers.get_aircraft_at_charger(1), 2);
+        EXPECT_EQ(chargers.get_aircraft_at_charger(2), 1);
+
+        chargers.add_to_queue(4);
+        chargers.add_to_queue(3);
+        chargers.add_to_queue(6);
+        EXPECT_EQ(chargers.get_queue_size(), 3);
+        EXPECT_EQ(chargers.get_queue_size(1), 1);
+
+        // Queues list their aircraft in serving order
+        EXPECT_EQ(chargers.waiting_order(0), (std::vector<int>{4, 6}));
+        EXPECT_EQ(chargers.get_waiting_queue(), (std::vector<int>{4, 6, 3}));
+        EXPECT_EQ(chargers.waiting_queue(0).front(), 4);
+        EXPECT_TRUE(chargers.waiting_queue(1).contains(3));
+
+        // A release serves its own pool's queue and hands the same charger on
+        chargers.release_charger(2);
+        EXPECT_FALSE(chargers.is_charger_occupied(1));
+        EXPECT_EQ(chargers.get_next_from_queue(), 4);
+        EXPECT_TRUE(chargers.assign_charger(4));
+        EXPECT_EQ(chargers.get_charger_id(4), 1);
+        EXPECT_EQ(chargers.get_next_from_queue(1), 3);
+        EXPECT_EQ(chargers.get_next_from_queue(1), -1);
+        EXPECT_EQ(chargers.get_active_chargers() + chargers.get_available_chargers(), 3);
+
+        // Ids outside the dense table still work
+        evtol::ChargerManager wide(1000);
+        EXPECT_TRUE(wide.request_charger(-5));
+        EXPECT_TRUE(wide.request_charger(2147483647));
+        EXPECT_EQ(wide.get_active_chargers(), 2);
+        wide.release_charger(-5);
+        EXPECT_EQ(wide.get_charger_id(-5), -1);
+        EXPECT_EQ(wide.get_available_chargers(), 999);
+    }
+
+    // Test 16: Per-worker stats shards merge to the same totals as one collector, and mocks keep their virtual calls
+    TEST_F(CoreFunctionalityTest, StatsShardsMergeToCollectorTotals)
+    {
+        evtol::StatisticsCollector direct;
+        evtol::ShardedStats shards(3);
+        ASSERT_EQ(shards.size(), 3u);
+
+        for (int i = 0; i < 30; ++i)
+        {
+            auto type = static_cast<evtol::AircraftType>(i % evtol::NUM_AIRCRAFT_TYPES);
+            double hours = 0.25 * (i + 1);
+            direct.record_flight(type, hours, 10.0 * hours, 1 + i % 4);
+            direct.record_charge_session(type, 0.5, 0.125 * (i % 3));
+            shards.local(static_cast<size_t>(i % 3)).record_flight(type, hours, 10.0 * hours, 1 + i % 4);
+            shards.local(static_cast<size_t>(i % 3)).record_charge_session(type, 0.5, 0.125 * (i % 3));
+            if (i % 7 == 0)
+            {
+                direct.record_fault(type);
+                shards.local(static_cast<size_t>(i % 3)).record_fault(type);
+            }
+        }
+
+        evtol::StatisticsCollector merged;
+        merged.merge(shards.merged());
+        for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+        {
+            auto type = static_cast<evtol::AircraftType>(t);
+            const evtol::FlightStats &expected = direct.get_stats(type);
+            const evtol::FlightStats &actual = merged.get_stats(type);
+            EXPECT_EQ(actual.flight_count, expected.flight_count);
+            EXPECT_EQ(actual.charge_count, expected.charge_count);
+            EXPECT_EQ(actual.total_faults, expected.total_faults);
+            EXPECT_DOUBLE_EQ(actual.total_flight_time_hours, expected.total_flight_time_hours);
+            EXPECT_DOUBLE_EQ(actual.total_passenger_miles, expected.total_passenger_miles);
+            EXPECT_DOUBLE_EQ(actual.total_waiting_time_hours, expected.total_waiting_time_hours);
+        }
+
+        shards.reset();
+        EXPECT_EQ(shards.merged().get(evtol::AircraftType::ALPHA).flight_count, 0);
+
+        // The recorder writes straight into a plain collector but routes overridden collectors through their methods
+        EXPECT_NE(direct.direct_shard(), nullptr);
+        MockStatisticsCollector mock;
+        EXPECT_EQ(mock.direct_shard(), nullptr);
+
+        evtol::StatsRecorder plain_recorder(direct);
+        plain_recorder.record_flight(evtol::AircraftType::ECHO, 1.0, 30.0, 2);
+        EXPECT_EQ(direct.get_stats(evtol::AircraftType::ECHO).flight_count, 7);
+
+        evtol::StatsRecorder mock_recorder(mock);
+        mock_recorder.record_flight(evtol::AircraftType::BETA, 1.0, 100.0, 5);
+        mock_recorder.record_fault(evtol::AircraftType::BETA);
+        EXPECT_EQ(mock.get_flight_count(), 1);
+        EXPECT_EQ(mock.get_fault_count(), 1);
+        EXPECT_EQ(mock.get_stats(evtol::AircraftType::BETA).flight_count, 1);
+    }
+
+    // Test 17: Streaming histograms report percentiles within their resolution and merge exactly
+    TEST_F(CoreFunctionalityTest, StreamingHistogramPercentilesAndMerge)
+    {
+        evtol::StreamingHistogram whole(1.0);
+        evtol::StreamingHistogram low(1.0);
+        evtol::StreamingHistogram high(1.0);
+        for (int value = 1; value <= 10000; ++value)
+        {
+            whole.record(value);
+            (value % 2 == 0 ? low : high).record(value);
+        }
+
+        EXPECT_EQ(whole.count(), 10000u);
+        EXPECT_EQ(whole.min(), 1.0);
+        EXPECT_EQ(whole.max(), 10000.0);
+        for (double percentile : {50.0, 95.0, 99.0})
+        {
+            double exact = percentile * 100.0;
+            double estimate = whole.value_at_percentile(percentile);
+            EXPECT_LE(estimate, exact);
+            EXPECT_GE(estimate, exact * (1.0 - 1.0 / 32.0)) << "p" << percentile;
+        }
+        EXPECT_EQ(whole.value_at_percentile(100.0), 10000.0);
+
+        // Small integers are exact, and merging shards reproduces the single histogram
+        evtol::StreamingHistogram queue(1.0);
+        for (int length : {0, 0, 0, 1, 2, 2, 5, 7})
+        {
+            queue.record(length);
+        }
+        EXPECT_EQ(queue.value_at_percentile(50.0), 1.0);
+        EXPECT_EQ(queue.value_at_percentile(99.0), 7.0);
+
+        low.merge(high);
+        for (double percentile : {1.0, 50.0, 95.0, 99.0, 99.9})
+        {
+            EXPECT_EQ(low.value_at_percentile(percentile), whole.value_at_percentile(percentile));
+        }
+        EXPECT_THROW(low.merge(evtol::StreamingHistogram(0.5)), std::invalid_argument);
+
+        // Memory is fixed: huge values land in the last bucket instead of growing the table
+        evtol::StreamingHistogram wide(1.0);
+        wide.record(1e300);
+        wide.record(-3.0);
+        EXPECT_EQ(wide.count(), 2u);
+        EXPECT_EQ(wide.value_at_percentile(50.0), 0.0);
+        EXPECT_EQ(wide.value_at_percentile(100.0), 1e300);
+        wide.reset();
+        EXPECT_EQ(wide.count(), 0u);
+        EXPECT_EQ(wide.value_at_percentile(50.0), 0.0);
+    }
+
+    // Test 18: Binary trace records round-trip through the background writer in order
+    TEST_F(CoreFunctionalityTest, TraceWriterRoundTripsRecords)
+    {
+        std::string path = ::testing::TempDir() + "evtol_trace_roundtrip.bin";
+        {
+            // Tiny blocks so the writer thread and the block recycling are exercised
+            evtol::TraceWriter writer(path, 7, 2);
+            for (int i = 0; i < 1000; ++i)
+            {
+                writer.record(0.01 * i, i % 20, static_cast<evtol::TraceEventType>(i % evtol::NUM_TRACE_EVENT_TYPES),
+                              static_cast<evtol::AircraftType>(i % evtol::NUM_AIRCRAFT_TYPES), i * 1.5, -i);
+            }
+            EXPECT_EQ(writer.get_record_count(), 1000u);
+            writer.flush();
+            writer.record(99.0, 7, evtol::TraceEventType::FAULT, evtol::AircraftType::DELTA, 0.25);
+            writer.close();
+            writer.close(); // closing twice is harmless
+        }
+
+        evtol::TraceReader reader(path);
+        evtol::TraceRecord record{};
+        for (int i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(reader.next(record)) << "record " << i;
+            EXPECT_EQ(record.time_hours, 0.01 * i);
+            EXPECT_EQ(record.aircraft_id, i % 20);
+            EXPECT_EQ(static_cast<size_t>(record.event_type), static_cast<size_t>(i) % evtol::NUM_TRACE_EVENT_TYPES);
+            EXPECT_EQ(record.aircraft_type, static_cast<std::uint8_t>(i % evtol::NUM_AIRCRAFT_TYPES));
+            EXPECT_EQ(record.value_a, i * 1.5);
+            EXPECT_EQ(record.value_b, -i);
+        }
+
+        std::vector<evtol::TraceRecord> tail;
+        EXPECT_EQ(reader.read_batch(tail, 10), 1u);
+        EXPECT_EQ(tail[0].event_type, evtol::TraceEventType::FAULT);
+        EXPECT_EQ(tail[0].value_a, 0.25);
+        EXPECT_FALSE(reader.next(record));
+        EXPECT_STREQ(evtol::trace_event_name(evtol::TraceEventType::CHARGER_QUEUED), "CHARGER_QUEUED");
+
+        // Anything that is not a trace is rejected
+        std::string bogus = ::testing::TempDir() + "evtol_trace_bogus.bin";
+        std::FILE *file = std::fopen(bogus.c_str(), "wb");
+        ASSERT_NE(file, nullptr);
+        std::fputs("not a trace file at all", file);
+        std::fclose(file);
+        EXPECT_THROW(evtol::TraceReader{bogus}, std::runtime_error);
+        EXPECT_THROW(evtol::TraceReader{path + ".missing"}, std::runtime_error);
+
+        std::remove(path.c_str());
+        std::remove(bogus.c_str());
+    }
+
+    // Test 19: Snapshots round-trip chargers, statistics and aircraft state, and reject damaged input
+    TEST_F(CoreFunctionalityTest, SnapshotsRoundTripSimulationState)
+    {
+        evtol::ChargerManager chargers({{"north", 2}, {"south", 1}});
+        for (int id : {0, 1, 2, 3, 4, 1000})
+        {
+            chargers.request_charger(id);
+        }
+        evtol::StatisticsCollector stats;
+        stats.enable_distributions();
+        stats.record_flight(evtol::AircraftType::BETA, 0.75, 60.0, 5);
+        stats.record_charge_session(evtol::AircraftType::BETA, 0.2);
+        stats.record_fault(evtol::AircraftType::ECHO);
+
+        evtol::AlphaAircraft aircraft(3);
+        aircraft.seed_random_stream(77, 3);
+        aircraft.check_fault_during_flight(1.0);
+        aircraft.discharge_battery();
+        aircraft.set_faulty(true);
+        evtol::AircraftSnapshot saved = aircraft.save_state();
+
+        evtol::SnapshotWriter out;
+        out.begin_section(evtol::snapshot_tag("TEST"));
+        out.write_vector(std::vector<int>{5, 6, 7});
+        out.write_string("vertiport");
+        chargers.save_state(out);
+        stats.save_state(out);
+
+        evtol::SnapshotReader in(out.data());
+        in.expect_section(evtol::snapshot_tag("TEST"));
+        EXPECT_EQ(in.read_vector<int>(), (std::vector<int>{5, 6, 7}));
+        EXPECT_EQ(in.read_string(), "vertiport");
+
+        evtol::ChargerManager restored_chargers({{"north", 2}, {"south", 1}});
+        restored_chargers.restore_state(in);
+        evtol::StatisticsCollector restored_stats;
+        restored_stats.restore_state(in);
+        EXPECT_TRUE(in.at_end());
+
+        EXPECT_EQ(restored_chargers.get_active_chargers(), chargers.get_active_chargers());
+        EXPECT_EQ(restored_chargers.get_queue_size(), chargers.get_queue_size());
+        EXPECT_EQ(restored_chargers.get_charger_id(1000), chargers.get_charger_id(1000));
+        for (int charger = 0; charger < chargers.get_total_chargers(); ++charger)
+        {
+            EXPECT_EQ(restored_chargers.get_aircraft_at_charger(charger), chargers.get_aircraft_at_charger(charger));
+        }
+        // The queues continue in the saved order
+        chargers.release_charger(0);
+        restored_chargers.release_charger(0);
+        EXPECT_EQ(restored_chargers.get_next_from_queue(0), chargers.get_next_from_queue(0));
+
+        EXPECT_TRUE(restored_stats.has_distributions());
+        EXPECT_EQ(restored_stats.generate_report(), stats.generate_report());
+
+        // The restored aircraft draws the same fault times as the original from here on
+        evtol::AlphaAircraft restored_aircraft(3);
+        restored_aircraft.restore_state(saved);
+        EXPECT_TRUE(restored_aircraft.is_faulty());
+        EXPECT_EQ(restored_aircraft.get_battery_level(), aircraft.get_battery_level());
+        for (int i = 0; i < 5; ++i)
+        {
+            EXPECT_EQ(restored_aircraft.check_fault_during_flight(1.0), aircraft.check_fault_during_flight(1.0));
+        }
+
+        // Mismatched pools, truncated data and foreign files are rejected
+        evtol::SnapshotReader other_pools(out.data());
+        other_pools.expect_section(evtol::snapshot_tag("TEST"));
+        other_pools.read_vector<int>();
+        other_pools.read_string();
+        evtol::ChargerManager single_pool(3);
+        EXPECT_THROW(single_pool.restore_state(other_pools), std::runtime_error);
+
+        std::vector<std::byte> truncated(out.data().begin(), out.data().end() - 4);
+        evtol::SnapshotReader short_reader(truncated);
+        short_reader.expect_section(evtol::snapshot_tag("TEST"));
+        short_reader.read_vector<int>();
+        short_reader.read_string();
+        evtol::ChargerManager truncated_chargers({{"north", 2}, {"south", 1}});
+        truncated_chargers.restore_state(short_reader);
+        evtol::StatisticsCollector truncated_stats;
+        EXPECT_THROW(truncated_stats.restore_state(short_reader), std::runtime_error);
+
+        // Ids and counts that do not fit the configured pools are rejected before anything changes
+        struct PoolState
+        {
+            std::vector<int> free_chargers;
+            std::vector<int> waiting;
+        };
+        auto damaged = [](std::vector<PoolState> pools, std::vector<int> charger_to_aircraft, int active, int queued, std::uint64_t last_pool)
+        {
+            evtol::SnapshotWriter writer;
+            writer.begin_section(evtol::snapshot_tag("CHRG"));
+            writer.write(evtol::DispatchPolicy::FIFO);
+            writer.write(std::uint64_t{2});
+            const char *names[] = {"north", "south"};
+            for (size_t p = 0; p < 2; ++p)
+            {
+                writer.write_string(names[p]);
+                writer.write(p == 0 ? 2 : 1);
+                writer.write_vector(pools[p].free_chargers);
+                writer.write_vector(pools[p].waiting);
+                writer.write_vector(std::vector<double>(pools[p].waiting.size(), 0.0));
+            }
+            writer.write_vector(charger_to_aircraft);
+            writer.write_vector(std::vector<int>{}); // aircraft slots
+            writer.write_vector(std::vector<int>{}); // sparse slots
+            writer.write(active);
+            writer.write(queued);
+            writer.write(last_pool);
+            return writer;
+        };
+        auto restores = [](const evtol::SnapshotWriter &writer)
+        {
+            evtol::ChargerManager target({{"north", 2}, {"south", 1}});
+            evtol::SnapshotReader reader(writer.data());
+            target.restore_state(reader);
+            return target.get_available_chargers();
+        };
+        EXPECT_EQ(restores(damaged({{{1, 0}, {}}, {{2}, {}}}, {-1, -1, -1}, 0, 0, 0)), 3);
+        EXPECT_EQ(restores(damaged({{{1}, {2}}, {{}, {}}}, {7, -1, 9}, 2, 1, 1)), 1);
+        EXPECT_THROW(restores(damaged({{{1, 99}, {}}, {{2}, {}}}, {-1, -1, -1}, 0, 0, 0)), std::runtime_error);  // no such charger
+        EXPECT_THROW(restores(damaged({{{1, 2}, {}}, {{0}, {}}}, {-1, -1, -1}, 0, 0, 0)), std::runtime_error);   // another pool's charger
+        EXPECT_THROW(restores(damaged({{{1, 1}, {}}, {{2}, {}}}, {-1, -1, -1}, 0, 0, 0)), std::runtime_error);   // listed twice
+        EXPECT_THROW(restores(damaged({{{1, 0}, {}}, {{2}, {}}}, {5, -1, -1}, 1, 0, 0)), std::runtime_error);    // free and held
+        EXPECT_THROW(restores(damaged({{{1}, {}}, {{2}, {}}}, {-1, -1, -1}, 0, 0, 0)), std::runtime_error);      // charger lost
+        EXPECT_THROW(restores(damaged({{{1}, {}}, {{2}, {}}}, {5, -1, -1}, 3, 0, 0)), std::runtime_error);       // active count
+        EXPECT_THROW(restores(damaged({{{1, 0}, {3}}, {{2}, {}}}, {-1, -1, -1}, 0, 1, 0)), std::runtime_error);  // waits at the wrong pool
+        EXPECT_THROW(restores(damaged({{{1, 0}, {}}, {{2}, {}}}, {-1, -1, -1}, 0, 0, 2)), std::runtime_error);   // last released pool
+
+        evtol::SnapshotReader wrong_section(out.data());
+        EXPECT_THROW(wrong_section.expect_section(evtol::snapshot_tag("HEAD")), std::runtime_error);
+        EXPECT_THROW(evtol::SnapshotReader{std::vector<std::byte>(4)}, std::runtime_error);
+        EXPECT_THROW(evtol::SnapshotReader{::testing::TempDir() + "evtol_missing.ckpt"}, std::runtime_error);
+    }
+
+    // Test 20: Fleet mixes deal out types in weighted blocks, and SoA fleets rebuild in place
+    TEST_F(CoreFunctionalityTest, FleetMixAssignsTypesAndReusesStorage)
+    {
+        evtol::FleetMix round_robin;
+        for (int id = 0; id < 100; ++id)
+        {
+            EXPECT_EQ(static_cast<int>(round_robin.type_of(id)), id % 5);
+        }
+
+        evtol::FleetMix mix;
+        mix.weights = {2, 0, 0, 0, 1};
+        EXPECT_EQ(mix.to_string(), "alpha:2,echo:1");
+        evtol::FleetMix doubled;
+        doubled.weights = {4, 0, 0, 0, 2};
+        EXPECT_EQ(doubled.normalized(), mix);
+
+        auto pointer_fleet = evtol::AircraftFactory<>::create_fleet(9, mix);
+        std::vector<evtol::AircraftType> expected_types = {
+            evtol::AircraftType::ALPHA, evtol::AircraftType::ALPHA, evtol::AircraftType::ECHO,
+            evtol::AircraftType::ALPHA, evtol::AircraftType::ALPHA, evtol::AircraftType::ECHO,
+            evtol::AircraftType::ALPHA, evtol::AircraftType::ALPHA, evtol::AircraftType::ECHO};
+        for (size_t i = 0; i < pointer_fleet.size(); ++i)
+        {
+            EXPECT_EQ(pointer_fleet[i]->get_type(), expected_types[i]);
+        }
+
+        // Grouped by type by default, or in the pointer factory's id order
+        evtol::SoaFleet soa_fleet;
+        soa_fleet.assign(100, mix);
+        EXPECT_TRUE(soa_fleet.is_grouped());
+        EXPECT_EQ(soa_fleet.count_by_type()[static_cast<size_t>(evtol::AircraftType::ALPHA)], 67);
+        EXPECT_EQ(soa_fleet.count_by_type()[static_cast<size_t>(evtol::AircraftType::BETA)], 0);
+
+        const int *storage = soa_fleet.ids().data();
+        soa_fleet.assign(9, mix, false);
+        EXPECT_EQ(soa_fleet.ids().data(), storage) << "a smaller fleet reuses the columns";
+        for (size_t i = 0; i < soa_fleet.size(); ++i)
+        {
+            EXPECT_EQ(soa_fleet[i]->get_id(), static_cast<int>(i));
+            EXPECT_EQ(soa_fleet[i]->get_type(), expected_types[i]);
+        }
+
+        // Mixes and sweep lists come from the command line
+        std::vector<std::string> args = {"evtolsim", "--fleet-size", "9", "--fleet-mix", "Alpha:2,echo:1",
+                                         "--sweep-chargers", "1,2", "--sweep-mix", "beta:1", "--sweep-seeds", "7,8"};
+        std::vector<char *> argv;
+        for (auto &arg : args)
+        {
+            argv.push_back(arg.data());
+        }
+        evtol::SimulationConfig config;
+        config.parse_args(static_cast<int>(argv.size()), argv.data());
+        EXPECT_EQ(config.fleet_size, 9);
+        EXPECT_EQ(config.fleet_mix, mix);
+        EXPECT_EQ(config.sweep.charger_counts, (std::vector<int>{1, 2}));
+        ASSERT_EQ(config.sweep.fleet_mixes.size(), 1u);
+        EXPECT_EQ(config.sweep.fleet_mixes[0].to_string(), "beta:1");
+        EXPECT_EQ(config.sweep.seeds, (std::vector<std::uint64_t>{7, 8}));
+
+        std::vector<std::string> bad_args = {"evtolsim", "--fleet-mix", "gamma:1"};
+        std::vector<char *> bad_argv = {bad_args[0].data(), bad_args[1].data(), bad_args[2].data()};
+        EXPECT_THROW(config.parse_args(3, bad_argv.data()), std::invalid_argument);
+
+        config.fleet_mix.weights.fill(0);
+        EXPECT_FALSE(config.validate());
+    }
+
+    // Test 21: Arena fleets are contiguous by type, reset in place, and run exactly like pointer fleets
+    TEST_F(CoreFunctionalityTest, ArenaFleetIsContiguousAndResettable)
+    {
+        static_assert(evtol::SimulationFleet<evtol::ArenaFleet>);
+        static_assert(evtol::ResettableFleet<evtol::ArenaFleet>);
+        static_assert(!evtol::ResettableFleet<evtol::AircraftFleet>);
+
+        evtol::ArenaFleet fleet(20);
+        ASSERT_EQ(fleet.size(), 20u);
+        for (size_t i = 0; i < fleet.size(); ++i)
+        {
+            EXPECT_EQ(fleet[i]->get_id(), static_cast<int>(i));
+            EXPECT_EQ(static_cast<int>(fleet[i]->get_type()), static_cast<int>(i % 5));
+        }
+
+        // Same-type aircraft sit back to back, types in order, all inside one block
+        const auto *first_alpha = reinterpret_cast<const std::byte *>(fleet[0]);
+        const auto *second_alpha = reinterpret_cast<const std::byte *>(fleet[5]);
+        const auto *first_beta = reinterpret_cast<const std::byte *>(fleet[1]);
+        EXPECT_EQ(second_alpha - first_alpha, static_cast<std::ptrdiff_t>(sizeof(evtol::AlphaAircraft)));
+        EXPECT_EQ(first_beta - first_alpha, static_cast<std::ptrdiff_t>(4 * sizeof(evtol::AlphaAircraft)));
+
+        fleet[3]->discharge_battery();
+        fleet[3]->set_faulty(true);
+        evtol::AircraftBase *before = fleet[3];
+        size_t bytes = fleet.arena_bytes();
+        fleet.reset();
+        EXPECT_EQ(fleet[3], before) << "reset rebuilds in the same block";
+        EXPECT_EQ(fleet[3]->get_battery_level(), 1.0);
+        EXPECT_FALSE(fleet[3]->is_faulty());
+
+        evtol::FleetMix mix;
+        mix.weights = {0, 1, 0, 0, 1};
+        fleet.reset(10, mix);
+        EXPECT_EQ(fleet.arena_bytes(), bytes) << "a smaller fleet keeps the block";
+        EXPECT_EQ(fleet[0]->get_type(), evtol::AircraftType::BETA);
+        EXPECT_EQ(fleet[1]->get_type(), evtol::AircraftType::ECHO);
+
+        evtol::ArenaFleet moved = std::move(fleet);
+        EXPECT_TRUE(fleet.empty());
+        EXPECT_EQ(moved.size(), 10u);
+
+        // Single runs and batches match the pointer factory's fleet bit for bit
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = 11;
+            config.simulation_duration_hours = 6.0;
+
+            evtol::StatisticsCollector pointer_stats;
+            evtol::ChargerManager pointer_chargers;
+            auto pointer_fleet = evtol::AircraftFactory<>::create_fleet(30, mix);
+            evtol::SimulationRunner(pointer_stats, config).run_simulation(pointer_chargers, pointer_fleet);
+
+            evtol::StatisticsCollector arena_stats;
+            evtol::ChargerManager arena_chargers;
+            evtol::ArenaFleet arena_fleet(30, mix);
+            evtol::SimulationRunner(arena_stats, config).run_simulation(arena_chargers, arena_fleet);
+            EXPECT_EQ(arena_stats.generate_report(), pointer_stats.generate_report());
+
+            config.replications = 6;
+            config.num_threads = 2;
+            evtol::SimulationRunner batch_runner(arena_stats, config);
+            auto pointer_batch = batch_runner.run_replications([&]
+                                                               { return evtol::AircraftFactory<>::create_fleet(30, mix); });
+            auto arena_batch = batch_runner.run_replications([&]
+                                                             { return evtol::ArenaFleet(30, mix); });
+            EXPECT_EQ(arena_batch.generate_report(), pointer_batch.generate_report());
+        }
+    }
+
+    // Test 22: Per-type flight constants are folded at compile time and match the general formula
+    TEST_F(CoreFunctionalityTest, TypeTableIsConstexprAndMatchesFormula)
+    {
+        constexpr const evtol::AircraftTypeParameters &alpha =
+            evtol::AIRCRAFT_TYPE_TABLE[static_cast<size_t>(evtol::AircraftType::ALPHA)];
+        static_assert(alpha.spec->manufacturer == "Alpha");
+        static_assert(alpha.full_charge_flight_time_hours == 320.0 / (120.0 * 1.6));
+        static_assert(evtol::EchoAircraft::full_charge_flight_distance_miles() ==
+                      evtol::EchoAircraft::full_charge_flight_time_hours() * 30.0);
+
+        evtol::SoaFleet partial;
+        evtol::for_each_aircraft_class([&](auto type_tag)
+                                       {
+            using T = typename decltype(type_tag)::type;
+            const auto &params = evtol::aircraft_type_table()[static_cast<size_t>(T::get_aircraft_type())];
+            const evtol::AircraftSpec &spec = T::get_aircraft_spec();
+            double formula = 1.0 * spec.battery_capacity_kwh / (spec.cruise_speed_mph * T::get_energy_consumption_per_mile());
+
+            T aircraft(0);
+            EXPECT_EQ(aircraft.get_flight_time_hours(), formula);
+            EXPECT_EQ(aircraft.get_flight_distance_miles(), formula * spec.cruise_speed_mph);
+            EXPECT_EQ(params.full_charge_flight_time_hours, formula);
+            EXPECT_EQ(params.full_charge_flight_distance_miles, formula * spec.cruise_speed_mph);
+            EXPECT_EQ(aircraft.get_manufacturer(), std::string(spec.manufacturer));
+            aircraft.discharge_battery();
+            EXPECT_EQ(aircraft.get_flight_time_hours(), 0.0);
+
+            // Levels other than full take the general expression
+            partial.add_aircraft(T::get_aircraft_type(), static_cast<int>(partial.size()), 0.5);
+            EXPECT_DOUBLE_EQ(partial[partial.size() - 1].get_flight_time_hours(), 0.5 * formula);
+            EXPECT_DOUBLE_EQ(partial[partial.size() - 1].get_flight_distance_miles(), 0.5 * formula * spec.cruise_speed_mph); });
+    }
+
+    // Test 23: Bulk fills and cross-stream prefetches match single draws, and the exponential fault model takes one draw per flight
+    TEST_F(CoreFunctionalityTest, BulkFillsAndExponentialFaultModel)
+    {
+        // Odd starting offsets and lengths cover the half-used block and the scalar tail
+        for (size_t offset : {0u, 1u, 5u})
+        {
+            evtol::RandomStream single(99, 4);
+            evtol::RandomStream bulk(99, 4);
+            for (size_t i = 0; i < offset; ++i)
+            {
+                single.next_uniform();
+                bulk.next_uniform();
+            }
+            std::vector<double> block(3 * evtol::RandomStream::FILL_LANES + 3);
+            bulk.fill_uniforms(block);
+            for (double value : block)
+            {
+                EXPECT_EQ(value, single.next_uniform());
+            }
+            EXPECT_EQ(bulk.get_draw_index(), single.get_draw_index());
+            EXPECT_EQ(bulk.next_uniform(), single.next_uniform());
+        }
+
+        // Cross-stream prefetch: full batches, a partial one and a lone leftover, with streams on both
+        // halves of a block, already cached, or missing; the draws that follow are unchanged
+        for (size_t count : {evtol::RandomStream::FILL_LANES * 2 + 3, size_t{1}})
+        {
+            std::vector<evtol::RandomStream> plain, prefetched;
+            for (size_t i = 0; i < count; ++i)
+            {
+                plain.emplace_back(7, i);
+                prefetched.emplace_back(7, i);
+                for (size_t draw = 0; draw < i % 3; ++draw)
+                {
+                    plain[i].next_uniform();
+                    prefetched[i].next_uniform();
+                }
+            }
+            std::vector<evtol::RandomStream *> streams{nullptr};
+            for (evtol::RandomStream &stream : prefetched)
+            {
+                streams.push_back(&stream);
+            }
+            evtol::RandomStream::prefetch_blocks(streams);
+            for (size_t i = 0; i < count; ++i)
+            {
+                for (int draw = 0; draw < 3; ++draw)
+                {
+                    EXPECT_EQ(prefetched[i].next_uniform(), plain[i].next_uniform());
+                }
+                EXPECT_EQ(prefetched[i].get_draw_index(), plain[i].get_draw_index());
+            }
+        }
+
+        EXPECT_EQ(evtol::parse_fault_model("exponential"), evtol::FaultModel::EXPONENTIAL);
+        EXPECT_STREQ(evtol::fault_model_to_string(evtol::FaultModel::LINEAR), "linear");
+        EXPECT_THROW(evtol::parse_fault_model("weibull"), std::invalid_argument);
+
+        // Pointer and SoA aircraft sample the same faults, one draw each, at the exact Poisson rate
+        evtol::EchoAircraft echo(0);
+        echo.seed_random_stream(12, 0);
+        echo.set_fault_model(evtol::FaultModel::EXPONENTIAL);
+        evtol::SoaFleet soa;
+        soa.add_aircraft(evtol::AircraftType::ECHO, 0);
+        soa[0].seed_random_stream(12, 0);
+        soa[0].set_fault_model(evtol::FaultModel::EXPONENTIAL);
+
+        const int flights = 20000;
+        double flight_time = echo.get_flight_time_hours();
+        int faults = 0;
+        for (int i = 0; i < flights; ++i)
+        {
+            double fault_time = echo.check_fault_during_flight(flight_time);
+            EXPECT_EQ(soa[0].check_fault_during_flight(flight_time), fault_time);
+            EXPECT_LT(fault_time, flight_time);
+            faults += fault_time >= 0.0;
+        }
+        EXPECT_EQ(echo.get_random_stream().get_draw_index(), static_cast<std::uint64_t>(flights));
+        double expected = 1.0 - std::exp(-echo.get_spec().fault_probability_per_hour * flight_time);
+        EXPECT_NEAR(static_cast<double>(faults) / flights, expected, 0.015);
+
+        // The engines switch the whole fleet: every flight started is exactly one draw
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = 8;
+            config.fault_model = evtol::FaultModel::EXPONENTIAL;
+            config.simulation_duration_hours = 6.0;
+            config.num_threads = 1;
+            auto fleet = evtol::AircraftFactory<>::create_fleet(config.fleet_size);
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers(config.get_charger_pools());
+            evtol::SimulationRunner(stats, config).run_simulation(chargers, fleet);
+
+            std::uint64_t draws = 0;
+            for (const auto &aircraft : fleet)
+            {
+                draws += aircraft->save_state().rng_draw_index;
+            }
+            evtol::FlightStats totals = evtol::BatchStatistics::fleet_totals(evtol::BatchStatistics::capture(stats));
+            EXPECT_GT(totals.total_faults, 0);
+            EXPECT_GT(totals.partial_flight_count, 0);
+            EXPECT_EQ(draws, static_cast<std::uint64_t>(totals.flight_count)); // flight_count includes partial flights
+        }
+    }
+
+    // Test 24: Seqlock progress snapshots are never torn, and engines publish only on request and at the end
+    TEST_F(CoreFunctionalityTest, ProgressSnapshotsAreConsistent)
+    {
+        struct Words
+        {
+            std::array<std::uint64_t, 16> values;
+        };
+
+        // A reader racing the writer sees whole stores, in order
+        evtol::SeqlockSlot<Words> slot;
+        Words value{};
+        EXPECT_FALSE(slot.load(value));
+        const std::uint64_t stores = 200000;
+        std::atomic<bool> torn{false};
+        std::atomic<bool> backwards{false};
+        std::thread reader([&]
+                           {
+            std::uint64_t last = 0;
+            Words seen{};
+            while (last < stores)
+            {
+                if (!slot.load(seen))
+                {
+                    continue;
+                }
+                for (std::uint64_t word : seen.values)
+                {
+                    torn = torn || word != seen.values[0];
+                }
+                backwards = backwards || seen.values[0] < last;
+                last = seen.values[0];
+            } });
+        for (std::uint64_t k = 1; k <= stores; ++k)
+        {
+            value.values.fill(k);
+            slot.store(value);
+        }
+        reader.join();
+        EXPECT_FALSE(torn);
+        EXPECT_FALSE(backwards);
+        EXPECT_EQ(slot.store_count(), stores);
+
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = 4;
+            config.num_threads = 1;
+
+            // Unrequested, only the final snapshot is published; a request is served at the next event or frame
+            for (bool requested : {false, true})
+            {
+                evtol::StatisticsCollector stats;
+                evtol::ChargerManager chargers(config.get_charger_pools());
+                evtol::ProgressChannel channel;
+                if (requested)
+                {
+                    channel.request();
+                }
+                auto engine = evtol::SimulationFactory::create_engine(config, stats);
+                engine->set_progress_channel(&channel);
+                auto fleet = evtol::AircraftFactory<>::create_fleet(config.fleet_size);
+                engine->run_simulation(chargers, fleet);
+
+                EXPECT_EQ(channel.publish_count(), requested ? 2u : 1u);
+                EXPECT_FALSE(channel.requested());
+                evtol::ProgressSnapshot snapshot;
+                ASSERT_TRUE(channel.read(snapshot));
+                EXPECT_TRUE(snapshot.finished);
+                EXPECT_DOUBLE_EQ(snapshot.time_hours, config.simulation_duration_hours);
+                evtol::SummaryStats summary = stats.get_summary_stats();
+                EXPECT_EQ(snapshot.summary.total_flights, summary.total_flights);
+                EXPECT_EQ(snapshot.summary.total_faults, summary.total_faults);
+                EXPECT_DOUBLE_EQ(snapshot.summary.total_flight_time, summary.total_flight_time);
+                EXPECT_EQ(snapshot.total_chargers, chargers.get_total_chargers());
+                EXPECT_EQ(snapshot.chargers_in_use, chargers.get_active_chargers());
+                EXPECT_EQ(snapshot.flights_by_type[0], stats.shard().by_type()[0].flight_count);
+                EXPECT_NE(snapshot.to_string().find("(done)"), std::string::npos);
+            }
+        }
+
+        // The runner owns the channel and runs the monitor only with progress_seconds set
+        evtol::SimulationConfig config;
+        config.random_seed = 4;
+        config.num_threads = 1;
+        EXPECT_EQ(evtol::SimulationRunner(*stats_collector_, config).get_progress_channel(), nullptr);
+        config.progress_seconds = 60.0;
+        evtol::SimulationRunner runner(*stats_collector_, config);
+        ASSERT_NE(runner.get_progress_channel(), nullptr);
+        auto fleet = evtol::AircraftFactory<>::create_fleet(config.fleet_size);
+        runner.run_simulation(*charger_manager_, fleet);
+        evtol::ProgressSnapshot snapshot;
+        ASSERT_TRUE(runner.get_progress_channel()->read(snapshot));
+        EXPECT_TRUE(snapshot.finished);
+        EXPECT_EQ(snapshot.summary.total_flights, stats_collector_->get_summary_stats().total_flights);
+    }
+
+    // Test 25: The indexed 4-ary heap serves by priority then arrival, and chargers dispatch by policy
+    TEST_F(CoreFunctionalityTest, DispatchPoliciesServeWaitingAircraftByPriority)
+    {
+        // Random pushes, reprioritizations and removals, checked against the tracked priorities and arrivals
+        evtol::IndexedDaryHeap<4> heap;
+        evtol::RandomStream rng(11, 0);
+        int arrivals = 0;
+        std::vector<int> arrival_of(400, -1);
+        std::vector<double> priority_of(400, -1.0);
+        for (int step = 0; step < 4000; ++step)
+        {
+            int id = static_cast<int>(rng.next_uniform() * 400.0);
+            double priority = std::floor(rng.next_uniform() * 8.0); // many ties
+            double action = rng.next_uniform();
+            if (!heap.contains(id))
+            {
+                heap.push(id, priority);
+                arrival_of[static_cast<size_t>(id)] = arrivals++;
+                priority_of[static_cast<size_t>(id)] = priority;
+            }
+            else if (action < 0.4)
+            {
+                EXPECT_TRUE(heap.update(id, priority));
+                priority_of[static_cast<size_t>(id)] = priority;
+            }
+            else if (action < 0.7)
+            {
+                EXPECT_TRUE(heap.erase(id));
+                priority_of[static_cast<size_t>(id)] = -1.0;
+            }
+            else
+            {
+                int top = heap.top().id;
+                for (int other = 0; other < 400; ++other)
+                {
+                    double p = priority_of[static_cast<size_t>(other)];
+                    if (p >= 0.0 && other != top)
+                    {
+                        double top_p = priority_of[static_cast<size_t>(top)];
+                        EXPECT_TRUE(top_p < p || (top_p == p && arrival_of[static_cast<size_t>(top)] < arrival_of[static_cast<size_t>(other)]));
+                    }
+                }
+                EXPECT_EQ(heap.pop(), top);
+                priority_of[static_cast<size_t>(top)] = -1.0;
+            }
+        }
+        EXPECT_THROW(heap.push(heap.top().id, 0.0), std::logic_error);
+        EXPECT_FALSE(heap.erase(-5));
+        std::vector<evtol::IndexedDaryHeap<4>::Entry> in_order = heap.entries_in_order();
+        for (const auto &entry : in_order)
+        {
+            EXPECT_EQ(heap.pop(), entry.id);
+        }
+        EXPECT_TRUE(heap.empty());
+
+        // Beta (0.2 h charge) is served before Charlie (0.8 h) and Alpha (0.6 h) under shortest-charge-first
+        evtol::ChargerManager chargers(1, evtol::DispatchPolicy::SHORTEST_CHARGE_FIRST);
+        chargers.request_charger(0);
+        auto alpha = std::make_unique<evtol::AlphaAircraft>(1);
+        auto charlie = std::make_unique<evtol::CharlieAircraft>(2);
+        auto beta = std::make_unique<evtol::BetaAircraft>(3);
+        chargers.queue_for_charger(charlie);
+        chargers.queue_for_charger(alpha);
+        chargers.queue_for_charger(beta);
+        EXPECT_EQ(chargers.waiting_order(), (std::vector<int>{3, 1, 2}));
+        EXPECT_EQ(chargers.waiting_queue().front(), 3);
+        EXPECT_DOUBLE_EQ(chargers.waiting_queue().priority_of(2), 0.8);
+        EXPECT_TRUE(chargers.reprioritize(2, 0.0)); // Charlie jumps the queue
+        EXPECT_TRUE(chargers.remove_from_queue(1));
+        EXPECT_FALSE(chargers.is_queued(1));
+        EXPECT_EQ(chargers.get_queue_size(), 2);
+        chargers.release_charger(0);
+        EXPECT_EQ(chargers.get_next_from_queue(), 2);
+        EXPECT_EQ(chargers.get_next_from_queue(), 3);
+
+        // FIFO queues index their ids too: a second add is rejected, removal keeps the others' order
+        evtol::ChargerManager first_come(1);
+        for (int id : {5, 9, 7, 1 << 25})
+        {
+            first_come.add_to_queue(id);
+        }
+        EXPECT_THROW(first_come.add_to_queue(9), std::logic_error);
+        EXPECT_THROW(first_come.add_to_queue(1 << 25), std::logic_error);
+        EXPECT_TRUE(first_come.remove_from_queue(5));
+        EXPECT_FALSE(first_come.remove_from_queue(5));
+        EXPECT_TRUE(first_come.remove_from_queue(7));
+        EXPECT_FALSE(first_come.is_queued(7));
+        EXPECT_EQ(first_come.waiting_queue().front(), 9);
+        first_come.add_to_queue(5);
+        EXPECT_EQ(first_come.waiting_order(), (std::vector<int>{9, 1 << 25, 5}));
+        EXPECT_EQ(first_come.get_next_from_queue(0), 9);
+        EXPECT_EQ(first_come.get_queue_size(), 2);
+
+        // Removals anywhere leave stale records behind; the rest are still served in arrival order
+        evtol::ArrivalQueue fifo_queue;
+        std::deque<int> expected;
+        std::mt19937 arrival_rng(31);
+        for (int step = 0; step < 3000; ++step)
+        {
+            int id = static_cast<int>(arrival_rng() % 300);
+            if (!fifo_queue.contains(id))
+            {
+                fifo_queue.push(id);
+                expected.push_back(id);
+            }
+            else if (arrival_rng() % 3 != 0)
+            {
+                EXPECT_TRUE(fifo_queue.erase(id));
+                expected.erase(std::find(expected.begin(), expected.end(), id));
+            }
+            else
+            {
+                EXPECT_EQ(fifo_queue.pop(), expected.front());
+                expected.pop_front();
+            }
+            ASSERT_EQ(fifo_queue.size(), expected.size());
+        }
+        std::vector<int> arrival_order;
+        for (const auto &entry : fifo_queue.entries_in_order())
+        {
+            arrival_order.push_back(entry.id);
+        }
+        EXPECT_EQ(arrival_order, std::vector<int>(expected.begin(), expected.end()));
+
+        // A checkpoint keeps the priorities and only restores under the same policy
+        evtol::ChargerManager saved(1, evtol::DispatchPolicy::MOST_PASSENGERS_FIRST);
+        saved.request_charger(0);
+        saved.queue_for_charger(alpha);   // 4 passengers
+        saved.queue_for_charger(charlie); // 3
+        saved.queue_for_charger(beta);    // 5
+        evtol::SnapshotWriter out;
+        saved.save_state(out);
+        evtol::ChargerManager restored(1, evtol::DispatchPolicy::MOST_PASSENGERS_FIRST);
+        evtol::SnapshotReader in(out.data());
+        restored.restore_state(in);
+        EXPECT_EQ(restored.waiting_order(), (std::vector<int>{3, 1, 2}));
+        evtol::ChargerManager fifo(1);
+        evtol::SnapshotReader fifo_in(out.data());
+        EXPECT_THROW(fifo.restore_state(fifo_in), std::runtime_error);
+
+        // Whole runs under contention: the policy changes who waits, and the report names it
+        evtol::SimulationConfig config;
+        config.simulation_duration_hours = 12.0;
+        config.random_seed = 5;
+        config.num_chargers = 2;
+        auto run_with = [&](evtol::DispatchPolicy policy)
+        {
+            config.dispatch_policy = policy;
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager charger_mgr = config.make_charger_manager();
+            auto fleet = evtol::AircraftFactory<>::create_fleet(60);
+            stats.set_aircraft_counts(fleet);
+            evtol::SimulationRunner runner(stats, config);
+            runner.run_simulation(charger_mgr, fleet);
+            return std::make_pair(stats.shard().get(evtol::AircraftType::BETA).total_waiting_time_hours, stats.generate_report());
+        };
+        auto [fifo_beta_wait, fifo_report] = run_with(evtol::DispatchPolicy::FIFO);
+        auto [scf_beta_wait, scf_report] = run_with(evtol::DispatchPolicy::SHORTEST_CHARGE_FIRST);
+        EXPECT_LT(scf_beta_wait, fifo_beta_wait);
+        EXPECT_EQ(fifo_report.find("Dispatch Policy"), std::string::npos);
+        EXPECT_NE(scf_report.find("Dispatch Policy: shortest-charge"), std::string::npos);
+    }
+
+} // namespace evtol_test
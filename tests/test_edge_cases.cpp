@@ -1,4 +1,6 @@
 #include "test_utilities.h"
+#include "simulation_runner.h"
+#include "simulation_log.h"
 
 namespace evtol_test
 {
@@ -125,4 +127,209 @@ namespace evtol_test
         }
     }
 
-} // namespace evtol_test
\ No newline at end of file
+    // Test 7: Non-contiguous aircraft ids still resolve in O(1) to fleet positions
+    TEST_F(EdgeCasesTest, SparseAircraftIdsResolveToFleetPositions)
+    {
+        std::vector<std::unique_ptr<evtol::AircraftBase>> fleet;
+        for (int id : {40, 3, 17, 8, 25})
+        {
+            fleet.emplace_back(std::make_unique<MockAircraft>(id));
+        }
+
+        evtol::FleetIndex index;
+        index.build(fleet);
+        EXPECT_EQ(index.index_of(40), 0u);
+        EXPECT_EQ(index.index_of(3), 1u);
+        EXPECT_EQ(index.index_of(25), 4u);
+        EXPECT_EQ(index.index_of(4), evtol::FleetIndex::npos);
+        EXPECT_EQ(index.index_of(-1), evtol::FleetIndex::npos);
+        EXPECT_EQ(index.index_of(1000), evtol::FleetIndex::npos);
+
+        // More aircraft than chargers, so queued aircraft are looked up by id
+        evtol::EventDrivenSimulation sim_engine(*stats_collector_, 3.0);
+        sim_engine.run_simulation(*charger_manager_, fleet);
+
+        auto summary = stats_collector_->get_summary_stats();
+        EXPECT_GE(summary.total_flights, 5);
+        EXPECT_GT(summary.total_waiting_time, 0.0);
+    }
+
+    // Test 8: Partial events scheduled exactly at the time limit are all finalized
+    TEST_F(EdgeCasesTest, EventsAtTimeLimitAreFinalized)
+    {
+        std::vector<std::unique_ptr<evtol::AircraftBase>> fleet;
+        for (int id = 0; id < 4; ++id)
+        {
+            fleet.emplace_back(std::make_unique<MockAircraft>(id));
+        }
+
+        // Every 0.5h flight is still airborne at 0.25h, so each becomes a partial event at the limit
+        evtol::EventDrivenSimulation sim_engine(*stats_collector_, 0.25);
+        sim_engine.run_simulation(*charger_manager_, fleet);
+
+        const auto &stats = stats_collector_->get_stats(evtol::AircraftType::ALPHA);
+        EXPECT_EQ(stats.partial_flight_count, 4);
+        EXPECT_EQ(stats.flight_count, stats.partial_flight_count);
+        EXPECT_NEAR_TOLERANCE(stats.partial_flight_time_hours, 1.0);
+    }
+
+    // Test 9: Charger counts are configurable, and bad pool specs are rejected up front
+    TEST_F(EdgeCasesTest, ChargerConfigurationIsValidated)
+    {
+        evtol::SimulationConfig config;
+        EXPECT_EQ(config.get_charger_pools().size(), 1u);
+        EXPECT_EQ(config.get_charger_pools()[0].charger_count, 3);
+
+        config.num_chargers = 0;
+        EXPECT_FALSE(config.validate());
+        config.num_chargers = 3;
+        config.charger_pools = {{"north", 2}, {"south", 0}};
+        EXPECT_FALSE(config.validate());
+
+        EXPECT_THROW(evtol::ChargerManager(std::vector<evtol::ChargerPoolSpec>{}), std::invalid_argument);
+        EXPECT_THROW(evtol::ChargerManager(-1), std::invalid_argument);
+
+        evtol::ChargerManager chargers(2);
+        EXPECT_THROW(chargers.find_pool("missing"), std::invalid_argument);
+        EXPECT_THROW(chargers.waiting_queue(1), std::out_of_range);
+        EXPECT_EQ(chargers.get_aircraft_at_charger(5), -1);
+        EXPECT_FALSE(chargers.is_charger_occupied(-1));
+
+        // With a charger per aircraft nobody ever waits
+        auto fleet = evtol::AircraftFactory<>::create_fleet(10);
+        evtol::ChargerManager plenty(10);
+        evtol::SimulationConfig frame_config;
+        frame_config.mode = evtol::SimulationMode::FRAME_BASED;
+        frame_config.random_seed = 3;
+        evtol::SimulationRunner(*stats_collector_, frame_config).run_simulation(plenty, fleet);
+        EXPECT_GT(stats_collector_->get_summary_stats().total_charges, 0);
+        EXPECT_DOUBLE_EQ(stats_collector_->get_summary_stats().total_waiting_time, 0.0);
+    }
+
+    // Test 10: Detailed logging only formats messages when it is switched on
+    TEST_F(EdgeCasesTest, DetailedLoggingIsLazy)
+    {
+        int formatted = 0;
+        ::testing::internal::CaptureStdout();
+        evtol::write_log_event(1.5, [&]
+                               { ++formatted; return std::string("message"); });
+        EXPECT_EQ(::testing::internal::GetCapturedStdout(), "[1.5h] message\n");
+        EXPECT_EQ(formatted, 1);
+
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            for (bool logging : {false, true})
+            {
+                evtol::SimulationConfig config;
+                config.mode = mode;
+                config.random_seed = 2;
+                config.enable_detailed_logging = logging;
+
+                evtol::StatisticsCollector stats;
+                evtol::ChargerManager chargers;
+                auto fleet = evtol::AircraftFactory<>::create_fleet(5);
+
+                ::testing::internal::CaptureStdout();
+                evtol::SimulationRunner(stats, config).run_simulation(chargers, fleet);
+                std::string output = ::testing::internal::GetCapturedStdout();
+
+                if (logging && evtol::DETAILED_LOGGING_COMPILED_IN)
+                {
+                    EXPECT_NE(output.find("completed flight"), std::string::npos);
+                }
+                else
+                {
+                    EXPECT_EQ(output, "");
+                }
+            }
+        }
+    }
+
+    // Test 11: A checkpoint only resumes the set-up it was taken from
+    TEST_F(EdgeCasesTest, MismatchedCheckpointsAreRejected)
+    {
+        evtol::SimulationConfig config;
+        config.random_seed = 5;
+        config.simulation_duration_hours = 3.0;
+        config.checkpoint.every_hours = 2.0;
+        config.checkpoint.path_prefix = ::testing::TempDir() + "evtol_mismatch";
+        std::string path = evtol::checkpoint_file_name(config.checkpoint.path_prefix, 2.0);
+        {
+            evtol::ChargerManager chargers;
+            auto fleet = evtol::AircraftFactory<>::create_fleet(10);
+            evtol::SimulationRunner(*stats_collector_, config).run_simulation(chargers, fleet);
+        }
+
+        auto resume = [&](evtol::SimulationConfig resume_config, int fleet_size, evtol::ChargerManager chargers)
+        {
+            resume_config.checkpoint.every_hours = 0.0;
+            resume_config.checkpoint.restore_path = path;
+            evtol::StatisticsCollector stats;
+            auto fleet = evtol::AircraftFactory<>::create_fleet(fleet_size);
+            evtol::SimulationRunner(stats, resume_config).run_simulation(chargers, fleet);
+        };
+
+        EXPECT_NO_THROW(resume(config, 10, evtol::ChargerManager(3)));
+        EXPECT_THROW(resume(config, 11, evtol::ChargerManager(3)), std::runtime_error);
+        EXPECT_THROW(resume(config, 10, evtol::ChargerManager(4)), std::runtime_error);
+
+        evtol::SimulationConfig frame_config = config;
+        frame_config.mode = evtol::SimulationMode::FRAME_BASED;
+        EXPECT_THROW(resume(frame_config, 10, evtol::ChargerManager(3)), std::runtime_error);
+
+        evtol::SimulationConfig too_short = config;
+        too_short.simulation_duration_hours = 1.0;
+        EXPECT_THROW(resume(too_short, 10, evtol::ChargerManager(3)), std::runtime_error);
+
+        evtol::SimulationConfig negative = config;
+        negative.checkpoint.every_hours = -1.0;
+        EXPECT_FALSE(negative.validate());
+
+        std::remove(path.c_str());
+        evtol::SimulationConfig missing = config;
+        EXPECT_THROW(resume(missing, 10, evtol::ChargerManager(3)), std::runtime_error);
+    }
+
+    // Test 12: At the time limit, only aircraft still flying or charging end as partial activities
+    TEST_F(EdgeCasesTest, RunEndsEachAircraftFromItsTimeline)
+    {
+        for (bool partial_flights : {true, false})
+        {
+            std::vector<std::unique_ptr<evtol::AircraftBase>> fleet;
+            for (int id = 0; id < 3; ++id)
+            {
+                fleet.emplace_back(std::make_unique<MockAircraft>(id));
+            }
+            fleet.emplace_back(std::make_unique<MockAircraft>(3, evtol::AircraftType::BETA, true));
+            for (auto &aircraft : fleet)
+            {
+                aircraft->set_faulty(false);
+            }
+
+            // All land at 0.5h: aircraft 0 charges until 1.0h and is airborne again at the limit, aircraft 1
+            // then takes over the charger, aircraft 2 is still waiting and aircraft 3 is grounded by its fault
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers(1);
+            evtol::EventDrivenSimulation sim_engine(stats, 1.2, false, partial_flights);
+            sim_engine.run_simulation(chargers, fleet);
+
+            const auto &alpha = stats.get_stats(evtol::AircraftType::ALPHA);
+            int partial = partial_flights ? 1 : 0;
+            EXPECT_EQ(alpha.flight_count, 3 + partial);
+            EXPECT_EQ(alpha.partial_flight_count, partial);
+            EXPECT_NEAR_TOLERANCE(alpha.partial_flight_time_hours, 0.2 * partial);
+            EXPECT_NEAR_TOLERANCE(alpha.partial_distance_miles, 20.0 * partial);
+            EXPECT_EQ(alpha.charge_count, 1 + partial);
+            EXPECT_EQ(alpha.partial_charge_count, partial);
+            EXPECT_NEAR_TOLERANCE(alpha.partial_charging_time_hours, 0.2 * partial);
+            EXPECT_EQ(alpha.total_waiting_time_hours, 0.0) << "the wait is recorded when the charge completes";
+
+            const auto &beta = stats.get_stats(evtol::AircraftType::BETA);
+            EXPECT_EQ(beta.flight_count, 1);
+            EXPECT_EQ(beta.total_faults, 1);
+            EXPECT_EQ(beta.partial_flight_count + beta.charge_count, 0);
+            EXPECT_EQ(chargers.get_queue_size(), 1);
+        }
+    }
+
+} // namespace evtol_test
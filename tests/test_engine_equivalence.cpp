@@ -0,0 +1,337 @@
+#include "test_utilities.h"
+#include "simulation_runner.h"
+#include "soa_fleet.h"
+#include "arena_fleet.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace evtol_test
+{
+    // Differential harness: every optimized variant runs the same seeded, randomized scenarios as its
+    // reference engine and must reproduce its FlightStats field by field
+
+    constexpr std::uint64_t HARNESS_SEED = 0x45564F4Cull; // scenarios are random but the same on every run
+    constexpr double EQUIVALENCE_TOLERANCE = 1e-12;     // relative; the variants are meant to be bit-identical
+    constexpr int PARALLEL_FLEET_SIZE = 1024;           // FrameBasedSimulationEngine's threshold for parallel frames
+
+    enum class FleetKind
+    {
+        POINTER,
+        SOA,
+        ARENA
+    };
+
+    /**
+     * An optimized configuration of a reference engine
+     */
+    struct EngineVariant
+    {
+        std::string name;
+        FleetKind fleet = FleetKind::POINTER;
+        std::function<void(evtol::SimulationConfig &)> configure;
+        // Whether the run took the optimized path, for variants that fall back on some scenarios
+        std::function<bool(evtol::ISimulationEngine &)> took_fast_path;
+    };
+
+    struct RunOutcome
+    {
+        evtol::ReplicationResult stats{};
+        double seconds = 0.0;
+        bool took_fast_path = true;
+    };
+
+    /**
+     * What one variant did over all scenarios, for the report
+     */
+    struct VariantReport
+    {
+        std::string name;
+        double reference_seconds = 0.0;
+        double variant_seconds = 0.0;
+        double max_relative_error = 0.0;
+        size_t divergent_fields = 0;
+        size_t fast_path_runs = 0;
+
+        double speedup() const { return variant_seconds > 0.0 ? reference_seconds / variant_seconds : 0.0; }
+    };
+
+    class EngineEquivalenceTest : public ::testing::Test
+    {
+    protected:
+        std::mt19937_64 rng_{HARNESS_SEED};
+
+        int uniform_int(int low, int high) { return std::uniform_int_distribution<int>(low, high)(rng_); }
+        double uniform_real(double low, double high) { return std::uniform_real_distribution<double>(low, high)(rng_); }
+        bool coin() { return uniform_int(0, 1) == 1; }
+
+        /**
+         * Random scenario both engines can run: fleet, mix, duration, chargers, faults, dispatch and seed
+         * A third of the scenarios get chargers to spare, so the analytic solver has runs it can solve.
+         */
+        evtol::SimulationConfig random_scenario(evtol::SimulationMode mode, int min_fleet, int max_fleet, double max_hours)
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = std::uniform_int_distribution<std::uint64_t>()(rng_);
+            config.fleet_size = uniform_int(min_fleet, max_fleet);
+            config.simulation_duration_hours = uniform_real(0.25, max_hours);
+            config.enable_partial_flights = uniform_int(0, 3) != 0;
+            config.fault_model = coin() ? evtol::FaultModel::LINEAR : evtol::FaultModel::EXPONENTIAL;
+            config.dispatch_policy = static_cast<evtol::DispatchPolicy>(uniform_int(0, 2));
+            config.num_threads = 1;
+
+            // Weight 0 drops a type; at least one type stays
+            for (int &weight : config.fleet_mix.weights)
+            {
+                weight = uniform_int(0, 3);
+            }
+            config.fleet_mix.weights[static_cast<size_t>(uniform_int(0, evtol::NUM_AIRCRAFT_TYPES - 1))] += 1;
+
+            // A charge session every 20 minutes is more than any type manages
+            int spare = config.fleet_size * (static_cast<int>(config.simulation_duration_hours * 3.0) + 1);
+            int chargers = uniform_int(0, 2) == 0 ? spare : uniform_int(1, std::max(1, config.fleet_size / 3));
+            if (coin())
+            {
+                config.num_chargers = chargers;
+            }
+            else
+            {
+                config.charger_pools = {{"north", chargers}, {"south", uniform_int(1, chargers)}};
+            }
+
+            if (mode == evtol::SimulationMode::FRAME_BASED)
+            {
+                static constexpr double FRAME_TIMES[] = {0.5, 1.0, 7.5, 60.0, 300.0, 900.0};
+                config.frame_time_seconds = FRAME_TIMES[uniform_int(0, 5)];
+            }
+            return config;
+        }
+
+        static std::string describe(const evtol::SimulationConfig &config)
+        {
+            std::ostringstream out;
+            out << config.fleet_size << " aircraft, " << config.simulation_duration_hours << " h, ";
+            for (const auto &pool : config.get_charger_pools())
+            {
+                out << pool.charger_count << " chargers (" << pool.name << "), ";
+            }
+            if (config.mode == evtol::SimulationMode::FRAME_BASED)
+            {
+                out << config.frame_time_seconds << " s frames, ";
+            }
+            out << evtol::fault_model_to_string(config.fault_model) << " faults, "
+                << evtol::dispatch_policy_to_string(config.dispatch_policy) << " dispatch"
+                << (config.enable_partial_flights ? "" : ", no partial flights")
+                << ", seed " << *config.random_seed;
+            return out.str();
+        }
+
+        /**
+         * Time one engine run; building the fleet is not timed
+         */
+        static RunOutcome run(const evtol::SimulationConfig &config, const EngineVariant &variant)
+        {
+            evtol::SimulationConfig run_config = config;
+            if (variant.configure)
+            {
+                variant.configure(run_config);
+            }
+
+            RunOutcome outcome;
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers = run_config.make_charger_manager();
+            evtol::SimulationRunner runner(stats, run_config);
+            auto timed = [&](auto &fleet)
+            {
+                auto start = std::chrono::steady_clock::now();
+                runner.run_simulation(chargers, fleet);
+                outcome.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            };
+
+            switch (variant.fleet)
+            {
+            case FleetKind::POINTER:
+            {
+                auto fleet = evtol::AircraftFactory<>::create_fleet(run_config.fleet_size, run_config.fleet_mix);
+                timed(fleet);
+                break;
+            }
+            case FleetKind::SOA:
+            {
+                auto fleet = evtol::SoaFleet::from_fleet(evtol::AircraftFactory<>::create_fleet(run_config.fleet_size, run_config.fleet_mix));
+                timed(fleet);
+                break;
+            }
+            case FleetKind::ARENA:
+            {
+                evtol::ArenaFleet fleet(run_config.fleet_size, run_config.fleet_mix);
+                timed(fleet);
+                break;
+            }
+            }
+
+            outcome.stats = evtol::BatchStatistics::capture(stats);
+            if (variant.took_fast_path)
+            {
+                outcome.took_fast_path = variant.took_fast_path(*runner.get_engine());
+            }
+            return outcome;
+        }
+
+        /**
+         * Compare every FlightStats field of every type, failing once per divergent field
+         */
+        static void compare(const RunOutcome &actual, const RunOutcome &expected, VariantReport &report, const std::string &scenario)
+        {
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                {
+                    double want = metric.extract(expected.stats[t]);
+                    double got = metric.extract(actual.stats[t]);
+                    double error = std::abs(got - want) / std::max({std::abs(want), std::abs(got), 1.0});
+                    report.max_relative_error = std::max(report.max_relative_error, error);
+                    if (error > EQUIVALENCE_TOLERANCE)
+                    {
+                        ++report.divergent_fields;
+                        ADD_FAILURE() << report.name << " diverges on " << evtol::FleetMix::type_names[t] << " " << metric.name
+                                      << ": " << std::setprecision(17) << got << " vs reference " << want
+                                      << " (relative error " << error << ") with " << scenario;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Run the reference and every variant on each scenario, report them and return the reports
+         */
+        std::vector<VariantReport> run_harness(const EngineVariant &reference, const std::vector<evtol::SimulationConfig> &scenarios,
+                                               const std::vector<EngineVariant> &variants)
+        {
+            std::vector<VariantReport> reports;
+            for (const auto &variant : variants)
+            {
+                reports.push_back({variant.name});
+            }
+
+            for (const auto &scenario : scenarios)
+            {
+                RunOutcome expected = run(scenario, reference);
+                std::string context = describe(scenario);
+                for (size_t v = 0; v < variants.size(); ++v)
+                {
+                    RunOutcome actual = run(scenario, variants[v]);
+                    reports[v].reference_seconds += expected.seconds;
+                    reports[v].variant_seconds += actual.seconds;
+                    reports[v].fast_path_runs += actual.took_fast_path ? 1 : 0;
+                    compare(actual, expected, reports[v], context);
+                }
+            }
+
+            std::cout << "[ harness  ] " << reference.name << " vs optimized variants, " << scenarios.size()
+                      << " random scenarios (speedups of this test build, not of a release build)\n";
+            for (const auto &report : reports)
+            {
+                std::cout << "[ harness  ]   " << std::left << std::setw(36) << report.name << std::right
+                          << std::fixed << std::setprecision(2) << std::setw(6) << report.speedup() << "x"
+                          << std::scientific << std::setprecision(1) << "  max rel. error " << report.max_relative_error
+                          << std::defaultfloat << "  divergent fields " << report.divergent_fields
+                          << "  optimized path " << report.fast_path_runs << "/" << scenarios.size() << "\n";
+            }
+            return reports;
+        }
+    };
+
+    // Test 1: Fleet layouts, schedulers, the analytic solver and coroutines reproduce the event-driven engine
+    TEST_F(EngineEquivalenceTest, EventDrivenVariantsMatchReference)
+    {
+        std::vector<evtol::SimulationConfig> scenarios;
+        for (int i = 0; i < 24; ++i)
+        {
+            scenarios.push_back(random_scenario(evtol::SimulationMode::EVENT_DRIVEN, 1, 400, 24.0));
+        }
+
+        auto analytic = [](evtol::ISimulationEngine &engine)
+        { return dynamic_cast<evtol::EventDrivenSimulationEngine &>(engine).solved_analytically(); };
+        std::vector<EngineVariant> variants = {
+            {"SoA fleet", FleetKind::SOA, nullptr, nullptr},
+            {"arena fleet", FleetKind::ARENA, nullptr, nullptr},
+            {"4-ary heap", FleetKind::POINTER, [](evtol::SimulationConfig &c)
+             { c.scheduler = evtol::EventSchedulerType::QUATERNARY_HEAP; }, nullptr},
+            {"calendar queue", FleetKind::POINTER, [](evtol::SimulationConfig &c)
+             { c.scheduler = evtol::EventSchedulerType::CALENDAR_QUEUE; }, nullptr},
+            {"analytic solver", FleetKind::POINTER, [](evtol::SimulationConfig &c)
+             { c.enable_analytic_solver = true; }, analytic},
+            {"coroutines", FleetKind::POINTER, [](evtol::SimulationConfig &c)
+             { c.mode = evtol::SimulationMode::COROUTINE; }, nullptr},
+            {"SoA + calendar queue + analytic", FleetKind::SOA, [](evtol::SimulationConfig &c)
+             {
+                 c.scheduler = evtol::EventSchedulerType::CALENDAR_QUEUE;
+                 c.enable_analytic_solver = true;
+             },
+             analytic},
+        };
+
+        const EngineVariant reference{"event-driven (binary heap, pointer fleet)", FleetKind::POINTER, nullptr, nullptr};
+        auto reports = run_harness(reference, scenarios, variants);
+        for (const auto &report : reports)
+        {
+            EXPECT_EQ(report.divergent_fields, 0u) << report.name;
+            EXPECT_GT(report.fast_path_runs, 0u) << report.name << " never took its optimized path";
+        }
+        EXPECT_LT(reports[4].fast_path_runs, scenarios.size()) << "contended scenarios should fall back to the event queue";
+    }
+
+    // Test 2: The sparse frame update, parallel frames, skip-ahead and other fleet layouts reproduce full frame scans
+    TEST_F(EngineEquivalenceTest, FrameBasedVariantsMatchReference)
+    {
+        // A third of the fleets are large enough for parallel frames
+        std::vector<evtol::SimulationConfig> scenarios;
+        size_t parallel_scenarios = 0;
+        for (int i = 0; i < 12; ++i)
+        {
+            scenarios.push_back(random_scenario(evtol::SimulationMode::FRAME_BASED, 1, 200, 6.0));
+        }
+        for (int i = 0; i < 6; ++i)
+        {
+            scenarios.push_back(random_scenario(evtol::SimulationMode::FRAME_BASED, PARALLEL_FLEET_SIZE, 3 * PARALLEL_FLEET_SIZE, 2.0));
+            ++parallel_scenarios;
+        }
+
+        auto skipped_frames = [](evtol::ISimulationEngine &engine)
+        { return dynamic_cast<evtol::FrameBasedSimulationEngine &>(engine).get_skipped_frame_count() > 0; };
+        auto parallel_frames = [](evtol::ISimulationEngine &engine)
+        { return dynamic_cast<evtol::FrameBasedSimulationEngine &>(engine).get_parallel_frame_count() > 0; };
+        std::vector<EngineVariant> variants = {
+            {"sparse dispatch + SIMD timers", FleetKind::POINTER, nullptr, nullptr},
+            {"parallel frames (4 threads)", FleetKind::POINTER, [](evtol::SimulationConfig &c)
+             { c.num_threads = 4; }, parallel_frames},
+            {"skip-ahead", FleetKind::POINTER, [](evtol::SimulationConfig &c)
+             { c.enable_skip_ahead = true; }, skipped_frames},
+            {"SoA fleet", FleetKind::SOA, nullptr, nullptr},
+            {"arena fleet", FleetKind::ARENA, nullptr, nullptr},
+            {"SoA + 4 threads + skip-ahead", FleetKind::SOA, [](evtol::SimulationConfig &c)
+             {
+                 c.num_threads = 4;
+                 c.enable_skip_ahead = true;
+             },
+             [=](evtol::ISimulationEngine &engine) { return parallel_frames(engine) && skipped_frames(engine); }},
+        };
+
+        const EngineVariant reference{"frame-based (full frame scan, serial, pointer fleet)", FleetKind::POINTER,
+                                      [](evtol::SimulationConfig &c) { c.full_frame_scan = true; }, nullptr};
+        auto reports = run_harness(reference, scenarios, variants);
+        for (const auto &report : reports)
+        {
+            EXPECT_EQ(report.divergent_fields, 0u) << report.name;
+            EXPECT_GT(report.fast_path_runs, 0u) << report.name << " never took its optimized path";
+        }
+        EXPECT_EQ(reports[1].fast_path_runs, parallel_scenarios) << "every large fleet should step its frames in parallel";
+    }
+
+} // namespace evtol_test
@@ -1,4 +1,16 @@
 #include "test_utilities.h"
+#include "simulation_runner.h"
+#include "soa_fleet.h"
+#include "sweep_runner.h"
+#include "scenario_file.h"
+#include "distributed_batch.h"
+#include "arena_fleet.h"
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <thread>
 
 namespace evtol_test
 {
@@ -149,4 +161,1100 @@ namespace evtol_test
         EXPECT_LE(charger_manager_->get_active_chargers(), 3);
     }
 
-} // namespace evtol_test
\ No newline at end of file
+    // Test 7: Batch replications run independently and aggregate into one report
+    TEST_F(SystemBehaviorTest, BatchReplicationsAggregateResults)
+    {
+        evtol::SimulationConfig config;
+        config.simulation_duration_hours = 2.0;
+        config.replications = 8;
+        config.num_threads = 2;
+
+        evtol::SimulationRunner runner(*stats_collector_, config);
+        auto batch = runner.run_replications([]
+                                             { return evtol::AircraftFactory<>::create_fleet(10); });
+
+        EXPECT_EQ(batch.get_replication_count(), 8u);
+
+        int flight_count = evtol::BatchStatistics::find_metric("flight_count");
+        ASSERT_GE(flight_count, 0);
+        const auto &fleet_flights = batch.get_fleet_metric(static_cast<size_t>(flight_count));
+        EXPECT_EQ(fleet_flights.count(), 8u);
+        EXPECT_GE(fleet_flights.mean(), 10.0); // every aircraft flies at least once per replication
+        EXPECT_GE(fleet_flights.ci95_half_width(), 0.0);
+
+        // The shared collector passed to the runner is untouched by batch runs
+        EXPECT_EQ(stats_collector_->get_summary_stats().total_flights, 0);
+
+        std::string report = batch.generate_report();
+        EXPECT_NE(report.find("8 replications"), std::string::npos);
+        EXPECT_NE(report.find("95% CI"), std::string::npos);
+
+        // A replication that throws on a pool thread reaches the caller, and the pool stays usable
+        evtol::ThreadPool pool(3);
+        std::atomic<size_t> ran{0};
+        EXPECT_THROW(pool.parallel_for(64, [&](size_t index, size_t)
+                                       {
+                                           ++ran;
+                                           if (index == 5)
+                                           {
+                                               throw std::runtime_error("replication failed");
+                                           } }),
+                     std::runtime_error);
+        EXPECT_LE(ran.load(), 64u);
+        ran = 0;
+        pool.parallel_for(64, [&](size_t, size_t)
+                          { ++ran; });
+        EXPECT_EQ(ran.load(), 64u);
+    }
+
+    // Test 8: Runs with the same seed produce identical statistics in both engines
+    TEST_F(SystemBehaviorTest, SeededRunsAreReproducible)
+    {
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = 20240601;
+
+            auto run_once = [&]
+            {
+                evtol::StatisticsCollector stats;
+                evtol::ChargerManager chargers;
+                auto fleet = evtol::AircraftFactory<>::create_fleet(20);
+                auto engine = evtol::SimulationFactory::create_engine(config, stats);
+                engine->run_simulation(chargers, fleet);
+                return stats.get_summary_stats();
+            };
+
+            auto first = run_once();
+            auto second = run_once();
+
+            EXPECT_EQ(first.total_flights, second.total_flights);
+            EXPECT_EQ(first.total_charges, second.total_charges);
+            EXPECT_EQ(first.total_faults, second.total_faults);
+            EXPECT_EQ(first.total_flight_time, second.total_flight_time);
+            EXPECT_EQ(first.total_waiting_time, second.total_waiting_time);
+            EXPECT_EQ(first.total_passenger_miles, second.total_passenger_miles);
+        }
+    }
+
+    // Test 9: The runner hands non-pointer fleets to the engine templates and matches the pointer fleet
+    TEST_F(SystemBehaviorTest, RunnerAcceptsCustomFleetContainers)
+    {
+        static_assert(evtol::SimulationFleet<evtol::AircraftFleet>);
+        static_assert(evtol::SimulationFleet<evtol::SoaFleet>);
+        static_assert(!evtol::SimulationFleet<std::vector<int>>);
+
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = 7;
+
+            evtol::StatisticsCollector pointer_stats;
+            evtol::ChargerManager pointer_chargers;
+            auto pointer_fleet = evtol::AircraftFactory<>::create_fleet(20);
+            auto soa_fleet = evtol::SoaFleet::from_fleet(pointer_fleet);
+            evtol::SimulationRunner(pointer_stats, config).run_simulation(pointer_chargers, pointer_fleet);
+
+            evtol::StatisticsCollector soa_stats;
+            evtol::ChargerManager soa_chargers;
+            evtol::SimulationRunner soa_runner(soa_stats, config);
+            soa_runner.run_simulation(soa_chargers, soa_fleet);
+
+            auto expected = pointer_stats.get_summary_stats();
+            auto actual = soa_stats.get_summary_stats();
+            EXPECT_GT(actual.total_flights, 0);
+            EXPECT_EQ(actual.total_flights, expected.total_flights);
+            EXPECT_EQ(actual.total_faults, expected.total_faults);
+            EXPECT_EQ(actual.total_flight_time, expected.total_flight_time);
+            EXPECT_EQ(actual.total_waiting_time, expected.total_waiting_time);
+            EXPECT_DOUBLE_EQ(soa_runner.get_current_time(), config.simulation_duration_hours);
+
+            config.replications = 4;
+            config.num_threads = 2;
+            evtol::StatisticsCollector unused_stats;
+            evtol::SimulationRunner batch_runner(unused_stats, config);
+            auto pointer_batch = batch_runner.run_replications([]
+                                                               { return evtol::AircraftFactory<>::create_fleet(20); });
+            auto soa_batch = batch_runner.run_replications([]
+                                                           { return evtol::SoaFleet::from_fleet(evtol::AircraftFactory<>::create_fleet(20)); });
+            int flight_count = evtol::BatchStatistics::find_metric("flight_count");
+            EXPECT_EQ(soa_batch.get_fleet_metric(flight_count).mean(), pointer_batch.get_fleet_metric(flight_count).mean());
+        }
+    }
+
+    // Test 10: The simulation is bit-identical whichever event scheduler is selected
+    TEST_F(SystemBehaviorTest, EventSchedulersProduceIdenticalResults)
+    {
+        auto run_with = [](evtol::EventSchedulerType scheduler)
+        {
+            evtol::SimulationConfig config;
+            config.simulation_duration_hours = 24.0;
+            config.random_seed = 42;
+            config.scheduler = scheduler;
+
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers;
+            auto fleet = evtol::AircraftFactory<>::create_fleet(200);
+            evtol::SimulationRunner(stats, config).run_simulation(chargers, fleet);
+            return evtol::BatchStatistics::capture(stats);
+        };
+
+        auto expected = run_with(evtol::EventSchedulerType::BINARY_HEAP);
+        for (auto scheduler : {evtol::EventSchedulerType::QUATERNARY_HEAP, evtol::EventSchedulerType::CALENDAR_QUEUE})
+        {
+            auto actual = run_with(scheduler);
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                {
+                    EXPECT_EQ(metric.extract(actual[t]), metric.extract(expected[t]))
+                        << metric.name << " differs with scheduler " << evtol::scheduler_type_to_string(scheduler);
+                }
+            }
+        }
+        EXPECT_GT(expected[0].flight_count, 0);
+    }
+
+    // Test 11: The parallel frame update matches the serial one bit for bit
+    TEST_F(SystemBehaviorTest, ParallelFrameUpdateMatchesSerial)
+    {
+        // 900s frames are longer than Beta's charge time, so a charger handed to a higher-index
+        // aircraft can also finish within the same frame
+        for (double frame_time : {60.0, 900.0})
+        {
+            auto run_with = [&](int threads)
+            {
+                evtol::SimulationConfig config;
+                config.mode = evtol::SimulationMode::FRAME_BASED;
+                config.simulation_duration_hours = 6.0;
+                config.frame_time_seconds = frame_time;
+                config.random_seed = 11;
+                config.num_threads = threads;
+
+                evtol::StatisticsCollector stats;
+                evtol::ChargerManager chargers;
+                auto fleet = evtol::AircraftFactory<>::create_fleet(3000);
+                evtol::SimulationRunner(stats, config).run_simulation(chargers, fleet);
+                return evtol::BatchStatistics::capture(stats);
+            };
+
+            auto serial = run_with(1);
+            for (int threads : {2, 5})
+            {
+                auto parallel = run_with(threads);
+                for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+                {
+                    for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                    {
+                        EXPECT_EQ(metric.extract(parallel[t]), metric.extract(serial[t]))
+                            << metric.name << " with " << threads << " threads, frame " << frame_time << "s";
+                    }
+                }
+            }
+            EXPECT_GT(evtol::BatchStatistics::fleet_totals(serial).charge_count, 0);
+        }
+    }
+
+    // Test 12: Skip-ahead frames give exactly the statistics of full frame stepping
+    TEST_F(SystemBehaviorTest, SkipAheadMatchesFrameStepping)
+    {
+        // 60s and 1s are exact in bulk; 0.1s exercises the per-frame fallback
+        for (double frame_time : {60.0, 1.0, 0.1})
+        {
+            auto run_with = [&](bool skip_ahead, size_t &skipped)
+            {
+                evtol::SimulationConfig config;
+                config.mode = evtol::SimulationMode::FRAME_BASED;
+                config.simulation_duration_hours = 4.0;
+                config.frame_time_seconds = frame_time;
+                config.random_seed = 5;
+                config.enable_skip_ahead = skip_ahead;
+
+                evtol::StatisticsCollector stats;
+                evtol::ChargerManager chargers;
+                auto fleet = evtol::AircraftFactory<>::create_fleet(20);
+                evtol::FrameBasedSimulationEngine engine(stats, config);
+                engine.run_frame_based_simulation(chargers, fleet);
+                skipped = engine.get_skipped_frame_count();
+                return evtol::BatchStatistics::capture(stats);
+            };
+
+            size_t stepped_skips = 0;
+            size_t skipped = 0;
+            auto stepped = run_with(false, stepped_skips);
+            auto skipping = run_with(true, skipped);
+
+            EXPECT_EQ(stepped_skips, 0u);
+            EXPECT_GT(skipped, 0u) << "frame " << frame_time << "s";
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                {
+                    EXPECT_EQ(metric.extract(skipping[t]), metric.extract(stepped[t]))
+                        << metric.name << " with frame " << frame_time << "s";
+                }
+            }
+        }
+    }
+
+    // Test 13: Percentile histograms see every completed flight and charge without changing the totals
+    TEST_F(SystemBehaviorTest, PercentileDistributionsTrackEngineActivity)
+    {
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.simulation_duration_hours = 6.0;
+            config.random_seed = 9;
+            config.enable_partial_flights = false;
+
+            auto run_with = [&](bool percentiles)
+            {
+                auto stats = std::make_unique<evtol::StatisticsCollector>();
+                if (percentiles)
+                {
+                    stats->enable_distributions();
+                }
+                evtol::ChargerManager chargers;
+                auto fleet = evtol::AircraftFactory<>::create_fleet(20);
+                evtol::SimulationRunner runner(*stats, config);
+                runner.run_simulation(chargers, fleet);
+                return stats;
+            };
+
+            auto plain = run_with(false);
+            auto tracked = run_with(true);
+            ASSERT_FALSE(plain->has_distributions());
+            ASSERT_TRUE(tracked->has_distributions());
+
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                auto type = static_cast<evtol::AircraftType>(t);
+                const evtol::FlightStats &stats = tracked->get_stats(type);
+                const evtol::TypeDistributions &distributions = tracked->get_distributions(type);
+                EXPECT_EQ(stats.flight_count, plain->get_stats(type).flight_count);
+                EXPECT_EQ(stats.total_waiting_time_hours, plain->get_stats(type).total_waiting_time_hours);
+                EXPECT_EQ(distributions.flight_time_hours.count(), static_cast<std::uint64_t>(stats.flight_count));
+                EXPECT_EQ(distributions.charge_wait_hours.count(), static_cast<std::uint64_t>(stats.charge_count));
+                EXPECT_LE(distributions.charge_wait_hours.value_at_percentile(50.0),
+                          distributions.charge_wait_hours.value_at_percentile(99.0));
+            }
+
+            // 20 aircraft on 3 chargers queue up, so the tail of the arrival queue is not empty
+            evtol::TypeDistributions fleet = tracked->get_fleet_distributions();
+            EXPECT_GT(fleet.queue_length.value_at_percentile(99.0), 0.0);
+            EXPECT_NE(tracked->generate_report().find("Charge Wait p50/p95/p99"), std::string::npos);
+        }
+
+        // Batches pool the histograms of every replication
+        evtol::SimulationConfig batch_config;
+        batch_config.simulation_duration_hours = 3.0;
+        batch_config.random_seed = 1;
+        batch_config.replications = 4;
+        batch_config.num_threads = 2;
+        batch_config.enable_percentiles = true;
+        batch_config.enable_partial_flights = false;
+        evtol::StatisticsCollector unused;
+        evtol::SimulationRunner runner(unused, batch_config);
+        auto batch = runner.run_replications([]
+                                             { return evtol::AircraftFactory<>::create_fleet(20); });
+        ASSERT_TRUE(batch.has_distributions());
+
+        int flight_metric = evtol::BatchStatistics::find_metric("flight_count");
+        for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+        {
+            auto type = static_cast<evtol::AircraftType>(t);
+            double total_flights = batch.get_metric(type, static_cast<size_t>(flight_metric)).mean() * 4.0;
+            EXPECT_NEAR(static_cast<double>(batch.get_distributions(type).flight_time_hours.count()), total_flights, 1e-9);
+        }
+        EXPECT_NE(batch.generate_report().find("charge_wait_hours"), std::string::npos);
+    }
+
+    // Test 14: Both engines trace every completed and partial activity they record in the statistics
+    TEST_F(SystemBehaviorTest, EventTraceMatchesRecordedStatistics)
+    {
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            std::string path = ::testing::TempDir() + "evtol_engine_trace.bin";
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.simulation_duration_hours = 5.0;
+            config.random_seed = 4;
+            config.trace_path = path;
+
+            evtol::StatisticsCollector stats;
+            {
+                evtol::ChargerManager chargers;
+                auto fleet = evtol::AircraftFactory<>::create_fleet(20);
+                evtol::SimulationRunner runner(stats, config);
+                ASSERT_NE(runner.get_trace_writer(), nullptr);
+                runner.run_simulation(chargers, fleet);
+            }
+
+            std::array<std::array<int, evtol::NUM_TRACE_EVENT_TYPES>, evtol::NUM_AIRCRAFT_TYPES> counts{};
+            double last_time = 0.0;
+            evtol::TraceReader reader(path);
+            evtol::TraceRecord record{};
+            while (reader.next(record))
+            {
+                ASSERT_LT(record.aircraft_type, evtol::NUM_AIRCRAFT_TYPES);
+                EXPECT_GE(record.time_hours, last_time) << "trace must be in time order";
+                last_time = record.time_hours;
+                counts[record.aircraft_type][static_cast<size_t>(record.event_type)]++;
+            }
+            EXPECT_LE(last_time, config.simulation_duration_hours);
+
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                const auto &type_counts = counts[t];
+                const evtol::FlightStats &type_stats = stats.get_stats(static_cast<evtol::AircraftType>(t));
+                auto count_of = [&](evtol::TraceEventType event)
+                { return type_counts[static_cast<size_t>(event)]; };
+
+                EXPECT_EQ(count_of(evtol::TraceEventType::FLIGHT_COMPLETE) + count_of(evtol::TraceEventType::PARTIAL_FLIGHT),
+                          type_stats.flight_count);
+                EXPECT_EQ(count_of(evtol::TraceEventType::PARTIAL_FLIGHT), type_stats.partial_flight_count);
+                EXPECT_EQ(count_of(evtol::TraceEventType::CHARGE_COMPLETE) + count_of(evtol::TraceEventType::PARTIAL_CHARGE),
+                          type_stats.charge_count);
+                EXPECT_EQ(count_of(evtol::TraceEventType::FAULT), type_stats.total_faults);
+                EXPECT_GE(count_of(evtol::TraceEventType::FLIGHT_START), count_of(evtol::TraceEventType::FLIGHT_COMPLETE));
+            }
+            std::remove(path.c_str());
+        }
+    }
+
+    // Test 15: Resuming from a checkpoint, even with a longer duration or another scheduler, matches an uninterrupted run
+    TEST_F(SystemBehaviorTest, CheckpointResumeMatchesUninterruptedRun)
+    {
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            evtol::SimulationConfig config;
+            config.mode = mode;
+            config.random_seed = 9;
+            config.simulation_duration_hours = 8.0;
+            config.enable_skip_ahead = true;
+            config.checkpoint.path_prefix = ::testing::TempDir() + "evtol_resume";
+
+            auto run_with = [](const evtol::SimulationConfig &run_config)
+            {
+                evtol::StatisticsCollector stats;
+                stats.enable_distributions();
+                evtol::ChargerManager chargers({{"north", 2}, {"south", 1}});
+                auto fleet = evtol::AircraftFactory<>::create_fleet(30);
+                stats.set_aircraft_counts(fleet);
+                evtol::SimulationRunner(stats, run_config).run_simulation(chargers, fleet);
+                return stats.generate_report();
+            };
+
+            std::string expected = run_with(config);
+
+            // Checkpoints are written at 2h and 4h of a shorter run without changing its outcome
+            evtol::SimulationConfig checkpointed = config;
+            checkpointed.simulation_duration_hours = 5.0;
+            checkpointed.checkpoint.every_hours = 2.0;
+            evtol::SimulationConfig shorter = config;
+            shorter.simulation_duration_hours = 5.0;
+            EXPECT_EQ(run_with(checkpointed), run_with(shorter));
+
+            for (double hours : {2.0, 4.0})
+            {
+                evtol::SimulationConfig resumed = config;
+                resumed.scheduler = evtol::EventSchedulerType::CALENDAR_QUEUE;
+                resumed.checkpoint.restore_path = evtol::checkpoint_file_name(config.checkpoint.path_prefix, hours);
+                EXPECT_EQ(run_with(resumed), expected) << "resumed from " << hours << "h";
+
+                // A branch seed re-keys the random streams, so the run diverges from the checkpoint on
+                resumed.checkpoint.branch_seed = 1234;
+                EXPECT_NE(run_with(resumed), expected);
+            }
+
+            std::remove(evtol::checkpoint_file_name(config.checkpoint.path_prefix, 2.0).c_str());
+            std::remove(evtol::checkpoint_file_name(config.checkpoint.path_prefix, 4.0).c_str());
+        }
+    }
+
+    // Test 16: A sweep runs each distinct scenario once and reproduces the matching single runs
+    TEST_F(SystemBehaviorTest, SweepRunsDistinctScenariosLikeSingleRuns)
+    {
+        evtol::SimulationConfig base;
+        base.random_seed = 3;
+        base.simulation_duration_hours = 4.0;
+        base.num_threads = 2;
+        evtol::FleetMix doubled;
+        doubled.weights = {2, 2, 2, 2, 2};
+        base.sweep.charger_counts = {1, 3, 3};
+        base.sweep.fleet_sizes = {10, 25};
+        base.sweep.fleet_mixes = {evtol::FleetMix{}, doubled};
+        base.sweep.seeds = {1, 2};
+
+        evtol::SweepRunner sweep(base);
+        ASSERT_EQ(sweep.get_points().size(), 8u);
+        EXPECT_EQ(sweep.get_duplicate_count(), 16u);
+
+        std::ostringstream csv;
+        auto results = sweep.run(csv);
+        ASSERT_EQ(results.size(), 8u);
+
+        std::istringstream rows(csv.str());
+        std::string line;
+        std::getline(rows, line);
+        EXPECT_EQ(line + "\n", evtol::SweepRunner::csv_header());
+        size_t row_count = 0;
+        while (std::getline(rows, line))
+        {
+            ++row_count;
+        }
+        EXPECT_EQ(row_count, 8u);
+
+        auto run_single = [](const evtol::SimulationConfig &config)
+        {
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers(config.get_charger_pools());
+            auto fleet = evtol::AircraftFactory<>::create_fleet(config.fleet_size, config.fleet_mix);
+            evtol::SimulationRunner(stats, config).run_simulation(chargers, fleet);
+            return evtol::BatchStatistics::capture(stats);
+        };
+
+        for (const auto &result : results)
+        {
+            auto expected = run_single(result.point.config);
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                {
+                    EXPECT_EQ(metric.extract(result.stats[t]), metric.extract(expected[t]))
+                        << metric.name << " differs at sweep point " << result.point.index;
+                }
+            }
+        }
+
+        // Forking from a checkpoint: without swept seeds each scenario resumes it unchanged
+        evtol::SimulationConfig checkpointed = base;
+        checkpointed.sweep = evtol::SweepGrid{};
+        checkpointed.checkpoint.every_hours = 2.0;
+        checkpointed.checkpoint.path_prefix = ::testing::TempDir() + "evtol_sweep_fork";
+        auto uninterrupted = run_single(checkpointed);
+
+        evtol::SimulationConfig fork = base;
+        fork.sweep = evtol::SweepGrid{};
+        fork.sweep.fleet_sizes = {20, 20};
+        fork.checkpoint.restore_path = evtol::checkpoint_file_name(checkpointed.checkpoint.path_prefix, 2.0);
+        std::ostringstream fork_csv;
+        auto forked = evtol::SweepRunner(fork).run(fork_csv);
+        ASSERT_EQ(forked.size(), 1u);
+        EXPECT_EQ(evtol::BatchStatistics::fleet_totals(forked[0].stats).total_flight_time_hours,
+                  evtol::BatchStatistics::fleet_totals(uninterrupted).total_flight_time_hours);
+
+        // A mismatched scenario surfaces its error once the sweep is done
+        fork.sweep.fleet_sizes = {20, 21};
+        EXPECT_THROW(evtol::SweepRunner(fork).run(fork_csv), std::runtime_error);
+        std::remove(fork.checkpoint.restore_path.c_str());
+    }
+
+    // Test 17: With chargers to spare, the analytic solver reproduces the event queue bit for bit
+    TEST_F(SystemBehaviorTest, AnalyticSolverMatchesEventQueueWhenUncontended)
+    {
+        struct Outcome
+        {
+            evtol::ReplicationResult stats;
+            bool solved_analytically;
+            int available_chargers;
+            std::vector<std::pair<double, bool>> aircraft_states;
+        };
+
+        auto run_with = [](const evtol::SimulationConfig &config, bool analytic)
+        {
+            evtol::SimulationConfig run_config = config;
+            run_config.enable_analytic_solver = analytic;
+
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers(run_config.get_charger_pools());
+            auto fleet = evtol::AircraftFactory<>::create_fleet(run_config.fleet_size, run_config.fleet_mix);
+            auto engine = evtol::SimulationFactory::create_engine(run_config, stats);
+            auto &event_engine = dynamic_cast<evtol::EventDrivenSimulationEngine &>(*engine);
+            event_engine.run(chargers, fleet);
+
+            Outcome outcome{evtol::BatchStatistics::capture(stats), event_engine.solved_analytically(),
+                            chargers.get_available_chargers(), {}};
+            for (const auto &aircraft : fleet)
+            {
+                outcome.aircraft_states.emplace_back(aircraft->get_battery_level(), aircraft->is_faulty());
+            }
+            return outcome;
+        };
+
+        auto expect_same_stats = [](const Outcome &actual, const Outcome &expected, const std::string &context)
+        {
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                {
+                    EXPECT_EQ(metric.extract(actual.stats[t]), metric.extract(expected.stats[t]))
+                        << metric.name << " differs for " << context;
+                }
+            }
+        };
+
+        // Runs ending exactly on an Alpha landing or charge completion finish those as partial activities
+        double alpha_landing = evtol::AlphaAircraft::full_charge_flight_time_hours();
+        double alpha_charged = alpha_landing + evtol::AlphaAircraft::get_aircraft_spec().time_to_charge_hours;
+
+        evtol::FleetMix echo_heavy;
+        echo_heavy.weights = {1, 0, 1, 0, 3};
+        for (double duration : {3.0, 10.0, alpha_landing, alpha_charged})
+        {
+            for (bool partial_flights : {true, false})
+            {
+                for (std::uint64_t seed : {3u, 17u})
+                {
+                    evtol::SimulationConfig config;
+                    config.simulation_duration_hours = duration;
+                    config.enable_partial_flights = partial_flights;
+                    config.random_seed = seed;
+                    config.fleet_size = 60;
+                    config.fleet_mix = echo_heavy;
+                    config.charger_pools = {{"north", 400}, {"south", 400}};
+
+                    Outcome queued = run_with(config, false);
+                    Outcome analytic = run_with(config, true);
+                    EXPECT_FALSE(queued.solved_analytically);
+                    EXPECT_TRUE(analytic.solved_analytically);
+                    EXPECT_EQ(analytic.available_chargers, queued.available_chargers);
+                    EXPECT_EQ(analytic.aircraft_states, queued.aircraft_states);
+                    expect_same_stats(analytic, queued, "duration " + std::to_string(duration) + ", seed " + std::to_string(seed) +
+                                                            (partial_flights ? "" : " without partial flights"));
+                }
+            }
+        }
+
+        // Too few chargers: the run goes through the event queue as before
+        evtol::SimulationConfig contended;
+        contended.random_seed = 5;
+        contended.num_chargers = 3;
+        Outcome fallback = run_with(contended, true);
+        EXPECT_FALSE(fallback.solved_analytically);
+        expect_same_stats(fallback, run_with(contended, false), "three chargers");
+        EXPECT_GT(evtol::BatchStatistics::fleet_totals(fallback.stats).total_waiting_time_hours, 0.0);
+    }
+
+    // Test 18: --profile counters agree with the statistics of the runs they count
+    TEST_F(SystemBehaviorTest, ProfileCountersMatchTheRun)
+    {
+        evtol::SimulationConfig config;
+        config.random_seed = 6;
+        config.num_threads = 1;
+
+        {
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers(config.get_charger_pools());
+            auto fleet = evtol::AircraftFactory<>::create_fleet(config.fleet_size);
+            evtol::SimulationRunner runner(stats, config);
+            runner.run_simulation(chargers, fleet);
+            EXPECT_EQ(runner.get_profile(), nullptr);
+        }
+
+        config.enable_profile = true;
+        evtol::StatisticsCollector stats;
+        evtol::ChargerManager chargers(config.get_charger_pools());
+        auto fleet = evtol::AircraftFactory<>::create_fleet(config.fleet_size);
+        evtol::SimulationRunner runner(stats, config);
+        runner.run_simulation(chargers, fleet);
+        ASSERT_NE(runner.get_profile(), nullptr);
+
+        // Partial activities are counted but never popped as events
+        evtol::ProfileCounters counters = runner.get_profile()->merged();
+        evtol::FlightStats totals = evtol::BatchStatistics::fleet_totals(evtol::BatchStatistics::capture(stats));
+        EXPECT_EQ(counters.events[static_cast<size_t>(evtol::EventType::FLIGHT_COMPLETE)],
+                  static_cast<std::uint64_t>(totals.flight_count - totals.partial_flight_count));
+        EXPECT_EQ(counters.events[static_cast<size_t>(evtol::EventType::CHARGING_COMPLETE)],
+                  static_cast<std::uint64_t>(totals.charge_count - totals.partial_charge_count));
+        EXPECT_EQ(counters.events[static_cast<size_t>(evtol::EventType::FAULT_OCCURRED)],
+                  static_cast<std::uint64_t>(totals.total_faults));
+        EXPECT_GT(counters.event_queue_depth_peak, 0u);
+        EXPECT_LE(counters.event_queue_depth_peak, 2u * static_cast<std::uint64_t>(config.fleet_size));
+        EXPECT_GT(counters.charger_queue_peak, 0u);
+        EXPECT_DOUBLE_EQ(counters.simulated_hours, config.simulation_duration_hours);
+        EXPECT_GT(counters.state_changes, counters.event_count());
+        EXPECT_GT(counters.phase_ticks[static_cast<size_t>(evtol::ProfilePhase::MAIN_LOOP)], 0u);
+        EXPECT_NE(runner.get_profile()->generate_report().find("Event queue depth"), std::string::npos);
+        EXPECT_NE(runner.get_profile()->to_json().find("\"charger_queue_length\""), std::string::npos);
+
+        // Frames skipped ahead are exactly the frames the full loop updates without a state change
+        auto frame_counters = [&](bool skip_ahead)
+        {
+            evtol::SimulationConfig frame_config = config;
+            frame_config.mode = evtol::SimulationMode::FRAME_BASED;
+            frame_config.enable_skip_ahead = skip_ahead;
+            evtol::StatisticsCollector frame_stats;
+            evtol::ChargerManager frame_chargers(frame_config.get_charger_pools());
+            auto frame_fleet = evtol::AircraftFactory<>::create_fleet(frame_config.fleet_size);
+            evtol::SimulationRunner frame_runner(frame_stats, frame_config);
+            frame_runner.run_simulation(frame_chargers, frame_fleet);
+            return frame_runner.get_profile()->merged();
+        };
+        evtol::ProfileCounters full = frame_counters(false);
+        evtol::ProfileCounters skipping = frame_counters(true);
+        EXPECT_EQ(full.skipped_frames, 0u);
+        EXPECT_EQ(full.frames, skipping.frames + skipping.skipped_frames);
+        EXPECT_GT(skipping.skipped_frames, 0u);
+        EXPECT_LT(full.active_frames, full.frames);
+        EXPECT_EQ(full.state_changes, skipping.state_changes);
+        EXPECT_EQ(full.event_count(), 0u);
+
+        // Replications count into their worker's counters
+        config.replications = 6;
+        config.num_threads = 2;
+        evtol::SimulationRunner batch_runner(stats, config);
+        batch_runner.run_replications([&]
+                                      { return evtol::AircraftFactory<>::create_fleet(config.fleet_size); });
+        ASSERT_EQ(batch_runner.get_profile()->size(), 2u);
+        EXPECT_DOUBLE_EQ(batch_runner.get_profile()->merged().simulated_hours, 6 * config.simulation_duration_hours);
+    }
+
+    // Test 19: A scenario file maps into the fleet without copies and runs like the same fleet built in code
+    TEST_F(SystemBehaviorTest, MappedScenarioRunsLikeBuiltFleet)
+    {
+        std::ostringstream text;
+        text << "# two vertiports\npool north 2\npool south 1\n";
+        for (int id = 0; id < 30; ++id)
+        {
+            text << "aircraft " << id << " " << evtol::FleetMix::type_names[(id * 7) % evtol::NUM_AIRCRAFT_TYPES];
+            if (id % 3 == 0)
+            {
+                text << " " << 0.25 + 0.02 * id << (id % 2 == 0 ? " south" : "");
+            }
+            text << "\n";
+        }
+        std::istringstream in(text.str());
+        evtol::Scenario scenario = evtol::parse_scenario_text(in);
+        ASSERT_EQ(scenario.size(), 30u);
+        EXPECT_EQ(scenario.types[1], evtol::AircraftType::CHARLIE);
+        EXPECT_DOUBLE_EQ(scenario.battery_levels[3], 0.31);
+        EXPECT_EQ(scenario.home_pools[6], 1u); // named
+        EXPECT_EQ(scenario.home_pools[3], 1u); // id % pool count
+
+        std::string path = ::testing::TempDir() + "evtol_scenario.bin";
+        evtol::write_scenario_file(path, scenario);
+        auto mapped = evtol::MappedScenario::open(path);
+        EXPECT_NO_THROW(mapped->verify());
+        ASSERT_EQ(mapped->size(), scenario.size());
+        ASSERT_EQ(mapped->charger_pools().size(), 2u);
+        EXPECT_EQ(mapped->charger_pools()[1].name, "south");
+
+        evtol::SoaFleet fleet = evtol::MappedScenario::map_fleet(mapped);
+        EXPECT_TRUE(fleet.is_mapped());
+        EXPECT_EQ(fleet.ids().data(), mapped->ids().data()) << "the fleet reads the mapped pages";
+        EXPECT_FALSE(fleet.is_grouped());
+
+        // The same aircraft built one by one, with the same home pools
+        evtol::SoaFleet built;
+        for (size_t i = 0; i < scenario.size(); ++i)
+        {
+            built.add_aircraft(scenario.types[i], scenario.ids[i], scenario.battery_levels[i]);
+        }
+
+        for (auto mode : {evtol::SimulationMode::EVENT_DRIVEN, evtol::SimulationMode::FRAME_BASED})
+        {
+            auto run = [&](evtol::SoaFleet &run_fleet, bool from_scenario)
+            {
+                evtol::SimulationConfig config;
+                config.mode = mode;
+                config.random_seed = 5;
+                config.num_threads = 1;
+                config.charger_pools = scenario.charger_pools;
+                evtol::ChargerManager chargers(config.get_charger_pools());
+                if (from_scenario)
+                {
+                    mapped->assign_home_pools(chargers);
+                }
+                else
+                {
+                    for (size_t i = 0; i < scenario.size(); ++i)
+                    {
+                        chargers.set_home_pool(scenario.ids[i], scenario.home_pools[i]);
+                    }
+                }
+                evtol::StatisticsCollector stats;
+                evtol::SimulationRunner(stats, config).run_simulation(chargers, run_fleet);
+                return evtol::BatchStatistics::capture(stats);
+            };
+            // Start both from the scenario's levels; the first run left them as it ended
+            built.reset_state();
+            std::copy(scenario.battery_levels.begin(), scenario.battery_levels.end(), built.battery_levels().begin());
+            std::copy(scenario.battery_levels.begin(), scenario.battery_levels.end(), fleet.battery_levels().begin());
+
+            auto expected = run(built, false);
+            auto actual = run(fleet, true);
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                EXPECT_EQ(actual[t].flight_count, expected[t].flight_count);
+                EXPECT_EQ(actual[t].total_faults, expected[t].total_faults);
+                EXPECT_DOUBLE_EQ(actual[t].total_charging_time_hours, expected[t].total_charging_time_hours);
+                EXPECT_DOUBLE_EQ(actual[t].total_waiting_time_hours, expected[t].total_waiting_time_hours);
+            }
+        }
+
+        // Runs write the fleet's private pages; the file keeps the initial levels
+        EXPECT_EQ(evtol::MappedScenario(path).battery_levels()[3], 0.31);
+
+        // Copies and structural changes move the columns into owned storage
+        evtol::SoaFleet copy = fleet;
+        EXPECT_FALSE(copy.is_mapped());
+        EXPECT_EQ(copy.size(), fleet.size());
+        fleet.add_aircraft(evtol::AircraftType::ALPHA, 30);
+        EXPECT_FALSE(fleet.is_mapped());
+        EXPECT_EQ(fleet[29]->get_id(), 29);
+
+        std::istringstream bad("pool north 2\naircraft 0 zulu\n");
+        EXPECT_THROW(
+            {
+                try
+                {
+                    evtol::parse_scenario_text(bad);
+                }
+                catch (const std::invalid_argument &e)
+                {
+                    EXPECT_NE(std::string(e.what()).find("line 2"), std::string::npos);
+                    throw;
+                }
+            },
+            std::invalid_argument);
+        scenario.ids[4] = 2;
+        EXPECT_THROW(evtol::write_scenario_file(path, scenario), std::invalid_argument);
+
+        // A truncated file is rejected before any column is read
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+        EXPECT_THROW(evtol::MappedScenario truncated_scenario(path), std::runtime_error);
+
+        // A pool without chargers would strand the aircraft homed there; --charger-pools rejects it too
+        std::istringstream empty_pool("pool north 2\npool south 0\naircraft 0 alpha\n");
+        EXPECT_THROW(evtol::write_scenario_file(path, evtol::parse_scenario_text(empty_pool)), std::invalid_argument);
+
+        // Type ranges past the columns are rejected on opening, bad records (including empty pools) by verify()
+        std::istringstream two_aircraft("pool north 2\naircraft 0 alpha\naircraft 1 beta\n");
+        evtol::write_scenario_file(path, evtol::parse_scenario_text(two_aircraft));
+        evtol::ScenarioFileHeader header = evtol::MappedScenario(path).header();
+        auto patch = [&](std::uint64_t offset, const auto &value)
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(static_cast<std::streamoff>(offset));
+            file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        };
+        patch(header.pools_offset + offsetof(evtol::ScenarioPoolRecord, charger_count), std::int32_t{0});
+        EXPECT_THROW(evtol::MappedScenario(path).verify(), std::runtime_error);
+        patch(header.pools_offset + offsetof(evtol::ScenarioPoolRecord, charger_count), std::int32_t{2});
+        EXPECT_NO_THROW(evtol::MappedScenario(path).verify());
+        patch(header.types_offset + sizeof(evtol::AircraftType), std::int32_t{17});
+        EXPECT_NO_THROW(evtol::MappedScenario unverified(path));
+        EXPECT_THROW(evtol::MappedScenario(path).verify(), std::runtime_error);
+        patch(offsetof(evtol::ScenarioFileHeader, type_end) + sizeof(std::uint64_t), std::uint64_t{1000});
+        EXPECT_THROW(evtol::MappedScenario past_the_end(path), std::runtime_error);
+        std::remove(path.c_str());
+    }
+
+    // Test 20: A vertiport network gives the same results on any thread count, and every flight lands somewhere
+    TEST_F(SystemBehaviorTest, NetworkRunIsIndependentOfThreadCount)
+    {
+        evtol::SimulationConfig config;
+        config.enable_network = true;
+        config.random_seed = 11;
+        config.simulation_duration_hours = 12.0;
+        config.charger_pools = {{"north", 3}, {"south", 2}, {"east", 2}, {"west", 1}};
+
+        auto run = [&](int threads, evtol::StatisticsCollector &stats)
+        {
+            config.num_threads = threads;
+            auto fleet = evtol::AircraftFactory<>::create_fleet(80);
+            evtol::ChargerManager chargers(config.get_charger_pools());
+            evtol::SimulationRunner runner(stats, config);
+            runner.run_simulation(chargers, fleet);
+
+            auto *network = dynamic_cast<evtol::NetworkSimulationEngine *>(runner.get_engine());
+            EXPECT_NE(network, nullptr);
+            EXPECT_EQ(network->get_vertiport_count(), 4u);
+            EXPECT_GT(network->get_window_count(), 1u);
+            EXPECT_GT(network->get_flights_between_vertiports(), 0u);
+            EXPECT_EQ(chargers.get_active_chargers(), 0) << "the caller's manager only names the vertiports";
+
+            // Every vertiport's shard adds up to the collector's totals
+            int flights = 0;
+            for (size_t v = 0; v < network->get_vertiport_count(); ++v)
+            {
+                for (const auto &type_stats : network->get_vertiport_stats(v).by_type())
+                {
+                    flights += type_stats.flight_count;
+                }
+            }
+            EXPECT_EQ(flights, stats.get_summary_stats().total_flights);
+            return network->get_lookahead_hours();
+        };
+
+        evtol::StatisticsCollector serial, parallel;
+        double lookahead = run(1, serial);
+        run(4, parallel);
+
+        double shortest = std::numeric_limits<double>::infinity();
+        for (const auto &type : evtol::aircraft_type_table())
+        {
+            shortest = std::min(shortest, type.full_charge_flight_time_hours);
+        }
+        EXPECT_DOUBLE_EQ(lookahead, shortest);
+
+        auto expected = evtol::BatchStatistics::capture(serial);
+        auto actual = evtol::BatchStatistics::capture(parallel);
+        EXPECT_GT(serial.get_summary_stats().total_charges, 0);
+        for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+        {
+            EXPECT_EQ(actual[t].flight_count, expected[t].flight_count);
+            EXPECT_EQ(actual[t].charge_count, expected[t].charge_count);
+            EXPECT_EQ(actual[t].total_faults, expected[t].total_faults);
+            EXPECT_EQ(actual[t].total_flight_time_hours, expected[t].total_flight_time_hours);
+            EXPECT_EQ(actual[t].total_waiting_time_hours, expected[t].total_waiting_time_hours);
+            EXPECT_EQ(actual[t].partial_flight_time_hours, expected[t].partial_flight_time_hours);
+        }
+    }
+
+
+    // Test 21: A distributed batch survives a worker dying mid-task and matches the local batch; without workers it keeps partial results
+    TEST_F(SystemBehaviorTest, DistributedBatchSurvivesLostWorkers)
+    {
+        evtol::SimulationConfig config;
+        config.random_seed = 5;
+        config.replications = 24;
+        config.num_threads = 2;
+
+        evtol::DistributedBatchOptions options;
+        options.chunk = 4;
+        options.worker_wait_seconds = 0.3;
+
+        auto make_fleet = [&config]
+        { return evtol::ArenaFleet(config.fleet_size, config.fleet_mix); };
+        evtol::StatisticsCollector unused_stats;
+        evtol::SimulationRunner local(unused_stats, config);
+
+        // A rank that joins, takes a task, optionally answers it, then disappears
+        auto join_and_die = [&](int port, bool answer_first_task)
+        {
+            auto socket = evtol::MessageSocket::connect("localhost:" + std::to_string(port));
+            evtol::SnapshotWriter hello;
+            hello.begin_section(evtol::snapshot_tag("HELO"));
+            hello.write(std::uint32_t{1});
+            hello.write_string("doomed");
+            socket.send(hello);
+
+            evtol::SnapshotReader job = socket.receive();
+            EXPECT_EQ(job.read<std::uint32_t>(), evtol::snapshot_tag("JOB_"));
+
+            evtol::SnapshotReader task = socket.receive();
+            EXPECT_EQ(task.read<std::uint32_t>(), evtol::snapshot_tag("TASK"));
+            auto index = task.read<std::uint64_t>();
+            auto first = task.read<std::uint64_t>();
+            auto count = task.read<std::uint64_t>();
+
+            if (answer_first_task)
+            {
+                evtol::SnapshotWriter result;
+                result.begin_section(evtol::snapshot_tag("RSLT"));
+                result.write(index);
+                local.run_replications(make_fleet, first, count).save_state(result);
+                socket.send(result);
+                socket.receive(); // the next task, never answered
+            }
+            socket.close();
+        };
+
+        auto expect_batches_match = [](const evtol::BatchStatistics &actual, const evtol::BatchStatistics &expected)
+        {
+            ASSERT_EQ(actual.get_replication_count(), expected.get_replication_count());
+            for (size_t m = 0; m < evtol::FLIGHT_STATS_METRICS.size(); ++m)
+            {
+                const auto &a = actual.get_fleet_metric(m);
+                const auto &e = expected.get_fleet_metric(m);
+                EXPECT_NEAR(a.mean(), e.mean(), 1e-9 * (1.0 + std::abs(e.mean()))) << evtol::FLIGHT_STATS_METRICS[m].name;
+                EXPECT_NEAR(a.stddev(), e.stddev(), 1e-9 * (1.0 + e.stddev())) << evtol::FLIGHT_STATS_METRICS[m].name;
+            }
+        };
+
+        {
+            evtol::BatchCoordinator coordinator(config, options);
+            evtol::DistributedBatchResult distributed;
+            std::thread serving([&]
+                                { distributed = coordinator.run_replications(); });
+
+            join_and_die(coordinator.port(), false);
+            std::vector<std::thread> workers;
+            std::vector<size_t> tasks(2);
+            for (size_t w = 0; w < tasks.size(); ++w)
+            {
+                workers.emplace_back([&, w]
+                                     { tasks[w] = evtol::BatchWorker(1).run("localhost:" + std::to_string(coordinator.port())); });
+            }
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+            serving.join();
+
+            EXPECT_TRUE(distributed.report.complete());
+            EXPECT_EQ(distributed.report.tasks_total, 6u);
+            EXPECT_EQ(distributed.report.workers_seen, 3u);
+            EXPECT_EQ(distributed.report.workers_lost, 1u);
+            EXPECT_EQ(tasks[0] + tasks[1], 6u) << "the lost task was run again";
+            expect_batches_match(distributed.batch, local.run_replications(make_fleet));
+        }
+
+        {
+            evtol::BatchCoordinator coordinator(config, options);
+            evtol::DistributedBatchResult partial;
+            std::thread serving([&]
+                                { partial = coordinator.run_replications(); });
+            join_and_die(coordinator.port(), true);
+            serving.join();
+
+            EXPECT_FALSE(partial.report.complete());
+            EXPECT_EQ(partial.report.tasks_done, 1u);
+            expect_batches_match(partial.batch, local.run_replications(make_fleet, 0, 4));
+        }
+    }
+
+    // Test 22: Coroutine aircraft reproduce the event engine exactly, on pointer and SoA fleets, run after run
+    TEST_F(SystemBehaviorTest, CoroutineEngineMatchesEventEngine)
+    {
+        evtol::SimulationConfig config;
+        config.simulation_duration_hours = 24.0;
+        config.random_seed = 42;
+        config.charger_pools = {{"north", 3}, {"south", 2}};
+        config.fault_model = evtol::FaultModel::EXPONENTIAL;
+
+        auto run_with = [&](evtol::SimulationMode mode, bool soa)
+        {
+            config.mode = mode;
+            evtol::StatisticsCollector stats;
+            evtol::ChargerManager chargers(config.get_charger_pools());
+            evtol::SimulationRunner runner(stats, config);
+            if (soa)
+            {
+                auto fleet = evtol::SoaFleet::from_fleet(evtol::AircraftFactory<>::create_fleet(150));
+                runner.run_simulation(chargers, fleet);
+            }
+            else
+            {
+                if (mode == evtol::SimulationMode::COROUTINE)
+                {
+                    // a first run on the same engine, so the second one reuses its frame pool
+                    auto warmup_fleet = evtol::AircraftFactory<>::create_fleet(40);
+                    evtol::ChargerManager warmup_chargers(config.get_charger_pools());
+                    runner.run_simulation(warmup_chargers, warmup_fleet);
+                    stats.reset_stats();
+                }
+                auto fleet = evtol::AircraftFactory<>::create_fleet(150);
+                runner.run_simulation(chargers, fleet);
+            }
+            if (mode == evtol::SimulationMode::COROUTINE)
+            {
+                auto *engine = dynamic_cast<evtol::CoroutineSimulationEngine *>(runner.get_engine());
+                EXPECT_NE(engine, nullptr);
+                EXPECT_GT(engine->get_frame_size(), 0u);
+            }
+            return evtol::BatchStatistics::capture(stats);
+        };
+
+        for (bool soa : {false, true})
+        {
+            auto expected = run_with(evtol::SimulationMode::EVENT_DRIVEN, soa);
+            auto actual = run_with(evtol::SimulationMode::COROUTINE, soa);
+            EXPECT_GT(expected[0].total_faults + expected[1].total_faults, 0);
+            EXPECT_GT(expected[0].total_waiting_time_hours, 0.0) << "chargers should be contended";
+            for (size_t t = 0; t < evtol::NUM_AIRCRAFT_TYPES; ++t)
+            {
+                for (const auto &metric : evtol::FLIGHT_STATS_METRICS)
+                {
+                    EXPECT_EQ(metric.extract(actual[t]), metric.extract(expected[t])) << metric.name << (soa ? " (SoA fleet)" : "");
+                }
+            }
+        }
+    }
+
+    // Test 23: CI-target batches stop at the same replication for any thread count, cap out on hard targets, and stop early when distributed
+    TEST_F(SystemBehaviorTest, ConfidenceTargetStopsReplicationsDeterministically)
+    {
+        EXPECT_EQ(evtol::WatchedMetric::parse("Echo:total_faults").type, evtol::AircraftType::ECHO);
+        EXPECT_FALSE(evtol::WatchedMetric::parse("avg_waiting_time").type.has_value());
+        EXPECT_THROW(evtol::WatchedMetric::parse("avg_wait"), std::invalid_argument);
+        EXPECT_THROW(evtol::WatchedMetric::parse("zulu:total_faults"), std::invalid_argument);
+
+        evtol::SimulationConfig config;
+        config.random_seed = 4;
+        config.replications = 2000;
+        config.ci_target = 0.02;
+        auto make_fleet = [&config]
+        { return evtol::ArenaFleet(config.fleet_size, config.fleet_mix); };
+
+        auto run_with = [&](int threads)
+        {
+            config.num_threads = threads;
+            evtol::StatisticsCollector unused_stats;
+            evtol::SimulationRunner runner(unused_stats, config);
+            return runner.run_replications_until(make_fleet, config.stopping_rule());
+        };
+
+        evtol::ConfidenceStoppingRule rule = config.stopping_rule();
+        evtol::SequentialBatchResult one_thread = run_with(1);
+        evtol::SequentialBatchResult three_threads = run_with(3);
+        size_t stopped_at = one_thread.batch.get_replication_count();
+        EXPECT_TRUE(one_thread.converged);
+        EXPECT_TRUE(rule.is_met(one_thread.batch));
+        EXPECT_GT(stopped_at, rule.min_replications);
+        EXPECT_LT(stopped_at, 2000u);
+        EXPECT_EQ(three_threads.batch.get_replication_count(), stopped_at);
+        for (size_t m = 0; m < evtol::FLIGHT_STATS_METRICS.size(); ++m)
+        {
+            EXPECT_EQ(three_threads.batch.get_fleet_metric(m).mean(), one_thread.batch.get_fleet_metric(m).mean());
+        }
+
+        // The rounds are the replications a fixed batch of that size would run
+        evtol::StatisticsCollector unused_stats;
+        evtol::SimulationRunner runner(unused_stats, config);
+        evtol::BatchStatistics fixed = runner.run_replications(make_fleet, 0, stopped_at);
+        const auto &miles = fixed.get_fleet_metric(static_cast<size_t>(evtol::BatchStatistics::find_metric("total_passenger_miles")));
+        const auto &adaptive_miles = one_thread.batch.get_fleet_metric(static_cast<size_t>(evtol::BatchStatistics::find_metric("total_passenger_miles")));
+        EXPECT_NEAR(adaptive_miles.mean(), miles.mean(), 1e-9 * miles.mean());
+        EXPECT_FALSE(rule.is_met(runner.run_replications(make_fleet, 0, rule.min_replications)));
+
+        // A target out of reach runs to the cap
+        config.replications = 30;
+        config.ci_target = 1e-6;
+        config.ci_metrics = {evtol::WatchedMetric::parse("echo:total_faults")};
+        evtol::SequentialBatchResult capped = run_with(2);
+        EXPECT_FALSE(capped.converged);
+        EXPECT_EQ(capped.batch.get_replication_count(), 30u);
+        EXPECT_GT(config.stopping_rule().widest(capped.batch).first, 1e-6);
+
+        // Distributed batches check the rule as tasks merge in order, so they stop on a task boundary
+        config.replications = 2000;
+        config.ci_target = 0.02;
+        config.ci_metrics.clear();
+        config.num_threads = 1;
+        evtol::DistributedBatchOptions options;
+        options.chunk = 50;
+        options.worker_wait_seconds = 5.0;
+        evtol::BatchCoordinator coordinator(config, options);
+        evtol::DistributedBatchResult distributed;
+        std::thread serving([&]
+                            { distributed = coordinator.run_replications(); });
+        evtol::BatchWorker(2).run("localhost:" + std::to_string(coordinator.port()));
+        serving.join();
+
+        size_t distributed_count = distributed.batch.get_replication_count();
+        EXPECT_TRUE(distributed.report.converged);
+        EXPECT_TRUE(distributed.report.complete());
+        EXPECT_LT(distributed.report.tasks_done, distributed.report.tasks_total);
+        EXPECT_EQ(distributed_count % 50, 0u);
+        EXPECT_GE(distributed_count, stopped_at) << "no task boundary before the local stop can meet the target";
+        EXPECT_TRUE(rule.is_met(distributed.batch));
+        EXPECT_FALSE(rule.is_met(runner.run_replications(make_fleet, 0, distributed_count - 50)));
+    }
+
+} // namespace evtol_test
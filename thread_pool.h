@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace evtol
+{
+    /**
+     * Fixed-size worker pool for data-parallel loops
+     * The calling thread participates as worker 0, so a pool of size 1 runs everything inline
+     */
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable work_done_;
+
+        std::function<void(size_t, size_t)> job_;
+        std::atomic<size_t> next_index_{0};
+        size_t job_count_ = 0;
+        size_t generation_ = 0;
+        size_t busy_workers_ = 0;
+        bool stopping_ = false;
+        std::exception_ptr first_error_; // first exception thrown by the current job, guarded by mutex_
+
+        // An exception is kept for the caller and stops every worker from claiming further indices
+        void run_indices(size_t worker_id)
+        {
+            try
+            {
+                for (size_t index = next_index_.fetch_add(1, std::memory_order_relaxed); index < job_count_;
+                     index = next_index_.fetch_add(1, std::memory_order_relaxed))
+                {
+                    job_(index, worker_id);
+                }
+            }
+            catch (...)
+            {
+                next_index_.store(job_count_, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!first_error_)
+                {
+                    first_error_ = std::current_exception();
+                }
+            }
+        }
+
+        void worker_loop(size_t worker_id)
+        {
+            size_t seen_generation = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    work_ready_.wait(lock, [&]
+                                     { return stopping_ || generation_ != seen_generation; });
+                    if (stopping_)
+                    {
+                        return;
+                    }
+                    seen_generation = generation_;
+                }
+
+                run_indices(worker_id);
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--busy_workers_ == 0)
+                {
+                    work_done_.notify_one();
+                }
+            }
+        }
+
+    public:
+        /**
+         * @param num_threads Total worker count including the caller (0 = hardware concurrency)
+         */
+        explicit ThreadPool(size_t num_threads = 0)
+        {
+            if (num_threads == 0)
+            {
+                num_threads = resolve_thread_count(0);
+            }
+
+            workers_.reserve(num_threads - 1);
+            for (size_t i = 1; i < num_threads; ++i)
+            {
+                workers_.emplace_back([this, i]
+                                      { worker_loop(i); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            work_ready_.notify_all();
+            for (auto &worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * Number of workers, including the calling thread
+         */
+        size_t size() const { return workers_.size() + 1; }
+
+        /**
+         * Run func(index, worker_id) for every index in [0, count)
+         * Indices are claimed dynamically, so uneven work balances across workers.
+         * Blocks until all indices have been processed. If func throws on any worker, indices not yet
+         * claimed are skipped and the first exception is rethrown here once every worker has stopped.
+         */
+        template <typename Func>
+        void parallel_for(size_t count, Func &&func)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            if (workers_.empty() || count == 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    func(i, 0);
+                }
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job_ = std::ref(func);
+                job_count_ = count;
+                next_index_.store(0, std::memory_order_relaxed);
+                busy_workers_ = workers_.size();
+                ++generation_;
+            }
+            work_ready_.notify_all();
+
+            run_indices(0);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_done_.wait(lock, [&]
+                            { return busy_workers_ == 0; });
+            job_ = nullptr;
+            if (std::exception_ptr error = std::exchange(first_error_, nullptr))
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        /**
+         * Translate a requested thread count (0 = auto) into a usable one
+         */
+        static size_t resolve_thread_count(int requested)
+        {
+            if (requested > 0)
+            {
+                return static_cast<size_t>(requested);
+            }
+            unsigned int hw = std::thread::hardware_concurrency();
+            return hw > 0 ? hw : 1;
+        }
+    };
+}
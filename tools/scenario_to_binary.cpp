@@ -0,0 +1,43 @@
+#include <cstdio>
+#include <exception>
+#include <fstream>
+
+#include "scenario_file.h"
+
+/**
+ * Convert a text scenario (see parse_scenario_text) to the binary file --scenario maps
+ * Usage: scenario_to_binary <scenario.txt> <scenario.bin>
+ */
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s <scenario.txt> <scenario.bin>\n", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        std::ifstream text(argv[1]);
+        if (!text)
+        {
+            std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+            return 1;
+        }
+
+        evtol::Scenario scenario = evtol::parse_scenario_text(text);
+        evtol::write_scenario_file(argv[2], scenario);
+
+        // Read the file back the way the simulator will
+        evtol::MappedScenario mapped(argv[2]);
+        mapped.verify();
+        std::printf("Wrote %zu aircraft and %zu charger pools to %s\n", mapped.size(), mapped.charger_pools().size(), argv[2]);
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
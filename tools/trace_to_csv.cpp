@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+#include "event_trace.h"
+
+/**
+ * Convert a binary trace written with --trace to CSV
+ * Usage: trace_to_csv <trace file> [output.csv]   (CSV goes to stdout without an output file)
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::fprintf(stderr, "Usage: %s <trace file> [output.csv]\n", argv[0]);
+        return 1;
+    }
+
+    static const char *aircraft_type_names[] = {"Alpha", "Beta", "Charlie", "Delta", "Echo"};
+    constexpr size_t BATCH_RECORDS = 65536;
+
+    try
+    {
+        evtol::TraceReader reader(argv[1]);
+
+        std::FILE *out = stdout;
+        if (argc == 3)
+        {
+            out = std::fopen(argv[2], "w");
+            if (!out)
+            {
+                std::fprintf(stderr, "Cannot create %s\n", argv[2]);
+                return 1;
+            }
+        }
+
+        std::fprintf(out, "time_hours,aircraft_id,event,aircraft_type,value_a,value_b\n");
+
+        std::vector<evtol::TraceRecord> batch;
+        while (reader.read_batch(batch, BATCH_RECORDS) > 0)
+        {
+            for (const auto &record : batch)
+            {
+                const char *type_name = record.aircraft_type < evtol::NUM_AIRCRAFT_TYPES
+                                            ? aircraft_type_names[record.aircraft_type]
+                                            : "Unknown";
+                std::fprintf(out, "%.17g,%d,%s,%s,%.17g,%.17g\n", record.time_hours, record.aircraft_id,
+                             evtol::trace_event_name(record.event_type), type_name, record.value_a, record.value_b);
+            }
+        }
+
+        if (out != stdout && std::fclose(out) != 0)
+        {
+            std::fprintf(stderr, "Writing %s failed\n", argv[2]);
+            return 1;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
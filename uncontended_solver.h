@@ -0,0 +1,237 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "charger_manager.h"
+#include "statistics_engine.h"
+#include "simulation_interface.h"
+
+namespace evtol
+{
+    /**
+     * Event-driven run solved without an event queue, for charger pools that never run out
+     * The event-driven engine keeps the charger an aircraft was given: a finished charge hands it to
+     * the next aircraft waiting at the pool, and no charger ever goes back on the free list. So if every
+     * pool has a free charger for each charge session its aircraft can start, no aircraft ever waits, and
+     * each aircraft repeats its type's fixed flight -> charge cycle until a fault grounds it or the run
+     * ends. The solver walks those cycles aircraft by aircraft, drawing faults from each aircraft's own
+     * stream exactly as the engine does.
+     * Each per-type running sum only receives the type's full flight or charge until the run ends, then
+     * its activity cut off at the end; recording those in the same two phases as the engine makes the
+     * FlightStats bit-identical to the engine's for the same seed.
+     */
+    class UncontendedSolver
+    {
+    private:
+        /**
+         * The cycle every aircraft of a type follows until a fault grounds it
+         */
+        struct TypeCycle
+        {
+            bool present = false;
+            double flight_time_hours = 0.0;
+            double distance_miles = 0.0;
+            double charge_time_hours = 0.0;
+            int passenger_count = 0;
+            std::vector<double> flight_starts; // every flight started before the end of the run
+            int charge_sessions = 0;           // charges a fault-free aircraft starts
+        };
+
+        StatsRecorder &stats_recorder_;
+        double simulation_duration_hours_;
+        bool enable_partial_flights_;
+        std::array<TypeCycle, NUM_AIRCRAFT_TYPES> cycles_{};
+
+        // Same additions as the event queue's timestamps, so every boundary comparison agrees with the engine
+        void build_cycle(TypeCycle &cycle) const
+        {
+            cycle.flight_starts.clear();
+            cycle.charge_sessions = 0;
+            double flight_start = 0.0;
+            while (true)
+            {
+                cycle.flight_starts.push_back(flight_start);
+                double landing = flight_start + cycle.flight_time_hours;
+                if (!(landing < simulation_duration_hours_))
+                {
+                    break;
+                }
+                ++cycle.charge_sessions;
+                double charged = landing + cycle.charge_time_hours;
+                if (!(charged < simulation_duration_hours_))
+                {
+                    break;
+                }
+                flight_start = charged;
+            }
+        }
+
+        // Events at or before the end are finished as partial activities even without enable_partial_flights_
+        bool counts_as_partial(double event_time) const
+        {
+            return enable_partial_flights_ || event_time <= simulation_duration_hours_;
+        }
+
+    public:
+        UncontendedSolver(StatsRecorder &recorder, double duration_hours, bool partial_flights)
+            : stats_recorder_(recorder), simulation_duration_hours_(duration_hours), enable_partial_flights_(partial_flights)
+        {
+        }
+
+        /**
+         * Check that the run can be solved directly and prepare the per-type cycles
+         * Every aircraft must start charged, aircraft of a type must agree on their flight and charge
+         * times, no pool may have aircraft waiting, and each pool must have a free charger for every
+         * charge session its aircraft could start.
+         * @return True if run() gives the engine's result
+         */
+        template <SimulationFleet Fleet>
+        bool prepare(const ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            if (simulation_duration_hours_ <= 0.0 || charger_mgr.get_queue_size() != 0)
+            {
+                return false;
+            }
+
+            cycles_ = {};
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                auto &&aircraft = fleet[i];
+                if (aircraft->get_battery_level() != 1.0)
+                {
+                    return false;
+                }
+
+                TypeCycle &cycle = cycles_[static_cast<size_t>(aircraft->get_type())];
+                double flight_time = aircraft->get_flight_time_hours();
+                double distance = aircraft->get_flight_distance_miles();
+                double charge_time = aircraft->get_charge_time_hours();
+                int passengers = aircraft->get_passenger_count();
+                if (!cycle.present)
+                {
+                    if (!(flight_time > 0.0) || !(charge_time > 0.0))
+                    {
+                        return false;
+                    }
+                    cycle.present = true;
+                    cycle.flight_time_hours = flight_time;
+                    cycle.distance_miles = distance;
+                    cycle.charge_time_hours = charge_time;
+                    cycle.passenger_count = passengers;
+                }
+                else if (flight_time != cycle.flight_time_hours || distance != cycle.distance_miles ||
+                         charge_time != cycle.charge_time_hours || passengers != cycle.passenger_count)
+                {
+                    return false;
+                }
+            }
+
+            for (TypeCycle &cycle : cycles_)
+            {
+                if (cycle.present)
+                {
+                    build_cycle(cycle);
+                }
+            }
+
+            // Faults only ever end cycles early, so fault-free demand bounds every pool's charge sessions
+            std::vector<long long> demand(charger_mgr.get_pool_count(), 0);
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                auto &&aircraft = fleet[i];
+                demand[charger_mgr.get_home_pool(aircraft->get_id())] +=
+                    cycles_[static_cast<size_t>(aircraft->get_type())].charge_sessions;
+            }
+            for (size_t pool = 0; pool < demand.size(); ++pool)
+            {
+                if (demand[pool] > charger_mgr.get_available_chargers(pool))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Record every aircraft's run and leave the fleet and chargers as the engine would
+         * @pre prepare() returned true for this fleet and charger manager
+         */
+        template <SimulationFleet Fleet>
+        void run(ChargerManager &charger_mgr, Fleet &fleet)
+        {
+            // The engine finishes cut-off activities after everything else; they share their type's totals
+            std::array<int, NUM_AIRCRAFT_TYPES> partial_flights{};
+            std::array<int, NUM_AIRCRAFT_TYPES> partial_charges{};
+
+            for (size_t i = 0; i < fleet.size(); ++i)
+            {
+                auto &&aircraft = fleet[i];
+                AircraftType type = aircraft->get_type();
+                const TypeCycle &cycle = cycles_[static_cast<size_t>(type)];
+
+                for (double flight_start : cycle.flight_starts)
+                {
+                    // Tied with the landing, the fault was queued first and is handled first
+                    double fault_time = aircraft->check_fault_during_flight(cycle.flight_time_hours);
+                    if (fault_time >= 0.0 && flight_start + fault_time < simulation_duration_hours_)
+                    {
+                        aircraft->set_faulty(true);
+                        stats_recorder_.record_fault(type);
+                    }
+
+                    double landing = flight_start + cycle.flight_time_hours;
+                    if (!(landing < simulation_duration_hours_))
+                    {
+                        partial_flights[static_cast<size_t>(type)] += counts_as_partial(landing);
+                        break;
+                    }
+
+                    aircraft->discharge_battery();
+                    stats_recorder_.record_flight(type, cycle.flight_time_hours, cycle.distance_miles, cycle.passenger_count);
+                    if (aircraft->is_faulty())
+                    {
+                        break;
+                    }
+
+                    charger_mgr.request_charger(aircraft->get_id());
+                    stats_recorder_.record_queue_length(type, 0);
+
+                    double charged = landing + cycle.charge_time_hours;
+                    if (!(charged < simulation_duration_hours_))
+                    {
+                        partial_charges[static_cast<size_t>(type)] += counts_as_partial(charged);
+                        break;
+                    }
+
+                    aircraft->charge_battery();
+                    stats_recorder_.record_charge_session(type, cycle.charge_time_hours, 0.0);
+                }
+            }
+
+            // Only the last flight of a cycle can be cut off, so every aircraft of a type ends the same way
+            for (size_t t = 0; t < NUM_AIRCRAFT_TYPES; ++t)
+            {
+                const TypeCycle &cycle = cycles_[t];
+                if (!cycle.present)
+                {
+                    continue;
+                }
+                AircraftType type = static_cast<AircraftType>(t);
+                double last_start = cycle.flight_starts.back();
+                double partial_flight_time = simulation_duration_hours_ - last_start;
+                double partial_distance = (partial_flight_time / cycle.flight_time_hours) * cycle.distance_miles;
+                for (int n = 0; n < partial_flights[t]; ++n)
+                {
+                    stats_recorder_.record_partial_flight(type, partial_flight_time, partial_distance, cycle.passenger_count);
+                }
+
+                double partial_charge_time = simulation_duration_hours_ - (last_start + cycle.flight_time_hours);
+                for (int n = 0; n < partial_charges[t]; ++n)
+                {
+                    stats_recorder_.record_partial_charge(type, partial_charge_time);
+                }
+            }
+        }
+    };
+}